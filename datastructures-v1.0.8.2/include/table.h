@@ -21,6 +21,11 @@
  * free_function is set, do not add the same pointer twice as this
  * will result in memory errors.
  *
+ * A table created by table_empty_ex() with TABLE_UNIQUE_KEYS holds at
+ * most one pair per key instead. Insert then replaces the pair of a
+ * key that is already in the table, and remove stops at the first
+ * match.
+ *
  * Authors: Niclas Borlin (niclas@cs.umu.se)
  *	    Adam Dahlgren Lindstrom (dali@cs.umu.se)
  *
@@ -28,12 +33,56 @@
  *
  * Version information:
  *   2018-02-06: v1.0, first public version.
+ *   2026-10-17: v1.1, added table_empty_hashed().
+ *   2026-10-17: v1.2, added batched insert/lookup/remove.
+ *   2026-10-17: v1.3, added table_stats().
+ *   2026-10-17: v1.4, added table_empty_ex() and TABLE_UNIQUE_KEYS.
+ *   2026-10-17: v1.5, added table_clear() and table_drain().
+ *   2026-10-17: v1.6, added table_lookup_all() and table_count().
  */
 
 // ==========PUBLIC DATA TYPES============
 // Table type.
 typedef struct table table;
 
+// Flag for table_empty_ex(). Keys are unique, so inserting a key that
+// is already in the table replaces its pair.
+#define TABLE_UNIQUE_KEYS 0x1
+
+// Number of buckets in the probe length histograms of table_stats().
+#define TABLE_STATS_BUCKETS 32
+
+// Probe lengths of one kind of operation. The probe length of an
+// operation is the number of stored keys or slots it examined.
+typedef struct table_probe_stats {
+	// Number of operations.
+	unsigned long count;
+	// Sum, maximum and mean of the probe lengths.
+	unsigned long total;
+	unsigned long max;
+	double mean;
+	// histogram[0] counts the operations with probe length 0, and
+	// histogram[i] those with probe length 2^(i-1) to 2^i - 1.
+	unsigned long histogram[TABLE_STATS_BUCKETS];
+} table_probe_stats;
+
+// Statistics of the operations on a table, see table_stats().
+typedef struct table_statistics {
+	// False if the implementation keeps no statistics.
+	bool enabled;
+	unsigned long inserts;
+	unsigned long lookups;
+	// Lookups that found and did not find their key.
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long removes;
+	// Number of calls to the key compare function.
+	unsigned long key_compares;
+	table_probe_stats insert_probes;
+	table_probe_stats lookup_probes;
+	table_probe_stats remove_probes;
+} table_statistics;
+
 // ==========DATA STRUCTURE INTERFACE==========
 
 /**
@@ -51,6 +100,54 @@ table *table_empty(compare_function key_cmp_func,
 		   free_function key_free_func,
 		   free_function value_free_func);
 
+/**
+ * table_empty_hashed() - Create an empty table that may hash its keys.
+ * @key_cmp_func: A pointer to a function to be used to compare keys. See
+ *                util.h for the definition of compare_function.
+ * @key_hash_func: A pointer to a function to be used to hash keys. See
+ *                 util.h for the definition of hash_function.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Implementations that do not hash their keys ignore key_hash_func
+ * and behave exactly as table_empty().
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function key_cmp_func,
+			  hash_function key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func);
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys. See
+ *                util.h for the definition of compare_function.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash
+ *                 keys. See util.h for the definition of hash_function.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: TABLE_UNIQUE_KEYS, or 0 for the same table as
+ *	   table_empty_hashed().
+ *
+ * With TABLE_UNIQUE_KEYS, table_insert() of a key that is already in
+ * the table replaces the key and value of its pair and calls any free
+ * functions set for keys/values on the replaced ones, unless they are
+ * the same memory as the new ones. Since there are no duplicates,
+ * table_remove() can stop at the first matching key.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function key_cmp_func,
+		      hash_function key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags);
+
 /**
  * table_is_empty() - Check if a table is empty.
  * @t: Table to check.
@@ -85,13 +182,39 @@ void table_insert(table *t, void *key, void *value);
  */
 void *table_lookup(const table *t, const void *key);
 
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The pairs are visited latest inserted first, so the first value
+ * func gets is the one table_lookup() returns. Tables that keep the
+ * duplicates of a key together visit them without examining the pairs
+ * of other keys. The table must not be changed by func.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func);
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates, or
+ * 0 if the key is not in the table.
+ */
+unsigned long table_count(const table *t, const void *key);
+
 /**
  * table_choose_key() - Return an arbitrary key.
  * @t: Table to inspect.
  *
  * Return an arbitrary key stored in the table. Can be used together
- * with table_remove() to deconstruct the table if no duplicates have
- * been stored in the table. Undefined for an empty table.
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
  *
  * Returns: An arbitrary key stored in the table.
  */
@@ -123,6 +246,33 @@ void table_remove(table *t, const void *key);
  */
 void table_kill(table *t);
 
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs, including
+ * duplicates, and releases the memory used to store them, in time
+ * linear in the number of pairs. The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t);
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table,
+ *	  including duplicates.
+ *
+ * Removes all pairs from the table in time linear in the number of
+ * pairs, as table_clear() does, but calls func on each pair instead of
+ * the free functions. func takes over the memory of the key and value.
+ * The table must not be used by func. The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func);
+
 /**
  * table_print() - Print the given table.
  * @t: Table to print.
@@ -135,4 +285,63 @@ void table_kill(table *t);
  */
 void table_print(const table *t, inspect_callback_pair print_func);
 
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Same result as calling table_insert() for each pair in array
+ * order, so a later duplicate key in the batch becomes the latest
+ * value for that key.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n);
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Same result as calling table_lookup() for each key, but
+ * implementations may overlap the memory accesses of the lookups.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n);
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Same result as calling table_remove() for each key. As with
+ * table_remove(), a key may point to the same memory as a key stored
+ * in the table, but not to one that an earlier key in the batch
+ * removes.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n);
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * Statistics are only kept by implementations compiled with
+ * TABLE_STATS defined, see table_stats.h. Otherwise out->enabled is
+ * set to false and all counts to zero, and the operations spend no
+ * time on statistics. The batched operations count as one operation
+ * per key.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out);
+
 #endif
@@ -0,0 +1,204 @@
+#ifndef TABLE_STATS_H
+#define TABLE_STATS_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "table.h"
+
+/*
+ * Helpers for implementations of table.h that keep the statistics
+ * returned by table_stats(). Statistics are only kept when compiled
+ * with TABLE_STATS defined. Otherwise the macros below do nothing but
+ * evaluate their probe length and found arguments, which the compiler
+ * then removes, so the table operations cost the same as without the
+ * helpers.
+ *
+ * An implementation adds the field
+ *
+ *	#ifdef TABLE_STATS
+ *	table_statistics *stats;
+ *	#endif
+ *
+ * to its struct table, as a pointer so that const operations such as
+ * table_lookup() can count, and then uses
+ *
+ *	TABLE_STATS_INIT(t)			when the table is created,
+ *	TABLE_STATS_FREE(t)			when the table is killed,
+ *	TABLE_KEY_CMP(t, a, b)			to compare keys a and b,
+ *	TABLE_STATS_INSERT(t, probes)		for each inserted pair,
+ *	TABLE_STATS_LOOKUP(t, probes, found)	for each looked up key,
+ *	TABLE_STATS_REMOVE(t, probes)		for each removed key and
+ *	TABLE_STATS_GET(t, out)			in table_stats().
+ *
+ * For implementations that only examine keys by comparing them, the
+ * probe length of an operation is the number of compares it made:
+ *
+ *	unsigned long mark = TABLE_STATS_COMPARES(t);
+ *	...
+ *	TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, found);
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+#ifdef TABLE_STATS
+
+#define TABLE_STATS_INIT(t) ((t)->stats = calloc(1, sizeof(*(t)->stats)))
+#define TABLE_STATS_FREE(t) free((t)->stats)
+#define TABLE_KEY_CMP(t, a, b)						\
+	((t)->stats->key_compares++, (t)->key_cmp_func((a), (b)))
+#define TABLE_STATS_COMPARES(t) ((t)->stats->key_compares)
+#define TABLE_STATS_INSERT(t, probes)					\
+	table_stats_record((t)->stats, TABLE_STATS_OP_INSERT, (probes), true)
+#define TABLE_STATS_LOOKUP(t, probes, found)				\
+	table_stats_record((t)->stats, TABLE_STATS_OP_LOOKUP, (probes), (found))
+#define TABLE_STATS_REMOVE(t, probes)					\
+	table_stats_record((t)->stats, TABLE_STATS_OP_REMOVE, (probes), true)
+#define TABLE_STATS_GET(t, out) table_stats_get((t)->stats, (out))
+
+#else
+
+#define TABLE_STATS_INIT(t) ((void)0)
+#define TABLE_STATS_FREE(t) ((void)0)
+#define TABLE_KEY_CMP(t, a, b) ((t)->key_cmp_func((a), (b)))
+#define TABLE_STATS_COMPARES(t) 0UL
+#define TABLE_STATS_INSERT(t, probes) ((void)(probes))
+#define TABLE_STATS_LOOKUP(t, probes, found) ((void)(probes), (void)(found))
+#define TABLE_STATS_REMOVE(t, probes) ((void)(probes))
+#define TABLE_STATS_GET(t, out) table_stats_get(NULL, (out))
+
+#endif
+
+// Kinds of operations recorded by table_stats_record().
+enum table_stats_op {
+	TABLE_STATS_OP_INSERT,
+	TABLE_STATS_OP_LOOKUP,
+	TABLE_STATS_OP_REMOVE
+};
+
+/**
+ * table_stats_record() - Record one operation.
+ * @s: Statistics to update.
+ * @op: Kind of operation.
+ * @probes: Probe length of the operation.
+ * @found: For lookups, whether the key was found.
+ *
+ * Returns: Nothing.
+ */
+static inline void table_stats_record(table_statistics *s,
+				      enum table_stats_op op,
+				      unsigned long probes, bool found)
+{
+	table_probe_stats *p;
+
+	switch (op) {
+	case TABLE_STATS_OP_INSERT:
+		s->inserts++;
+		p = &s->insert_probes;
+		break;
+	case TABLE_STATS_OP_LOOKUP:
+		s->lookups++;
+		if (found) {
+			s->hits++;
+		} else {
+			s->misses++;
+		}
+		p = &s->lookup_probes;
+		break;
+	default:
+		s->removes++;
+		p = &s->remove_probes;
+		break;
+	}
+	p->count++;
+	p->total += probes;
+	if (probes > p->max) {
+		p->max = probes;
+	}
+	int bucket = 0;
+	while (probes > 0 && bucket < TABLE_STATS_BUCKETS - 1) {
+		probes >>= 1;
+		bucket++;
+	}
+	p->histogram[bucket]++;
+}
+
+/**
+ * table_stats_merge() - Add statistics to other statistics.
+ * @out: Statistics to add to.
+ * @s: Statistics to add.
+ *
+ * Used by implementations that keep statistics in several parts. The
+ * means are not updated, see table_stats_finish().
+ *
+ * Returns: Nothing.
+ */
+static inline void table_stats_merge(table_statistics *out,
+				     const table_statistics *s)
+{
+	table_probe_stats *to[3] = {
+		&out->insert_probes, &out->lookup_probes, &out->remove_probes
+	};
+	const table_probe_stats *from[3] = {
+		&s->insert_probes, &s->lookup_probes, &s->remove_probes
+	};
+
+	out->inserts += s->inserts;
+	out->lookups += s->lookups;
+	out->hits += s->hits;
+	out->misses += s->misses;
+	out->removes += s->removes;
+	out->key_compares += s->key_compares;
+	for (int i = 0; i < 3; i++) {
+		to[i]->count += from[i]->count;
+		to[i]->total += from[i]->total;
+		if (from[i]->max > to[i]->max) {
+			to[i]->max = from[i]->max;
+		}
+		for (int j = 0; j < TABLE_STATS_BUCKETS; j++) {
+			to[i]->histogram[j] += from[i]->histogram[j];
+		}
+	}
+}
+
+/**
+ * table_stats_finish() - Compute the mean probe lengths.
+ * @out: Statistics to update.
+ *
+ * Returns: Nothing.
+ */
+static inline void table_stats_finish(table_statistics *out)
+{
+	table_probe_stats *p[3] = {
+		&out->insert_probes, &out->lookup_probes, &out->remove_probes
+	};
+
+	for (int i = 0; i < 3; i++) {
+		p[i]->mean = p[i]->count == 0 ? 0.0
+			: (double)p[i]->total / p[i]->count;
+	}
+}
+
+/**
+ * table_stats_get() - Copy statistics for table_stats().
+ * @s: Statistics kept by a table, or NULL if it keeps none.
+ * @out: Set to a copy of s with the means computed.
+ *
+ * Returns: Nothing.
+ */
+static inline void table_stats_get(const table_statistics *s,
+				   table_statistics *out)
+{
+	memset(out, 0, sizeof(*out));
+	if (s == NULL) {
+		return;
+	}
+	table_stats_merge(out, s);
+	out->enabled = true;
+	table_stats_finish(out);
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef __TYPED_TABLE_H
+#define __TYPED_TABLE_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * Generator of typed tables for the "Datastructures and algorithms"
+ * courses at the Department of Computing Science, Umea University.
+ *
+ * DOA_DEFINE_TABLE(name, KeyType, ValueType, key_cmp, key_hash)
+ * defines a table type called name that stores keys and values by
+ * value, and static inline functions name_empty(), name_insert(), etc.
+ * that work on it. Unlike table.h no key or value has to be allocated
+ * on the heap, and since key_cmp and key_hash are called directly the
+ * compiler can inline them.
+ *
+ * key_cmp(a, b) must return 0 if the keys a and b are equal, and
+ * key_hash(key) must return the same unsigned long for equal keys.
+ * Both may be functions or function-like macros.
+ *
+ * The pairs are kept in an open addressing hash table with linear
+ * probing that doubles in size when it is 3/4 full. Removal shifts
+ * later pairs back, so no tombstones are needed.
+ *
+ * Unlike table.h, a typed table keeps only one pair per key. Inserting
+ * a key that is already in the table replaces its value.
+ *
+ * Example:
+ *
+ *	static int int_cmp(int a, int b) { return a - b; }
+ *	static unsigned long int_hash(int a) { return a; }
+ *	DOA_DEFINE_TABLE(int_table, int, double, int_cmp, int_hash)
+ *
+ *	int_table *t = int_table_empty();
+ *	int_table_insert(t, 90187, 63.8);
+ *	double *v = int_table_lookup(t, 90187);
+ *	int_table_kill(t);
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-18: v1.1, comment no longer claims table.h is built on it.
+ */
+
+// Number of slots in a newly created table. Must be a power of two.
+#define TYPED_TABLE_INITIAL_CAPACITY 16UL
+
+// Hash value marking an unused slot.
+#define TYPED_TABLE_EMPTY_HASH 0UL
+
+/**
+ * typed_table_mix_hash() - Spread the bits of a user supplied hash value.
+ * @h: Hash value returned by the key hash function.
+ *
+ * Uses the finalizer of MurmurHash3, so that identity hashes of
+ * integers do not form long clusters. Never returns
+ * TYPED_TABLE_EMPTY_HASH.
+ *
+ * Returns: The mixed hash value.
+ */
+static inline unsigned long typed_table_mix_hash(unsigned long h)
+{
+	unsigned long long x = h;
+
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+
+	if ((unsigned long)x == TYPED_TABLE_EMPTY_HASH) {
+		return 1;
+	}
+	return (unsigned long)x;
+}
+
+/**
+ * DOA_DEFINE_TABLE() - Define a typed table and its functions.
+ * @name: Name of the table type, also used as prefix of the functions.
+ * @KeyType: Type of the keys.
+ * @ValueType: Type of the values.
+ * @key_cmp: Function or macro that compares two keys, 0 if equal.
+ * @key_hash: Function or macro that hashes a key to an unsigned long.
+ *
+ * Defines the following, with name replaced by the given name:
+ *
+ *   name *name_empty(void);
+ *   bool name_is_empty(const name *t);
+ *   void name_insert(name *t, KeyType key, ValueType value);
+ *   ValueType *name_lookup(const name *t, KeyType key);
+ *   KeyType name_choose_key(const name *t);
+ *   bool name_remove(name *t, KeyType key);
+ *   void name_kill(name *t);
+ *   void name_print(const name *t, void (*print_func)(KeyType, ValueType));
+ *
+ * name_lookup() returns a pointer to the stored value, or NULL if the
+ * key is not found. The pointer is valid until the next insert or
+ * remove. name_remove() returns true if the key was found.
+ * name_choose_key() is undefined for an empty table.
+ */
+#define DOA_DEFINE_TABLE(name, KeyType, ValueType, key_cmp, key_hash)	\
+									\
+struct name##_slot {							\
+	unsigned long hash;						\
+	KeyType key;							\
+	ValueType value;						\
+};									\
+									\
+typedef struct name {							\
+	struct name##_slot *slots;					\
+	unsigned long capacity;						\
+	unsigned long size;						\
+	unsigned long first_used;					\
+} name;									\
+									\
+static inline unsigned long name##_find_slot(const name *t, KeyType key, \
+					     unsigned long mixed_hash)	\
+{									\
+	unsigned long mask = t->capacity - 1;				\
+	unsigned long i = mixed_hash & mask;				\
+									\
+	while (t->slots[i].hash != TYPED_TABLE_EMPTY_HASH) {		\
+		if (t->slots[i].hash == mixed_hash			\
+		    && key_cmp(t->slots[i].key, key) == 0) {		\
+			return i;					\
+		}							\
+		i = (i + 1) & mask;					\
+	}								\
+	return i;							\
+}									\
+									\
+static inline void name##_grow(name *t)					\
+{									\
+	struct name##_slot *old_slots = t->slots;			\
+	unsigned long old_capacity = t->capacity;			\
+									\
+	t->capacity = old_capacity * 2;					\
+	t->slots = calloc(t->capacity, sizeof(*t->slots));		\
+	t->first_used = t->capacity;					\
+									\
+	unsigned long mask = t->capacity - 1;				\
+	for (unsigned long j = 0; j < old_capacity; j++) {		\
+		if (old_slots[j].hash == TYPED_TABLE_EMPTY_HASH) {	\
+			continue;					\
+		}							\
+		unsigned long i = old_slots[j].hash & mask;		\
+		while (t->slots[i].hash != TYPED_TABLE_EMPTY_HASH) {	\
+			i = (i + 1) & mask;				\
+		}							\
+		t->slots[i] = old_slots[j];				\
+		if (i < t->first_used) {				\
+			t->first_used = i;				\
+		}							\
+	}								\
+	free(old_slots);						\
+}									\
+									\
+static inline name *name##_empty(void)					\
+{									\
+	name *t = malloc(sizeof(*t));					\
+									\
+	t->capacity = TYPED_TABLE_INITIAL_CAPACITY;			\
+	t->slots = calloc(t->capacity, sizeof(*t->slots));		\
+	t->size = 0;							\
+	t->first_used = t->capacity;					\
+	return t;							\
+}									\
+									\
+static inline bool name##_is_empty(const name *t)			\
+{									\
+	return t->size == 0;						\
+}									\
+									\
+static inline void name##_insert(name *t, KeyType key, ValueType value)	\
+{									\
+	if (4 * (t->size + 1) > 3 * t->capacity) {			\
+		name##_grow(t);						\
+	}								\
+	unsigned long mixed_hash = typed_table_mix_hash(key_hash(key));	\
+	unsigned long i = name##_find_slot(t, key, mixed_hash);		\
+									\
+	if (t->slots[i].hash == TYPED_TABLE_EMPTY_HASH) {		\
+		t->slots[i].hash = mixed_hash;				\
+		t->slots[i].key = key;					\
+		t->size++;						\
+		if (i < t->first_used) {				\
+			t->first_used = i;				\
+		}							\
+	}								\
+	t->slots[i].value = value;					\
+}									\
+									\
+static inline ValueType *name##_lookup(const name *t, KeyType key)	\
+{									\
+	unsigned long mixed_hash = typed_table_mix_hash(key_hash(key));	\
+	unsigned long i = name##_find_slot(t, key, mixed_hash);		\
+									\
+	if (t->slots[i].hash == TYPED_TABLE_EMPTY_HASH) {		\
+		return NULL;						\
+	}								\
+	return &t->slots[i].value;					\
+}									\
+									\
+static inline KeyType name##_choose_key(const name *t)			\
+{									\
+	return t->slots[t->first_used].key;				\
+}									\
+									\
+static inline bool name##_remove(name *t, KeyType key)			\
+{									\
+	unsigned long mask = t->capacity - 1;				\
+	unsigned long mixed_hash = typed_table_mix_hash(key_hash(key));	\
+	unsigned long i = name##_find_slot(t, key, mixed_hash);		\
+	unsigned long j = i;						\
+									\
+	if (t->slots[i].hash == TYPED_TABLE_EMPTY_HASH) {		\
+		return false;						\
+	}								\
+	/* Move later slots of the cluster back into the gap unless	\
+	 * their home lies cyclically in (i, j]. */			\
+	for (;;) {							\
+		j = (j + 1) & mask;					\
+		if (t->slots[j].hash == TYPED_TABLE_EMPTY_HASH) {	\
+			break;						\
+		}							\
+		unsigned long home = t->slots[j].hash & mask;		\
+		bool stays = (i <= j) ? (i < home && home <= j)		\
+			: (i < home || home <= j);			\
+		if (!stays) {						\
+			t->slots[i] = t->slots[j];			\
+			i = j;						\
+		}							\
+	}								\
+	t->slots[i].hash = TYPED_TABLE_EMPTY_HASH;			\
+	t->size--;							\
+	while (t->first_used < t->capacity				\
+	       && t->slots[t->first_used].hash == TYPED_TABLE_EMPTY_HASH) { \
+		t->first_used++;					\
+	}								\
+	return true;							\
+}									\
+									\
+static inline void name##_kill(name *t)					\
+{									\
+	free(t->slots);							\
+	free(t);							\
+}									\
+									\
+static inline void name##_print(const name *t,				\
+				void (*print_func)(KeyType, ValueType))	\
+{									\
+	for (unsigned long i = 0; i < t->capacity; i++) {		\
+		if (t->slots[i].hash != TYPED_TABLE_EMPTY_HASH) {	\
+			print_func(t->slots[i].key, t->slots[i].value);	\
+		}							\
+	}								\
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef __UTIL_H
 #define __UTIL_H
 
+#include <stddef.h>
+
 /*
  * Utility function types for deallocating, printing and comparing
  * values stored by various data types.
@@ -13,6 +15,9 @@
  * Version information:
  *   2018-01-28: v1.0, first public version.
  *   2018-02-06: v1.1, updated explanation for the compare_function.
+ *   2026-10-17: v1.2, added hash_function.
+ *   2026-10-17: v1.3, added consume_callback_pair.
+ *   2026-10-17: v1.4, added serialize_function.
  */
 
 // Type definition for de-allocator function, e.g. free().
@@ -25,6 +30,10 @@ typedef void (*inspect_callback)(const void *);
 // Ditto for dual-value containers.
 typedef void (*inspect_callback_pair)(const void *, const void *);
 
+// Type definition for callback that takes over a key/value pair
+// removed from a container, used by e.g. table_drain().
+typedef void (*consume_callback_pair)(void *, void *);
+
 // Type definition for comparison function, used by e.g. table.
 //
 // Comparison functions should return values that indicate the order
@@ -35,4 +44,21 @@ typedef void (*inspect_callback_pair)(const void *, const void *);
 // value should be returned.
 typedef int compare_function(const void *,const void *);
 
+// Type definition for hash function, used by e.g. hashed tables.
+//
+// Hash functions should return the same value for any two arguments
+// that the corresponding comparison function considers equal. The
+// values need not be well distributed, the table mixes them before
+// use, but the more distinct values the fewer collisions.
+typedef unsigned long hash_function(const void *);
+
+// Type definition for serializer, used by e.g. tables saved to files.
+//
+// A serializer writes the bytes of a key or value to a buffer. It must
+// return the number of bytes needed, and only write them if that is at
+// most size. A table loaded from a file uses the bytes in place,
+// aligned to 16 bytes, so they must make up the object by themselves,
+// e.g. an int or a null terminated string.
+typedef size_t serialize_function(const void *p, void *buf, size_t size);
+
 #endif
@@ -16,6 +16,7 @@
  *
  * Version information:
  *   2018-01-28: v1.0, first public version.
+ *   2026-10-17: v1.1, added dlist_move().
  */
 
 // ===========INTERNAL DATA TYPES============
@@ -189,6 +190,40 @@ dlist_pos dlist_remove(dlist *l, const dlist_pos p)
 	return p;
 }
 
+/**
+ * dlist_move() - Move an element of a dlist to another position.
+ * @l: List to manipulate.
+ * @p: Position in the list of the element to move.
+ * @q: Position in the list before which the element should be placed.
+ *
+ * Unlinks the element at p and links it in again before q. The cell
+ * holding the element is reused, so no memory is allocated or freed.
+ * Moving an element to the front of the list is done with q equal to
+ * dlist_first(). Other positions may refer to other elements
+ * afterwards, in the same way as after dlist_insert() and
+ * dlist_remove().
+ *
+ * Returns: The position of the moved element.
+ */
+dlist_pos dlist_move(dlist *l, const dlist_pos p, const dlist_pos q)
+{
+	// Cell to move.
+	dlist_pos c=p->next;
+
+	// Moving an element to just before itself or just before the
+	// element after it leaves the list unchanged.
+	if (q == p || q == c) {
+		return p;
+	}
+	// Link past the cell to move...
+	p->next=c->next;
+	// ...and link it in again after q.
+	c->next=q->next;
+	q->next=c;
+
+	return q;
+}
+
 /**
  * dlist_kill() - Destroy a given dlist.
  * @l: List to destroy.
@@ -2,6 +2,7 @@
 #include <stdio.h>
 
 #include "table.h"
+#include "table_stats.h"
 #include "dlist.h"
 
 /*
@@ -9,7 +10,9 @@
  * algorithms" courses at the Department of Computing Science, Umea
  * University.
  *
- * Duplicates are handled by inspect and remove.
+ * Duplicates are handled by inspect and remove. Tables created with
+ * TABLE_UNIQUE_KEYS have no duplicates. Their insert replaces the pair
+ * of a key already in the list, and remove stops at the first match.
  *
  * Authors: Niclas Borlin (niclas@cs.umu.se)
  *	    Adam Dahlgren Lindstrom (dali@cs.umu.se)
@@ -19,8 +22,17 @@
  * Version information:
  *   2018-02-06: v1.0, first public version.
  *   2019-03-04: v1.1, bugfix in table_remove.
+ *   2026-10-17: v1.2, added batched insert/lookup/remove.
+ *   2026-10-17: v1.3, added table_stats().
+ *   2026-10-17: v1.4, added table_empty_ex().
+ *   2026-10-17: v1.5, added table_clear() and table_drain().
+ *   2026-10-17: v1.6, added table_lookup_all() and table_count().
  */
 
+// Number of keys handled per walk of the list by the batched
+// operations.
+#define BATCH_SIZE 64
+
 // ===========INTERNAL DATA TYPES============
 
 struct table {
@@ -28,6 +40,11 @@ struct table {
 	compare_function *key_cmp_func;
 	free_function key_free_func;
 	free_function value_free_func;
+	// True if created with TABLE_UNIQUE_KEYS.
+	bool unique_keys;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
 };
 
 struct table_entry {
@@ -37,6 +54,245 @@ struct table_entry {
 
 // ===========INTERNAL FUNCTION IMPLEMENTATIONS============
 
+/**
+ * batch_index() - Find the batch key that matches a key.
+ * @t: Table whose compare function is used.
+ * @key: Key to compare.
+ * @keys: Batch of keys.
+ * @done: Flags for keys that should be skipped, or NULL.
+ * @n: Number of keys in the batch.
+ *
+ * Returns: Index of the first matching key not flagged in done, or -1.
+ */
+static int batch_index(const table *t, const void *key, void **keys,
+		       const bool *done, int n)
+{
+	for (int i = 0; i < n; i++) {
+		if ((done == NULL || !done[i])
+		    && TABLE_KEY_CMP(t, key, keys[i]) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * is_batch_pointer() - Check if a pointer is one of the batch keys.
+ * @p: Pointer to check.
+ * @keys: Batch of keys.
+ * @n: Number of keys in the batch.
+ *
+ * Returns: True if p points to the same memory as one of the keys.
+ */
+static bool is_batch_pointer(const void *p, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		if (keys[i] == p) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * lookup_batch() - Look up at most BATCH_SIZE keys in one list walk.
+ * @t: Table to inspect.
+ * @keys: Keys to look up.
+ * @values: Set to the value for each key, or NULL.
+ * @n: Number of keys, at most BATCH_SIZE.
+ *
+ * Returns: Nothing.
+ */
+static void lookup_batch(const table *t, void **keys, void **values, int n)
+{
+	bool found[BATCH_SIZE] = { false };
+	int left = n;
+	unsigned long walked = 0;
+
+	for (int i = 0; i < n; i++) {
+		values[i] = NULL;
+	}
+	// Walk the list once, comparing each entry with every key that
+	// has not been found yet. Stop when all keys have been found.
+	dlist_pos pos = dlist_first(t->entries);
+	while (left > 0 && !dlist_is_end(t->entries, pos)) {
+		struct table_entry *entry = dlist_inspect(t->entries, pos);
+		int i = batch_index(t, entry->key, keys, found, n);
+		walked++;
+		// The first match is the latest added value. Equal keys
+		// in the batch all get it.
+		while (i >= 0) {
+			values[i] = entry->value;
+			found[i] = true;
+			left--;
+			TABLE_STATS_LOOKUP(t, walked, true);
+			i = batch_index(t, entry->key, keys, found, n);
+		}
+		pos = dlist_next(t->entries, pos);
+	}
+	for (int i = 0; i < left; i++) {
+		TABLE_STATS_LOOKUP(t, walked, false);
+	}
+}
+
+/**
+ * remove_batch() - Remove at most BATCH_SIZE keys in one list walk.
+ * @t: Table to manipulate.
+ * @keys: Keys to remove.
+ * @n: Number of keys, at most BATCH_SIZE.
+ *
+ * Returns: Nothing.
+ */
+static void remove_batch(table *t, void **keys, int n)
+{
+	// Stored keys that are also batch keys. They are still compared
+	// with, so they are freed after the walk.
+	void *deferred[BATCH_SIZE];
+	int n_deferred = 0;
+	unsigned long walked = 0;
+	// With unique keys, each batch key matches at most one entry, so
+	// the walk stops when all of them have been removed.
+	bool removed[BATCH_SIZE] = { false };
+	int left = n;
+
+	dlist_pos pos = dlist_first(t->entries);
+	while (left > 0 && !dlist_is_end(t->entries, pos)) {
+		struct table_entry *entry = dlist_inspect(t->entries, pos);
+		const bool *done = t->unique_keys ? removed : NULL;
+		int i = batch_index(t, entry->key, keys, done, n);
+
+		walked++;
+		if (i < 0) {
+			pos = dlist_next(t->entries, pos);
+			continue;
+		}
+		// Equal keys in the batch are all done with this entry.
+		while (t->unique_keys && i >= 0) {
+			removed[i] = true;
+			left--;
+			i = batch_index(t, entry->key, keys, removed, n);
+		}
+		if (t->key_free_func != NULL) {
+			if (is_batch_pointer(entry->key, keys, n)) {
+				deferred[n_deferred++] = entry->key;
+			} else {
+				t->key_free_func(entry->key);
+			}
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(entry->value);
+		}
+		// Remove the list element itself.
+		pos = dlist_remove(t->entries, pos);
+	}
+	for (int i = 0; i < n_deferred; i++) {
+		t->key_free_func(deferred[i]);
+	}
+	for (int i = 0; i < n; i++) {
+		TABLE_STATS_REMOVE(t, walked);
+	}
+}
+
+/**
+ * replace_pair() - Replace the pair of a key that is in a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Calls any free functions set for keys/values on the replaced key and
+ * value, unless they are the same memory as the new ones.
+ *
+ * Returns: True if the pair was replaced, false if key is not in the
+ * table.
+ */
+static bool replace_pair(table *t, void *key, void *value)
+{
+	dlist_pos pos = dlist_first(t->entries);
+
+	while (!dlist_is_end(t->entries, pos)) {
+		struct table_entry *entry = dlist_inspect(t->entries, pos);
+		if (TABLE_KEY_CMP(t, entry->key, key) == 0) {
+			if (t->key_free_func != NULL && entry->key != key) {
+				t->key_free_func(entry->key);
+			}
+			if (t->value_free_func != NULL
+			    && entry->value != value) {
+				t->value_free_func(entry->value);
+			}
+			entry->key = key;
+			entry->value = value;
+			return true;
+		}
+		pos = dlist_next(t->entries, pos);
+	}
+	return false;
+}
+
+/**
+ * empty_list() - Remove all pairs from the list of a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * Always removes the first cell, so each removal takes constant time.
+ *
+ * Returns: Nothing.
+ */
+static void empty_list(table *t, consume_callback_pair func)
+{
+	dlist_pos pos = dlist_first(t->entries);
+
+	while (!dlist_is_end(t->entries, pos)) {
+		struct table_entry *entry = dlist_inspect(t->entries, pos);
+		if (func != NULL) {
+			func(entry->key, entry->value);
+		} else {
+			if (t->key_free_func != NULL) {
+				t->key_free_func(entry->key);
+			}
+			if (t->value_free_func != NULL) {
+				t->value_free_func(entry->value);
+			}
+		}
+		pos = dlist_remove(t->entries, pos);
+	}
+}
+
+/**
+ * visit_key() - Visit the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function to call for each pair, or NULL.
+ *
+ * Walks the whole list, since duplicates are separate entries. Tables
+ * with unique keys stop at the first match.
+ *
+ * Returns: The number of pairs with the key.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	dlist_pos pos = dlist_first(t->entries);
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+	unsigned long n = 0;
+
+	while (!dlist_is_end(t->entries, pos)) {
+		struct table_entry *entry = dlist_inspect(t->entries, pos);
+		if (TABLE_KEY_CMP(t, entry->key, key) == 0) {
+			if (func != NULL) {
+				func(entry->key, entry->value);
+			}
+			n++;
+			if (t->unique_keys) {
+				break;
+			}
+		}
+		pos = dlist_next(t->entries, pos);
+	}
+	TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, n > 0);
+	return n;
+}
+
 /**
  * table_empty() - Create an empty table.
  * @key_cmp_func: A pointer to a function to be used to compare keys.
@@ -59,10 +315,54 @@ table *table_empty(compare_function *key_cmp_func,
 	t->key_cmp_func = key_cmp_func;
 	t->key_free_func = key_free_func;
 	t->value_free_func = value_free_func;
+	TABLE_STATS_INIT(t);
 
 	return t;
 }
 
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the list is searched linearly.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the list is searched linearly.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: TABLE_UNIQUE_KEYS or 0.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	table *t = table_empty(key_cmp_func, key_free_func, value_free_func);
+
+	t->unique_keys = (flags & TABLE_UNIQUE_KEYS) != 0;
+	return t;
+}
+
 /**
  * table_is_empty() - Check if a table is empty.
  * @table: Table to check.
@@ -83,12 +383,21 @@ bool table_is_empty(const table *t)
  * Insert the key/value pair into the table. No test is performed to
  * check if key is a duplicate. table_lookup() will return the latest
  * added value for a duplicate key. table_remove() will remove all
- * duplicates for a given key.
+ * duplicates for a given key. If the table was created with
+ * TABLE_UNIQUE_KEYS, the pair of a key already in the table is
+ * replaced instead.
  *
  * Returns: Nothing.
  */
 void table_insert(table *t, void *key, void *value)
 {
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+
+	if (t->unique_keys && replace_pair(t, key, value)) {
+		TABLE_STATS_INSERT(t, TABLE_STATS_COMPARES(t) - mark);
+		return;
+	}
+
 	// Allocate the key/value structure.
 	struct table_entry *entry = malloc(sizeof(struct table_entry));
 
@@ -97,6 +406,7 @@ void table_insert(table *t, void *key, void *value)
 	entry->key = key;
 	entry->value = value;
 	dlist_insert(t->entries, entry, dlist_first(t->entries));
+	TABLE_STATS_INSERT(t, TABLE_STATS_COMPARES(t) - mark);
 }
 
 /**
@@ -113,22 +423,56 @@ void *table_lookup(const table *t, const void *key)
 	// Iterate over the list. Return first match.
 
 	dlist_pos pos = dlist_first(t->entries);
+	unsigned long mark = TABLE_STATS_COMPARES(t);
 
 	while (!dlist_is_end(t->entries, pos)) {
 		// Inspect the table entry
 		struct table_entry *entry = dlist_inspect(t->entries, pos);
 		// Check if the entry key matches the search key.
-		if (t->key_cmp_func(entry->key, key) == 0) {
+		if (TABLE_KEY_CMP(t, entry->key, key) == 0) {
 			// If yes, return the corresponding value pointer.
+			TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark,
+					   true);
 			return entry->value;
 		}
 		// Continue with the next position.
 		pos = dlist_next(t->entries, pos);
 	}
 	// No match found. Return NULL.
+	TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, false);
 	return NULL;
 }
 
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The pairs are visited latest inserted first, so the first value
+ * equals the one returned by table_lookup(). func must not change the
+ * table.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
 /**
  * table_choose_key() - Return an arbitrary key.
  * @t: Table to inspect.
@@ -163,6 +507,7 @@ void table_remove(table *t, const void *key)
 {
         // Will be set if we need to delay a free.
         void *deferred_ptr = NULL;
+        unsigned long mark = TABLE_STATS_COMPARES(t);
 
         // Start at beginning of the list.
         dlist_pos pos = dlist_first(t->entries);
@@ -173,7 +518,7 @@ void table_remove(table *t, const void *key)
                 struct table_entry *entry = dlist_inspect(t->entries, pos);
 
                 // Compare the supplied key with the key of this entry.
-                if (t->key_cmp_func(entry->key, key) == 0) {
+                if (TABLE_KEY_CMP(t, entry->key, key) == 0) {
                         // If we have a match, call free on the key
                         // and/or value if given the responsiblity
                         if (t->key_free_func != NULL) {
@@ -193,6 +538,10 @@ void table_remove(table *t, const void *key)
                         }
                         // Remove the list element itself.
                         pos = dlist_remove(t->entries, pos);
+                        if (t->unique_keys) {
+                                // There are no more matches.
+                                break;
+                        }
                 } else {
                         // No match, move on to next element in the list.
                         pos = dlist_next(t->entries, pos);
@@ -202,6 +551,7 @@ void table_remove(table *t, const void *key)
                 // Take care of the delayed free.
                 t->key_free_func(deferred_ptr);
         }
+        TABLE_STATS_REMOVE(t, TABLE_STATS_COMPARES(t) - mark);
 }
 
 /*
@@ -237,9 +587,39 @@ void table_kill(table *t)
 	// Kill what's left of the list...
 	dlist_kill(t->entries);
 	// ...and the table.
+	TABLE_STATS_FREE(t);
 	free(t);
 }
 
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_list(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table,
+ *	  including duplicates. Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_list(t, func);
+}
+
 /**
  * table_print() - Print the given table.
  * @t: Table to print.
@@ -262,3 +642,72 @@ void table_print(const table *t, inspect_callback_pair print_func)
 		pos = dlist_next(t->entries, pos);
 	}
 }
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Looks up BATCH_SIZE keys per walk of the list.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	for (int first = 0; first < n; first += BATCH_SIZE) {
+		int m = n - first < BATCH_SIZE ? n - first : BATCH_SIZE;
+		lookup_batch(t, keys + first, values + first, m);
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Removes BATCH_SIZE keys per walk of the list.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int first = 0; first < n; first += BATCH_SIZE) {
+		int m = n - first < BATCH_SIZE ? n - first : BATCH_SIZE;
+		remove_batch(t, keys + first, m);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of an operation is the number of list entries it
+ * compared with. Inserts have probe length 0, except in tables with
+ * unique keys where they look for the key first.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
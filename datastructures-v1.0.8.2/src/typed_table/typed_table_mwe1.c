@@ -0,0 +1,68 @@
+#include <stdio.h>
+
+#include "typed_table.h"
+
+/*
+ * Minimum working example for typed_table.h. Defines a table from
+ * int postal codes to city names, inserts 4 key-value pairs into it,
+ * including one with a key that is already in the table, makes two
+ * lookups and prints the result. Keys are stored by value, so nothing
+ * has to be allocated for them.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+// Compare two keys.
+static int compare_ints(int key1, int key2)
+{
+	if (key1 == key2) {
+		return 0;
+	}
+	if (key1 < key2) {
+		return -1;
+	}
+	return 1;
+}
+
+// Hash a key. The table mixes the bits, so the key itself will do.
+static unsigned long hash_int(int key)
+{
+	return (unsigned long)key;
+}
+
+DOA_DEFINE_TABLE(postal_table, int, const char *, compare_ints, hash_int)
+
+// Print a key-value pair.
+static void print_int_string_pair(int key, const char *value)
+{
+	printf("[%d, %s]\n", key, value);
+}
+
+int main(void)
+{
+	postal_table *t = postal_table_empty();
+
+	postal_table_insert(t, 90187, "Umea");
+	postal_table_insert(t, 90184, "Umea");
+	postal_table_insert(t, 98185, "Kiruna");
+
+	printf("Table after inserting 3 pairs:\n");
+	postal_table_print(t, print_int_string_pair);
+
+	const char **s = postal_table_lookup(t, 90187);
+	printf("Lookup of postal code %d: %s.\n", 90187, *s);
+
+	postal_table_insert(t, 90187, "Umea (Universitet)");
+
+	printf("Table after replacing a value:\n");
+	postal_table_print(t, print_int_string_pair);
+
+	s = postal_table_lookup(t, 90187);
+	printf("Lookup of postal code %d: %s.\n", 90187, *s);
+
+	postal_table_kill(t);
+	return 0;
+}
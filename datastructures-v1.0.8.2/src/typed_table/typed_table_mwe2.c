@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "typed_table.h"
+
+/*
+ * Minimum working example for typed_table.h with string keys. Counts
+ * how many times each word occurs in a sentence by storing the counts
+ * by value in the table. The keys point into the sentence, which
+ * outlives the table, so the table never needs to free them.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+// Hash a string with 32 bit FNV-1a.
+static unsigned long hash_string(const char *s)
+{
+	unsigned long h = 2166136261UL;
+
+	while (*s != '\0') {
+		h = ((h ^ (unsigned char)*s) * 16777619UL) & 0xffffffffUL;
+		s++;
+	}
+	return h;
+}
+
+// strcmp() is a function taking two strings, so it is used directly.
+DOA_DEFINE_TABLE(word_table, const char *, int, strcmp, hash_string)
+
+// Print a word and its count.
+static void print_word_count(const char *word, int count)
+{
+	printf("%-6s %d\n", word, count);
+}
+
+int main(void)
+{
+	char sentence[] = "the cat saw the dog and the dog saw the cat";
+	word_table *t = word_table_empty();
+
+	for (char *w = strtok(sentence, " "); w != NULL;
+	     w = strtok(NULL, " ")) {
+		int *count = word_table_lookup(t, w);
+		if (count == NULL) {
+			word_table_insert(t, w, 1);
+		} else {
+			(*count)++;
+		}
+	}
+	word_table_print(t, print_word_count);
+
+	// Remove all words, one at a time.
+	while (!word_table_is_empty(t)) {
+		word_table_remove(t, word_table_choose_key(t));
+	}
+	word_table_kill(t);
+	return 0;
+}
@@ -0,0 +1,946 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "table.h"
+#include "table_stats.h"
+#include "adaptivetable.h"
+
+/*
+ * Implementation of a generic table that changes its layout to suit
+ * how it is used.
+ *
+ * The pairs are always kept in one array. A new table uses a small
+ * array inside the table itself, searched linearly, which is the
+ * fastest layout for a few pairs. When it outgrows that array the
+ * pairs move to an allocated array and the table picks one of two
+ * layouts for it:
+ *
+ * - hashed: an open addressing index with linear probing maps the
+ *   mixed hash value of each key to the position of its pair, as in
+ *   hashtable.c. Removal moves the last pair into the gap.
+ * - move-to-front: the array is kept in recency order and searched
+ *   from the most recently used end, as in mtftable.c. A found pair is
+ *   moved to that end, so the work of the move equals the work of the
+ *   search.
+ *
+ * Tables with a hash function start out hashed. Every SAMPLE_PERIOD
+ * lookups one is sampled, and its cost under move-to-front is
+ * recorded. In the move-to-front layout that cost is the number of
+ * compares the lookup made. In the hashed layout it is estimated from
+ * a short move-to-front list of the hash values of recent samples.
+ * After SAMPLE_WINDOW samples the table switches to move-to-front if
+ * the average cost is below MTF_ENTER_COST, i.e. most lookups hit a
+ * handful of keys, and back to hashed if it is above MTF_LEAVE_COST.
+ * Neither switch moves any pairs. Tables without a hash function use
+ * move-to-front for all but the smallest sizes.
+ *
+ * A table that shrinks to SMALL_CAPACITY / 2 pairs moves back to the
+ * small array.
+ *
+ * The keys are always unique. Inserting a key that is already in the
+ * table replaces its key and value, as with TABLE_UNIQUE_KEYS.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added table_lookup_all() and table_count().
+ */
+
+// Number of pairs in the array inside the table.
+#define SMALL_CAPACITY 8
+
+// Number of index slots of a newly hashed table. Must be a power of
+// two.
+#define INITIAL_SLOTS 32
+
+// Hash value marking an unused index slot.
+#define EMPTY_HASH 0UL
+
+// One lookup in this many is sampled.
+#define SAMPLE_PERIOD 8
+
+// Number of samples the layout is chosen from.
+#define SAMPLE_WINDOW 64
+
+// Number of recent hash values remembered by the hashed layout to
+// estimate the cost under move-to-front.
+#define HOT_KEYS 8
+
+// Cost recorded for a sampled lookup that would have to search deep
+// into a move-to-front array, and the largest cost recorded.
+#define DEEP_COST 64
+
+// Average sampled cost below which a hashed table switches to
+// move-to-front, and above which it switches back.
+#define MTF_ENTER_COST 4
+#define MTF_LEAVE_COST 16
+
+// ===========INTERNAL DATA TYPES============
+
+struct table_pair {
+	void *key;
+	void *value;
+	// Mixed hash value of the key, or 0 without a hash function.
+	unsigned long hash;
+};
+
+struct index_slot {
+	unsigned long hash;
+	// Position of the pair in the pair array.
+	unsigned long pos;
+};
+
+struct table {
+	adaptive_layout layout;
+	// Pair array, either small or allocated, its number of pairs and
+	// the number of pairs it has room for.
+	struct table_pair *pairs;
+	unsigned long size;
+	unsigned long capacity;
+	// Hash index of the hashed layout, or NULL, and its number of
+	// slots, always a power of two.
+	struct index_slot *slots;
+	unsigned long n_slots;
+	// Lookups left until the next sample.
+	unsigned int countdown;
+	// Number of samples in the window and their total cost.
+	unsigned int samples;
+	unsigned long cost;
+	// Hash values of recently sampled keys, most recent first.
+	unsigned long recent[HOT_KEYS];
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	free_function key_free_func;
+	free_function value_free_func;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
+	struct table_pair small[SMALL_CAPACITY];
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * mix_hash() - Spread the bits of a user supplied hash value.
+ * @h: Hash value returned by the key hash function.
+ *
+ * Uses the finalizer of MurmurHash3. Never returns EMPTY_HASH.
+ *
+ * Returns: The mixed hash value.
+ */
+static unsigned long mix_hash(unsigned long h)
+{
+	unsigned long long x = h;
+
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+
+	if ((unsigned long)x == EMPTY_HASH) {
+		return 1;
+	}
+	return (unsigned long)x;
+}
+
+/**
+ * key_hash() - Compute the mixed hash value of a key.
+ * @t: Table the key belongs to.
+ * @key: Key to hash.
+ *
+ * Returns: The mixed hash value of the key, or 0 if the table has no
+ * hash function.
+ */
+static unsigned long key_hash(const table *t, const void *key)
+{
+	if (t->key_hash_func == NULL) {
+		return 0;
+	}
+	return mix_hash(t->key_hash_func(key));
+}
+
+/**
+ * reset_samples() - Start a new sample window.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+static void reset_samples(table *t)
+{
+	t->countdown = SAMPLE_PERIOD;
+	t->samples = 0;
+	t->cost = 0;
+}
+
+/**
+ * index_insert() - Add the position of a pair to the hash index.
+ * @t: Table to manipulate.
+ * @hash: Mixed hash value of the key, not already in the index.
+ * @pos: Position of the pair.
+ *
+ * Returns: Nothing.
+ */
+static void index_insert(table *t, unsigned long hash, unsigned long pos)
+{
+	unsigned long mask = t->n_slots - 1;
+	unsigned long i = hash & mask;
+
+	while (t->slots[i].hash != EMPTY_HASH) {
+		i = (i + 1) & mask;
+	}
+	t->slots[i].hash = hash;
+	t->slots[i].pos = pos;
+}
+
+/**
+ * build_index() - Create a hash index of all pairs.
+ * @t: Table to manipulate.
+ * @n_slots: Number of slots, a power of two larger than twice the
+ *	     number of pairs.
+ *
+ * Any old index is freed.
+ *
+ * Returns: Nothing.
+ */
+static void build_index(table *t, unsigned long n_slots)
+{
+	free(t->slots);
+	t->n_slots = n_slots;
+	t->slots = calloc(n_slots, sizeof(*t->slots));
+	for (unsigned long p = 0; p < t->size; p++) {
+		index_insert(t, t->pairs[p].hash, p);
+	}
+}
+
+/**
+ * find_slot() - Find the index slot of a key.
+ * @t: Hashed table to inspect.
+ * @key: Key to look for.
+ * @hash: Mixed hash value of key.
+ * @probes: Set to the number of slots examined.
+ *
+ * Returns: The index of the slot of key, or the index of the empty
+ * slot that ends the probe sequence if key is not in the table.
+ */
+static unsigned long find_slot(const table *t, const void *key,
+			       unsigned long hash, unsigned long *probes)
+{
+	unsigned long mask = t->n_slots - 1;
+	unsigned long i = hash & mask;
+
+	*probes = 1;
+	while (t->slots[i].hash != EMPTY_HASH) {
+		if (t->slots[i].hash == hash
+		    && TABLE_KEY_CMP(t, t->pairs[t->slots[i].pos].key,
+				     key) == 0) {
+			return i;
+		}
+		i = (i + 1) & mask;
+		(*probes)++;
+	}
+	return i;
+}
+
+/**
+ * find_pos_slot() - Find the index slot pointing at a position.
+ * @t: Hashed table to inspect.
+ * @pos: Position of a pair in the table.
+ *
+ * Returns: The index of the slot.
+ */
+static unsigned long find_pos_slot(const table *t, unsigned long pos)
+{
+	unsigned long mask = t->n_slots - 1;
+	unsigned long i = t->pairs[pos].hash & mask;
+
+	while (t->slots[i].pos != pos || t->slots[i].hash == EMPTY_HASH) {
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/**
+ * delete_slot() - Empty an index slot and close the gap in its cluster.
+ * @t: Table to manipulate.
+ * @i: Index of the slot to empty.
+ *
+ * Moves later slots of the same cluster back into the gap if that
+ * does not place them before their home slot.
+ *
+ * Returns: Nothing.
+ */
+static void delete_slot(table *t, unsigned long i)
+{
+	unsigned long mask = t->n_slots - 1;
+	unsigned long j = i;
+
+	for (;;) {
+		j = (j + 1) & mask;
+		if (t->slots[j].hash == EMPTY_HASH) {
+			break;
+		}
+		unsigned long home = t->slots[j].hash & mask;
+		// Move slot j into the gap unless its home lies cyclically
+		// in (i, j], in which case moving it would hide it.
+		bool stays = (i <= j) ? (i < home && home <= j)
+			: (i < home || home <= j);
+		if (!stays) {
+			t->slots[i] = t->slots[j];
+			i = j;
+		}
+	}
+	t->slots[i].hash = EMPTY_HASH;
+}
+
+/**
+ * set_layout() - Change the layout of a table.
+ * @t: Table to manipulate.
+ * @layout: New layout.
+ *
+ * Moves the pairs between the small and the allocated array when
+ * needed, and builds or frees the hash index. The positions of the
+ * pairs do not change.
+ *
+ * Returns: Nothing.
+ */
+static void set_layout(table *t, adaptive_layout layout)
+{
+	if (layout == ADAPTIVE_SMALL && t->pairs != t->small) {
+		memcpy(t->small, t->pairs, t->size * sizeof(*t->pairs));
+		free(t->pairs);
+		t->pairs = t->small;
+		t->capacity = SMALL_CAPACITY;
+	} else if (layout != ADAPTIVE_SMALL && t->pairs == t->small) {
+		t->capacity = 2 * SMALL_CAPACITY;
+		t->pairs = malloc(t->capacity * sizeof(*t->pairs));
+		memcpy(t->pairs, t->small, t->size * sizeof(*t->pairs));
+	}
+	if (layout == ADAPTIVE_HASHED) {
+		unsigned long n_slots = INITIAL_SLOTS;
+		while (n_slots <= 2 * t->size) {
+			n_slots *= 2;
+		}
+		build_index(t, n_slots);
+	} else {
+		free(t->slots);
+		t->slots = NULL;
+		t->n_slots = 0;
+	}
+	t->layout = layout;
+	memset(t->recent, 0, sizeof(t->recent));
+	reset_samples(t);
+}
+
+/**
+ * end_window() - Pick a layout from a full sample window.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+static void end_window(table *t)
+{
+	unsigned long average = t->cost / t->samples;
+
+	if (t->layout == ADAPTIVE_HASHED && average < MTF_ENTER_COST) {
+		set_layout(t, ADAPTIVE_MTF);
+	} else if (t->layout == ADAPTIVE_MTF && average > MTF_LEAVE_COST
+		   && t->key_hash_func != NULL) {
+		set_layout(t, ADAPTIVE_HASHED);
+	} else {
+		reset_samples(t);
+	}
+}
+
+/**
+ * add_sample() - Record the move-to-front cost of a sampled lookup.
+ * @t: Table to manipulate.
+ * @cost: Number of compares the lookup made or would have made.
+ *
+ * Returns: Nothing.
+ */
+static void add_sample(table *t, unsigned long cost)
+{
+	t->cost += cost < DEEP_COST ? cost : DEEP_COST;
+	t->samples++;
+	if (t->samples == SAMPLE_WINDOW) {
+		end_window(t);
+	}
+}
+
+/**
+ * sample_hashed() - Estimate the move-to-front cost of a lookup.
+ * @t: Hashed table to manipulate.
+ * @hash: Mixed hash value of the key that was found, or EMPTY_HASH
+ *	  for a lookup of a missing key.
+ *
+ * A key among the HOT_KEYS most recently sampled ones would be found
+ * after as many compares as its place in that list. Other keys, and
+ * missing keys, are given DEEP_COST.
+ *
+ * Returns: Nothing.
+ */
+static void sample_hashed(table *t, unsigned long hash)
+{
+	int i = 0;
+
+	while (i < HOT_KEYS - 1 && t->recent[i] != hash) {
+		i++;
+	}
+	unsigned long cost = (hash != EMPTY_HASH && t->recent[i] == hash)
+		? i + 1 : DEEP_COST;
+	if (hash != EMPTY_HASH) {
+		memmove(&t->recent[1], &t->recent[0], i * sizeof(*t->recent));
+		t->recent[0] = hash;
+	}
+	add_sample(t, cost);
+}
+
+/**
+ * find_pair() - Find the pair of a key.
+ * @t: Table to inspect.
+ * @key: Key to look for.
+ * @hash: Mixed hash value of key.
+ * @probes: Set to the number of compares, or of index slots examined
+ *	    by a hashed table.
+ *
+ * Returns: The position of the pair of key, or -1 if key is not in
+ * the table.
+ */
+static long find_pair(const table *t, const void *key, unsigned long hash,
+		      unsigned long *probes)
+{
+	if (t->layout == ADAPTIVE_HASHED) {
+		unsigned long i = find_slot(t, key, hash, probes);
+		if (t->slots[i].hash == EMPTY_HASH) {
+			return -1;
+		}
+		return t->slots[i].pos;
+	}
+	// Search the move-to-front array from its most recent end. The
+	// small array has no order, so the direction does not matter.
+	*probes = 0;
+	for (long p = (long)t->size - 1; p >= 0; p--) {
+		(*probes)++;
+		if (TABLE_KEY_CMP(t, t->pairs[p].key, key) == 0) {
+			return p;
+		}
+	}
+	return -1;
+}
+
+/**
+ * move_to_back() - Move a pair to the most recent end of the array.
+ * @t: Move-to-front table to manipulate.
+ * @p: Position of the pair.
+ *
+ * Returns: Nothing.
+ */
+static void move_to_back(table *t, unsigned long p)
+{
+	struct table_pair pair = t->pairs[p];
+
+	memmove(&t->pairs[p], &t->pairs[p + 1],
+		(t->size - p - 1) * sizeof(*t->pairs));
+	t->pairs[t->size - 1] = pair;
+}
+
+/**
+ * remove_pair() - Remove the pair at a position.
+ * @t: Table to manipulate.
+ * @p: Position of the pair.
+ * @slot: Index slot of the pair in a hashed table.
+ *
+ * Calls any free functions set for keys/values on the pair. The gap is
+ * closed by moving the following pairs in a move-to-front table, to
+ * keep their order, and by moving the last pair otherwise.
+ *
+ * Returns: Nothing.
+ */
+static void remove_pair(table *t, unsigned long p, unsigned long slot)
+{
+	if (t->key_free_func != NULL) {
+		t->key_free_func(t->pairs[p].key);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(t->pairs[p].value);
+	}
+	unsigned long last = t->size - 1;
+	if (t->layout == ADAPTIVE_MTF) {
+		memmove(&t->pairs[p], &t->pairs[p + 1],
+			(last - p) * sizeof(*t->pairs));
+	} else if (t->layout == ADAPTIVE_HASHED) {
+		delete_slot(t, slot);
+		if (p != last) {
+			t->slots[find_pos_slot(t, last)].pos = p;
+			t->pairs[p] = t->pairs[last];
+		}
+	} else {
+		t->pairs[p] = t->pairs[last];
+	}
+	t->size--;
+	if (t->layout != ADAPTIVE_SMALL && t->size <= SMALL_CAPACITY / 2) {
+		set_layout(t, ADAPTIVE_SMALL);
+	}
+}
+
+/**
+ * empty_pairs() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * The table moves back to the small array.
+ *
+ * Returns: Nothing.
+ */
+static void empty_pairs(table *t, consume_callback_pair func)
+{
+	for (unsigned long p = 0; p < t->size; p++) {
+		if (func != NULL) {
+			func(t->pairs[p].key, t->pairs[p].value);
+			continue;
+		}
+		if (t->key_free_func != NULL) {
+			t->key_free_func(t->pairs[p].key);
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(t->pairs[p].value);
+		}
+	}
+	t->size = 0;
+	set_layout(t, ADAPTIVE_SMALL);
+}
+
+/**
+ * visit_key() - Visit the pair with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function to call for the pair, or NULL.
+ *
+ * Unlike table_lookup(), the pairs are not reordered and the lookup
+ * is not sampled, so the layout stays the same.
+ *
+ * Returns: The number of pairs with the key, 0 or 1.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	unsigned long hash = t->layout == ADAPTIVE_HASHED
+		? key_hash(t, key) : 0;
+	unsigned long probes;
+	long p = find_pair(t, key, hash, &probes);
+
+	TABLE_STATS_LOOKUP(t, probes, p >= 0);
+	if (p < 0) {
+		return 0;
+	}
+	if (func != NULL) {
+		func(t->pairs[p].key, t->pairs[p].value);
+	}
+	return 1;
+}
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash
+ *		   keys. Without it the table never uses the hashed
+ *		   layout.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	// Allocate the table header, with room for the small array.
+	table *t = calloc(1, sizeof(*t));
+	t->layout = ADAPTIVE_SMALL;
+	t->pairs = t->small;
+	t->capacity = SMALL_CAPACITY;
+	reset_samples(t);
+	// Store the key compare/hash functions and key/value free functions.
+	t->key_cmp_func = key_cmp_func;
+	t->key_hash_func = key_hash_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	TABLE_STATS_INIT(t);
+
+	return t;
+}
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * The table has no hash function, so it uses the move-to-front layout
+ * once it outgrows the small array.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return table_empty_hashed(key_cmp_func, NULL, key_free_func,
+				  value_free_func);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash
+ *		   keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: Ignored, keys are always unique since insert replaces the
+ *	   pair of a key already in the table.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	return table_empty_hashed(key_cmp_func, key_hash_func, key_free_func,
+				  value_free_func);
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If key already exists in
+ * the table the existing key and value are replaced by the new ones.
+ * A new pair that does not fit in the small array moves the table to
+ * the hashed layout, or to move-to-front without a hash function.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	unsigned long hash = key_hash(t, key);
+	unsigned long probes;
+	long p = find_pair(t, key, hash, &probes);
+
+	TABLE_STATS_INSERT(t, probes);
+	if (p >= 0) {
+		// Free the previous key and value (if it is our business)
+		// unless they are the same memory as the new ones.
+		struct table_pair *pair = &t->pairs[p];
+		if (pair->key != key && t->key_free_func != NULL) {
+			t->key_free_func(pair->key);
+		}
+		if (pair->value != value && t->value_free_func != NULL) {
+			t->value_free_func(pair->value);
+		}
+		pair->key = key;
+		pair->value = value;
+		return;
+	}
+	if (t->size == t->capacity) {
+		if (t->layout == ADAPTIVE_SMALL) {
+			set_layout(t, t->key_hash_func != NULL
+				   ? ADAPTIVE_HASHED : ADAPTIVE_MTF);
+		} else {
+			t->capacity *= 2;
+			t->pairs = realloc(t->pairs,
+					   t->capacity * sizeof(*t->pairs));
+		}
+	}
+	if (t->layout == ADAPTIVE_HASHED) {
+		if (2 * (t->size + 1) > t->n_slots) {
+			build_index(t, 2 * t->n_slots);
+		}
+		index_insert(t, hash, t->size);
+	}
+	t->pairs[t->size].key = key;
+	t->pairs[t->size].value = value;
+	t->pairs[t->size].hash = hash;
+	t->size++;
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * A move-to-front table moves the found pair to its most recent end.
+ * Sampled lookups may change the layout of the table.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	// Reordering and sampling do not change the contents of the table.
+	table *mt = (table *)t;
+	unsigned long hash = t->layout == ADAPTIVE_HASHED
+		? key_hash(t, key) : 0;
+	unsigned long probes;
+	long p = find_pair(t, key, hash, &probes);
+
+	TABLE_STATS_LOOKUP(t, probes, p >= 0);
+	if (t->layout == ADAPTIVE_SMALL) {
+		return p < 0 ? NULL : t->pairs[p].value;
+	}
+	void *value = p < 0 ? NULL : t->pairs[p].value;
+	if (t->layout == ADAPTIVE_MTF && p >= 0) {
+		move_to_back(mt, p);
+	}
+	if (--mt->countdown == 0) {
+		mt->countdown = SAMPLE_PERIOD;
+		if (t->layout == ADAPTIVE_HASHED) {
+			sample_hashed(mt, p < 0 ? EMPTY_HASH : hash);
+		} else {
+			add_sample(mt, probes);
+		}
+	}
+	return value;
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The keys of the table are unique, so func is called at most once.
+ * Unlike table_lookup(), the pairs are not reordered. func must not
+ * change the table.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	// The last pair is the cheapest one to remove in every layout.
+	return t->pairs[t->size - 1].key;
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free functions set for keys/values. Does nothing if
+ * key is not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	unsigned long hash = t->layout == ADAPTIVE_HASHED
+		? key_hash(t, key) : 0;
+	unsigned long probes;
+	unsigned long slot = 0;
+	long p;
+
+	if (t->layout == ADAPTIVE_HASHED) {
+		slot = find_slot(t, key, hash, &probes);
+		p = t->slots[slot].hash == EMPTY_HASH ? -1
+			: (long)t->slots[slot].pos;
+	} else {
+		p = find_pair(t, key, hash, &probes);
+	}
+	TABLE_STATS_REMOVE(t, probes);
+	if (p >= 0) {
+		remove_pair(t, p, slot);
+	}
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	empty_pairs(t, NULL);
+	TABLE_STATS_FREE(t);
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_pairs(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table.
+ *	  Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_pairs(t, func);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table and prints them.
+ * Will print all stored elements.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	for (unsigned long p = 0; p < t->size; p++) {
+		print_func(t->pairs[p].key, t->pairs[p].value);
+	}
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of an operation is the number of index slots it
+ * examined in the hashed layout, and the number of pairs it compared
+ * otherwise.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
+
+/**
+ * table_layout() - Get the current layout of a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The layout of the pairs.
+ */
+adaptive_layout table_layout(const table *t)
+{
+	return t->layout;
+}
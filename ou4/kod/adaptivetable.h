@@ -0,0 +1,41 @@
+#ifndef ADAPTIVETABLE_H
+#define ADAPTIVETABLE_H
+
+#include "table.h"
+
+/*
+ * Extra operations for the adaptive implementation of table.h in
+ * adaptivetable.c.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+
+// Layout of the pairs of a table.
+typedef enum adaptive_layout {
+	// Unordered array inside the table, searched linearly.
+	ADAPTIVE_SMALL,
+	// Array indexed by an open addressing hash index.
+	ADAPTIVE_HASHED,
+	// Array kept in move-to-front order, searched linearly.
+	ADAPTIVE_MTF
+} adaptive_layout;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_layout() - Get the current layout of a table.
+ * @t: Table to inspect.
+ *
+ * The layout changes with the size of the table and with how skewed
+ * its lookups are.
+ *
+ * Returns: The layout of the pairs.
+ */
+adaptive_layout table_layout(const table *t);
+
+#endif
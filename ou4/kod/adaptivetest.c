@@ -0,0 +1,333 @@
+/*
+ * adaptivetest - test the layout changes of the adaptive table.
+ *
+ * Should be compiled together with adaptivetable.c.
+ *
+ * Usage: adaptivetest [n]
+ *
+ * Tests that a table moves between its layouts as documented in
+ * adaptivetable.c, and that no pair is lost or changed by a move. A
+ * table with a hash function starts small, and becomes hashed when it
+ * is filled with n keys. Lookups of a few hot keys then switch it to
+ * move-to-front, and lookups spread over all keys switch it back to
+ * hashed. Removing most keys moves it back to the small array. A table
+ * without a hash function must use move-to-front instead of hashed,
+ * and stay there under spread lookups. After every change of layout
+ * every key is checked to have its value, using table_lookup_all() and
+ * table_count(), which do not affect the layout. Every key and value
+ * must have been freed exactly once when the tables are killed.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "table.h"
+#include "adaptivetable.h"
+
+// Default number of keys
+#define DEFAULT_SIZE 5000
+// Fewest keys whose uniform lookups cost enough under move-to-front
+// to switch back to hashed
+#define MIN_SIZE 100
+// Number of keys that outgrow the small array of the table
+#define SMALL_SIZE 9
+// Number of keys left to move the table back to the small array
+#define SHRUNK_SIZE 4
+// Number of hot keys looked up to switch to move-to-front
+#define HOT_SIZE 3
+// Most lookups a switch of layout may take, several sample windows
+#define MAX_LOOKUPS 10000
+
+// Number of keys and values allocated and freed by the tests
+unsigned long n_allocated;
+unsigned long n_freed;
+
+// Value visited by table_lookup_all(), and the number of visits
+int visited_value;
+int n_visited;
+
+// Names of the layouts, in the order of adaptive_layout
+const char *layout_names[] = { "small", "hashed", "move-to-front" };
+
+/**
+ * int_ptr_from_int() - Create a dynamic copy of an int.
+ * @i: Value to copy.
+ *
+ * Returns: Pointer to the copy of i.
+ */
+int *int_ptr_from_int(int i)
+{
+        int *ip = malloc(sizeof(int));
+        *ip = i;
+        n_allocated++;
+        return ip;
+}
+
+/**
+ * counting_free() - Free a key or value and count it.
+ * @p: Pointer from int_ptr_from_int().
+ *
+ * Returns: Nothing.
+ */
+void counting_free(void *p)
+{
+        free(p);
+        n_freed++;
+}
+
+int int_compare(const void *ip1,const void *ip2)
+{
+        const int *n1=ip1;
+        const int *n2=ip2;
+        return (*n1 > *n2) - (*n1 < *n2);
+}
+
+unsigned long int_hash(const void *ip)
+{
+        return *(const int *)ip;
+}
+
+/**
+ * visit_pair() - Record a value visited by table_lookup_all().
+ * @key: Key of the pair.
+ * @value: Value of the pair.
+ *
+ * Returns: Nothing.
+ */
+void visit_pair(const void *key, const void *value)
+{
+        visited_value = *(const int *)value;
+        n_visited++;
+}
+
+/**
+ * fail() - Print an error message and exit.
+ * @name: Name of the test that failed.
+ * @what: What went wrong.
+ * @key: Key that went wrong.
+ *
+ * Returns: Never.
+ */
+void fail(const char *name, const char *what, int key)
+{
+        fprintf(stderr, "FAIL: %s: %s %d.\n", name, what, key);
+        exit(EXIT_FAILURE);
+}
+
+/**
+ * check_table() - Check the layout of a table and the value of every
+ * key.
+ * @t: Table to check.
+ * @layout: Expected layout.
+ * @n: The keys 0..n-1 must be in the table with the value 2*key, and
+ *     the keys n..2n must not.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void check_table(const table *t, adaptive_layout layout, int n,
+                 const char *name)
+{
+        if (table_layout(t) != layout) {
+                fprintf(stderr, "FAIL: %s: layout is %s, expected %s.\n",
+                        name, layout_names[table_layout(t)],
+                        layout_names[layout]);
+                exit(EXIT_FAILURE);
+        }
+        for (int key = 0; key <= 2*n; key++) {
+                bool stored = key < n;
+                n_visited = 0;
+                table_lookup_all(t, &key, visit_pair);
+                if (n_visited != (stored ? 1 : 0)) {
+                        fail(name, stored ? "lost key" : "found missing key",
+                             key);
+                }
+                if (stored && visited_value != 2*key) {
+                        fail(name, "wrong value of key", key);
+                }
+                if (table_count(t, &key) != (stored ? 1UL : 0UL)) {
+                        fail(name, "wrong count of key", key);
+                }
+        }
+        if (table_layout(t) != layout) {
+                fail(name, "checking the keys changed the layout, n =", n);
+        }
+        printf("%s: OK.\n", name);
+}
+
+/**
+ * lookup_until() - Look up keys until a table changes its layout.
+ * @t: Table to look up in.
+ * @layout: Layout to wait for.
+ * @n_keys: The keys 0..n_keys-1 are looked up in turn.
+ * @name: Name of the test.
+ *
+ * Every lookup must find its key with the value 2*key. Fails if the
+ * layout has not changed after MAX_LOOKUPS lookups.
+ *
+ * Returns: Nothing.
+ */
+void lookup_until(const table *t, adaptive_layout layout, int n_keys,
+                  const char *name)
+{
+        for (int i = 0; i < MAX_LOOKUPS; i++) {
+                int key = i % n_keys;
+                const int *v = table_lookup(t, &key);
+                if (v == NULL || *v != 2*key) {
+                        fail(name, "lookup lost key", key);
+                }
+                if (table_layout(t) == layout) {
+                        return;
+                }
+        }
+        fprintf(stderr, "FAIL: %s: still %s after %d lookups.\n", name,
+                layout_names[table_layout(t)], MAX_LOOKUPS);
+        exit(EXIT_FAILURE);
+}
+
+/**
+ * insert_keys() - Insert the keys from..to-1 with the value 2*key.
+ * @t: Table to insert into.
+ * @from: First key.
+ * @to: Key after the last one.
+ *
+ * Returns: Nothing.
+ */
+void insert_keys(table *t, int from, int to)
+{
+        for (int key = from; key < to; key++) {
+                table_insert(t, int_ptr_from_int(key),
+                             int_ptr_from_int(2*key));
+        }
+}
+
+/**
+ * remove_keys() - Remove the keys from..to-1, last first.
+ * @t: Table to remove from.
+ * @from: First key.
+ * @to: Key after the last one.
+ *
+ * Returns: Nothing.
+ */
+void remove_keys(table *t, int from, int to)
+{
+        for (int key = to - 1; key >= from; key--) {
+                table_remove(t, &key);
+        }
+}
+
+/**
+ * check_kill() - Kill a table and check that all keys and values have
+ * been freed.
+ * @t: Table to kill.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void check_kill(table *t, const char *name)
+{
+        table_kill(t);
+        if (n_freed != n_allocated) {
+                fail(name, "keys and values not freed:",
+                     (int)(n_allocated - n_freed));
+        }
+        printf("%s: OK.\n", name);
+}
+
+/**
+ * test_hashed() - Move a table with a hash function through all its
+ * layouts.
+ * @n: Number of keys, at least MIN_SIZE.
+ *
+ * Returns: Nothing.
+ */
+void test_hashed(int n)
+{
+        table *t = table_empty_hashed(int_compare, int_hash, counting_free,
+                                      counting_free);
+
+        insert_keys(t, 0, SMALL_SIZE - 1);
+        check_table(t, ADAPTIVE_SMALL, SMALL_SIZE - 1, "Hashed, small");
+        insert_keys(t, SMALL_SIZE - 1, n);
+        check_table(t, ADAPTIVE_HASHED, n, "Hashed, filled");
+
+        lookup_until(t, ADAPTIVE_MTF, HOT_SIZE, "Hashed, skewed lookups");
+        check_table(t, ADAPTIVE_MTF, n, "Hashed, skewed lookups");
+
+        // Replace a pair while the table is move-to-front
+        int key = n/2;
+        table_insert(t, int_ptr_from_int(key), int_ptr_from_int(2*key));
+        lookup_until(t, ADAPTIVE_HASHED, n, "Hashed, uniform lookups");
+        check_table(t, ADAPTIVE_HASHED, n, "Hashed, uniform lookups");
+
+        // Skew again, so that the table is move-to-front when it shrinks
+        lookup_until(t, ADAPTIVE_MTF, HOT_SIZE, "Hashed, skewed again");
+        remove_keys(t, SHRUNK_SIZE + 1, n);
+        check_table(t, ADAPTIVE_MTF, SHRUNK_SIZE + 1,
+                    "Hashed, shrunk in move-to-front");
+        remove_keys(t, SHRUNK_SIZE, SHRUNK_SIZE + 1);
+        check_table(t, ADAPTIVE_SMALL, SHRUNK_SIZE,
+                    "Hashed, small from move-to-front");
+
+        insert_keys(t, SHRUNK_SIZE, n);
+        check_table(t, ADAPTIVE_HASHED, n, "Hashed, filled again");
+        remove_keys(t, SHRUNK_SIZE, n);
+        check_table(t, ADAPTIVE_SMALL, SHRUNK_SIZE,
+                    "Hashed, small from hashed");
+        check_kill(t, "Hashed, killed");
+}
+
+/**
+ * test_unhashed() - Move a table without a hash function through its
+ * layouts.
+ * @n: Number of keys, at least MIN_SIZE.
+ *
+ * Returns: Nothing.
+ */
+void test_unhashed(int n)
+{
+        table *t = table_empty(int_compare, counting_free, counting_free);
+
+        insert_keys(t, 0, SMALL_SIZE - 1);
+        check_table(t, ADAPTIVE_SMALL, SMALL_SIZE - 1, "Unhashed, small");
+        insert_keys(t, SMALL_SIZE - 1, n);
+        check_table(t, ADAPTIVE_MTF, n, "Unhashed, filled");
+
+        // Uniform lookups cannot switch to hashed without a hash
+        // function, so only check that they keep every key
+        for (int i = 0; i < MAX_LOOKUPS/10; i++) {
+                int key = i % n;
+                const int *v = table_lookup(t, &key);
+                if (v == NULL || *v != 2*key) {
+                        fail("Unhashed, uniform lookups", "lookup lost key",
+                             key);
+                }
+        }
+        check_table(t, ADAPTIVE_MTF, n, "Unhashed, uniform lookups");
+
+        remove_keys(t, SHRUNK_SIZE, n);
+        check_table(t, ADAPTIVE_SMALL, SHRUNK_SIZE, "Unhashed, shrunk");
+        check_kill(t, "Unhashed, killed");
+}
+
+int main(int argc, char **argv)
+{
+        int n = DEFAULT_SIZE;
+        if (argc > 1) {
+                n = atoi(argv[1]);
+        }
+        if (n < MIN_SIZE || n > 100000000) {
+                fprintf(stderr, "Usage: %s [n], n >= %d\n", argv[0],
+                        MIN_SIZE);
+                exit(EXIT_FAILURE);
+        }
+
+        test_hashed(n);
+        test_unhashed(n);
+        return 0;
+}
@@ -1,12 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "table.h"
-#include "array_1d.h"
+#include "table_stats.h"
 
 /*
  * Implementation of a generic table using one dimensional
  * arrays for.
  *
+ * Keys and values are stored directly in two parallel arrays, so a
+ * lookup scans contiguous memory. The arrays double in size when
+ * full.
+ *
  * Duplicates are handled by insert.
  *
  * Author: c19rll@cs.umu.se
@@ -14,30 +18,104 @@
  *
  * Version information:
  *   2020-02-24: v1.0, first version.
+ *   2026-10-17: v1.1, added batched insert/lookup/remove.
+ *   2026-10-17: v1.2, keys and values stored in growable arrays.
+ *   2026-10-17: v1.3, added table_stats().
+ *   2026-10-17: v1.4, added table_empty_ex().
+ *   2026-10-17: v1.5, added table_clear() and table_drain().
+ *   2026-10-17: v1.6, added table_lookup_all() and table_count().
  */
 
 
-#define MAX_ENTRIES 80000
+// Number of pairs a newly created table has room for.
+#define INITIAL_CAPACITY 16
 
 // ===========INTERNAL DATA TYPES============
 
-struct table_entry{
-	void *key;
-	void *value;
-};
-
 struct table{
 	int firstEmptyElement;
-	array_1d *entries;
+	int capacity;
+	void **keys;
+	void **values;
 	compare_function *key_cmp_func;
 	free_function key_free_func;
 	free_function value_free_func;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
 };
 
 
 
 // ===========INTERNAL FUNCTION IMPLEMENTATIONS============
 
+/**
+ * grow() - Double the capacity of the key and value arrays.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+static void grow(table *t)
+{
+	t->capacity *= 2;
+	t->keys = realloc(t->keys, t->capacity * sizeof(*t->keys));
+	t->values = realloc(t->values, t->capacity * sizeof(*t->values));
+}
+
+/**
+ * empty_arrays() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * The arrays are shrunk back to INITIAL_CAPACITY.
+ *
+ * Returns: Nothing.
+ */
+static void empty_arrays(table *t, consume_callback_pair func)
+{
+	for (int i = 0; i < t->firstEmptyElement; i++) {
+		if (func != NULL) {
+			func(t->keys[i], t->values[i]);
+			continue;
+		}
+		if (t->key_free_func != NULL) {
+			t->key_free_func(t->keys[i]);
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(t->values[i]);
+		}
+	}
+	t->firstEmptyElement = 0;
+	t->capacity = INITIAL_CAPACITY;
+	t->keys = realloc(t->keys, t->capacity * sizeof(*t->keys));
+	t->values = realloc(t->values, t->capacity * sizeof(*t->values));
+}
+
+/**
+ * visit_key() - Visit the pair with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function to call for the pair, or NULL.
+ *
+ * Returns: The number of pairs with the key, 0 or 1.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	for (int i = 0; i < t->firstEmptyElement; ++i) {
+		if (TABLE_KEY_CMP(t, t->keys[i], key) == 0) {
+			TABLE_STATS_LOOKUP(t, i + 1, true);
+			if (func != NULL) {
+				func(t->keys[i], t->values[i]);
+			}
+			return 1;
+		}
+	}
+	TABLE_STATS_LOOKUP(t, t->firstEmptyElement, false);
+	return 0;
+}
+
 /**
  * table_empty() - Create an empty table.
  * @key_cmp_func: A pointer to a function to be used to compare keys.
@@ -52,15 +130,59 @@ table *table_empty(compare_function *key_cmp_func, free_function key_free_func,
 {
 	table *t = calloc(1, sizeof(table));
 
-	t->entries = array_1d_create(0, MAX_ENTRIES - 1, NULL);
-	t->firstEmptyElement = array_1d_low(t->entries);
+	t->capacity = INITIAL_CAPACITY;
+	t->keys = malloc(t->capacity * sizeof(*t->keys));
+	t->values = malloc(t->capacity * sizeof(*t->values));
+	t->firstEmptyElement = 0;
 	t->key_cmp_func = key_cmp_func;
 	t->key_free_func = key_free_func;
 	t->value_free_func = value_free_func;
+	TABLE_STATS_INIT(t);
 
 	return t;
 }
 
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the array is searched linearly.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the array is searched linearly.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: Ignored, keys are always unique since insert replaces the
+ *	   pair of a key already in the table.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
 
 /**
  * table_is_empty() - Check if a table is empty.
@@ -71,7 +193,7 @@ table *table_empty(compare_function *key_cmp_func, free_function key_free_func,
 bool table_is_empty(const table *t)
 {
 	//Check if the first empty element is at the lowest position
-	if(t->firstEmptyElement == array_1d_low(t->entries)){
+	if(t->firstEmptyElement == 0){
 		return true;
 	} else{
 		return false;
@@ -94,42 +216,39 @@ void table_insert(table *t, void *key, void *value)
 {
 	bool keyFound = false;
 	int i  = 0;
-
+	unsigned long mark = TABLE_STATS_COMPARES(t);
 
 	while(!keyFound && i < t->firstEmptyElement){
-		//Update currEntry to entry at current index in while-loop
-		struct table_entry *currEntry = array_1d_inspect_value(t->entries, i);
-
-		if(!(t->key_cmp_func(currEntry->key, key))){ //If keys are equal
+		if(!(TABLE_KEY_CMP(t, t->keys[i], key))){ //If keys are equal
 			keyFound = true;
 			//Free previous key (if it is our business) and update pointer if input key is not the same allocated
-			if(currEntry->key != key){
+			if(t->keys[i] != key){
 				if(t->key_free_func != NULL){
-					t->key_free_func(currEntry->key);
+					t->key_free_func(t->keys[i]);
 				}
-				currEntry->key = key;
+				t->keys[i] = key;
 			}
 			//Free previous value (if it is our business) and update pointer if input calue is not the same allocated memory
 			//as previuos entry
-			if(currEntry->value != value){
+			if(t->values[i] != value){
 				if(t->value_free_func != NULL){
-					t->value_free_func(currEntry->value);
+					t->value_free_func(t->values[i]);
 				}
-				currEntry->value = value;
+				t->values[i] = value;
 			}
 		}
 		++i;
 	}
-	//Allocate new entry and insert input key and value into table if no duplicate was found.
-	if(keyFound != true && t->firstEmptyElement < MAX_ENTRIES){
-		struct table_entry *entry = malloc(sizeof(struct table_entry));
-		entry->key = key;
-		entry->value = value;
-
-		array_1d_set_value(t->entries, entry, t->firstEmptyElement);
+	//Append input key and value to the arrays if no duplicate was found.
+	if(keyFound != true){
+		if(t->firstEmptyElement == t->capacity){
+			grow(t);
+		}
+		t->keys[t->firstEmptyElement] = key;
+		t->values[t->firstEmptyElement] = value;
 		t->firstEmptyElement++;
 	}
-
+	TABLE_STATS_INSERT(t, TABLE_STATS_COMPARES(t) - mark);
 }
 
 /**
@@ -142,17 +261,46 @@ void table_insert(table *t, void *key, void *value)
  */
 void *table_lookup(const table *t, const void *key)
 {
-	for (int i = array_1d_low(t->entries); i < t->firstEmptyElement; ++i) {
-		struct table_entry *currEntry = array_1d_inspect_value(t->entries, i);
-
-		if(!(t->key_cmp_func(currEntry->key, key))){
-			return currEntry->value;
+	for (int i = 0; i < t->firstEmptyElement; ++i) {
+		if(!(TABLE_KEY_CMP(t, t->keys[i], key))){
+			TABLE_STATS_LOOKUP(t, i + 1, true);
+			return t->values[i];
 		}
 	}
 	//Return NULL if no key was found
+	TABLE_STATS_LOOKUP(t, t->firstEmptyElement, false);
 	return NULL;
 }
 
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The keys of the table are unique, so func is called at most once.
+ * func must not change the table.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
 /**
  * table_choose_key() - Return an arbitrary key.
  * @t: Table to inspect.
@@ -165,9 +313,8 @@ void *table_lookup(const table *t, const void *key)
  */
 void *table_choose_key(const table *t)
 {
-	//Return internally last table_entry.
-	struct table_entry *lastEntry = array_1d_inspect_value(t->entries, t->firstEmptyElement - 1);
-	return lastEntry->key;
+	//Return internally last key.
+	return t->keys[t->firstEmptyElement - 1];
 }
 
 /**
@@ -184,29 +331,29 @@ void table_remove(table *t, const void *key)
 {
 	int i = t->firstEmptyElement-1;
 	bool keyFound = false;
+	unsigned long mark = TABLE_STATS_COMPARES(t);
 
 	//Loop backwards from end of table to integrate better with table_choose_key()
 	while(!keyFound && i >= 0){
-		struct table_entry *currEntry = array_1d_inspect_value(t->entries, i);
-		if(!(t->key_cmp_func(currEntry->key, key))){
+		if(!(TABLE_KEY_CMP(t, t->keys[i], key))){
 			keyFound = true;
 
 			if(t->key_free_func != NULL){
-				t->key_free_func(currEntry->key);
+				t->key_free_func(t->keys[i]);
 			}
 			if(t->value_free_func != NULL){
-				t->value_free_func(currEntry->value);
+				t->value_free_func(t->values[i]);
 			}
-			free(currEntry);
 
-			//Place the pointer to the last table_entry in the newly "empty" index in the array to
+			//Move the last pair into the newly "empty" index in the arrays to
 			//fill the gap created.
-			struct table_entry *lastEntry = array_1d_inspect_value(t->entries, t->firstEmptyElement - 1);
-			array_1d_set_value(t->entries, lastEntry, i);
+			t->keys[i] = t->keys[t->firstEmptyElement - 1];
+			t->values[i] = t->values[t->firstEmptyElement - 1];
 			t->firstEmptyElement--;
 		}
 		--i;
 	}
+	TABLE_STATS_REMOVE(t, TABLE_STATS_COMPARES(t) - mark);
 }
 
 /*
@@ -222,21 +369,50 @@ void table_remove(table *t, const void *key)
  */
 void table_kill(table *t){
 	while(t->firstEmptyElement > 0){
-		struct table_entry *lastEntry = array_1d_inspect_value(t->entries, t->firstEmptyElement - 1);
 		if (t->key_free_func != NULL) {
-			t->key_free_func(lastEntry->key);
+			t->key_free_func(t->keys[t->firstEmptyElement - 1]);
 		}
 		if (t->value_free_func != NULL) {
-			t->value_free_func(lastEntry->value);
+			t->value_free_func(t->values[t->firstEmptyElement - 1]);
 		}
 
-		free(lastEntry);
 		t->firstEmptyElement--;
 	}
-	array_1d_kill(t->entries);
+	free(t->keys);
+	free(t->values);
+	TABLE_STATS_FREE(t);
 	free(t);
 }
 
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_arrays(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table.
+ *	  Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_arrays(t, func);
+}
+
 /**
  * table_print() - Print the given table.
  * @t: Table to print.
@@ -249,7 +425,68 @@ void table_kill(table *t){
  */
 void table_print(const table *t, inspect_callback_pair print_func){
 	for (int i = 0; i < t->firstEmptyElement; ++i) {
-		struct table_entry *currEntry = array_1d_inspect_value(t->entries, i);
-		print_func(currEntry->key, currEntry->value);
+		print_func(t->keys[i], t->values[i]);
 	}
 }
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of an operation is the number of array elements
+ * it compared with.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
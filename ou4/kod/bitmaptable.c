@@ -0,0 +1,692 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "table.h"
+#include "table_stats.h"
+#include "bitmaptable.h"
+
+/*
+ * Implementation of a generic table as a direct-address array,
+ * specialized for small non-negative integer keys. Every key must be a
+ * pointer to an int. The key pointer and value of key k are kept at
+ * index k of two arrays, and bit k of a presence bitmap tells whether
+ * k is in the table, so insert, lookup and remove take constant time.
+ * key_cmp_func is never called.
+ *
+ * Every table has a domain, fixed when it is created, and can only
+ * store the keys 0 to domain-1. The arrays cover the keys 0 to
+ * capacity-1 and grow to cover any larger key in the domain that is
+ * inserted, so the memory used is proportional to the largest key
+ * rather than to the number of keys. The table is meant for dense
+ * keys, such as the keys 0 to 2n-1 used by tabletest. Negative keys
+ * and keys outside the domain can not be stored, nor can keys for
+ * which the arrays can not be grown.
+ *
+ * Iteration and table_choose_key() skip empty parts of the bitmap 64
+ * keys at a time, and find the keys within a word with count trailing
+ * zeros.
+ *
+ * Duplicates are handled by insert, as in arraytable.c. If the key
+ * already exists its key and value are replaced by the new ones.
+ *
+ * The correctness tests in tabletest use string keys, so run tabletest
+ * with -n for this table. Its keys must fit in BITMAP_DEFAULT_DOMAIN,
+ * so compile with a larger one for very large n.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added table_lookup_all() and table_count().
+ *   2026-10-18: v1.2, the domain bounds the keys instead of the initial
+ *                     capacity.
+ */
+
+// Number of keys a newly created table has room for. Must be a
+// multiple of BITS_PER_WORD.
+#define INITIAL_CAPACITY 64
+
+// Number of keys per word of the presence bitmap.
+#define BITS_PER_WORD 64
+
+// ===========INTERNAL DATA TYPES============
+
+struct table {
+	// Number of keys the arrays have room for, a multiple of
+	// BITS_PER_WORD.
+	unsigned long capacity;
+	// Keys from 0 to domain-1 can be stored.
+	unsigned long domain;
+	// Number of keys in the table.
+	unsigned long size;
+	// Bit k of word k / BITS_PER_WORD is set if key k is in the table.
+	uint64_t *present;
+	// No word of present before this one has a bit set.
+	unsigned long first_word;
+	// Key pointers and values, valid where the bit is set.
+	void **keys;
+	void **values;
+	free_function key_free_func;
+	free_function value_free_func;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * lowest_bit() - Find the lowest set bit of a word.
+ * @w: Word with at least one bit set.
+ *
+ * Returns: The index of the lowest set bit.
+ */
+static int lowest_bit(uint64_t w)
+{
+#ifdef __GNUC__
+	return __builtin_ctzll(w);
+#else
+	int i = 0;
+	while ((w & 1) == 0) {
+		w >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+/**
+ * words() - Compute the number of words in the presence bitmap.
+ * @t: Table to inspect.
+ *
+ * Returns: The number of words.
+ */
+static unsigned long words(const table *t)
+{
+	return t->capacity / BITS_PER_WORD;
+}
+
+/**
+ * key_index() - Find the index of a key.
+ * @t: Table to inspect.
+ * @key: Pointer to an int.
+ *
+ * Returns: The index of key in the arrays, or -1 if key is outside
+ * them and so can not be in the table.
+ */
+static long key_index(const table *t, const void *key)
+{
+	int k = *(const int *)key;
+
+	if (k < 0 || (unsigned long)k >= t->capacity) {
+		return -1;
+	}
+	return k;
+}
+
+/**
+ * is_present() - Check if an index holds a key.
+ * @t: Table to inspect.
+ * @i: Index in the arrays.
+ *
+ * Returns: True if the bit of i is set.
+ */
+static bool is_present(const table *t, unsigned long i)
+{
+	return (t->present[i / BITS_PER_WORD] >> (i % BITS_PER_WORD)) & 1;
+}
+
+/**
+ * round_to_words() - Round a number of keys up to whole words.
+ * @n: Number of keys.
+ *
+ * Returns: The smallest multiple of BITS_PER_WORD not less than n.
+ */
+static unsigned long round_to_words(unsigned long n)
+{
+	return (n / BITS_PER_WORD + (n % BITS_PER_WORD != 0)) * BITS_PER_WORD;
+}
+
+/**
+ * resize() - Increase the number of keys the arrays have room for.
+ * @t: Table to manipulate.
+ * @capacity: New capacity, a multiple of BITS_PER_WORD and not less
+ *	      than the old one.
+ *
+ * New words of the bitmap are cleared. If an array can not be grown
+ * the capacity is kept, and the arrays that were grown are only used
+ * up to it.
+ *
+ * Returns: True if the capacity was changed.
+ */
+static bool resize(table *t, unsigned long capacity)
+{
+	unsigned long old_words = words(t);
+	unsigned long new_words = capacity / BITS_PER_WORD;
+	uint64_t *present = realloc(t->present, new_words * sizeof(*present));
+
+	if (present == NULL) {
+		return false;
+	}
+	t->present = present;
+	void **keys = realloc(t->keys, capacity * sizeof(*keys));
+	if (keys == NULL) {
+		return false;
+	}
+	t->keys = keys;
+	void **values = realloc(t->values, capacity * sizeof(*values));
+	if (values == NULL) {
+		return false;
+	}
+	t->values = values;
+
+	memset(t->present + old_words, 0,
+	       (new_words - old_words) * sizeof(*t->present));
+	t->capacity = capacity;
+	if (t->size == 0) {
+		t->first_word = words(t);
+	}
+	return true;
+}
+
+/**
+ * grow() - Make room for a key.
+ * @t: Table to manipulate.
+ * @k: Key in the domain, not less than the capacity.
+ *
+ * The capacity is at least doubled, so that inserting increasing keys
+ * takes amortized constant time, but never exceeds the domain by more
+ * than a word.
+ *
+ * Returns: True if there is room for the key.
+ */
+static bool grow(table *t, unsigned long k)
+{
+	unsigned long capacity = 2 * t->capacity;
+
+	if (capacity <= k) {
+		capacity = round_to_words(k + 1);
+	}
+	if (capacity > round_to_words(t->domain)) {
+		capacity = round_to_words(t->domain);
+	}
+	return resize(t, capacity);
+}
+
+/**
+ * reject_pair() - Free a pair that can not be inserted.
+ * @t: Table to manipulate.
+ * @key: Key of the pair.
+ * @value: Value of the pair.
+ * @why: Why the pair can not be inserted.
+ *
+ * Prints a warning and calls any free functions set for keys/values.
+ *
+ * Returns: Nothing.
+ */
+static void reject_pair(const table *t, void *key, void *value,
+			const char *why)
+{
+	fprintf(stderr, "table_insert: Warning: Trying to insert %s key %d "
+		"into a bitmap table.\n", why, *(int *)key);
+	if (t->key_free_func != NULL) {
+		t->key_free_func(key);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(value);
+	}
+}
+
+/**
+ * empty_arrays() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * The capacity is kept, since the keys of a table usually come from
+ * the same range again.
+ *
+ * Returns: Nothing.
+ */
+static void empty_arrays(table *t, consume_callback_pair func)
+{
+	for (unsigned long w = t->first_word; w < words(t); w++) {
+		uint64_t bits = t->present[w];
+		while (bits != 0) {
+			unsigned long i = w * BITS_PER_WORD + lowest_bit(bits);
+			bits &= bits - 1;
+			if (func != NULL) {
+				func(t->keys[i], t->values[i]);
+				continue;
+			}
+			if (t->key_free_func != NULL) {
+				t->key_free_func(t->keys[i]);
+			}
+			if (t->value_free_func != NULL) {
+				t->value_free_func(t->values[i]);
+			}
+		}
+		t->present[w] = 0;
+	}
+	t->size = 0;
+	t->first_word = words(t);
+}
+
+/**
+ * visit_key() - Visit the pair with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function to call for the pair, or NULL.
+ *
+ * Returns: The number of pairs with the key, 0 or 1.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	long i = key_index(t, key);
+	bool found = i >= 0 && is_present(t, i);
+
+	TABLE_STATS_LOOKUP(t, 1, found);
+	if (!found) {
+		return 0;
+	}
+	if (func != NULL) {
+		func(t->keys[i], t->values[i]);
+	}
+	return 1;
+}
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty_bitmap() - Create an empty table for a range of keys.
+ * @key_cmp_func: Ignored, keys are compared as ints.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @domain: Only the keys 0 to domain-1 can be stored.
+ *
+ * The arrays start with room for INITIAL_CAPACITY keys and grow as
+ * larger keys are inserted, up to the domain.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_bitmap(compare_function *key_cmp_func,
+			  free_function key_free_func,
+			  free_function value_free_func,
+			  unsigned long domain)
+{
+	table *t = calloc(1, sizeof(*t));
+
+	t->domain = domain;
+	resize(t, INITIAL_CAPACITY);
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	TABLE_STATS_INIT(t);
+
+	return t;
+}
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: Ignored, keys are compared as ints.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * The table has the domain BITMAP_DEFAULT_DOMAIN, see bitmaptable.h.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return table_empty_bitmap(key_cmp_func, key_free_func,
+				  value_free_func, BITMAP_DEFAULT_DOMAIN);
+}
+
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: Ignored, keys are compared as ints.
+ * @key_hash_func: Ignored, the keys are used as indices.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * The table has the domain BITMAP_DEFAULT_DOMAIN, see bitmaptable.h.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: Ignored, keys are compared as ints.
+ * @key_hash_func: Ignored, the keys are used as indices.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: Ignored, keys are always unique since insert replaces the
+ *	   pair of a key already in the table.
+ *
+ * The table has the domain BITMAP_DEFAULT_DOMAIN, see bitmaptable.h.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to an int from 0 to domain-1.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If key already exists in
+ * the table the existing key and value are replaced by the new ones.
+ * A negative key, a key outside the domain or a key the arrays can
+ * not grow to cover can not be inserted. A warning is printed and any
+ * free functions are called on the key and value.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	int k = *(int *)key;
+
+	TABLE_STATS_INSERT(t, 1);
+	if (k < 0) {
+		reject_pair(t, key, value, "negative");
+		return;
+	}
+	unsigned long i = k;
+	if (i >= t->domain) {
+		reject_pair(t, key, value, "out of domain");
+		return;
+	}
+	if (i >= t->capacity && !grow(t, i)) {
+		reject_pair(t, key, value, "out of memory for");
+		return;
+	}
+	if (is_present(t, i)) {
+		// Free the previous key and value (if it is our business)
+		// unless they are the same memory as the new ones.
+		if (t->keys[i] != key && t->key_free_func != NULL) {
+			t->key_free_func(t->keys[i]);
+		}
+		if (t->values[i] != value && t->value_free_func != NULL) {
+			t->value_free_func(t->values[i]);
+		}
+	} else {
+		t->present[i / BITS_PER_WORD] |= 1ULL << (i % BITS_PER_WORD);
+		t->size++;
+		if (i / BITS_PER_WORD < t->first_word) {
+			t->first_word = i / BITS_PER_WORD;
+		}
+	}
+	t->keys[i] = key;
+	t->values[i] = value;
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	long i = key_index(t, key);
+	bool found = i >= 0 && is_present(t, i);
+
+	TABLE_STATS_LOOKUP(t, 1, found);
+	return found ? t->values[i] : NULL;
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The keys of the table are unique, so func is called at most once.
+ * func must not change the table.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	// The smallest key is found from the first word with a bit set.
+	unsigned long w = t->first_word;
+
+	while (t->present[w] == 0) {
+		w++;
+	}
+	return t->keys[w * BITS_PER_WORD + lowest_bit(t->present[w])];
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free functions set for keys/values. Does nothing if
+ * key is not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	long i = key_index(t, key);
+
+	TABLE_STATS_REMOVE(t, 1);
+	if (i < 0 || !is_present(t, i)) {
+		return;
+	}
+	if (t->key_free_func != NULL) {
+		t->key_free_func(t->keys[i]);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(t->values[i]);
+	}
+	t->present[i / BITS_PER_WORD] &= ~(1ULL << (i % BITS_PER_WORD));
+	t->size--;
+	// Keep first_word at a word with a bit set, so that removing the
+	// keys found by table_choose_key() takes amortized constant time.
+	while (t->first_word < words(t) && t->present[t->first_word] == 0) {
+		t->first_word++;
+	}
+}
+
+/**
+ * table_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	empty_arrays(t, NULL);
+	free(t->present);
+	free(t->keys);
+	free(t->values);
+	TABLE_STATS_FREE(t);
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_arrays(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table.
+ *	  Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_arrays(t, func);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table in increasing order
+ * of their keys and prints them.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	for (unsigned long w = t->first_word; w < words(t); w++) {
+		for (uint64_t bits = t->present[w]; bits != 0;
+		     bits &= bits - 1) {
+			unsigned long i = w * BITS_PER_WORD + lowest_bit(bits);
+			print_func(t->keys[i], t->values[i]);
+		}
+	}
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * Every operation reads a single bit and so has probe length 1. Keys
+ * are used as indices, so the number of key compares is always 0.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
@@ -0,0 +1,46 @@
+#ifndef BITMAPTABLE_H
+#define BITMAPTABLE_H
+
+#include "table.h"
+
+/*
+ * Extra operations for the direct-address implementation of table.h
+ * in bitmaptable.c.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-18: v1.1, added BITMAP_DEFAULT_DOMAIN.
+ */
+
+// Domain of the tables created by table_empty(), table_empty_hashed()
+// and table_empty_ex(), which can store the keys 0 to 2^24-1. May be
+// defined at compile time, the same for all files.
+#ifndef BITMAP_DEFAULT_DOMAIN
+#define BITMAP_DEFAULT_DOMAIN (1UL << 24)
+#endif
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_empty_bitmap() - Create an empty table for a range of keys.
+ * @key_cmp_func: Ignored, keys are compared as ints.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @domain: Only the keys 0 to domain-1 can be stored.
+ *
+ * Inserting a negative key or a key outside the domain prints a
+ * warning and calls any free functions on the key and value. The
+ * memory used grows with the largest key inserted, up to the domain.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_bitmap(compare_function *key_cmp_func,
+			  free_function key_free_func,
+			  free_function value_free_func,
+			  unsigned long domain);
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * bitmaptest - test the key domain of the direct-address table.
+ *
+ * Should be compiled together with bitmaptable.c.
+ *
+ * Usage: bitmaptest [n]
+ *
+ * Tests that a table only stores the keys of its domain. Tables made
+ * by table_empty() and by table_empty_bitmap() with domains of 0, 1,
+ * 64, 65 and n keys are filled with every key of the domain, and
+ * then given the keys just outside it, INT_MAX and negative keys.
+ * Those must not be stored and their keys and values must be freed at
+ * once, without the table growing to cover them. Every key and value
+ * must have been freed exactly once when the table is killed. The
+ * warnings printed for the rejected keys are expected.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "table.h"
+#include "bitmaptable.h"
+
+// Default domain
+#define DEFAULT_SIZE 1000
+
+// Number of keys and values allocated and freed by the tests
+unsigned long n_allocated;
+unsigned long n_freed;
+
+// Keys visited by table_print(), and their number
+int *visited_keys;
+int n_visited;
+
+/**
+ * int_ptr_from_int() - Create a dynamic copy of an int.
+ * @i: Value to copy.
+ *
+ * Returns: Pointer to the copy of i.
+ */
+int *int_ptr_from_int(int i)
+{
+        int *ip = malloc(sizeof(int));
+        *ip = i;
+        n_allocated++;
+        return ip;
+}
+
+/**
+ * counting_free() - Free a key or value and count it.
+ * @p: Pointer from int_ptr_from_int().
+ *
+ * Returns: Nothing.
+ */
+void counting_free(void *p)
+{
+        free(p);
+        n_freed++;
+}
+
+int int_compare(const void *ip1,const void *ip2)
+{
+        const int *n1=ip1;
+        const int *n2=ip2;
+        return (*n1 > *n2) - (*n1 < *n2);
+}
+
+/**
+ * visit_pair() - Record a key visited by table_print().
+ * @key: Key of the pair.
+ * @value: Value of the pair.
+ *
+ * Returns: Nothing.
+ */
+void visit_pair(const void *key, const void *value)
+{
+        visited_keys[n_visited++] = *(const int *)key;
+}
+
+/**
+ * fail() - Print an error message and exit.
+ * @name: Name of the test that failed.
+ * @what: What went wrong.
+ * @key: Key that went wrong.
+ *
+ * Returns: Never.
+ */
+void fail(const char *name, const char *what, long key)
+{
+        fprintf(stderr, "FAIL: %s: %s %ld.\n", name, what, key);
+        exit(EXIT_FAILURE);
+}
+
+/**
+ * reject_key() - Insert a key outside the domain and check that it is
+ * not stored.
+ * @t: Table to insert into.
+ * @key: Key outside the domain of the table.
+ * @size: Number of keys in the table.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void reject_key(table *t, int key, unsigned long size, const char *name)
+{
+        unsigned long freed = n_freed;
+
+        table_insert(t, int_ptr_from_int(key), int_ptr_from_int(key));
+        if (n_freed != freed + 2) {
+                fail(name, "did not free the pair of key", key);
+        }
+        if (table_lookup(t, &key) != NULL || table_count(t, &key) != 0) {
+                fail(name, "stored key", key);
+        }
+        table_remove(t, &key);
+
+        n_visited = 0;
+        table_print(t, visit_pair);
+        if ((unsigned long)n_visited != size) {
+                fail(name, "changed the number of keys when inserting", key);
+        }
+}
+
+/**
+ * test_domain() - Fill a table and insert keys outside its domain.
+ * @t: Empty table to test.
+ * @domain: Domain of the table.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void test_domain(table *t, unsigned long domain, const char *name)
+{
+        for (unsigned long k = 0; k < domain; k++) {
+                table_insert(t, int_ptr_from_int(k), int_ptr_from_int(k));
+        }
+        for (unsigned long k = 0; k < domain; k++) {
+                int key = k;
+                const int *v = table_lookup(t, &key);
+                if (v == NULL || *v != key) {
+                        fail(name, "lost key", key);
+                }
+        }
+
+        if (domain <= INT_MAX) {
+                reject_key(t, domain, domain, name);
+                reject_key(t, domain + 1, domain, name);
+        }
+        reject_key(t, INT_MAX, domain, name);
+        reject_key(t, -1, domain, name);
+        reject_key(t, INT_MIN, domain, name);
+
+        for (int i = 0; i < n_visited; i++) {
+                if (visited_keys[i] != i) {
+                        fail(name, "visited key", visited_keys[i]);
+                }
+        }
+        table_kill(t);
+        if (n_freed != n_allocated) {
+                fail(name, "keys and values not freed:",
+                     n_allocated - n_freed);
+        }
+        printf("%s: OK.\n", name);
+}
+
+/**
+ * test_default_domain() - Insert the smallest and largest keys into a
+ * table made by table_empty().
+ *
+ * Returns: Nothing.
+ */
+void test_default_domain()
+{
+        table *t = table_empty(int_compare, counting_free, counting_free);
+        int keys[] = { 0, BITMAP_DEFAULT_DOMAIN - 1 };
+        const char *name = "Default domain";
+
+        for (int i = 0; i < 2; i++) {
+                table_insert(t, int_ptr_from_int(keys[i]),
+                             int_ptr_from_int(keys[i]));
+                const int *v = table_lookup(t, &keys[i]);
+                if (v == NULL || *v != keys[i]) {
+                        fail(name, "lost key", keys[i]);
+                }
+        }
+        reject_key(t, BITMAP_DEFAULT_DOMAIN, 2, name);
+        reject_key(t, INT_MAX, 2, name);
+        reject_key(t, -1, 2, name);
+        if (visited_keys[0] != keys[0] || visited_keys[1] != keys[1]) {
+                fail(name, "visited key", visited_keys[0]);
+        }
+        table_kill(t);
+        if (n_freed != n_allocated) {
+                fail(name, "keys and values not freed:",
+                     n_allocated - n_freed);
+        }
+        printf("%s: OK.\n", name);
+}
+
+int main(int argc, char **argv)
+{
+        int n = DEFAULT_SIZE;
+        if (argc > 1) {
+                n = atoi(argv[1]);
+        }
+        if (n < 0) {
+                fprintf(stderr, "Usage: %s [n]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+
+        unsigned long domains[] = { 0, 1, 64, 65, n };
+        visited_keys = malloc((n > 65 ? n : 65)*sizeof(*visited_keys));
+        test_default_domain();
+        for (int i = 0; i < (int)(sizeof(domains)/sizeof(domains[0])); i++) {
+                char name[40];
+                table *t = table_empty_bitmap(int_compare, counting_free,
+                                              counting_free, domains[i]);
+                snprintf(name, sizeof(name), "Domain %lu", domains[i]);
+                test_domain(t, domains[i], name);
+        }
+        free(visited_keys);
+        return 0;
+}
@@ -0,0 +1,764 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "table.h"
+#include "table_stats.h"
+#include "bloomtable.h"
+#include "innertable.h"
+
+/*
+ * Implementation of a generic table that wraps another implementation
+ * of table.h and keeps a Bloom filter over its keys. A lookup or
+ * remove of a key that the filter knows is not in the table returns at
+ * once, without touching the wrapped table. See innertable.h for how
+ * the wrapped implementation is compiled and linked.
+ *
+ * The filter is blocked: each key maps to one cache line of 512 bits
+ * and sets PROBES bits within it, so a query reads a single cache
+ * line. Bits cannot be cleared on remove, since other keys may share
+ * them, so removed keys stay in the filter as stale keys that only
+ * cause false positives. The filter is rebuilt from the keys in the
+ * wrapped table when more than half of its keys are stale, and doubled
+ * in size when there are too many keys for it. Both take time linear
+ * in the size of the table, spread over at least as many inserts or
+ * removes.
+ *
+ * Tables created without a hash function have no filter and simply
+ * forward every operation. So does a table whose filter memory cannot
+ * be allocated, from then on.
+ *
+ * A rebuild passes the table to its callback, and the wrapped table
+ * passes the keys it frees back to the table, through thread-local
+ * variables, see rebuilding and freeing below. Compilers other than
+ * GCC and Clang make them shared, so tables may then only be changed
+ * from one thread at a time.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added table_stats().
+ *   2026-10-17: v1.2, added table_empty_ex().
+ *   2026-10-17: v1.3, added table_clear() and table_drain().
+ *   2026-10-17: v1.4, added table_lookup_all() and table_count().
+ *   2026-10-18: v1.5, the table being rebuilt is kept per thread.
+ *   2026-10-18: v1.6, only removes that free keys count them as stale,
+ *                     and a failed filter allocation drops the filter.
+ */
+
+#define CACHE_LINE 64
+
+// Number of 64 bit words per block, one block per cache line.
+#define BLOCK_WORDS (CACHE_LINE / 8)
+
+// Number of bits set per key. Each uses 9 bits of the hash.
+#define PROBES 7
+
+// Filter bits per key. The filter is doubled when there are fewer.
+#define BITS_PER_KEY 12
+
+// Number of blocks in a new filter. Must be a power of two.
+#define INITIAL_BLOCKS 4
+
+// Number of keys passed on together to inner_table_lookup_many().
+#define BATCH_SIZE 64
+
+// ===========INTERNAL DATA TYPES============
+
+struct bloom_filter {
+	unsigned long long *words;
+	// Number of blocks, always a power of two.
+	unsigned long blocks;
+	// Number of keys added since the last rebuild, including stale.
+	unsigned long keys;
+	// Number of keys removed since the last rebuild.
+	unsigned long stale;
+	unsigned long lookups;
+	unsigned long filtered;
+	unsigned long false_positives;
+};
+
+struct table {
+	inner_table *inner;
+	hash_function *key_hash_func;
+	// Kept behind a pointer so that table_lookup() can count.
+	struct bloom_filter *filter;
+	// Free function for keys, called by free_key() on behalf of the
+	// wrapped table, and the number of keys it has freed.
+	free_function key_free_func;
+	unsigned long freed_keys;
+};
+
+// Table whose filter is being rebuilt by rebuild_add(). The callback of
+// table_print() takes no context, so the table is passed here. With GCC
+// each thread has its own, so tables used by different threads can be
+// rebuilt at once. Otherwise a table must not be changed while another
+// thread changes any table of this implementation.
+#ifdef __GNUC__
+static __thread table *rebuilding;
+#else
+static table *rebuilding;
+#endif
+
+// Table whose wrapped table may free keys through free_key(). Set
+// around every call that can, in the same way as rebuilding.
+#ifdef __GNUC__
+static __thread table *freeing;
+#else
+static table *freeing;
+#endif
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * mix() - Spread the bits of a hash value.
+ * @x: Value to mix.
+ *
+ * Uses the finalizer of MurmurHash3.
+ *
+ * Returns: The mixed value.
+ */
+static unsigned long long mix(unsigned long long x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+/**
+ * key_hash() - Compute the filter hash of a key.
+ * @t: Table the key belongs to. Must have a filter.
+ * @key: Key to hash.
+ *
+ * Returns: The mixed hash value of the key.
+ */
+static unsigned long long key_hash(const table *t, const void *key)
+{
+	return mix(t->key_hash_func(key));
+}
+
+/**
+ * popcount() - Count the set bits of a word.
+ * @w: Word to inspect.
+ *
+ * Returns: The number of bits set in w.
+ */
+static int popcount(unsigned long long w)
+{
+#ifdef __GNUC__
+	return __builtin_popcountll(w);
+#else
+	int n = 0;
+
+	for (; w != 0; w &= w - 1) {
+		n++;
+	}
+	return n;
+#endif
+}
+
+/**
+ * block_of() - Find the block a hash maps to.
+ * @f: Filter to inspect.
+ * @h: Hash value from key_hash().
+ *
+ * Returns: Pointer to the first word of the block.
+ */
+static unsigned long long *block_of(const struct bloom_filter *f,
+				    unsigned long long h)
+{
+	return f->words + (h & (f->blocks - 1)) * BLOCK_WORDS;
+}
+
+/**
+ * probe_bits() - Compute the bits within a block a hash sets.
+ * @h: Hash value from key_hash().
+ *
+ * Returns: PROBES bit numbers of 9 bits each, packed into one value.
+ */
+static unsigned long long probe_bits(unsigned long long h)
+{
+	return mix(h ^ 0x9e3779b97f4a7c15ULL);
+}
+
+/**
+ * filter_add() - Add a hash to a filter.
+ * @f: Filter to manipulate.
+ * @h: Hash value from key_hash().
+ *
+ * Returns: Nothing.
+ */
+static void filter_add(struct bloom_filter *f, unsigned long long h)
+{
+	unsigned long long *block = block_of(f, h);
+	unsigned long long bits = probe_bits(h);
+
+	for (int i = 0; i < PROBES; i++, bits >>= 9) {
+		block[(bits >> 6) & 7] |= 1ULL << (bits & 63);
+	}
+	f->keys++;
+}
+
+/**
+ * filter_may_contain() - Check if a hash may have been added to a filter.
+ * @f: Filter to inspect.
+ * @h: Hash value from key_hash().
+ *
+ * Returns: False if no key with hash h is in the filter. True if one
+ * may be.
+ */
+static bool filter_may_contain(const struct bloom_filter *f,
+			       unsigned long long h)
+{
+	const unsigned long long *block = block_of(f, h);
+	unsigned long long bits = probe_bits(h);
+
+	for (int i = 0; i < PROBES; i++, bits >>= 9) {
+		if ((block[(bits >> 6) & 7] & (1ULL << (bits & 63))) == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * alloc_words() - Allocate zeroed, cache-line aligned filter blocks.
+ * @blocks: Number of blocks.
+ *
+ * Returns: Pointer to the first word, or NULL if the memory could not
+ * be allocated.
+ */
+static unsigned long long *alloc_words(unsigned long blocks)
+{
+	void *p = NULL;
+	size_t words = blocks * BLOCK_WORDS;
+
+	if (posix_memalign(&p, CACHE_LINE, words * sizeof(unsigned long long))
+	    != 0 || p == NULL) {
+		return NULL;
+	}
+	for (size_t i = 0; i < words; i++) {
+		((unsigned long long *)p)[i] = 0;
+	}
+	return p;
+}
+
+/**
+ * rebuild_add() - Add a pair of the table being rebuilt to its filter.
+ * @key: Key of the pair.
+ * @value: Ignored.
+ *
+ * Returns: Nothing.
+ */
+static void rebuild_add(const void *key, const void *value)
+{
+	filter_add(rebuilding->filter, key_hash(rebuilding, key));
+}
+
+/**
+ * free_key() - Free a key on behalf of the wrapped table.
+ * @key: Key to free.
+ *
+ * Counts the key, so that table_remove() learns how many pairs the
+ * wrapped table removed, and calls the free function set for keys.
+ *
+ * Returns: Nothing.
+ */
+static void free_key(void *key)
+{
+	freeing->freed_keys++;
+	if (freeing->key_free_func != NULL) {
+		freeing->key_free_func(key);
+	}
+}
+
+/**
+ * rebuild_filter() - Rebuild the filter from the keys of the table.
+ * @t: Table to manipulate.
+ * @blocks: Number of blocks of the new filter.
+ *
+ * Drops all stale keys. Every stored pair is added, so a duplicate key
+ * counts more than once towards the size of the filter. If the new
+ * filter cannot be allocated the table is left without one.
+ *
+ * Returns: Nothing.
+ */
+static void rebuild_filter(table *t, unsigned long blocks)
+{
+	struct bloom_filter *f = t->filter;
+
+	free(f->words);
+	f->blocks = blocks;
+	f->words = alloc_words(f->blocks);
+	if (f->words == NULL) {
+		free(f);
+		t->filter = NULL;
+		return;
+	}
+	f->keys = 0;
+	f->stale = 0;
+
+	rebuilding = t;
+	inner_table_print(t->inner, rebuild_add);
+	rebuilding = NULL;
+}
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Without a hash function the table has no filter.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return table_empty_hashed(key_cmp_func, NULL, key_free_func,
+				  value_free_func);
+}
+
+/**
+ * table_empty_hashed() - Create an empty table with a filter.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys for
+ *		   the filter, or NULL for no filter. Also passed on to
+ *		   the wrapped table.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return table_empty_ex(key_cmp_func, key_hash_func, key_free_func,
+			      value_free_func, 0);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with a filter and options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys for
+ *		   the filter, or NULL for no filter. Also passed on to
+ *		   the wrapped table.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: Passed on to the wrapped table.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	table *t = malloc(sizeof(*t));
+
+	// Only a table with a filter needs to count the removed keys.
+	t->inner = inner_table_empty_ex(key_cmp_func, key_hash_func,
+					key_hash_func != NULL
+					? free_key : key_free_func,
+					value_free_func, flags);
+	t->key_hash_func = key_hash_func;
+	t->key_free_func = key_free_func;
+	t->freed_keys = 0;
+	t->filter = NULL;
+	if (key_hash_func != NULL) {
+		t->filter = calloc(1, sizeof(*t->filter));
+		t->filter->blocks = INITIAL_BLOCKS;
+		t->filter->words = alloc_words(t->filter->blocks);
+		if (t->filter->words == NULL) {
+			free(t->filter);
+			t->filter = NULL;
+		}
+	}
+	return t;
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return inner_table_is_empty(t->inner);
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. Duplicates are handled as
+ * by the wrapped table.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	struct bloom_filter *f = t->filter;
+
+	freeing = t;
+	inner_table_insert(t->inner, key, value);
+	freeing = NULL;
+	if (f == NULL) {
+		return;
+	}
+	filter_add(f, key_hash(t, key));
+	if (f->keys * BITS_PER_KEY > f->blocks * CACHE_LINE * 8) {
+		rebuild_filter(t, 2 * f->blocks);
+	}
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table. If the table contains duplicate keys,
+ * the value that was latest inserted will be returned.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	struct bloom_filter *f = t->filter;
+
+	if (f == NULL) {
+		return inner_table_lookup(t->inner, key);
+	}
+	f->lookups++;
+	if (!filter_may_contain(f, key_hash(t, key))) {
+		f->filtered++;
+		return NULL;
+	}
+	void *value = inner_table_lookup(t->inner, key);
+	if (value == NULL) {
+		f->false_positives++;
+	}
+	return value;
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * Keys rejected by the filter are not looked up in the wrapped table.
+ * The filter counters only count table_lookup().
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	if (t->filter != NULL
+	    && !filter_may_contain(t->filter, key_hash(t, key))) {
+		return;
+	}
+	inner_table_lookup_all(t->inner, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	if (t->filter != NULL
+	    && !filter_may_contain(t->filter, key_hash(t, key))) {
+		return 0;
+	}
+	return inner_table_count(t->inner, key);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	return inner_table_choose_key(t->inner);
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Any matching duplicates will be removed. Will call any free
+ * functions set for keys/values. Does nothing if key is not found in
+ * the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	struct bloom_filter *f = t->filter;
+
+	if (f != NULL && !filter_may_contain(f, key_hash(t, key))) {
+		return;
+	}
+	t->freed_keys = 0;
+	freeing = t;
+	inner_table_remove(t->inner, key);
+	freeing = NULL;
+	if (f == NULL) {
+		return;
+	}
+	// Only the pairs actually removed leave stale keys behind, one
+	// per duplicate since each was added to the filter.
+	f->stale += t->freed_keys;
+	if (2 * f->stale > f->keys) {
+		rebuild_filter(t, f->blocks);
+	}
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	freeing = t;
+	inner_table_kill(t->inner);
+	freeing = NULL;
+	if (t->filter != NULL) {
+		free(t->filter->words);
+		free(t->filter);
+	}
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty, with a new filter of INITIAL_BLOCKS
+ * blocks. The lookup counters are kept.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	freeing = t;
+	inner_table_clear(t->inner);
+	freeing = NULL;
+	if (t->filter != NULL) {
+		// The wrapped table is empty, so no keys are added.
+		rebuild_filter(t, INITIAL_BLOCKS);
+	}
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table,
+ *	  including duplicates. Takes over the key and value.
+ *
+ * The table stays valid and empty, with a new filter as after
+ * table_clear().
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	inner_table_drain(t->inner, func);
+	if (t->filter != NULL) {
+		rebuild_filter(t, INITIAL_BLOCKS);
+	}
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table and prints them.
+ * Will print all stored elements, including duplicates.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	inner_table_print(t->inner, print_func);
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Only the keys that pass the filter are passed on to the wrapped
+ * table, in one call per BATCH_SIZE keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	struct bloom_filter *f = t->filter;
+	void *passed_keys[BATCH_SIZE];
+	void *passed_values[BATCH_SIZE];
+	int index[BATCH_SIZE];
+
+	if (f == NULL) {
+		inner_table_lookup_many(t->inner, keys, values, n);
+		return;
+	}
+	for (int first = 0; first < n; first += BATCH_SIZE) {
+		int m = n - first < BATCH_SIZE ? n - first : BATCH_SIZE;
+		int passed = 0;
+		for (int i = first; i < first + m; i++) {
+			values[i] = NULL;
+			if (filter_may_contain(f, key_hash(t, keys[i]))) {
+				passed_keys[passed] = keys[i];
+				index[passed] = i;
+				passed++;
+			}
+		}
+		inner_table_lookup_many(t->inner, passed_keys, passed_values,
+					passed);
+		for (int j = 0; j < passed; j++) {
+			values[index[j]] = passed_values[j];
+			if (passed_values[j] == NULL) {
+				f->false_positives++;
+			}
+		}
+		f->lookups += m;
+		f->filtered += m - passed;
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics of the wrapped table.
+ *
+ * Lookups answered by the filter never reach the wrapped table. They
+ * are added to its statistics as misses with probe length 0.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	inner_table_stats(t->inner, out);
+	if (!out->enabled || t->filter == NULL) {
+		return;
+	}
+	out->lookups += t->filter->filtered;
+	out->misses += t->filter->filtered;
+	out->lookup_probes.count += t->filter->filtered;
+	out->lookup_probes.histogram[0] += t->filter->filtered;
+	table_stats_finish(out);
+}
+
+/**
+ * table_bloom_stats() - Get the filter statistics of a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The estimated rate is the fraction of set bits raised to the number
+ * of probes per key.
+ *
+ * Returns: Nothing.
+ */
+void table_bloom_stats(const table *t, bloom_stats *out)
+{
+	const struct bloom_filter *f = t->filter;
+
+	*out = (bloom_stats){ 0 };
+	if (f == NULL) {
+		return;
+	}
+	out->lookups = f->lookups;
+	out->filtered = f->filtered;
+	out->false_positives = f->false_positives;
+	if (f->filtered + f->false_positives > 0) {
+		out->observed_fpr = (double)f->false_positives
+			/ (f->filtered + f->false_positives);
+	}
+
+	unsigned long words = f->blocks * BLOCK_WORDS;
+	unsigned long set = 0;
+	for (unsigned long i = 0; i < words; i++) {
+		set += popcount(f->words[i]);
+	}
+	double fill = (double)set / (words * 64);
+	out->estimated_fpr = 1.0;
+	for (int i = 0; i < PROBES; i++) {
+		out->estimated_fpr *= fill;
+	}
+}
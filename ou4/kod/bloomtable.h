@@ -0,0 +1,46 @@
+#ifndef BLOOMTABLE_H
+#define BLOOMTABLE_H
+
+#include "table.h"
+
+/*
+ * Extra operations for the Bloom filter wrapper implementation of
+ * table.h in bloomtable.c.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+
+// Lookup counters and false positive rates of a table's filter.
+typedef struct bloom_stats {
+	// Number of keys looked up.
+	unsigned long lookups;
+	// Lookups answered by the filter without touching the table.
+	unsigned long filtered;
+	// Lookups the filter let through for keys not in the table.
+	unsigned long false_positives;
+	// false_positives / (filtered + false_positives), or 0.
+	double observed_fpr;
+	// Expected rate for the current number of keys and filter size.
+	double estimated_fpr;
+} bloom_stats;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_bloom_stats() - Get the filter statistics of a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * A table created without a hash function has no filter. All its
+ * lookups reach the wrapped table and all counters stay zero.
+ *
+ * Returns: Nothing.
+ */
+void table_bloom_stats(const table *t, bloom_stats *out);
+
+#endif
@@ -0,0 +1,1282 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "table.h"
+#include "table_stats.h"
+#include "orderedtable.h"
+
+/*
+ * Implementation of a generic table as a B+tree ordered by
+ * key_cmp_func. All pairs are stored in the leaves, which are linked
+ * in key order for the ordered operations in orderedtable.h. Inner
+ * nodes only hold separator keys. Every node is four cache lines in
+ * size and aligned to a cache line, so a node is searched without
+ * touching more memory than necessary. Insert, lookup and remove take
+ * O(log n) time.
+ *
+ * The separator before child i of an inner node always points to the
+ * smallest key in the subtree of that child. Separators are therefore
+ * updated whenever the smallest key of a subtree is removed, so that
+ * no separator points to a key that has been freed.
+ *
+ * table_lookup_many() descends with a group of keys in lock step, one
+ * level at a time, and prefetches each node a key moves to. The cache
+ * misses of the group then overlap instead of being taken one after
+ * the other.
+ *
+ * Duplicates are handled by insert. The latest added pair for a key
+ * is kept in the leaf, older pairs with the same key are chained
+ * behind it so that remove, kill and print still see all of them.
+ * Tables created with TABLE_UNIQUE_KEYS replace the pair in the leaf
+ * instead and never allocate a chain.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added batched insert/lookup/remove.
+ *   2026-10-17: v1.2, added table_stats().
+ *   2026-10-17: v1.3, added table_empty_ex().
+ *   2026-10-17: v1.4, added table_clear() and table_drain().
+ *   2026-10-17: v1.5, added table_lookup_all() and table_count().
+ */
+
+#define CACHE_LINE 64
+#define NODE_SIZE (4 * CACHE_LINE)
+
+// A leaf holds a header, a next pointer and three arrays of pointers.
+#define LEAF_KEYS ((NODE_SIZE - 2 * sizeof(void *)) / (3 * sizeof(void *)))
+// An inner node holds a header, n keys and n + 1 children.
+#define INNER_KEYS ((NODE_SIZE - 2 * sizeof(void *)) / (2 * sizeof(void *)))
+
+// Fewest keys allowed in a node other than the root.
+#define LEAF_MIN (LEAF_KEYS / 2)
+#define INNER_MIN (INNER_KEYS / 2)
+
+// Number of keys that descend the tree together in table_lookup_many().
+#define BATCH_SIZE 16
+
+// Prefetch a cache line that will soon be read, if the compiler can.
+#ifdef __GNUC__
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p)
+#endif
+
+// ===========INTERNAL DATA TYPES============
+
+// An older key/value pair shadowed by a later insert of the same key.
+struct table_entry {
+	void *key;
+	void *value;
+	struct table_entry *next;
+};
+
+// Common first member of leaves and inner nodes.
+struct node {
+	int count;
+	bool is_leaf;
+};
+
+struct leaf {
+	struct node hdr;
+	struct leaf *next;
+	void *keys[LEAF_KEYS];
+	void *values[LEAF_KEYS];
+	struct table_entry *older[LEAF_KEYS];
+};
+
+struct inner {
+	struct node hdr;
+	void *keys[INNER_KEYS];
+	struct node *children[INNER_KEYS + 1];
+};
+
+struct table {
+	struct node *root;
+	compare_function *key_cmp_func;
+	free_function key_free_func;
+	free_function value_free_func;
+	// True if created with TABLE_UNIQUE_KEYS.
+	bool unique_keys;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * node_alloc() - Allocate a cache-line aligned, zeroed node.
+ * @is_leaf: True to allocate a leaf, false for an inner node.
+ *
+ * Returns: Pointer to the new node.
+ */
+static struct node *node_alloc(bool is_leaf)
+{
+	size_t size = is_leaf ? sizeof(struct leaf) : sizeof(struct inner);
+	void *p = NULL;
+
+	if (posix_memalign(&p, CACHE_LINE, size) != 0) {
+		return NULL;
+	}
+	for (size_t i = 0; i < size; i++) {
+		((char *)p)[i] = 0;
+	}
+	struct node *n = p;
+	n->is_leaf = is_leaf;
+	return n;
+}
+
+/**
+ * prefetch_node() - Start loading all cache lines of a node.
+ * @n: Node that will soon be searched.
+ *
+ * Returns: Nothing.
+ */
+static void prefetch_node(const struct node *n)
+{
+	const char *p = (const char *)n;
+
+	for (int line = 0; line < NODE_SIZE; line += CACHE_LINE) {
+		PREFETCH(p + line);
+	}
+}
+
+/**
+ * leaf_search() - Find the first key in a leaf not less than key.
+ * @t: Table the leaf belongs to.
+ * @l: Leaf to search.
+ * @key: Key to search for.
+ *
+ * Returns: Index of the first key not less than key, or the number of
+ * keys in the leaf if there is no such key.
+ */
+static int leaf_search(const table *t, const struct leaf *l, const void *key)
+{
+	int lo = 0;
+	int hi = l->hdr.count;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (TABLE_KEY_CMP(t, l->keys[mid], key) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * child_search() - Find the child of an inner node that covers key.
+ * @t: Table the node belongs to.
+ * @n: Inner node to search.
+ * @key: Key to search for.
+ *
+ * Returns: Index of the child whose subtree would hold key, i.e. the
+ * number of separators that are less than or equal to key.
+ */
+static int child_search(const table *t, const struct inner *n,
+			const void *key)
+{
+	int lo = 0;
+	int hi = n->hdr.count;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (TABLE_KEY_CMP(t, n->keys[mid], key) <= 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * find_leaf() - Find the leaf whose key range covers key.
+ * @t: Table to inspect.
+ * @key: Key to search for.
+ *
+ * Returns: The leaf that holds key if key is in the table.
+ */
+static struct leaf *find_leaf(const table *t, const void *key)
+{
+	struct node *n = t->root;
+
+	while (!n->is_leaf) {
+		struct inner *in = (struct inner *)n;
+		n = in->children[child_search(t, in, key)];
+	}
+	return (struct leaf *)n;
+}
+
+/**
+ * subtree_min() - Return the smallest key in a non-empty subtree.
+ * @n: Root of the subtree.
+ *
+ * Returns: The smallest key in the subtree.
+ */
+static void *subtree_min(const struct node *n)
+{
+	while (!n->is_leaf) {
+		n = ((const struct inner *)n)->children[0];
+	}
+	return ((const struct leaf *)n)->keys[0];
+}
+
+/**
+ * fix_separators() - Recompute all separators of an inner node.
+ * @n: Inner node to manipulate.
+ *
+ * Returns: Nothing.
+ */
+static void fix_separators(struct inner *n)
+{
+	for (int i = 1; i <= n->hdr.count; i++) {
+		n->keys[i - 1] = subtree_min(n->children[i]);
+	}
+}
+
+/**
+ * leaf_insert_at() - Insert a new pair at a given index of a leaf.
+ * @l: Leaf to manipulate. Must not be full.
+ * @i: Index for the new pair.
+ * @key, @value: Pair to insert.
+ *
+ * Returns: Nothing.
+ */
+static void leaf_insert_at(struct leaf *l, int i, void *key, void *value)
+{
+	for (int j = l->hdr.count; j > i; j--) {
+		l->keys[j] = l->keys[j - 1];
+		l->values[j] = l->values[j - 1];
+		l->older[j] = l->older[j - 1];
+	}
+	l->keys[i] = key;
+	l->values[i] = value;
+	l->older[i] = NULL;
+	l->hdr.count++;
+}
+
+/**
+ * replace_pair() - Replace a pair in a leaf of a table with unique keys.
+ * @t: Table to manipulate.
+ * @l: Leaf holding the pair.
+ * @i: Index of the pair in the leaf.
+ * @key, @value: New pair, with a key equal to the one at index i.
+ *
+ * The first key of a leaf may be the separator of an ancestor, which
+ * then has to point to the new key before the old one is freed. Calls
+ * any free functions set for keys/values on the replaced key and
+ * value, unless they are the same memory as the new ones.
+ *
+ * Returns: Nothing.
+ */
+static void replace_pair(table *t, struct leaf *l, int i, void *key,
+			 void *value)
+{
+	void *old_key = l->keys[i];
+	void *old_value = l->values[i];
+
+	l->keys[i] = key;
+	l->values[i] = value;
+	if (i == 0 && old_key != key) {
+		struct node *n = t->root;
+		while (!n->is_leaf) {
+			struct inner *in = (struct inner *)n;
+			int c = child_search(t, in, key);
+			if (c > 0 && in->keys[c - 1] == old_key) {
+				in->keys[c - 1] = key;
+			}
+			n = in->children[c];
+		}
+	}
+	if (t->key_free_func != NULL && old_key != key) {
+		t->key_free_func(old_key);
+	}
+	if (t->value_free_func != NULL && old_value != value) {
+		t->value_free_func(old_value);
+	}
+}
+
+/**
+ * leaf_insert() - Insert a pair into a leaf, splitting it if full.
+ * @t: Table to manipulate.
+ * @l: Leaf to manipulate.
+ * @key, @value: Pair to insert.
+ * @sep: Set to the smallest key of the new right leaf on a split.
+ *
+ * Returns: The new right leaf if l was split, otherwise NULL.
+ */
+static struct node *leaf_insert(table *t, struct leaf *l, void *key,
+				void *value, void **sep)
+{
+	int i = leaf_search(t, l, key);
+
+	if (i < l->hdr.count && TABLE_KEY_CMP(t, l->keys[i], key) == 0) {
+		if (t->unique_keys) {
+			replace_pair(t, l, i, key, value);
+			return NULL;
+		}
+		// Duplicate key. Push the current pair onto the chain.
+		struct table_entry *entry = malloc(sizeof(*entry));
+		entry->key = l->keys[i];
+		entry->value = l->values[i];
+		entry->next = l->older[i];
+		l->older[i] = entry;
+		l->keys[i] = key;
+		l->values[i] = value;
+		return NULL;
+	}
+	if (l->hdr.count < (int)LEAF_KEYS) {
+		leaf_insert_at(l, i, key, value);
+		return NULL;
+	}
+
+	// Split the full leaf in two halves and insert into one of them.
+	struct leaf *right = (struct leaf *)node_alloc(true);
+	int half = l->hdr.count / 2;
+	for (int j = half; j < l->hdr.count; j++) {
+		right->keys[j - half] = l->keys[j];
+		right->values[j - half] = l->values[j];
+		right->older[j - half] = l->older[j];
+	}
+	right->hdr.count = l->hdr.count - half;
+	l->hdr.count = half;
+	right->next = l->next;
+	l->next = right;
+
+	if (i <= half) {
+		leaf_insert_at(l, i, key, value);
+	} else {
+		leaf_insert_at(right, i - half, key, value);
+	}
+	*sep = right->keys[0];
+	return (struct node *)right;
+}
+
+/**
+ * insert_rec() - Insert a pair into a subtree.
+ * @t: Table to manipulate.
+ * @n: Root of the subtree.
+ * @key, @value: Pair to insert.
+ * @sep: Set to the smallest key of the new right node on a split.
+ *
+ * Returns: The new right sibling of n if n was split, otherwise NULL.
+ */
+static struct node *insert_rec(table *t, struct node *n, void *key,
+			       void *value, void **sep)
+{
+	if (n->is_leaf) {
+		return leaf_insert(t, (struct leaf *)n, key, value, sep);
+	}
+
+	struct inner *in = (struct inner *)n;
+	int i = child_search(t, in, key);
+	void *child_sep;
+	struct node *sibling = insert_rec(t, in->children[i], key, value,
+					  &child_sep);
+	if (sibling == NULL) {
+		return NULL;
+	}
+
+	// Put the new child and its separator right after child i. The
+	// arrays have room for one extra child only if not full, so split
+	// first when needed.
+	struct inner *target = in;
+	struct inner *right = NULL;
+	if (in->hdr.count == (int)INNER_KEYS) {
+		right = (struct inner *)node_alloc(false);
+		int half = (in->hdr.count + 1) / 2;
+		// Children [half, count] move to the right node.
+		for (int j = half; j <= in->hdr.count; j++) {
+			right->children[j - half] = in->children[j];
+		}
+		right->hdr.count = in->hdr.count - half;
+		in->hdr.count = half - 1;
+		fix_separators(right);
+		if (i >= half) {
+			target = right;
+			i -= half;
+		}
+	}
+	for (int j = target->hdr.count; j > i; j--) {
+		target->keys[j] = target->keys[j - 1];
+		target->children[j + 1] = target->children[j];
+	}
+	target->keys[i] = child_sep;
+	target->children[i + 1] = sibling;
+	target->hdr.count++;
+
+	if (right == NULL) {
+		return NULL;
+	}
+	*sep = subtree_min((struct node *)right);
+	return (struct node *)right;
+}
+
+/**
+ * free_pairs() - Free a pair and all older duplicates of its key.
+ * @t: Table the pair belongs to.
+ * @key, @value: The latest pair.
+ * @older: Chain of older duplicates.
+ *
+ * Calls any free functions set for keys/values and deallocates the
+ * duplicate chain.
+ *
+ * Returns: Nothing.
+ */
+static void free_pairs(const table *t, void *key, void *value,
+		       struct table_entry *older)
+{
+	if (t->key_free_func != NULL) {
+		t->key_free_func(key);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(value);
+	}
+	while (older != NULL) {
+		struct table_entry *next = older->next;
+		if (t->key_free_func != NULL) {
+			t->key_free_func(older->key);
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(older->value);
+		}
+		free(older);
+		older = next;
+	}
+}
+
+/**
+ * node_underflows() - Check if a node has too few keys.
+ * @n: Node to check. Must not be the root.
+ *
+ * Returns: True if the node must borrow from or merge with a sibling.
+ */
+static bool node_underflows(const struct node *n)
+{
+	if (n->is_leaf) {
+		return n->count < (int)LEAF_MIN;
+	}
+	return n->count < (int)INNER_MIN;
+}
+
+/**
+ * node_can_lend() - Check if a node can give one key to a sibling.
+ * @n: Node to check.
+ *
+ * Returns: True if the node has more keys than the minimum.
+ */
+static bool node_can_lend(const struct node *n)
+{
+	if (n->is_leaf) {
+		return n->count > (int)LEAF_MIN;
+	}
+	return n->count > (int)INNER_MIN;
+}
+
+/**
+ * move_last_to_front() - Move the last entry of a node to its right
+ *			  sibling.
+ * @from: Left node.
+ * @to: Right node, of the same kind as from.
+ *
+ * Returns: Nothing.
+ */
+static void move_last_to_front(struct node *from, struct node *to)
+{
+	if (from->is_leaf) {
+		struct leaf *l = (struct leaf *)from;
+		struct leaf *r = (struct leaf *)to;
+		int last = l->hdr.count - 1;
+		leaf_insert_at(r, 0, l->keys[last], l->values[last]);
+		r->older[0] = l->older[last];
+		l->hdr.count--;
+	} else {
+		struct inner *l = (struct inner *)from;
+		struct inner *r = (struct inner *)to;
+		for (int j = r->hdr.count + 1; j > 0; j--) {
+			r->children[j] = r->children[j - 1];
+		}
+		r->children[0] = l->children[l->hdr.count];
+		r->hdr.count++;
+		l->hdr.count--;
+		fix_separators(r);
+	}
+}
+
+/**
+ * move_first_to_back() - Move the first entry of a node to its left
+ *			  sibling.
+ * @from: Right node.
+ * @to: Left node, of the same kind as from.
+ *
+ * Returns: Nothing.
+ */
+static void move_first_to_back(struct node *from, struct node *to)
+{
+	if (from->is_leaf) {
+		struct leaf *r = (struct leaf *)from;
+		struct leaf *l = (struct leaf *)to;
+		int n = l->hdr.count;
+		l->keys[n] = r->keys[0];
+		l->values[n] = r->values[0];
+		l->older[n] = r->older[0];
+		l->hdr.count++;
+		for (int j = 1; j < r->hdr.count; j++) {
+			r->keys[j - 1] = r->keys[j];
+			r->values[j - 1] = r->values[j];
+			r->older[j - 1] = r->older[j];
+		}
+		r->hdr.count--;
+	} else {
+		struct inner *r = (struct inner *)from;
+		struct inner *l = (struct inner *)to;
+		l->children[l->hdr.count + 1] = r->children[0];
+		l->hdr.count++;
+		for (int j = 1; j <= r->hdr.count; j++) {
+			r->children[j - 1] = r->children[j];
+		}
+		r->hdr.count--;
+		fix_separators(l);
+		fix_separators(r);
+	}
+}
+
+/**
+ * merge_nodes() - Move all entries of a node into its left sibling.
+ * @l: Left node.
+ * @r: Right node, of the same kind as l. Deallocated.
+ *
+ * Returns: Nothing.
+ */
+static void merge_nodes(struct node *l, struct node *r)
+{
+	if (l->is_leaf) {
+		struct leaf *ll = (struct leaf *)l;
+		struct leaf *rl = (struct leaf *)r;
+		for (int j = 0; j < rl->hdr.count; j++) {
+			ll->keys[ll->hdr.count + j] = rl->keys[j];
+			ll->values[ll->hdr.count + j] = rl->values[j];
+			ll->older[ll->hdr.count + j] = rl->older[j];
+		}
+		ll->hdr.count += rl->hdr.count;
+		ll->next = rl->next;
+	} else {
+		struct inner *li = (struct inner *)l;
+		struct inner *ri = (struct inner *)r;
+		for (int j = 0; j <= ri->hdr.count; j++) {
+			li->children[li->hdr.count + 1 + j] = ri->children[j];
+		}
+		li->hdr.count += ri->hdr.count + 1;
+		fix_separators(li);
+	}
+	free(r);
+}
+
+/**
+ * rebalance() - Fix an underflowing child of an inner node.
+ * @n: Parent node.
+ * @i: Index of the child that underflows.
+ *
+ * Borrows an entry from a sibling that can lend one, or else merges
+ * the child with a sibling.
+ *
+ * Returns: Nothing.
+ */
+static void rebalance(struct inner *n, int i)
+{
+	struct node *child = n->children[i];
+	struct node *left = i > 0 ? n->children[i - 1] : NULL;
+	struct node *right = i < n->hdr.count ? n->children[i + 1] : NULL;
+
+	if (left != NULL && node_can_lend(left)) {
+		move_last_to_front(left, child);
+	} else if (right != NULL && node_can_lend(right)) {
+		move_first_to_back(right, child);
+	} else {
+		// Merge the right one of two neighbours into the left one.
+		int r = left != NULL ? i : i + 1;
+		merge_nodes(n->children[r - 1], n->children[r]);
+		for (int j = r; j < n->hdr.count; j++) {
+			n->children[j] = n->children[j + 1];
+		}
+		n->hdr.count--;
+	}
+}
+
+/**
+ * remove_rec() - Remove a key and its duplicates from a subtree.
+ * @t: Table to manipulate.
+ * @n: Root of the subtree.
+ * @key: Key to remove.
+ *
+ * The key is not compared with anything once the pairs have been
+ * freed, so it may point to the same memory as one of the freed keys.
+ *
+ * Returns: True if the key was found and removed.
+ */
+static bool remove_rec(table *t, struct node *n, const void *key)
+{
+	if (n->is_leaf) {
+		struct leaf *l = (struct leaf *)n;
+		int i = leaf_search(t, l, key);
+		if (i == l->hdr.count
+		    || TABLE_KEY_CMP(t, l->keys[i], key) != 0) {
+			return false;
+		}
+		free_pairs(t, l->keys[i], l->values[i], l->older[i]);
+		for (int j = i + 1; j < l->hdr.count; j++) {
+			l->keys[j - 1] = l->keys[j];
+			l->values[j - 1] = l->values[j];
+			l->older[j - 1] = l->older[j];
+		}
+		l->hdr.count--;
+		return true;
+	}
+
+	struct inner *in = (struct inner *)n;
+	int i = child_search(t, in, key);
+	if (!remove_rec(t, in->children[i], key)) {
+		return false;
+	}
+	if (node_underflows(in->children[i])) {
+		rebalance(in, i);
+	}
+	// The removed key may have been the smallest of its subtree.
+	fix_separators(in);
+	return true;
+}
+
+/**
+ * kill_rec() - Deallocate a subtree and all pairs in it.
+ * @t: Table the subtree belongs to.
+ * @n: Root of the subtree.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * Returns: Nothing.
+ */
+static void kill_rec(const table *t, struct node *n,
+		     consume_callback_pair func)
+{
+	if (n->is_leaf) {
+		struct leaf *l = (struct leaf *)n;
+		for (int i = 0; i < l->hdr.count; i++) {
+			if (func == NULL) {
+				free_pairs(t, l->keys[i], l->values[i],
+					   l->older[i]);
+				continue;
+			}
+			func(l->keys[i], l->values[i]);
+			struct table_entry *older = l->older[i];
+			while (older != NULL) {
+				struct table_entry *next = older->next;
+				func(older->key, older->value);
+				free(older);
+				older = next;
+			}
+		}
+	} else {
+		struct inner *in = (struct inner *)n;
+		for (int i = 0; i <= in->hdr.count; i++) {
+			kill_rec(t, in->children[i], func);
+		}
+	}
+	free(n);
+}
+
+/**
+ * empty_tree() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * Returns: Nothing.
+ */
+static void empty_tree(table *t, consume_callback_pair func)
+{
+	kill_rec(t, t->root, func);
+	t->root = node_alloc(true);
+}
+
+/**
+ * first_leaf() - Return the leftmost leaf of a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The leaf holding the smallest keys.
+ */
+static struct leaf *first_leaf(const table *t)
+{
+	struct node *n = t->root;
+
+	while (!n->is_leaf) {
+		n = ((struct inner *)n)->children[0];
+	}
+	return (struct leaf *)n;
+}
+
+/**
+ * normalize_pos() - Move a position past the end of a leaf to the
+ *		     start of the next non-empty leaf.
+ * @l: Leaf of the position.
+ * @i: Index in the leaf.
+ *
+ * Returns: A position that is either at a key or the end position.
+ */
+static table_pos normalize_pos(struct leaf *l, int i)
+{
+	while (l != NULL && i >= l->hdr.count) {
+		l = l->next;
+		i = 0;
+	}
+	table_pos pos = { l, i };
+	return pos;
+}
+
+/**
+ * find_ge() - Find the position of the smallest key not less than key.
+ * @t: Table to inspect.
+ * @key: Key to compare with.
+ *
+ * Returns: The position, or the end position if there is no such key.
+ */
+static table_pos find_ge(const table *t, const void *key)
+{
+	struct leaf *l = find_leaf(t, key);
+
+	return normalize_pos(l, leaf_search(t, l, key));
+}
+
+/**
+ * visit_key() - Visit the pairs of a key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each pair of key, or NULL.
+ *
+ * Only the leaf entry of key and its chain of older duplicates are
+ * examined after the descent. Counted as a lookup by table_stats().
+ *
+ * Returns: The number of pairs of key.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+	struct leaf *l = find_leaf(t, key);
+	int i = leaf_search(t, l, key);
+
+	if (i == l->hdr.count || TABLE_KEY_CMP(t, l->keys[i], key) != 0) {
+		TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, false);
+		return 0;
+	}
+	TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, true);
+
+	unsigned long n = 1;
+	if (func != NULL) {
+		func(l->keys[i], l->values[i]);
+	}
+	for (struct table_entry *e = l->older[i]; e != NULL; e = e->next) {
+		n++;
+		if (func != NULL) {
+			func(e->key, e->value);
+		}
+	}
+	return n;
+}
+
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	// Allocate the table header.
+	table *t = calloc(1, sizeof(*t));
+	// The tree starts out as a single empty leaf.
+	t->root = node_alloc(true);
+	// Store the key compare function and key/value free functions.
+	t->key_cmp_func = key_cmp_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	TABLE_STATS_INIT(t);
+
+	return t;
+}
+
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the tree is ordered by key_cmp_func.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the tree is ordered by key_cmp_func.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: TABLE_UNIQUE_KEYS or 0.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	table *t = table_empty(key_cmp_func, key_free_func, value_free_func);
+
+	t->unique_keys = (flags & TABLE_UNIQUE_KEYS) != 0;
+	return t;
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @table: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	// Only the root can be an empty node.
+	return t->root->is_leaf && t->root->count == 0;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @table: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key is already
+ * present, the previous pair is kept as an older duplicate.
+ * table_lookup() will return the latest added value for a duplicate
+ * key. table_remove() will remove all duplicates for a given key. If
+ * the table was created with TABLE_UNIQUE_KEYS, the previous pair is
+ * replaced instead.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+	void *sep;
+	struct node *sibling = insert_rec(t, t->root, key, value, &sep);
+
+	TABLE_STATS_INSERT(t, TABLE_STATS_COMPARES(t) - mark);
+
+	if (sibling != NULL) {
+		// The root was split. Grow the tree by one level.
+		struct inner *root = (struct inner *)node_alloc(false);
+		root->children[0] = t->root;
+		root->children[1] = sibling;
+		root->keys[0] = sep;
+		root->hdr.count = 1;
+		t->root = (struct node *)root;
+	}
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @table: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table. If the table contains duplicate keys,
+ * the value that was latest inserted will be returned.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+	struct leaf *l = find_leaf(t, key);
+	int i = leaf_search(t, l, key);
+
+	if (i == l->hdr.count || TABLE_KEY_CMP(t, l->keys[i], key) != 0) {
+		TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, false);
+		return NULL;
+	}
+	TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, true);
+	return l->values[i];
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The pairs are visited latest inserted first. Only the leaf entry of
+ * the key and its chain of older duplicates are examined after the
+ * descent.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	// Return the smallest key.
+	return first_leaf(t)->keys[0];
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @table: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Any matching duplicates will be removed. Will call any free
+ * functions set for keys/values. Does nothing if key is not found in
+ * the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+	bool found = remove_rec(t, t->root, key);
+
+	TABLE_STATS_REMOVE(t, TABLE_STATS_COMPARES(t) - mark);
+	if (!found) {
+		return;
+	}
+	struct node *root = t->root;
+	if (!root->is_leaf && root->count == 0) {
+		// The root has a single child left. Shrink the tree.
+		t->root = ((struct inner *)root)->children[0];
+		free(root);
+	}
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @table: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	kill_rec(t, t->root, NULL);
+	TABLE_STATS_FREE(t);
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_tree(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table,
+ *	  including duplicates. Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_tree(t, func);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table in key order and
+ * prints them. Will print all stored elements, including duplicates.
+ * Duplicates are printed latest first.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	for (struct leaf *l = first_leaf(t); l != NULL; l = l->next) {
+		for (int i = 0; i < l->hdr.count; i++) {
+			print_func(l->keys[i], l->values[i]);
+			for (struct table_entry *e = l->older[i]; e != NULL;
+			     e = e->next) {
+				print_func(e->key, e->value);
+			}
+		}
+	}
+}
+
+/**
+ * table_first() - Return the position of the smallest key in a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The first position in key order.
+ */
+table_pos table_first(const table *t)
+{
+	return normalize_pos(first_leaf(t), 0);
+}
+
+/**
+ * table_next() - Return the next position in key order.
+ * @t: Table to inspect.
+ * @pos: Any valid position except the end position.
+ *
+ * Returns: The position of the next larger key.
+ */
+table_pos table_next(const table *t, table_pos pos)
+{
+	return normalize_pos(pos.node, pos.index + 1);
+}
+
+/**
+ * table_is_end() - Check if a position is past the largest key.
+ * @t: Table to inspect.
+ * @pos: Any valid position.
+ *
+ * Returns: True if pos is the end position.
+ */
+bool table_is_end(const table *t, table_pos pos)
+{
+	return pos.node == NULL;
+}
+
+/**
+ * table_inspect_key() - Return the key at a position.
+ * @t: Table to inspect.
+ * @pos: Any valid position except the end position.
+ *
+ * Returns: The key stored at pos.
+ */
+void *table_inspect_key(const table *t, table_pos pos)
+{
+	const struct leaf *l = pos.node;
+
+	return l->keys[pos.index];
+}
+
+/**
+ * table_inspect_value() - Return the value at a position.
+ * @t: Table to inspect.
+ * @pos: Any valid position except the end position.
+ *
+ * Returns: The latest value stored for the key at pos.
+ */
+void *table_inspect_value(const table *t, table_pos pos)
+{
+	const struct leaf *l = pos.node;
+
+	return l->values[pos.index];
+}
+
+/**
+ * table_first_ge() - Find the smallest key not less than a given key.
+ * @t: Table to inspect.
+ * @key: Key to compare with.
+ *
+ * Returns: The smallest stored key that is greater than or equal to
+ * key, or NULL if there is no such key.
+ */
+void *table_first_ge(const table *t, const void *key)
+{
+	table_pos pos = find_ge(t, key);
+
+	if (table_is_end(t, pos)) {
+		return NULL;
+	}
+	return table_inspect_key(t, pos);
+}
+
+/**
+ * table_range() - Visit the pairs with keys in a half-open range.
+ * @t: Table to inspect.
+ * @lo: Smallest key to visit, or NULL to start at the smallest key.
+ * @hi: Key to stop before, or NULL to continue to the largest key.
+ * @func: Function called for each key/value pair in the range.
+ *
+ * Returns: Nothing.
+ */
+void table_range(const table *t, const void *lo, const void *hi,
+		 inspect_callback_pair func)
+{
+	table_pos pos = lo != NULL ? find_ge(t, lo) : table_first(t);
+
+	while (!table_is_end(t, pos)) {
+		void *key = table_inspect_key(t, pos);
+		if (hi != NULL && TABLE_KEY_CMP(t, key, hi) >= 0) {
+			break;
+		}
+		func(key, table_inspect_value(t, pos));
+		pos = table_next(t, pos);
+	}
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	struct node *nodes[BATCH_SIZE];
+	// Compares made for each key, kept apart since the keys of a
+	// batch are searched in turns.
+	unsigned long probes[BATCH_SIZE];
+
+	for (int first = 0; first < n; first += BATCH_SIZE) {
+		int m = n - first < BATCH_SIZE ? n - first : BATCH_SIZE;
+		for (int j = 0; j < m; j++) {
+			nodes[j] = t->root;
+			probes[j] = 0;
+		}
+		// All leaves are at the same depth, so every key of the
+		// batch reaches its leaf in the same pass.
+		while (!nodes[0]->is_leaf) {
+			for (int j = 0; j < m; j++) {
+				struct inner *in = (struct inner *)nodes[j];
+				unsigned long mark = TABLE_STATS_COMPARES(t);
+				int i = child_search(t, in, keys[first + j]);
+				probes[j] += TABLE_STATS_COMPARES(t) - mark;
+				nodes[j] = in->children[i];
+				prefetch_node(nodes[j]);
+			}
+		}
+		for (int j = 0; j < m; j++) {
+			struct leaf *l = (struct leaf *)nodes[j];
+			const void *key = keys[first + j];
+			unsigned long mark = TABLE_STATS_COMPARES(t);
+			int i = leaf_search(t, l, key);
+			if (i == l->hdr.count
+			    || TABLE_KEY_CMP(t, l->keys[i], key) != 0) {
+				values[first + j] = NULL;
+			} else {
+				values[first + j] = l->values[i];
+			}
+			probes[j] += TABLE_STATS_COMPARES(t) - mark;
+			TABLE_STATS_LOOKUP(t, probes[j],
+					   values[first + j] != NULL);
+		}
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of an operation is the number of keys it compared
+ * on its way from the root to the leaf of the key, including the
+ * compare that decides if the key is in the leaf.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
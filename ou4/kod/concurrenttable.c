@@ -0,0 +1,809 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#include "table.h"
+#include "table_stats.h"
+
+/*
+ * Implementation of a generic table that can be shared by several
+ * threads. The table is split into STRIPES independent hash tables
+ * with separate chaining, each protected by its own mutex. A key
+ * always belongs to the stripe given by the top bits of its hash, so
+ * insert, lookup and remove of a key lock exactly one stripe and are
+ * linearizable, while operations on keys in different stripes run in
+ * parallel. Each stripe doubles its bucket array on its own when it
+ * has more pairs than buckets.
+ *
+ * Duplicates are handled by insert. New pairs are put first in their
+ * bucket, so lookup finds the latest inserted pair of a key first.
+ * Tables created with TABLE_UNIQUE_KEYS replace the pair of a key
+ * already in the bucket instead, and remove stops at the first match.
+ *
+ * table_is_empty(), table_choose_key(), table_print(), table_clear()
+ * and table_drain() lock one stripe at a time, so they only see a
+ * consistent table if no other thread modifies it meanwhile.
+ * table_lookup_all() calls its function with the stripe of the key
+ * locked, so the function must not use the table. table_kill() must
+ * only be called when no other thread uses the table. The free
+ * functions are called after the stripe is unlocked, so they may be
+ * slow without blocking other threads.
+ *
+ * Tables created without a hash function keep all pairs in a single
+ * list behind one lock.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added table_stats().
+ *   2026-10-17: v1.2, added table_empty_ex().
+ *   2026-10-17: v1.3, added table_clear() and table_drain().
+ *   2026-10-17: v1.4, added table_lookup_all() and table_count().
+ *   2026-10-18: v1.5, each stripe fills whole cache lines.
+ */
+
+#define CACHE_LINE 64
+
+// Aligns a type to CACHE_LINE, which also rounds its size up to a
+// multiple of CACHE_LINE.
+#ifdef __GNUC__
+#define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE)))
+#else
+#define CACHE_ALIGNED
+#endif
+
+// Number of stripes. Must be a power of two.
+#define STRIPES 64
+
+// Number of hash bits used to choose the stripe, log2(STRIPES).
+#define STRIPE_BITS 6
+
+// Number of buckets in each stripe of a new table. Must be a power of
+// two.
+#define INITIAL_BUCKETS 4
+
+// ===========INTERNAL DATA TYPES============
+
+struct table_entry {
+	unsigned long long hash;
+	void *key;
+	void *value;
+	struct table_entry *next;
+};
+
+// One lock and the pairs it protects, kept on cache lines of its own
+// so that threads using different stripes do not share cache lines.
+// The stripe array is allocated aligned to CACHE_LINE, so each stripe
+// starts on a cache line of its own.
+struct table_stripe {
+	pthread_mutex_t lock;
+	struct table_entry **buckets;
+	// Number of buckets, always a power of two.
+	unsigned long capacity;
+	// Number of stored pairs, including duplicates.
+	unsigned long size;
+#ifdef TABLE_STATS
+	// Statistics of the operations on the stripe, kept under the lock.
+	table_statistics *stats;
+#endif
+#ifndef __GNUC__
+	// Without CACHE_ALIGNED, at least keep the locks of neighbouring
+	// stripes on different cache lines.
+	char padding[CACHE_LINE];
+#endif
+} CACHE_ALIGNED;
+
+struct table {
+	struct table_stripe *stripes;
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	free_function key_free_func;
+	free_function value_free_func;
+	// True if created with TABLE_UNIQUE_KEYS.
+	bool unique_keys;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * mix() - Spread the bits of a hash value.
+ * @x: Value to mix.
+ *
+ * Uses the finalizer of MurmurHash3.
+ *
+ * Returns: The mixed value.
+ */
+static unsigned long long mix(unsigned long long x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+/**
+ * key_hash() - Compute the hash of a key.
+ * @t: Table the key belongs to.
+ * @key: Key to hash.
+ *
+ * Returns: The mixed hash value of the key, or 0 if the table has no
+ * hash function.
+ */
+static unsigned long long key_hash(const table *t, const void *key)
+{
+	if (t->key_hash_func == NULL) {
+		return 0;
+	}
+	return mix(t->key_hash_func(key));
+}
+
+/**
+ * stripe_of() - Find the stripe a hash belongs to.
+ * @t: Table to inspect.
+ * @h: Hash value from key_hash().
+ *
+ * Returns: Pointer to the stripe.
+ */
+static struct table_stripe *stripe_of(const table *t, unsigned long long h)
+{
+	return &t->stripes[h >> (64 - STRIPE_BITS)];
+}
+
+/**
+ * bucket_of() - Find the bucket a hash belongs to within its stripe.
+ * @s: Stripe to inspect.
+ * @h: Hash value from key_hash().
+ *
+ * Returns: Pointer to the first entry pointer of the bucket.
+ */
+static struct table_entry **bucket_of(const struct table_stripe *s,
+				      unsigned long long h)
+{
+	return &s->buckets[h & (s->capacity - 1)];
+}
+
+/**
+ * grow() - Double the number of buckets of a stripe.
+ * @s: Locked stripe to manipulate.
+ *
+ * Entries keep their relative order within each bucket, so the latest
+ * inserted pair of a key stays first.
+ *
+ * Returns: Nothing.
+ */
+static void grow(struct table_stripe *s)
+{
+	struct table_entry **old_buckets = s->buckets;
+	unsigned long old_capacity = s->capacity;
+
+	s->capacity = 2 * old_capacity;
+	s->buckets = calloc(s->capacity, sizeof(*s->buckets));
+
+	for (unsigned long i = 0; i < old_capacity; i++) {
+		// Every entry of old bucket i goes to bucket i or
+		// i + old_capacity, so appending keeps the order.
+		struct table_entry **tails[2] = {
+			&s->buckets[i], &s->buckets[i + old_capacity]
+		};
+		struct table_entry *e = old_buckets[i];
+		while (e != NULL) {
+			struct table_entry *next = e->next;
+			int high = (e->hash & old_capacity) != 0;
+			*tails[high] = e;
+			e->next = NULL;
+			tails[high] = &e->next;
+			e = next;
+		}
+	}
+	free(old_buckets);
+}
+
+/**
+ * compare_keys() - Compare two keys of a stripe.
+ * @t: Table the stripe belongs to.
+ * @s: Locked stripe the compare is made for.
+ * @a, @b: Keys to compare.
+ *
+ * Counts the compare in the statistics of the stripe, since the
+ * statistics of a table are kept per stripe.
+ *
+ * Returns: The result of the key compare function of the table.
+ */
+static int compare_keys(const table *t, struct table_stripe *s,
+			const void *a, const void *b)
+{
+#ifdef TABLE_STATS
+	s->stats->key_compares++;
+#endif
+	return t->key_cmp_func(a, b);
+}
+
+/**
+ * free_entries() - Free a list of unlinked entries.
+ * @t: Table the entries belonged to.
+ * @e: First entry of the list, or NULL.
+ *
+ * Calls the free functions of the table for each pair.
+ *
+ * Returns: Nothing.
+ */
+static void free_entries(const table *t, struct table_entry *e)
+{
+	while (e != NULL) {
+		struct table_entry *next = e->next;
+		if (t->key_free_func != NULL) {
+			t->key_free_func(e->key);
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(e->value);
+		}
+		free(e);
+		e = next;
+	}
+}
+
+/**
+ * empty_stripes() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * The bucket array of each stripe is swapped for an empty one under
+ * the lock of the stripe. The pairs of the old array are handed to
+ * func or freed after the stripe is unlocked.
+ *
+ * Returns: Nothing.
+ */
+static void empty_stripes(table *t, consume_callback_pair func)
+{
+	for (int i = 0; i < STRIPES; i++) {
+		struct table_stripe *s = &t->stripes[i];
+		struct table_entry **buckets =
+			calloc(INITIAL_BUCKETS, sizeof(*buckets));
+
+		pthread_mutex_lock(&s->lock);
+		struct table_entry **old = s->buckets;
+		unsigned long capacity = s->capacity;
+		s->buckets = buckets;
+		s->capacity = INITIAL_BUCKETS;
+		s->size = 0;
+		pthread_mutex_unlock(&s->lock);
+
+		for (unsigned long j = 0; j < capacity; j++) {
+			if (func == NULL) {
+				free_entries(t, old[j]);
+				continue;
+			}
+			struct table_entry *e = old[j];
+			while (e != NULL) {
+				struct table_entry *next = e->next;
+				func(e->key, e->value);
+				free(e);
+				e = next;
+			}
+		}
+		free(old);
+	}
+}
+
+/**
+ * visit_key() - Visit the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function to call for each pair, or NULL.
+ *
+ * Holds the lock of the stripe of the key while visiting.
+ *
+ * Returns: The number of pairs with the key.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	unsigned long long h = key_hash(t, key);
+	struct table_stripe *s = stripe_of(t, h);
+	unsigned long walked = 0;
+	unsigned long n = 0;
+
+	pthread_mutex_lock(&s->lock);
+	for (struct table_entry *e = *bucket_of(s, h); e != NULL;
+	     e = e->next) {
+		walked++;
+		if (e->hash == h && compare_keys(t, s, e->key, key) == 0) {
+			if (func != NULL) {
+				func(e->key, e->value);
+			}
+			n++;
+			if (t->unique_keys) {
+				break;
+			}
+		}
+	}
+	TABLE_STATS_LOOKUP(s, walked, n > 0);
+	pthread_mutex_unlock(&s->lock);
+	return n;
+}
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Without a hash function all pairs share one stripe and bucket.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return table_empty_hashed(key_cmp_func, NULL, key_free_func,
+				  value_free_func);
+}
+
+/**
+ * table_empty_hashed() - Create an empty table that hashes its keys.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys, or
+ *		   NULL.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	table *t = malloc(sizeof(*t));
+	void *p = NULL;
+
+	if (posix_memalign(&p, CACHE_LINE, STRIPES * sizeof(*t->stripes))
+	    != 0) {
+		free(t);
+		return NULL;
+	}
+	t->stripes = p;
+	for (int i = 0; i < STRIPES; i++) {
+		struct table_stripe *s = &t->stripes[i];
+		pthread_mutex_init(&s->lock, NULL);
+		s->capacity = INITIAL_BUCKETS;
+		s->buckets = calloc(s->capacity, sizeof(*s->buckets));
+		s->size = 0;
+		TABLE_STATS_INIT(s);
+	}
+	t->key_cmp_func = key_cmp_func;
+	t->key_hash_func = key_hash_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	t->unique_keys = false;
+	return t;
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys, or
+ *		   NULL.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: TABLE_UNIQUE_KEYS or 0.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	table *t = table_empty_hashed(key_cmp_func, key_hash_func,
+				      key_free_func, value_free_func);
+
+	if (t != NULL) {
+		t->unique_keys = (flags & TABLE_UNIQUE_KEYS) != 0;
+	}
+	return t;
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	for (int i = 0; i < STRIPES; i++) {
+		struct table_stripe *s = &t->stripes[i];
+		pthread_mutex_lock(&s->lock);
+		unsigned long size = s->size;
+		pthread_mutex_unlock(&s->lock);
+		if (size > 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. No test is performed to
+ * check if key is a duplicate. table_lookup() will return the latest
+ * added value for a duplicate key. table_remove() will remove all
+ * duplicates for a given key. If the table was created with
+ * TABLE_UNIQUE_KEYS, the pair of a key already in the table is
+ * replaced instead.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	unsigned long long h = key_hash(t, key);
+	struct table_stripe *s = stripe_of(t, h);
+	struct table_entry *e = malloc(sizeof(*e));
+	unsigned long walked = 0;
+	bool replaced = false;
+
+	e->hash = h;
+	e->key = key;
+	e->value = value;
+
+	pthread_mutex_lock(&s->lock);
+	if (t->unique_keys) {
+		// Swap the new pair into a matching entry, so that e holds
+		// the replaced pair when the stripe is unlocked.
+		for (struct table_entry *old = *bucket_of(s, h); old != NULL;
+		     old = old->next) {
+			walked++;
+			if (old->hash == h
+			    && compare_keys(t, s, old->key, key) == 0) {
+				e->key = old->key;
+				e->value = old->value;
+				old->key = key;
+				old->value = value;
+				replaced = true;
+				break;
+			}
+		}
+	}
+	if (!replaced) {
+		if (s->size >= s->capacity && t->key_hash_func != NULL) {
+			grow(s);
+		}
+		struct table_entry **bucket = bucket_of(s, h);
+		e->next = *bucket;
+		*bucket = e;
+		s->size++;
+	}
+	TABLE_STATS_INSERT(s, walked);
+	pthread_mutex_unlock(&s->lock);
+
+	if (replaced) {
+		if (t->key_free_func != NULL && e->key != key) {
+			t->key_free_func(e->key);
+		}
+		if (t->value_free_func != NULL && e->value != value) {
+			t->value_free_func(e->value);
+		}
+		free(e);
+	}
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table. If the table contains duplicate keys,
+ * the value that was latest inserted will be returned.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	unsigned long long h = key_hash(t, key);
+	struct table_stripe *s = stripe_of(t, h);
+	void *value = NULL;
+	unsigned long walked = 0;
+	bool found = false;
+
+	pthread_mutex_lock(&s->lock);
+	for (struct table_entry *e = *bucket_of(s, h); e != NULL;
+	     e = e->next) {
+		walked++;
+		if (e->hash == h && compare_keys(t, s, e->key, key) == 0) {
+			value = e->value;
+			found = true;
+			break;
+		}
+	}
+	TABLE_STATS_LOOKUP(s, walked, found);
+	pthread_mutex_unlock(&s->lock);
+	return value;
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The pairs are visited latest inserted first, so the first value
+ * equals the one returned by table_lookup(). The stripe of the key is
+ * locked during the visit, so func must not use the table.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	for (int i = 0; i < STRIPES; i++) {
+		struct table_stripe *s = &t->stripes[i];
+		void *key = NULL;
+		pthread_mutex_lock(&s->lock);
+		for (unsigned long j = 0; j < s->capacity && key == NULL;
+		     j++) {
+			if (s->buckets[j] != NULL) {
+				key = s->buckets[j]->key;
+			}
+		}
+		pthread_mutex_unlock(&s->lock);
+		if (key != NULL) {
+			return key;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Any matching duplicates will be removed. Will call any free
+ * functions set for keys/values. Does nothing if key is not found in
+ * the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	unsigned long long h = key_hash(t, key);
+	struct table_stripe *s = stripe_of(t, h);
+	struct table_entry *removed = NULL;
+	unsigned long walked = 0;
+
+	pthread_mutex_lock(&s->lock);
+	struct table_entry **p = bucket_of(s, h);
+	while (*p != NULL) {
+		struct table_entry *e = *p;
+		walked++;
+		// The key may point into a removed pair, so nothing is
+		// freed until the whole bucket has been searched.
+		if (e->hash == h && compare_keys(t, s, e->key, key) == 0) {
+			*p = e->next;
+			e->next = removed;
+			removed = e;
+			s->size--;
+			if (t->unique_keys) {
+				// There are no more matches.
+				break;
+			}
+		} else {
+			p = &e->next;
+		}
+	}
+	TABLE_STATS_REMOVE(s, walked);
+	pthread_mutex_unlock(&s->lock);
+
+	free_entries(t, removed);
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values. No other thread may use the table.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	for (int i = 0; i < STRIPES; i++) {
+		struct table_stripe *s = &t->stripes[i];
+		for (unsigned long j = 0; j < s->capacity; j++) {
+			free_entries(t, s->buckets[j]);
+		}
+		free(s->buckets);
+		TABLE_STATS_FREE(s);
+		pthread_mutex_destroy(&s->lock);
+	}
+	free(t->stripes);
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_stripes(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table,
+ *	  including duplicates. Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_stripes(t, func);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table and prints them.
+ * Will print all stored elements, including duplicates. Each stripe
+ * is locked while its pairs are printed, so print_func must not use
+ * the table.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	for (int i = 0; i < STRIPES; i++) {
+		struct table_stripe *s = &t->stripes[i];
+		pthread_mutex_lock(&s->lock);
+		for (unsigned long j = 0; j < s->capacity; j++) {
+			for (struct table_entry *e = s->buckets[j]; e != NULL;
+			     e = e->next) {
+				print_func(e->key, e->value);
+			}
+		}
+		pthread_mutex_unlock(&s->lock);
+	}
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Each pair is inserted as by table_insert(), so other threads may see
+ * some of the pairs before all are inserted.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Each key is looked up as by table_lookup().
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Each key is removed as by table_remove().
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The statistics are kept per stripe and added up here, locking one
+ * stripe at a time. The probe length of a lookup or remove is the
+ * number of entries it walked in its bucket. Inserts put the new pair
+ * first in its bucket and have probe length 0, except in tables with
+ * unique keys where they look for the key first.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	table_stats_get(NULL, out);
+#ifdef TABLE_STATS
+	out->enabled = true;
+	for (int i = 0; i < STRIPES; i++) {
+		struct table_stripe *s = &t->stripes[i];
+		pthread_mutex_lock(&s->lock);
+		table_stats_merge(out, s->stats);
+		pthread_mutex_unlock(&s->lock);
+	}
+	table_stats_finish(out);
+#endif
+}
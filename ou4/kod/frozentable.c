@@ -0,0 +1,855 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "table.h"
+#include "frozentable.h"
+
+/*
+ * Implementation of read-only tables placed by a minimal perfect hash
+ * function. Works with any implementation of table.h.
+ *
+ * The hash function is built by hash and displace. The keys are split
+ * into buckets of about KEYS_PER_BUCKET keys each by their hash value.
+ * Starting with the largest bucket, each bucket gets the smallest
+ * seed that sends all its keys to slots that are still free. Buckets
+ * with a single key are placed last and store the index of a free
+ * slot directly, as a negative seed. A lookup hashes the key, reads
+ * the seed of its bucket and compares the key with the one slot that
+ * the seed selects.
+ *
+ * Distinct keys with the same user hash value can not be separated by
+ * any seed. All but the first of them are kept in an overflow array
+ * after the slots, which a lookup only scans when the key in the slot
+ * has the same hash value as the key looked up but is not equal to it.
+ *
+ * The slots refer to keys and values by pointers stored as integers,
+ * or by offsets from the start of the file for a loaded table, so the
+ * same lookup works on both.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-18: v1.1, the state of table_freeze() is kept per thread.
+ */
+
+// Average number of keys per bucket. Fewer keys per bucket make the
+// seeds easier to find but take more memory.
+#define KEYS_PER_BUCKET 4
+
+// Largest seed tried for a bucket before the number of buckets is
+// doubled and all seeds are searched again.
+#define MAX_SEED (1 << 20)
+
+// Multiplier that spreads the seeds over all 64 bits.
+#define SEED_MULTIPLIER 0x9e3779b97f4a7c15ULL
+
+// Identifies a file written by frozen_table_save(), and its format
+// version.
+#define IMAGE_MAGIC "DOAFROZN"
+#define IMAGE_VERSION 1
+
+// Written in the byte order of the saving machine, to detect files
+// from machines with another byte order.
+#define IMAGE_BYTE_ORDER 0x0102030405060708ULL
+
+// Alignment of the keys and values in a saved file.
+#define IMAGE_ALIGN 16
+
+// ===========INTERNAL DATA TYPES============
+
+struct frozen_slot {
+	// User hash value of the key.
+	uint64_t hash;
+	// Pointers, or offsets in the mapped file with 0 for NULL.
+	uint64_t key;
+	uint64_t value;
+};
+
+// Start of a file written by frozen_table_save(). All offsets are from
+// the start of the file, and offset 0 stands for NULL.
+struct frozen_image {
+	char magic[8];
+	uint64_t version;
+	uint64_t byte_order;
+	uint64_t size;
+	uint64_t buckets;
+	uint64_t overflow;
+	uint64_t seeds_offset;
+	uint64_t slots_offset;
+	uint64_t file_size;
+};
+
+struct frozen_table {
+	// Number of slots placed by the hash function.
+	uint64_t size;
+	// Number of buckets, i.e. seeds.
+	uint64_t buckets;
+	// Number of slots in the overflow array after the placed slots.
+	uint64_t overflow;
+	const int32_t *seeds;
+	const struct frozen_slot *slots;
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	free_function key_free_func;
+	free_function value_free_func;
+	// Mapped file of a loaded table, or NULL, and its mapped size.
+	const struct frozen_image *image;
+	size_t image_size;
+};
+
+// A key of the table being frozen.
+struct build_key {
+	uint64_t hash;
+	void *key;
+};
+
+// State of table_freeze(), used by the callbacks it gives to the table.
+struct freeze_state {
+	// Keys of the table, later only the distinct ones.
+	struct build_key *keys;
+	size_t n_keys;
+	size_t capacity;
+	// Table under construction and which of its slots own their pair.
+	frozen_table *f;
+	bool *claimed;
+	// Pairs not taken over by the frozen table, freed after the drain.
+	void **discarded;
+	size_t n_discarded;
+	size_t discard_capacity;
+};
+
+// Output of frozen_table_save() while it writes the keys and values.
+struct save_state {
+	FILE *f;
+	// Offset in the file of the next key or value.
+	uint64_t pos;
+	// Buffer for the serializers and its size.
+	void *buf;
+	size_t size;
+	bool failed;
+};
+
+// State of the table_freeze() in progress, for the callbacks it gives
+// to the table, which take no context. With GCC each thread has its
+// own, so tables can be frozen by several threads at once. Otherwise
+// only one table may be frozen at a time.
+#ifdef __GNUC__
+static __thread struct freeze_state *freezing;
+#else
+static struct freeze_state *freezing;
+#endif
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * mix_hash() - Spread the bits of a hash value.
+ * @h: Value to mix.
+ *
+ * Uses the finalizer of MurmurHash3.
+ *
+ * Returns: The mixed value.
+ */
+static uint64_t mix_hash(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+/**
+ * reduce() - Map a mixed hash value to a range.
+ * @h: Mixed hash value.
+ * @n: Size of the range, less than 2^32.
+ *
+ * Multiplies the high half of h by n instead of dividing, which is
+ * much faster and just as uniform.
+ *
+ * Returns: A value in [0, n).
+ */
+static uint64_t reduce(uint64_t h, uint64_t n)
+{
+	return ((h >> 32) * n) >> 32;
+}
+
+/**
+ * bucket_of() - Find the bucket of a hash value.
+ * @h: User hash value of a key.
+ * @buckets: Number of buckets.
+ *
+ * Returns: The index of the bucket.
+ */
+static uint64_t bucket_of(uint64_t h, uint64_t buckets)
+{
+	return reduce(mix_hash(h), buckets);
+}
+
+/**
+ * slot_of() - Find the slot that a seed selects for a hash value.
+ * @h: User hash value of a key.
+ * @seed: Seed of the bucket of the key.
+ * @size: Number of placed slots.
+ *
+ * Returns: The index of the slot.
+ */
+static uint64_t slot_of(uint64_t h, int32_t seed, uint64_t size)
+{
+	if (seed < 0) {
+		return -(int64_t)seed - 1;
+	}
+	return reduce(mix_hash(h ^ ((uint64_t)seed * SEED_MULTIPLIER)),
+		      size);
+}
+
+/**
+ * pointer_of() - Convert a slot reference to a pointer.
+ * @f: Frozen table.
+ * @ref: Key or value of a slot.
+ *
+ * Returns: Pointer to the key or value.
+ */
+static void *pointer_of(const frozen_table *f, uint64_t ref)
+{
+	if (f->image == NULL) {
+		return (void *)(uintptr_t)ref;
+	}
+	if (ref == 0) {
+		return NULL;
+	}
+	return (char *)f->image + ref;
+}
+
+/**
+ * find_slot() - Find the slot holding a key.
+ * @f: Frozen table to inspect.
+ * @key: Key to look for.
+ *
+ * Returns: The index of the slot holding key, or -1 if key is not in
+ * the table.
+ */
+static int64_t find_slot(const frozen_table *f, const void *key)
+{
+	if (f->size == 0) {
+		return -1;
+	}
+	uint64_t h = f->key_hash_func(key);
+	int32_t seed = f->seeds[bucket_of(h, f->buckets)];
+	uint64_t i = slot_of(h, seed, f->size);
+
+	if (f->slots[i].hash != h) {
+		return -1;
+	}
+	if (f->key_cmp_func(pointer_of(f, f->slots[i].key), key) == 0) {
+		return i;
+	}
+	for (i = f->size; i < f->size + f->overflow; i++) {
+		if (f->slots[i].hash == h
+		    && f->key_cmp_func(pointer_of(f, f->slots[i].key),
+				       key) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * compare_build_keys() - Order keys by their hash value, for qsort().
+ * @a: First key.
+ * @b: Second key.
+ *
+ * Returns: A negative, zero or positive value as for compare_function.
+ */
+static int compare_build_keys(const void *a, const void *b)
+{
+	const struct build_key *ka = a;
+	const struct build_key *kb = b;
+
+	return (ka->hash > kb->hash) - (ka->hash < kb->hash);
+}
+
+/**
+ * collect_key() - Remember a key of the table being frozen.
+ * @key: Key of a pair.
+ * @value: Value of the pair, not used.
+ *
+ * Called by table_print() for each pair, including duplicates.
+ *
+ * Returns: Nothing.
+ */
+static void collect_key(const void *key, const void *value)
+{
+	struct freeze_state *st = freezing;
+
+	(void)value;
+	if (st->n_keys == st->capacity) {
+		st->capacity = 2 * st->capacity + 16;
+		st->keys = realloc(st->keys, st->capacity * sizeof(*st->keys));
+	}
+	struct build_key *k = &st->keys[st->n_keys++];
+	k->hash = st->f->key_hash_func(key);
+	// The keys stay owned by the table until it is drained.
+	k->key = (void *)key;
+}
+
+/**
+ * claim_pair() - Take over a pair drained from the table being frozen.
+ * @key: Key of the pair.
+ * @value: Value of the pair.
+ *
+ * The pair is stored in the slot of its key if its value is the one
+ * that table_lookup() returned for the key. Older duplicates are
+ * discarded.
+ *
+ * Returns: Nothing.
+ */
+static void claim_pair(void *key, void *value)
+{
+	struct freeze_state *st = freezing;
+	frozen_table *f = st->f;
+	int64_t i = find_slot(f, key);
+
+	if (i >= 0 && !st->claimed[i]
+	    && pointer_of(f, f->slots[i].value) == value) {
+		// Only table_freeze() writes to the slots.
+		struct frozen_slot *slot = (struct frozen_slot *)&f->slots[i];
+		slot->key = (uintptr_t)key;
+		st->claimed[i] = true;
+		return;
+	}
+	// The discarded keys may still be compared with, so they are freed
+	// after the drain.
+	if (st->n_discarded == st->discard_capacity) {
+		st->discard_capacity = 2 * st->discard_capacity + 16;
+		st->discarded = realloc(st->discarded, st->discard_capacity
+					* sizeof(*st->discarded));
+	}
+	st->discarded[st->n_discarded++] = key;
+	st->discarded[st->n_discarded++] = value;
+}
+
+/**
+ * place_buckets() - Search seeds for all buckets.
+ * @keys: Distinct keys to place, with distinct hash values.
+ * @n: Number of keys, and of slots.
+ * @buckets: Number of buckets.
+ * @seeds: Set to the seed of each bucket.
+ * @order: Set to the indices of the keys, sorted by bucket.
+ *
+ * Returns: true if all buckets were placed, false if some bucket needs
+ * a seed larger than MAX_SEED.
+ */
+static bool place_buckets(const struct build_key *keys, uint64_t n,
+			  uint64_t buckets, int32_t *seeds, uint64_t *order)
+{
+	// start[b] is the position in order of the first key of bucket b.
+	uint64_t *start = calloc(buckets + 1, sizeof(*start));
+	uint64_t *by_size = malloc(buckets * sizeof(*by_size));
+	uint64_t *slots = malloc(KEYS_PER_BUCKET * 4 * sizeof(*slots));
+	uint64_t max_size = KEYS_PER_BUCKET * 4;
+	bool *taken = calloc(n, sizeof(*taken));
+	bool placed = true;
+
+	for (uint64_t i = 0; i < n; i++) {
+		start[bucket_of(keys[i].hash, buckets) + 1]++;
+	}
+	for (uint64_t b = 0; b < buckets; b++) {
+		start[b + 1] += start[b];
+	}
+	uint64_t *next = malloc(buckets * sizeof(*next));
+	memcpy(next, start, buckets * sizeof(*next));
+	for (uint64_t i = 0; i < n; i++) {
+		order[next[bucket_of(keys[i].hash, buckets)]++] = i;
+	}
+	free(next);
+
+	// Sort the buckets by decreasing size with a counting sort.
+	uint64_t largest = 0;
+	for (uint64_t b = 0; b < buckets; b++) {
+		if (start[b + 1] - start[b] > largest) {
+			largest = start[b + 1] - start[b];
+		}
+	}
+	uint64_t *count = calloc(largest + 2, sizeof(*count));
+	for (uint64_t b = 0; b < buckets; b++) {
+		count[largest - (start[b + 1] - start[b]) + 1]++;
+	}
+	for (uint64_t s = 0; s <= largest; s++) {
+		count[s + 1] += count[s];
+	}
+	for (uint64_t b = 0; b < buckets; b++) {
+		by_size[count[largest - (start[b + 1] - start[b])]++] = b;
+	}
+	free(count);
+
+	uint64_t free_slot = 0;
+	for (uint64_t j = 0; j < buckets && placed; j++) {
+		uint64_t b = by_size[j];
+		uint64_t size = start[b + 1] - start[b];
+		const uint64_t *members = &order[start[b]];
+
+		seeds[b] = 0;
+		if (size == 0) {
+			continue;
+		}
+		if (size == 1) {
+			// Single keys go straight to a free slot.
+			while (taken[free_slot]) {
+				free_slot++;
+			}
+			taken[free_slot] = true;
+			seeds[b] = -(int32_t)free_slot - 1;
+			continue;
+		}
+		if (size > max_size) {
+			max_size = size;
+			slots = realloc(slots, max_size * sizeof(*slots));
+		}
+		int32_t seed;
+		for (seed = 1; seed <= MAX_SEED; seed++) {
+			uint64_t k;
+			for (k = 0; k < size; k++) {
+				slots[k] = slot_of(keys[members[k]].hash, seed, n);
+				if (taken[slots[k]]) {
+					break;
+				}
+				// Keep keys of the same bucket apart.
+				taken[slots[k]] = true;
+			}
+			if (k == size) {
+				break;
+			}
+			while (k-- > 0) {
+				taken[slots[k]] = false;
+			}
+		}
+		if (seed > MAX_SEED) {
+			placed = false;
+		} else {
+			seeds[b] = seed;
+		}
+	}
+
+	free(start);
+	free(by_size);
+	free(slots);
+	free(taken);
+	return placed;
+}
+
+/**
+ * build_slots() - Place the distinct keys of a table.
+ * @f: Frozen table to fill.
+ * @t: Table being frozen, used to look up the values.
+ * @st: State of the freeze, with the keys collected from t.
+ *
+ * Sorts st->keys by hash value and removes duplicate keys.
+ * Builds the seeds and slots of f, with the values that table_lookup()
+ * returns for the keys.
+ *
+ * Returns: Nothing.
+ */
+static void build_slots(frozen_table *f, const table *t,
+			struct freeze_state *st)
+{
+	struct build_key *keys = st->keys;
+	size_t n = st->n_keys;
+
+	if (n > 0) {
+		qsort(keys, n, sizeof(*keys), compare_build_keys);
+	}
+
+	// Move the first distinct key of each hash value to the front, and
+	// other distinct keys with the same hash value to overflow.
+	struct build_key *overflow = malloc((n + 1) * sizeof(*overflow));
+	uint64_t placed = 0;
+	uint64_t n_overflow = 0;
+	for (size_t i = 0; i < n;) {
+		size_t run = i;
+		keys[placed++] = keys[i];
+		uint64_t first_overflow = n_overflow;
+		for (i++; i < n && keys[i].hash == keys[run].hash; i++) {
+			bool seen = f->key_cmp_func(keys[placed - 1].key,
+						    keys[i].key) == 0;
+			for (uint64_t j = first_overflow;
+			     j < n_overflow && !seen; j++) {
+				seen = f->key_cmp_func(overflow[j].key,
+						       keys[i].key) == 0;
+			}
+			if (!seen) {
+				overflow[n_overflow++] = keys[i];
+			}
+		}
+	}
+
+	int32_t *seeds;
+	uint64_t *order = malloc((placed + 1) * sizeof(*order));
+	uint64_t buckets = (placed + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET;
+	if (buckets == 0) {
+		buckets = 1;
+	}
+	for (;;) {
+		seeds = calloc(buckets, sizeof(*seeds));
+		if (placed == 0 || place_buckets(keys, placed, buckets,
+						  seeds, order)) {
+			break;
+		}
+		free(seeds);
+		buckets = buckets < INT32_MAX / 2 ? 2 * buckets : INT32_MAX;
+	}
+	free(order);
+
+	struct frozen_slot *slots = calloc(placed + n_overflow + 1,
+					   sizeof(*slots));
+	for (uint64_t i = 0; i < placed; i++) {
+		int32_t seed = seeds[bucket_of(keys[i].hash, buckets)];
+		struct frozen_slot *slot = &slots[slot_of(keys[i].hash, seed,
+							  placed)];
+		slot->hash = keys[i].hash;
+		slot->key = (uintptr_t)keys[i].key;
+		slot->value = (uintptr_t)table_lookup(t, keys[i].key);
+	}
+	for (uint64_t i = 0; i < n_overflow; i++) {
+		struct frozen_slot *slot = &slots[placed + i];
+		slot->hash = overflow[i].hash;
+		slot->key = (uintptr_t)overflow[i].key;
+		slot->value = (uintptr_t)table_lookup(t, overflow[i].key);
+	}
+	free(overflow);
+
+	f->size = placed;
+	f->buckets = buckets;
+	f->overflow = n_overflow;
+	f->seeds = seeds;
+	f->slots = slots;
+}
+
+/**
+ * align_up() - Round an offset up to a multiple of an alignment.
+ * @offset: Offset to round.
+ * @alignment: Power of two to round to.
+ *
+ * Returns: The smallest multiple of alignment not less than offset.
+ */
+static uint64_t align_up(uint64_t offset, uint64_t alignment)
+{
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * save_object() - Write the bytes of a key or value to a saved file.
+ * @st: Output to write to.
+ * @p: Key or value to write, or NULL.
+ * @serializer: Function that writes the bytes of p.
+ *
+ * The bytes are padded to IMAGE_ALIGN. Sets st->failed if they could
+ * not be written.
+ *
+ * Returns: The offset of the bytes in the file, or 0 if p is NULL.
+ */
+static uint64_t save_object(struct save_state *st, const void *p,
+			    serialize_function *serializer)
+{
+	static const char padding[IMAGE_ALIGN];
+
+	if (p == NULL) {
+		return 0;
+	}
+	size_t n = serializer(p, st->buf, st->size);
+	if (n > st->size) {
+		st->buf = realloc(st->buf, n);
+		st->size = n;
+		serializer(p, st->buf, st->size);
+	}
+	size_t padded = align_up(n, IMAGE_ALIGN);
+	if (fwrite(st->buf, 1, n, st->f) != n
+	    || fwrite(padding, 1, padded - n, st->f) != padded - n) {
+		st->failed = true;
+	}
+	uint64_t offset = st->pos;
+	st->pos += padded;
+	return offset;
+}
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_freeze() - Convert a table into a frozen table.
+ * @t: Table to convert. It is destroyed.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on kill.
+ *
+ * The keys are collected with table_print() and placed while t still
+ * owns them. t is then drained, and each slot takes over the pair
+ * whose value is the one table_lookup() returned.
+ *
+ * Returns: Pointer to the frozen table.
+ */
+frozen_table *table_freeze(table *t, compare_function *key_cmp_func,
+			   hash_function *key_hash_func,
+			   free_function key_free_func,
+			   free_function value_free_func)
+{
+	frozen_table *f = calloc(1, sizeof(*f));
+	f->key_cmp_func = key_cmp_func;
+	f->key_hash_func = key_hash_func;
+	f->key_free_func = key_free_func;
+	f->value_free_func = value_free_func;
+
+	struct freeze_state st = { .f = f };
+
+	freezing = &st;
+	table_print(t, collect_key);
+	build_slots(f, t, &st);
+	free(st.keys);
+
+	st.claimed = calloc(f->size + f->overflow + 1, sizeof(*st.claimed));
+	table_drain(t, claim_pair);
+	freezing = NULL;
+	table_kill(t);
+	for (size_t i = 0; i < st.n_discarded; i += 2) {
+		if (key_free_func != NULL) {
+			key_free_func(st.discarded[i]);
+		}
+		if (value_free_func != NULL) {
+			value_free_func(st.discarded[i + 1]);
+		}
+	}
+	free(st.discarded);
+	free(st.claimed);
+	return f;
+}
+
+/**
+ * frozen_table_lookup() - Look up a given key in a frozen table.
+ * @f: Frozen table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *frozen_table_lookup(const frozen_table *f, const void *key)
+{
+	int64_t i = find_slot(f, key);
+
+	if (i < 0) {
+		return NULL;
+	}
+	return pointer_of(f, f->slots[i].value);
+}
+
+/**
+ * frozen_table_size() - Return the number of pairs in a frozen table.
+ * @f: Frozen table to inspect.
+ *
+ * Returns: The number of distinct keys.
+ */
+size_t frozen_table_size(const frozen_table *f)
+{
+	return f->size + f->overflow;
+}
+
+/**
+ * frozen_table_print() - Print the given frozen table.
+ * @f: Frozen table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * The pairs are visited in slot order.
+ *
+ * Returns: Nothing.
+ */
+void frozen_table_print(const frozen_table *f,
+			inspect_callback_pair print_func)
+{
+	for (uint64_t i = 0; i < f->size + f->overflow; i++) {
+		print_func(pointer_of(f, f->slots[i].key),
+			   pointer_of(f, f->slots[i].value));
+	}
+}
+
+/**
+ * frozen_table_kill() - Destroy a frozen table.
+ * @f: Frozen table to destroy.
+ *
+ * Returns: Nothing.
+ */
+void frozen_table_kill(frozen_table *f)
+{
+	if (f->image != NULL) {
+		munmap((void *)f->image, f->image_size);
+		free(f);
+		return;
+	}
+	for (uint64_t i = 0; i < f->size + f->overflow; i++) {
+		if (f->key_free_func != NULL) {
+			f->key_free_func(pointer_of(f, f->slots[i].key));
+		}
+		if (f->value_free_func != NULL) {
+			f->value_free_func(pointer_of(f, f->slots[i].value));
+		}
+	}
+	free((void *)f->seeds);
+	free((void *)f->slots);
+	free(f);
+}
+
+/**
+ * frozen_table_save() - Save a frozen table to a file.
+ * @f: Frozen table to save.
+ * @path: Name of the file to create or overwrite.
+ * @key_serializer: Function that writes the bytes of a key.
+ * @value_serializer: Function that writes the bytes of a value.
+ *
+ * The keys and values are written first, after room has been left for
+ * the header, seeds and slots, which are written last when the offsets
+ * of the keys and values are known. The seeds are saved as they are,
+ * so the loaded table needs the same hash function.
+ *
+ * Returns: 0 on success, -1 if the file could not be written.
+ */
+int frozen_table_save(const frozen_table *f, const char *path,
+		      serialize_function *key_serializer,
+		      serialize_function *value_serializer)
+{
+	uint64_t n = f->size + f->overflow;
+	struct frozen_image header = {
+		.version = IMAGE_VERSION,
+		.byte_order = IMAGE_BYTE_ORDER,
+		.size = f->size,
+		.buckets = f->buckets,
+		.overflow = f->overflow,
+	};
+	memcpy(header.magic, IMAGE_MAGIC, sizeof(header.magic));
+	header.seeds_offset = align_up(sizeof(header), 64);
+	header.slots_offset = align_up(header.seeds_offset
+				       + f->buckets * sizeof(*f->seeds), 64);
+	uint64_t slots_end = header.slots_offset
+		+ n * sizeof(struct frozen_slot);
+	uint64_t data_offset = align_up(slots_end, IMAGE_ALIGN);
+
+	struct save_state st = {
+		.f = fopen(path, "wb"),
+		.pos = data_offset,
+	};
+	if (st.f == NULL) {
+		return -1;
+	}
+	struct frozen_slot *slots = calloc(n + 1, sizeof(*slots));
+
+	if (fseeko(st.f, data_offset, SEEK_SET) != 0) {
+		st.failed = true;
+	}
+	for (uint64_t i = 0; i < n; i++) {
+		slots[i].hash = f->slots[i].hash;
+		slots[i].key = save_object(&st, pointer_of(f, f->slots[i].key),
+					   key_serializer);
+		slots[i].value = save_object(&st,
+					     pointer_of(f, f->slots[i].value),
+					     value_serializer);
+	}
+	header.file_size = st.pos > data_offset ? st.pos : slots_end;
+
+	if (fseeko(st.f, 0, SEEK_SET) != 0
+	    || fwrite(&header, sizeof(header), 1, st.f) != 1
+	    || fseeko(st.f, header.seeds_offset, SEEK_SET) != 0
+	    || fwrite(f->seeds, sizeof(*f->seeds), f->buckets, st.f)
+	    != f->buckets
+	    || fseeko(st.f, header.slots_offset, SEEK_SET) != 0
+	    || fwrite(slots, sizeof(*slots), n, st.f) != n) {
+		st.failed = true;
+	}
+	if (fclose(st.f) != 0) {
+		st.failed = true;
+	}
+	free(slots);
+	free(st.buf);
+
+	if (st.failed) {
+		remove(path);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * frozen_table_load_mapped() - Map a saved frozen table into memory.
+ * @path: Name of a file written by frozen_table_save().
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: The hash function of the saved table.
+ *
+ * The header is checked, but not the seeds, slots, keys and values.
+ *
+ * Returns: Pointer to the loaded table, or NULL if the file could not
+ * be mapped or was not written by frozen_table_save().
+ */
+frozen_table *frozen_table_load_mapped(const char *path,
+				       compare_function *key_cmp_func,
+				       hash_function *key_hash_func)
+{
+	struct stat st;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0) {
+		return NULL;
+	}
+	if (fstat(fd, &st) != 0
+	    || st.st_size < (off_t)sizeof(struct frozen_image)) {
+		close(fd);
+		return NULL;
+	}
+	size_t image_size = st.st_size;
+	void *p = mmap(NULL, image_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after the file is closed.
+	close(fd);
+	if (p == MAP_FAILED) {
+		return NULL;
+	}
+
+	const struct frozen_image *image = p;
+	if (memcmp(image->magic, IMAGE_MAGIC, sizeof(image->magic)) != 0
+	    || image->version != IMAGE_VERSION
+	    || image->byte_order != IMAGE_BYTE_ORDER
+	    || image->file_size > image_size
+	    || image->buckets == 0
+	    || image->buckets > INT32_MAX
+	    || image->size > INT32_MAX
+	    || image->seeds_offset > image->file_size
+	    || image->buckets > (image->file_size - image->seeds_offset)
+	    / sizeof(int32_t)
+	    || image->slots_offset > image->file_size
+	    || image->size + image->overflow
+	    > (image->file_size - image->slots_offset)
+	    / sizeof(struct frozen_slot)) {
+		munmap(p, image_size);
+		return NULL;
+	}
+
+	frozen_table *f = calloc(1, sizeof(*f));
+	f->size = image->size;
+	f->buckets = image->buckets;
+	f->overflow = image->overflow;
+	f->seeds = (const int32_t *)((const char *)image
+				     + image->seeds_offset);
+	f->slots = (const struct frozen_slot *)((const char *)image
+						+ image->slots_offset);
+	f->key_cmp_func = key_cmp_func;
+	f->key_hash_func = key_hash_func;
+	f->image = image;
+	f->image_size = image_size;
+	return f;
+}
@@ -0,0 +1,131 @@
+#ifndef FROZENTABLE_H
+#define FROZENTABLE_H
+
+#include <stddef.h>
+#include "table.h"
+
+/*
+ * Read-only tables built from any implementation of table.h, in
+ * frozentable.c.
+ *
+ * A frozen table holds one pair per distinct key of the table it was
+ * built from, placed by a minimal perfect hash function: n keys fill
+ * exactly n slots, and a lookup reads one small seed and then exactly
+ * one slot. Frozen tables are never modified after table_freeze()
+ * returns, so any number of threads may look up keys in the same
+ * frozen table at the same time without locks.
+ *
+ * A frozen table can be saved to a file and mapped back into memory,
+ * as with table_save() and table_load_mapped() in hashtable.h.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-18: v1.1, tables may be frozen by several threads at once.
+ */
+
+// ==========PUBLIC DATA TYPES============
+
+// Frozen table type.
+typedef struct frozen_table frozen_table;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_freeze() - Convert a table into a frozen table.
+ * @t: Table to convert. It is destroyed.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on kill. Should be the one
+ *		   t was created with.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on kill. Should be the
+ *		     one t was created with.
+ *
+ * The frozen table takes over the pair that table_lookup() returns
+ * for each key of t. Older duplicates are freed with the given free
+ * functions. Takes time linear in the size of t. Different threads
+ * may freeze different tables at the same time when compiled with GCC
+ * or Clang. Otherwise only one table may be frozen at a time.
+ *
+ * Returns: Pointer to the frozen table.
+ */
+frozen_table *table_freeze(table *t, compare_function *key_cmp_func,
+			   hash_function *key_hash_func,
+			   free_function key_free_func,
+			   free_function value_free_func);
+
+/**
+ * frozen_table_lookup() - Look up a given key in a frozen table.
+ * @f: Frozen table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *frozen_table_lookup(const frozen_table *f, const void *key);
+
+/**
+ * frozen_table_size() - Return the number of pairs in a frozen table.
+ * @f: Frozen table to inspect.
+ *
+ * Returns: The number of distinct keys.
+ */
+size_t frozen_table_size(const frozen_table *f);
+
+/**
+ * frozen_table_print() - Print the given frozen table.
+ * @f: Frozen table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Returns: Nothing.
+ */
+void frozen_table_print(const frozen_table *f,
+			inspect_callback_pair print_func);
+
+/**
+ * frozen_table_kill() - Destroy a frozen table.
+ * @f: Frozen table to destroy.
+ *
+ * Calls any free functions given to table_freeze() on all keys and
+ * values. A loaded table is unmapped.
+ *
+ * Returns: Nothing.
+ */
+void frozen_table_kill(frozen_table *f);
+
+/**
+ * frozen_table_save() - Save a frozen table to a file.
+ * @f: Frozen table to save.
+ * @path: Name of the file to create or overwrite.
+ * @key_serializer: Function that writes the bytes of a key.
+ * @value_serializer: Function that writes the bytes of a value.
+ *
+ * NULL keys and values are stored without calling the serializers.
+ *
+ * Returns: 0 on success, -1 if the file could not be written.
+ */
+int frozen_table_save(const frozen_table *f, const char *path,
+		      serialize_function *key_serializer,
+		      serialize_function *value_serializer);
+
+/**
+ * frozen_table_load_mapped() - Map a saved frozen table into memory.
+ * @path: Name of a file written by frozen_table_save().
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: The hash function of the saved table.
+ *
+ * The keys and values of the loaded table point into the mapped file
+ * and must not be freed or modified. They stay valid until
+ * frozen_table_kill(). Loading takes constant time.
+ *
+ * Returns: Pointer to the loaded table, or NULL if the file could not
+ * be mapped or was not written by frozen_table_save().
+ */
+frozen_table *frozen_table_load_mapped(const char *path,
+				       compare_function *key_cmp_func,
+				       hash_function *key_hash_func);
+
+#endif
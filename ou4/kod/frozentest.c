@@ -0,0 +1,271 @@
+/*
+ * frozentest - test frozen tables built from a table implementation.
+ *
+ * Should be compiled together with frozentable.c and a table
+ * implementation that follows the interface in table.h, e.g.
+ * hashtable.c.
+ *
+ * Usage: frozentest [n]
+ *
+ * Tests that a table of n int keys, some of them inserted twice, can
+ * be frozen and that every key is found with its latest value. The
+ * same is done with a weak hash function that makes many keys share a
+ * hash value. The frozen table is then saved, loaded and looked up
+ * again, also by several threads at the same time. Finally the time
+ * per lookup is measured before and after freezing.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "table.h"
+#include "frozentable.h"
+
+// Default number of keys
+#define DEFAULT_SIZE 10000
+// Number of threads looking up keys at the same time
+#define THREADS 4
+// Maximum number of keys sharing 7 hash values, whose lookups take
+// time linear in the number of keys
+#define WEAK_SIZE 1000
+// Name of the file used to test saving and loading
+#define SAVE_PATH "frozentest.img"
+
+/**
+ * int_ptr_from_int() - Create a dynamic copy of an int.
+ * @i: Value to copy.
+ *
+ * Returns: Pointer to the copy of i.
+ */
+int *int_ptr_from_int(int i)
+{
+        int *ip = malloc(sizeof(int));
+        *ip = i;
+        return ip;
+}
+
+/**
+ * get_nanoseconds() - Return a monotonic time in nanoseconds.
+ *
+ * Returns: The time.
+ */
+unsigned long long get_nanoseconds()
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int int_compare(const void *ip1,const void *ip2)
+{
+        const int *n1=ip1;
+        const int *n2=ip2;
+        return (*n1 - *n2);
+}
+
+unsigned long int_hash(const void *ip)
+{
+        return *(const int *)ip;
+}
+
+// Hash function that makes groups of keys share a hash value.
+unsigned long weak_hash(const void *ip)
+{
+        return *(const int *)ip % 7;
+}
+
+size_t int_serialize(const void *p, void *buf, size_t size)
+{
+        if (size >= sizeof(int)) {
+                memcpy(buf, p, sizeof(int));
+        }
+        return sizeof(int);
+}
+
+/**
+ * build_table() - Create a table with the keys 0..n-1.
+ * @n: Number of keys.
+ * @hash: Hash function of the table.
+ *
+ * Every third key is first inserted with the value -1, and then again
+ * with its final value 2*key.
+ *
+ * Returns: The table.
+ */
+table *build_table(int n, hash_function *hash)
+{
+        table *t = table_empty_hashed(int_compare, hash, free, free);
+        for (int i = 0; i < n; i++) {
+                if (i % 3 == 0) {
+                        table_insert(t, int_ptr_from_int(i),
+                                     int_ptr_from_int(-1));
+                }
+                table_insert(t, int_ptr_from_int(i), int_ptr_from_int(2*i));
+        }
+        return t;
+}
+
+/**
+ * check_lookups() - Check that a frozen table holds the keys 0..n-1.
+ * @f: Frozen table to check.
+ * @n: Number of keys.
+ * @name: Name of the test.
+ *
+ * Exits the program if any key is missing or has the wrong value, or
+ * if a key that was never inserted is found.
+ *
+ * Returns: Nothing.
+ */
+void check_lookups(const frozen_table *f, int n, const char *name)
+{
+        if (frozen_table_size(f) != (size_t)n) {
+                fprintf(stderr, "FAIL: %s has %zu keys, expected %d.\n",
+                        name, frozen_table_size(f), n);
+                exit(EXIT_FAILURE);
+        }
+        for (int i = -n; i < 2*n; i++) {
+                const int *v = frozen_table_lookup(f, &i);
+                if (i >= 0 && i < n && (v == NULL || *v != 2*i)) {
+                        fprintf(stderr, "FAIL: %s lost key %d.\n", name, i);
+                        exit(EXIT_FAILURE);
+                }
+                if ((i < 0 || i >= n) && v != NULL) {
+                        fprintf(stderr, "FAIL: %s found missing key %d.\n",
+                                name, i);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        printf("%s: OK.\n", name);
+}
+
+struct lookup_job {
+        const frozen_table *f;
+        int n;
+        bool failed;
+};
+
+void *run_lookup_job(void *arg)
+{
+        struct lookup_job *job = arg;
+        for (int round = 0; round < 10; round++) {
+                for (int i = 0; i < job->n; i++) {
+                        const int *v = frozen_table_lookup(job->f, &i);
+                        if (v == NULL || *v != 2*i) {
+                                job->failed = true;
+                        }
+                }
+        }
+        return NULL;
+}
+
+/**
+ * test_threads() - Look up all keys from several threads at once.
+ * @f: Frozen table holding the keys 0..n-1.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void test_threads(const frozen_table *f, int n)
+{
+        pthread_t threads[THREADS];
+        struct lookup_job jobs[THREADS];
+
+        for (int i = 0; i < THREADS; i++) {
+                jobs[i] = (struct lookup_job){ .f = f, .n = n };
+                pthread_create(&threads[i], NULL, run_lookup_job, &jobs[i]);
+        }
+        for (int i = 0; i < THREADS; i++) {
+                pthread_join(threads[i], NULL);
+                if (jobs[i].failed) {
+                        fprintf(stderr, "FAIL: thread %d lost a key.\n", i);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        printf("Lookups from %d threads: OK.\n", THREADS);
+}
+
+/**
+ * time_lookups() - Measure the time of looking up all keys.
+ * @t: Table to look up in, or NULL.
+ * @f: Frozen table to look up in if t is NULL.
+ * @n: Number of keys.
+ *
+ * Returns: The average time per lookup in nanoseconds.
+ */
+double time_lookups(table *t, const frozen_table *f, int n)
+{
+        int rounds = 10;
+        volatile long sum = 0;
+        unsigned long long start = get_nanoseconds();
+        for (int round = 0; round < rounds; round++) {
+                for (int i = 0; i < n; i++) {
+                        int key = (int)((i * 2654435761u) % n);
+                        const int *v = t != NULL ? table_lookup(t, &key)
+                                : frozen_table_lookup(f, &key);
+                        sum += *v;
+                }
+        }
+        return (double)(get_nanoseconds() - start) / ((double)rounds * n);
+}
+
+int main(int argc, char **argv)
+{
+        int n = DEFAULT_SIZE;
+        if (argc > 1) {
+                n = atoi(argv[1]);
+        }
+        if (n < 1) {
+                fprintf(stderr, "Usage: %s [n]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+
+        frozen_table *f = table_freeze(build_table(0, int_hash), int_compare,
+                                       int_hash, free, free);
+        check_lookups(f, 0, "Empty table");
+        frozen_table_kill(f);
+
+        int weak_n = n < WEAK_SIZE ? n : WEAK_SIZE;
+        f = table_freeze(build_table(weak_n, weak_hash), int_compare,
+                         weak_hash, free, free);
+        check_lookups(f, weak_n, "Shared hash values");
+        frozen_table_kill(f);
+
+        f = table_freeze(build_table(n, int_hash), int_compare, int_hash,
+                         free, free);
+        check_lookups(f, n, "Distinct hash values");
+
+        if (frozen_table_save(f, SAVE_PATH, int_serialize,
+                              int_serialize) != 0) {
+                fprintf(stderr, "FAIL: could not save %s.\n", SAVE_PATH);
+                exit(EXIT_FAILURE);
+        }
+        frozen_table *loaded = frozen_table_load_mapped(SAVE_PATH, int_compare,
+                                                        int_hash);
+        remove(SAVE_PATH);
+        if (loaded == NULL) {
+                fprintf(stderr, "FAIL: could not load %s.\n", SAVE_PATH);
+                exit(EXIT_FAILURE);
+        }
+        check_lookups(loaded, n, "Loaded table");
+        test_threads(loaded, n);
+        frozen_table_kill(loaded);
+
+        table *t = build_table(n, int_hash);
+        printf("Lookup time before freezing: %.1f ns\n",
+               time_lookups(t, NULL, n));
+        table_kill(t);
+        printf("Lookup time after freezing: %.1f ns\n",
+               time_lookups(NULL, f, n));
+        frozen_table_kill(f);
+        return 0;
+}
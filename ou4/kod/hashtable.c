@@ -0,0 +1,1280 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "table.h"
+#include "table_stats.h"
+#include "hashtable.h"
+
+/*
+ * Implementation of a generic table using open addressing with linear
+ * probing. The slot array is a power of two in size and is doubled
+ * whenever the load factor would exceed 3/4, so insert, lookup and
+ * remove take expected constant time.
+ *
+ * Duplicates are handled by insert. The latest added pair for a key
+ * is kept in the slot, older pairs with the same key are chained
+ * behind it so that lookup, remove, kill and print still see all of
+ * them. Tables created with TABLE_UNIQUE_KEYS replace the pair in the
+ * slot instead and never allocate a chain.
+ *
+ * Removal uses backward shift deletion, so no tombstones are needed
+ * and probe sequences never grow because of earlier removals.
+ *
+ * The batched operations hash a group of keys and prefetch all their
+ * home slots before probing any of them, so that the cache misses of
+ * the group overlap instead of being taken one after the other.
+ *
+ * A table loaded by table_load_mapped() has no slot array of its own.
+ * Lookups probe the image slots of the mapped file instead, until the
+ * first insert or remove thaws the table into an ordinary one whose
+ * keys and values still point into the file.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added batched insert/lookup/remove.
+ *   2026-10-17: v1.2, added table_save() and table_load_mapped().
+ *   2026-10-17: v1.3, added table_stats().
+ *   2026-10-17: v1.4, added table_empty_ex().
+ *   2026-10-17: v1.5, added table_clear() and table_drain().
+ *   2026-10-17: v1.6, added table_lookup_all() and table_count().
+ */
+
+// Number of slots in a newly created table. Must be a power of two.
+#define INITIAL_CAPACITY 16
+
+// Hash value marking an unused slot.
+#define EMPTY_HASH 0UL
+
+// Number of keys whose slots are prefetched together by the batched
+// operations.
+#define BATCH_SIZE 16
+
+// Identifies a file written by table_save(), and its format version.
+#define IMAGE_MAGIC "DOATABLE"
+#define IMAGE_VERSION 1
+
+// Written in the byte order of the saving machine, to detect files
+// from machines with another byte order.
+#define IMAGE_BYTE_ORDER 0x0102030405060708ULL
+
+// Alignment of the keys and values in a saved file.
+#define IMAGE_ALIGN 16
+
+// Prefetch a cache line that will soon be read, if the compiler can.
+#ifdef __GNUC__
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p)
+#endif
+
+// ===========INTERNAL DATA TYPES============
+
+// An older key/value pair shadowed by a later insert of the same key.
+struct table_entry {
+	void *key;
+	void *value;
+	struct table_entry *next;
+};
+
+struct table_slot {
+	unsigned long hash;
+	void *key;
+	void *value;
+	struct table_entry *older;
+};
+
+// Start of a file written by table_save(). All offsets are from the
+// start of the file, and offset 0 stands for NULL.
+struct table_image {
+	char magic[8];
+	uint64_t version;
+	uint64_t byte_order;
+	uint64_t capacity;
+	uint64_t size;
+	uint64_t first_used;
+	uint64_t slots_offset;
+	uint64_t entries_offset;
+	uint64_t file_size;
+};
+
+struct image_slot {
+	uint64_t hash;
+	uint64_t key;
+	uint64_t value;
+	// Offset of the first older duplicate, an image_entry.
+	uint64_t older;
+};
+
+struct image_entry {
+	uint64_t key;
+	uint64_t value;
+	uint64_t next;
+};
+
+struct table {
+	// Slot array, or NULL while a loaded table is still frozen.
+	struct table_slot *slots;
+	// Number of slots, always a power of two.
+	unsigned long capacity;
+	// Number of used slots, i.e. distinct keys.
+	unsigned long size;
+	// No used slot has a lower index than this.
+	unsigned long first_used;
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	free_function key_free_func;
+	free_function value_free_func;
+	// True if created with TABLE_UNIQUE_KEYS.
+	bool unique_keys;
+	// Mapped file of a loaded table, or NULL, and its mapped size.
+	const struct table_image *image;
+	size_t image_size;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
+};
+
+// Output of table_save() while it writes the keys and values.
+struct save_state {
+	FILE *f;
+	// Offset in the file of the next key or value.
+	uint64_t pos;
+	// Buffer for the serializers and its size.
+	void *buf;
+	size_t size;
+	bool failed;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * mix_hash() - Spread the bits of a user supplied hash value.
+ * @h: Hash value returned by the key hash function.
+ *
+ * Identity hashes such as the value of an integer key would otherwise
+ * fill consecutive slots and form long clusters. Uses the finalizer
+ * of MurmurHash3. Never returns EMPTY_HASH.
+ *
+ * Returns: The mixed hash value.
+ */
+static unsigned long mix_hash(unsigned long h)
+{
+	unsigned long long x = h;
+
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+
+	if ((unsigned long)x == EMPTY_HASH) {
+		return 1;
+	}
+	return (unsigned long)x;
+}
+
+/**
+ * key_hash() - Compute the mixed hash value of a key.
+ * @t: Table the key belongs to.
+ * @key: Key to hash.
+ *
+ * A table created without a hash function puts every key in the same
+ * probe sequence. It still works, but degenerates to a linear scan.
+ *
+ * Returns: The mixed hash value of the key.
+ */
+static unsigned long key_hash(const table *t, const void *key)
+{
+	if (t->key_hash_func == NULL) {
+		return mix_hash(0);
+	}
+	return mix_hash(t->key_hash_func(key));
+}
+
+/**
+ * find_slot() - Find the slot holding a key.
+ * @t: Table to inspect.
+ * @key: Key to look for.
+ * @hash: Mixed hash value of key.
+ *
+ * Returns: The index of the slot holding key, or the index of the
+ * empty slot that ends the probe sequence if key is not in the table.
+ */
+static unsigned long find_slot(const table *t, const void *key,
+			       unsigned long hash)
+{
+	unsigned long mask = t->capacity - 1;
+	unsigned long i = hash & mask;
+
+	while (t->slots[i].hash != EMPTY_HASH) {
+		if (t->slots[i].hash == hash
+		    && TABLE_KEY_CMP(t, t->slots[i].key, key) == 0) {
+			return i;
+		}
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/**
+ * probe_length() - Compute the number of slots a probe examined.
+ * @t: Table to inspect.
+ * @i: Index of the slot the probe ended at.
+ * @hash: Mixed hash value of the key probed for.
+ *
+ * Returns: The number of slots from the home slot of hash to i,
+ * both included.
+ */
+static unsigned long probe_length(const table *t, unsigned long i,
+				  unsigned long hash)
+{
+	return ((i - hash) & (t->capacity - 1)) + 1;
+}
+
+/**
+ * grow() - Double the number of slots and re-insert all used slots.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+static void grow(table *t)
+{
+	struct table_slot *old_slots = t->slots;
+	unsigned long old_capacity = t->capacity;
+
+	t->capacity = old_capacity * 2;
+	t->slots = calloc(t->capacity, sizeof(*t->slots));
+	t->first_used = 0;
+
+	unsigned long mask = t->capacity - 1;
+	for (unsigned long j = 0; j < old_capacity; j++) {
+		if (old_slots[j].hash == EMPTY_HASH) {
+			continue;
+		}
+		// Keys are known to be distinct, so only look for a free slot.
+		unsigned long i = old_slots[j].hash & mask;
+		while (t->slots[i].hash != EMPTY_HASH) {
+			i = (i + 1) & mask;
+		}
+		t->slots[i] = old_slots[j];
+	}
+	free(old_slots);
+}
+
+/**
+ * free_slot_pairs() - Free all key/value pairs stored in a slot.
+ * @t: Table the slot belongs to.
+ * @slot: Slot to empty.
+ *
+ * Calls any free functions set for keys/values on the latest pair and
+ * on every older duplicate, and deallocates the duplicate chain.
+ *
+ * Returns: Nothing.
+ */
+static void free_slot_pairs(const table *t, struct table_slot *slot)
+{
+	if (t->key_free_func != NULL) {
+		t->key_free_func(slot->key);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(slot->value);
+	}
+
+	struct table_entry *entry = slot->older;
+	while (entry != NULL) {
+		struct table_entry *next = entry->next;
+		if (t->key_free_func != NULL) {
+			t->key_free_func(entry->key);
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(entry->value);
+		}
+		free(entry);
+		entry = next;
+	}
+	slot->older = NULL;
+}
+
+/**
+ * delete_slot() - Empty a slot and close the gap in its cluster.
+ * @t: Table to manipulate.
+ * @i: Index of the slot to empty.
+ *
+ * Moves later slots of the same cluster back into the gap if that
+ * does not place them before their home slot.
+ *
+ * Returns: Nothing.
+ */
+static void delete_slot(table *t, unsigned long i)
+{
+	unsigned long mask = t->capacity - 1;
+	unsigned long j = i;
+
+	for (;;) {
+		j = (j + 1) & mask;
+		if (t->slots[j].hash == EMPTY_HASH) {
+			break;
+		}
+		unsigned long home = t->slots[j].hash & mask;
+		// Move slot j into the gap unless its home lies cyclically
+		// in (i, j], in which case moving it would hide it.
+		bool stays = (i <= j) ? (i < home && home <= j)
+			: (i < home || home <= j);
+		if (!stays) {
+			t->slots[i] = t->slots[j];
+			i = j;
+		}
+	}
+	t->slots[i].hash = EMPTY_HASH;
+	t->slots[i].older = NULL;
+	t->size--;
+
+	// Keep first_used tight so that table_choose_key() stays cheap
+	// while a table is being deconstructed.
+	while (t->first_used < t->capacity
+	       && t->slots[t->first_used].hash == EMPTY_HASH) {
+		t->first_used++;
+	}
+}
+
+/**
+ * reserve() - Grow a table until it can take more keys.
+ * @t: Table to manipulate.
+ * @n: Number of new keys the table must have room for.
+ *
+ * Returns: Nothing.
+ */
+static void reserve(table *t, unsigned long n)
+{
+	// Keep the load factor at or below 3/4.
+	while ((t->size + n) * 4 > t->capacity * 3) {
+		grow(t);
+	}
+}
+
+/**
+ * insert_hashed() - Add a key/value pair with a known hash value.
+ * @t: Table to manipulate. Must have room for one more key.
+ * @key, @value: Pair to insert.
+ * @hash: Mixed hash value of key.
+ *
+ * Returns: Nothing.
+ */
+static void insert_hashed(table *t, void *key, void *value,
+			  unsigned long hash)
+{
+	unsigned long i = find_slot(t, key, hash);
+	struct table_slot *slot = &t->slots[i];
+
+	TABLE_STATS_INSERT(t, probe_length(t, i, hash));
+	if (slot->hash != EMPTY_HASH && t->unique_keys) {
+		// Replace the pair, freeing what the new one does not reuse.
+		if (t->key_free_func != NULL && slot->key != key) {
+			t->key_free_func(slot->key);
+		}
+		if (t->value_free_func != NULL && slot->value != value) {
+			t->value_free_func(slot->value);
+		}
+	} else if (slot->hash != EMPTY_HASH) {
+		// Duplicate key. Push the current pair onto the chain.
+		struct table_entry *entry = malloc(sizeof(*entry));
+		entry->key = slot->key;
+		entry->value = slot->value;
+		entry->next = slot->older;
+		slot->older = entry;
+	} else {
+		slot->hash = hash;
+		slot->older = NULL;
+		t->size++;
+		if (i < t->first_used) {
+			t->first_used = i;
+		}
+	}
+	slot->key = key;
+	slot->value = value;
+}
+
+/**
+ * remove_hashed() - Remove a key with a known hash value.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pairs.
+ * @hash: Mixed hash value of key.
+ *
+ * Returns: Nothing.
+ */
+static void remove_hashed(table *t, const void *key, unsigned long hash)
+{
+	unsigned long i = find_slot(t, key, hash);
+
+	TABLE_STATS_REMOVE(t, probe_length(t, i, hash));
+	if (t->slots[i].hash == EMPTY_HASH) {
+		return;
+	}
+	// The key is not used again after this point, so it is safe for
+	// it to point to the same memory as one of the freed keys.
+	free_slot_pairs(t, &t->slots[i]);
+	delete_slot(t, i);
+}
+
+/**
+ * hash_batch() - Hash a batch of keys and prefetch their home slots.
+ * @t: Table to inspect.
+ * @keys: Keys to hash.
+ * @hashes: Set to the mixed hash value of each key.
+ * @n: Number of keys, at most BATCH_SIZE.
+ *
+ * Returns: Nothing.
+ */
+static void hash_batch(const table *t, void **keys, unsigned long *hashes,
+		       int n)
+{
+	for (int j = 0; j < n; j++) {
+		hashes[j] = key_hash(t, keys[j]);
+		PREFETCH(&t->slots[hashes[j] & (t->capacity - 1)]);
+	}
+}
+
+/**
+ * image_pointer() - Convert an offset in the mapped file to a pointer.
+ * @t: Loaded table.
+ * @offset: Offset from the start of the file, or 0.
+ *
+ * Returns: Pointer to the byte at offset, or NULL if offset is 0.
+ */
+static void *image_pointer(const table *t, uint64_t offset)
+{
+	if (offset == 0) {
+		return NULL;
+	}
+	return (char *)t->image + offset;
+}
+
+/**
+ * image_slots() - Find the slot array of the mapped file.
+ * @t: Loaded table.
+ *
+ * Returns: Pointer to the first image slot.
+ */
+static const struct image_slot *image_slots(const table *t)
+{
+	return image_pointer(t, t->image->slots_offset);
+}
+
+/**
+ * find_image_slot() - Find the image slot holding a key.
+ * @t: Frozen loaded table.
+ * @key: Key to look for.
+ * @hash: Mixed hash value of key.
+ *
+ * Returns: The index of the image slot holding key, or the index of
+ * the empty image slot that ends the probe sequence if key is not in
+ * the table.
+ */
+static unsigned long find_image_slot(const table *t, const void *key,
+				     unsigned long hash)
+{
+	const struct image_slot *slots = image_slots(t);
+	unsigned long mask = t->capacity - 1;
+	unsigned long i = hash & mask;
+
+	while (slots[i].hash != EMPTY_HASH) {
+		if (slots[i].hash == hash
+		    && TABLE_KEY_CMP(t, image_pointer(t, slots[i].key),
+				     key) == 0) {
+			return i;
+		}
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/**
+ * thaw() - Give a loaded table a slot array of its own.
+ * @t: Table to manipulate.
+ *
+ * Copies the image slots of a frozen table into an ordinary slot
+ * array, after which the table can be modified. The keys and values
+ * still point into the mapped file. Does nothing if the table already
+ * has a slot array.
+ *
+ * Returns: Nothing.
+ */
+static void thaw(table *t)
+{
+	if (t->slots != NULL) {
+		return;
+	}
+	const struct image_slot *image = image_slots(t);
+
+	t->slots = calloc(t->capacity, sizeof(*t->slots));
+	for (unsigned long i = t->first_used; i < t->capacity; i++) {
+		if (image[i].hash == EMPTY_HASH) {
+			continue;
+		}
+		struct table_slot *slot = &t->slots[i];
+		slot->hash = image[i].hash;
+		slot->key = image_pointer(t, image[i].key);
+		slot->value = image_pointer(t, image[i].value);
+
+		// Copy the duplicates, keeping the latest first.
+		struct table_entry **tail = &slot->older;
+		const struct image_entry *e = image_pointer(t, image[i].older);
+		while (e != NULL) {
+			struct table_entry *entry = malloc(sizeof(*entry));
+			entry->key = image_pointer(t, e->key);
+			entry->value = image_pointer(t, e->value);
+			*tail = entry;
+			tail = &entry->next;
+			e = image_pointer(t, e->next);
+		}
+		*tail = NULL;
+	}
+}
+
+/**
+ * empty_slots() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * A loaded table is thawed first, so the pairs of the mapped file
+ * stay valid until table_kill(). The slot array is shrunk back to
+ * INITIAL_CAPACITY.
+ *
+ * Returns: Nothing.
+ */
+static void empty_slots(table *t, consume_callback_pair func)
+{
+	thaw(t);
+	for (unsigned long i = t->first_used; i < t->capacity; i++) {
+		struct table_slot *slot = &t->slots[i];
+		if (slot->hash == EMPTY_HASH) {
+			continue;
+		}
+		if (func == NULL) {
+			free_slot_pairs(t, slot);
+			continue;
+		}
+		func(slot->key, slot->value);
+		struct table_entry *entry = slot->older;
+		while (entry != NULL) {
+			struct table_entry *next = entry->next;
+			func(entry->key, entry->value);
+			free(entry);
+			entry = next;
+		}
+	}
+	free(t->slots);
+	t->capacity = INITIAL_CAPACITY;
+	t->slots = calloc(t->capacity, sizeof(*t->slots));
+	t->size = 0;
+	t->first_used = t->capacity;
+}
+
+/**
+ * align_up() - Round an offset up to a multiple of an alignment.
+ * @offset: Offset to round.
+ * @alignment: Power of two to round to.
+ *
+ * Returns: The smallest multiple of alignment not less than offset.
+ */
+static uint64_t align_up(uint64_t offset, uint64_t alignment)
+{
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * save_object() - Write the bytes of a key or value to a saved file.
+ * @st: Output to write to.
+ * @p: Key or value to write, or NULL.
+ * @serializer: Function that writes the bytes of p.
+ *
+ * The bytes are padded to IMAGE_ALIGN. Sets st->failed if they could
+ * not be written.
+ *
+ * Returns: The offset of the bytes in the file, or 0 if p is NULL.
+ */
+static uint64_t save_object(struct save_state *st, const void *p,
+			    serialize_function *serializer)
+{
+	static const char padding[IMAGE_ALIGN];
+
+	if (p == NULL) {
+		return 0;
+	}
+	size_t n = serializer(p, st->buf, st->size);
+	if (n > st->size) {
+		st->buf = realloc(st->buf, n);
+		st->size = n;
+		serializer(p, st->buf, st->size);
+	}
+	size_t padded = align_up(n, IMAGE_ALIGN);
+	if (fwrite(st->buf, 1, n, st->f) != n
+	    || fwrite(padding, 1, padded - n, st->f) != padded - n) {
+		st->failed = true;
+	}
+	uint64_t offset = st->pos;
+	st->pos += padded;
+	return offset;
+}
+
+/**
+ * visit_key() - Visit the pairs of a key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each pair of key, or NULL.
+ *
+ * Only the slot of key and its chain of older duplicates are
+ * examined. Counted as a lookup by table_stats().
+ *
+ * Returns: The number of pairs of key.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	unsigned long hash = key_hash(t, key);
+	unsigned long n = 0;
+
+	if (t->slots == NULL) {
+		const struct image_slot *image = image_slots(t);
+		unsigned long i = find_image_slot(t, key, hash);
+		TABLE_STATS_LOOKUP(t, probe_length(t, i, hash),
+				   image[i].hash != EMPTY_HASH);
+		if (image[i].hash == EMPTY_HASH) {
+			return 0;
+		}
+		n++;
+		if (func != NULL) {
+			func(image_pointer(t, image[i].key),
+			     image_pointer(t, image[i].value));
+		}
+		for (const struct image_entry *e =
+			     image_pointer(t, image[i].older);
+		     e != NULL; e = image_pointer(t, e->next)) {
+			n++;
+			if (func != NULL) {
+				func(image_pointer(t, e->key),
+				     image_pointer(t, e->value));
+			}
+		}
+		return n;
+	}
+	unsigned long i = find_slot(t, key, hash);
+	const struct table_slot *slot = &t->slots[i];
+
+	TABLE_STATS_LOOKUP(t, probe_length(t, i, hash),
+			   slot->hash != EMPTY_HASH);
+	if (slot->hash == EMPTY_HASH) {
+		return 0;
+	}
+	n++;
+	if (func != NULL) {
+		func(slot->key, slot->value);
+	}
+	for (struct table_entry *e = slot->older; e != NULL; e = e->next) {
+		n++;
+		if (func != NULL) {
+			func(e->key, e->value);
+		}
+	}
+	return n;
+}
+
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	// Allocate the table header.
+	table *t = calloc(1, sizeof(*t));
+	// Allocate the slot array. All slots start out unused.
+	t->capacity = INITIAL_CAPACITY;
+	t->slots = calloc(t->capacity, sizeof(*t->slots));
+	t->first_used = t->capacity;
+	// Store the key compare/hash functions and key/value free functions.
+	t->key_cmp_func = key_cmp_func;
+	t->key_hash_func = key_hash_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	TABLE_STATS_INIT(t);
+
+	return t;
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: TABLE_UNIQUE_KEYS or 0.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	table *t = table_empty_hashed(key_cmp_func, key_hash_func,
+				      key_free_func, value_free_func);
+
+	t->unique_keys = (flags & TABLE_UNIQUE_KEYS) != 0;
+	return t;
+}
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Without a hash function all keys share one probe sequence, so use
+ * table_empty_hashed() to get constant time operations.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return table_empty_hashed(key_cmp_func, NULL, key_free_func,
+				  value_free_func);
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @table: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @table: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key is already
+ * present, the previous pair is kept as an older duplicate.
+ * table_lookup() will return the latest added value for a duplicate
+ * key. table_remove() will remove all duplicates for a given key. If
+ * the table was created with TABLE_UNIQUE_KEYS, the previous pair is
+ * replaced instead.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	thaw(t);
+	reserve(t, 1);
+	insert_hashed(t, key, value, key_hash(t, key));
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @table: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table. If the table contains duplicate keys,
+ * the value that was latest inserted will be returned.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	unsigned long hash = key_hash(t, key);
+
+	if (t->slots == NULL) {
+		const struct image_slot *image = image_slots(t);
+		unsigned long i = find_image_slot(t, key, hash);
+		bool found = image[i].hash != EMPTY_HASH;
+		TABLE_STATS_LOOKUP(t, probe_length(t, i, hash), found);
+		return found ? image_pointer(t, image[i].value) : NULL;
+	}
+	unsigned long i = find_slot(t, key, hash);
+
+	TABLE_STATS_LOOKUP(t, probe_length(t, i, hash),
+			   t->slots[i].hash != EMPTY_HASH);
+	if (t->slots[i].hash == EMPTY_HASH) {
+		return NULL;
+	}
+	return t->slots[i].value;
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The pairs are visited latest inserted first. Only the slot of the
+ * key and its chain of older duplicates are examined.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	// Return the key of the used slot with the lowest index.
+	unsigned long i = t->first_used;
+
+	if (t->slots == NULL) {
+		const struct image_slot *image = image_slots(t);
+		while (image[i].hash == EMPTY_HASH) {
+			i++;
+		}
+		return image_pointer(t, image[i].key);
+	}
+	while (t->slots[i].hash == EMPTY_HASH) {
+		i++;
+	}
+	return t->slots[i].key;
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @table: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Any matching duplicates will be removed. Will call any free
+ * functions set for keys/values. Does nothing if key is not found in
+ * the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	thaw(t);
+	remove_hashed(t, key, key_hash(t, key));
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @table: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	if (t->slots != NULL) {
+		for (unsigned long i = t->first_used; i < t->capacity; i++) {
+			if (t->slots[i].hash != EMPTY_HASH) {
+				free_slot_pairs(t, &t->slots[i]);
+			}
+		}
+		free(t->slots);
+	}
+	if (t->image != NULL) {
+		munmap((void *)t->image, t->image_size);
+	}
+	TABLE_STATS_FREE(t);
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_slots(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table,
+ *	  including duplicates. Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_slots(t, func);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table and prints them.
+ * Will print all stored elements, including duplicates. Duplicates
+ * are printed latest first.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	if (t->slots == NULL) {
+		const struct image_slot *image = image_slots(t);
+		for (unsigned long i = t->first_used; i < t->capacity; i++) {
+			if (image[i].hash == EMPTY_HASH) {
+				continue;
+			}
+			print_func(image_pointer(t, image[i].key),
+				   image_pointer(t, image[i].value));
+			for (const struct image_entry *e =
+				     image_pointer(t, image[i].older);
+			     e != NULL; e = image_pointer(t, e->next)) {
+				print_func(image_pointer(t, e->key),
+					   image_pointer(t, e->value));
+			}
+		}
+		return;
+	}
+	for (unsigned long i = t->first_used; i < t->capacity; i++) {
+		const struct table_slot *slot = &t->slots[i];
+		if (slot->hash == EMPTY_HASH) {
+			continue;
+		}
+		print_func(slot->key, slot->value);
+		for (struct table_entry *e = slot->older; e != NULL;
+		     e = e->next) {
+			print_func(e->key, e->value);
+		}
+	}
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	unsigned long hashes[BATCH_SIZE];
+
+	thaw(t);
+	for (int first = 0; first < n; first += BATCH_SIZE) {
+		int m = n - first < BATCH_SIZE ? n - first : BATCH_SIZE;
+		// Grow first, a later grow would move the prefetched slots.
+		reserve(t, m);
+		hash_batch(t, keys + first, hashes, m);
+		for (int j = 0; j < m; j++) {
+			insert_hashed(t, keys[first + j], values[first + j],
+				      hashes[j]);
+		}
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	unsigned long hashes[BATCH_SIZE];
+
+	if (t->slots == NULL) {
+		for (int i = 0; i < n; i++) {
+			values[i] = table_lookup(t, keys[i]);
+		}
+		return;
+	}
+
+	for (int first = 0; first < n; first += BATCH_SIZE) {
+		int m = n - first < BATCH_SIZE ? n - first : BATCH_SIZE;
+		hash_batch(t, keys + first, hashes, m);
+		for (int j = 0; j < m; j++) {
+			unsigned long i = find_slot(t, keys[first + j],
+						    hashes[j]);
+			TABLE_STATS_LOOKUP(t, probe_length(t, i, hashes[j]),
+					   t->slots[i].hash != EMPTY_HASH);
+			if (t->slots[i].hash == EMPTY_HASH) {
+				values[first + j] = NULL;
+			} else {
+				values[first + j] = t->slots[i].value;
+			}
+		}
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	unsigned long hashes[BATCH_SIZE];
+
+	thaw(t);
+	for (int first = 0; first < n; first += BATCH_SIZE) {
+		int m = n - first < BATCH_SIZE ? n - first : BATCH_SIZE;
+		hash_batch(t, keys + first, hashes, m);
+		for (int j = 0; j < m; j++) {
+			remove_hashed(t, keys[first + j], hashes[j]);
+		}
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of an operation is the number of slots it
+ * examined, from the home slot of the key up to the slot holding the
+ * key or the empty slot that ends the probe sequence.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
+
+/**
+ * table_save() - Save a table to a file.
+ * @t: Table to save.
+ * @path: Name of the file to create or overwrite.
+ * @key_serializer: Function that writes the bytes of a key.
+ * @value_serializer: Function that writes the bytes of a value.
+ *
+ * The keys and values are written first, after room has been left for
+ * the header, slots and duplicate entries, which are written last when
+ * the offsets of the keys and values are known. A frozen loaded table
+ * is thawed first.
+ *
+ * Returns: 0 on success, -1 if the file could not be written.
+ */
+int table_save(const table *t, const char *path,
+	       serialize_function *key_serializer,
+	       serialize_function *value_serializer)
+{
+	// Thawing does not change the contents of the table.
+	thaw((table *)t);
+
+	unsigned long entries = 0;
+	for (unsigned long i = t->first_used; i < t->capacity; i++) {
+		if (t->slots[i].hash == EMPTY_HASH) {
+			continue;
+		}
+		for (struct table_entry *e = t->slots[i].older; e != NULL;
+		     e = e->next) {
+			entries++;
+		}
+	}
+
+	struct table_image header = {
+		.version = IMAGE_VERSION,
+		.byte_order = IMAGE_BYTE_ORDER,
+		.capacity = t->capacity,
+		.size = t->size,
+		.first_used = t->first_used,
+	};
+	memcpy(header.magic, IMAGE_MAGIC, sizeof(header.magic));
+	header.slots_offset = align_up(sizeof(header), 64);
+	header.entries_offset = header.slots_offset
+		+ t->capacity * sizeof(struct image_slot);
+	uint64_t entries_end = header.entries_offset
+		+ entries * sizeof(struct image_entry);
+	uint64_t data_offset = align_up(entries_end, IMAGE_ALIGN);
+
+	struct save_state st = {
+		.f = fopen(path, "wb"),
+		.pos = data_offset,
+	};
+	if (st.f == NULL) {
+		return -1;
+	}
+	struct image_slot *slots = calloc(t->capacity, sizeof(*slots));
+	struct image_entry *image_entries =
+		malloc((entries + 1) * sizeof(*image_entries));
+	unsigned long next_entry = 0;
+
+	if (fseeko(st.f, data_offset, SEEK_SET) != 0) {
+		st.failed = true;
+	}
+	for (unsigned long i = t->first_used; i < t->capacity; i++) {
+		const struct table_slot *slot = &t->slots[i];
+		if (slot->hash == EMPTY_HASH) {
+			continue;
+		}
+		slots[i].hash = slot->hash;
+		slots[i].key = save_object(&st, slot->key, key_serializer);
+		slots[i].value = save_object(&st, slot->value,
+					     value_serializer);
+		uint64_t *link = &slots[i].older;
+		for (struct table_entry *e = slot->older; e != NULL;
+		     e = e->next) {
+			struct image_entry *ie = &image_entries[next_entry];
+			ie->key = save_object(&st, e->key, key_serializer);
+			ie->value = save_object(&st, e->value,
+						value_serializer);
+			ie->next = 0;
+			*link = header.entries_offset
+				+ next_entry * sizeof(*ie);
+			link = &ie->next;
+			next_entry++;
+		}
+	}
+	header.file_size = st.pos > data_offset ? st.pos : entries_end;
+
+	if (fseeko(st.f, 0, SEEK_SET) != 0
+	    || fwrite(&header, sizeof(header), 1, st.f) != 1
+	    || fseeko(st.f, header.slots_offset, SEEK_SET) != 0
+	    || fwrite(slots, sizeof(*slots), t->capacity, st.f) != t->capacity
+	    || fwrite(image_entries, sizeof(*image_entries), entries, st.f)
+	    != entries) {
+		st.failed = true;
+	}
+	if (fclose(st.f) != 0) {
+		st.failed = true;
+	}
+	free(slots);
+	free(image_entries);
+	free(st.buf);
+
+	if (st.failed) {
+		remove(path);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * table_load_mapped() - Map a saved table into memory.
+ * @path: Name of a file written by table_save().
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: The hash function of the saved table.
+ *
+ * The header is checked, but not the slots, keys and values.
+ *
+ * Returns: Pointer to the loaded table, or NULL if the file could not
+ * be mapped or was not written by table_save().
+ */
+table *table_load_mapped(const char *path, compare_function *key_cmp_func,
+			 hash_function *key_hash_func)
+{
+	struct stat st;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0) {
+		return NULL;
+	}
+	if (fstat(fd, &st) != 0
+	    || st.st_size < (off_t)sizeof(struct table_image)) {
+		close(fd);
+		return NULL;
+	}
+	size_t image_size = st.st_size;
+	void *p = mmap(NULL, image_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after the file is closed.
+	close(fd);
+	if (p == MAP_FAILED) {
+		return NULL;
+	}
+
+	const struct table_image *image = p;
+	if (memcmp(image->magic, IMAGE_MAGIC, sizeof(image->magic)) != 0
+	    || image->version != IMAGE_VERSION
+	    || image->byte_order != IMAGE_BYTE_ORDER
+	    || image->file_size > image_size
+	    || image->capacity == 0
+	    || (image->capacity & (image->capacity - 1)) != 0
+	    || image->size > image->capacity
+	    || image->first_used > image->capacity
+	    || image->slots_offset > image->file_size
+	    || image->capacity > (image->file_size - image->slots_offset)
+	    / sizeof(struct image_slot)) {
+		munmap(p, image_size);
+		return NULL;
+	}
+
+	table *t = calloc(1, sizeof(*t));
+	t->capacity = image->capacity;
+	t->size = image->size;
+	t->first_used = image->first_used;
+	t->key_cmp_func = key_cmp_func;
+	t->key_hash_func = key_hash_func;
+	t->image = image;
+	t->image_size = image_size;
+	TABLE_STATS_INIT(t);
+	return t;
+}
@@ -0,0 +1,64 @@
+#ifndef HASHTABLE_H
+#define HASHTABLE_H
+
+#include <stddef.h>
+#include "table.h"
+
+/*
+ * Extra operations for the hash table implementation of table.h in
+ * hashtable.c.
+ *
+ * A table can be saved to a file and later mapped back into memory.
+ * The file holds the slot array of the table as it is, with pointers
+ * replaced by file offsets, followed by the bytes of every key and
+ * value. A mapped table is searched directly in the mapped pages, so
+ * loading it takes constant time and only the pages that lookups
+ * touch are ever read from disk. The file format depends on the
+ * machine, so a file should be loaded on the same kind of machine
+ * that saved it.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, serialize_function moved to util.h.
+ */
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_save() - Save a table to a file.
+ * @t: Table to save.
+ * @path: Name of the file to create or overwrite.
+ * @key_serializer: Function that writes the bytes of a key.
+ * @value_serializer: Function that writes the bytes of a value.
+ *
+ * All pairs are saved, including duplicates. NULL keys and values are
+ * stored without calling the serializers.
+ *
+ * Returns: 0 on success, -1 if the file could not be written.
+ */
+int table_save(const table *t, const char *path,
+	       serialize_function *key_serializer,
+	       serialize_function *value_serializer);
+
+/**
+ * table_load_mapped() - Map a saved table into memory.
+ * @path: Name of a file written by table_save().
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: The hash function of the saved table.
+ *
+ * The keys and values of the loaded table point into the mapped file
+ * and must not be freed or modified. They stay valid until
+ * table_kill(). The loaded table has no free functions, so pairs
+ * inserted later are not freed by it either. The first insert or
+ * remove copies the slot array into ordinary memory, which takes time
+ * linear in the size of the table.
+ *
+ * Returns: Pointer to the loaded table, or NULL if the file could not
+ * be mapped or was not written by table_save().
+ */
+table *table_load_mapped(const char *path, compare_function *key_cmp_func,
+			 hash_function *key_hash_func);
+
+#endif
@@ -0,0 +1,340 @@
+/*
+ * hashtest - test saving and loading tables of the hash table.
+ *
+ * Should be compiled together with hashtable.c.
+ *
+ * Usage: hashtest [n]
+ *
+ * Tests that a table of n int keys, some of them inserted twice, can
+ * be saved with table_save() and mapped back with table_load_mapped()
+ * using the hash function the table was created with, and that every
+ * key is then found with all of its values, latest first. The loaded
+ * table is then changed, which thaws it, and checked again. The same
+ * is done with a weak hash function that makes many keys share a hash
+ * value. Finally it is checked that files with a corrupted header are
+ * not loaded.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "table.h"
+#include "hashtable.h"
+
+// Default number of keys
+#define DEFAULT_SIZE 10000
+// Maximum number of keys sharing 7 hash values, whose lookups take
+// time linear in the number of keys
+#define WEAK_SIZE 1000
+// Most values a key gets in the tests
+#define MAX_DUPS 3
+// Number of keys inserted into a loaded table
+#define EXTRA_KEYS 10
+// Bytes kept when the header of a saved table is truncated, at most
+// the size of the header
+#define HEADER_BYTES 64
+// Name of the file used to test saving and loading
+#define SAVE_PATH "hashtest.img"
+
+/* Keys the test expects to be in the table, from 0 to n-1.
+ *    n - the number of possible keys
+ *    values - the values of each key, latest first, MAX_DUPS per key
+ *    counts - the number of values of each key
+ */
+struct model {
+        int n;
+        int *values;
+        int *counts;
+};
+
+// Values visited by table_lookup_all(), in the order they were visited
+int visited_values[MAX_DUPS + 1];
+int n_visited;
+
+// Pairs inserted into a loaded table, which does not free them
+int extra_keys[EXTRA_KEYS + 1];
+int extra_values[EXTRA_KEYS + 1];
+
+/**
+ * int_ptr_from_int() - Create a dynamic copy of an int.
+ * @i: Value to copy.
+ *
+ * Returns: Pointer to the copy of i.
+ */
+int *int_ptr_from_int(int i)
+{
+        int *ip = malloc(sizeof(int));
+        *ip = i;
+        return ip;
+}
+
+int int_compare(const void *ip1,const void *ip2)
+{
+        const int *n1=ip1;
+        const int *n2=ip2;
+        return (*n1 > *n2) - (*n1 < *n2);
+}
+
+unsigned long int_hash(const void *ip)
+{
+        return *(const int *)ip;
+}
+
+// Hash function that makes groups of keys share a hash value.
+unsigned long weak_hash(const void *ip)
+{
+        return *(const int *)ip % 7;
+}
+
+size_t int_serialize(const void *p, void *buf, size_t size)
+{
+        if (size >= sizeof(int)) {
+                memcpy(buf, p, sizeof(int));
+        }
+        return sizeof(int);
+}
+
+/**
+ * fail() - Print an error message and exit.
+ * @name: Name of the test that failed.
+ * @what: What went wrong.
+ * @key: Key that went wrong.
+ *
+ * Returns: Never.
+ */
+void fail(const char *name, const char *what, int key)
+{
+        fprintf(stderr, "FAIL: %s: %s %d.\n", name, what, key);
+        exit(EXIT_FAILURE);
+}
+
+/**
+ * visit_pair() - Record a value visited by table_lookup_all().
+ * @key: Key of the pair.
+ * @value: Value of the pair.
+ *
+ * Returns: Nothing.
+ */
+void visit_pair(const void *key, const void *value)
+{
+        if (n_visited <= MAX_DUPS) {
+                visited_values[n_visited] = *(const int *)value;
+        }
+        n_visited++;
+}
+
+/**
+ * model_insert() - Add a value to a key of the model.
+ * @m: Model of the table.
+ * @key: Key from 0 to n-1.
+ * @value: Value of the key.
+ *
+ * Returns: Nothing.
+ */
+void model_insert(struct model *m, int key, int value)
+{
+        int *values = &m->values[key*MAX_DUPS];
+
+        memmove(&values[1], &values[0], m->counts[key]*sizeof(*values));
+        values[0] = value;
+        m->counts[key]++;
+}
+
+/**
+ * build_table() - Create a table with the keys 0..n-1.
+ * @m: Model of the table, with room for the keys.
+ * @hash: Hash function of the table.
+ *
+ * Every third key is first inserted with the value -1, and then again
+ * with its final value 2*key.
+ *
+ * Returns: The table.
+ */
+table *build_table(struct model *m, hash_function *hash)
+{
+        table *t = table_empty_hashed(int_compare, hash, free, free);
+        for (int i = 0; i < m->n - EXTRA_KEYS; i++) {
+                if (i % 3 == 0) {
+                        table_insert(t, int_ptr_from_int(i),
+                                     int_ptr_from_int(-1));
+                        model_insert(m, i, -1);
+                }
+                table_insert(t, int_ptr_from_int(i), int_ptr_from_int(2*i));
+                model_insert(m, i, 2*i);
+        }
+        return t;
+}
+
+/**
+ * check_table() - Check that a table holds the pairs of the model.
+ * @t: Table to check.
+ * @m: Model of the table.
+ * @name: Name of the test.
+ *
+ * Every key is looked up with table_lookup(), table_lookup_all() and
+ * table_count(), as are keys that were never inserted. Exits the
+ * program if any of them disagrees with the model.
+ *
+ * Returns: Nothing.
+ */
+void check_table(const table *t, const struct model *m, const char *name)
+{
+        for (int key = -m->n; key < 2*m->n; key++) {
+                bool stored = key >= 0 && key < m->n;
+                int count = stored ? m->counts[key] : 0;
+                const int *values = stored ? &m->values[key*MAX_DUPS] : NULL;
+                const int *v = table_lookup(t, &key);
+
+                if (count == 0 && v != NULL) {
+                        fail(name, "found missing key", key);
+                }
+                if (count > 0 && (v == NULL || *v != values[0])) {
+                        fail(name, "lost key", key);
+                }
+                if (table_count(t, &key) != (unsigned long)count) {
+                        fail(name, "wrong count of key", key);
+                }
+                n_visited = 0;
+                table_lookup_all(t, &key, visit_pair);
+                if (n_visited != count) {
+                        fail(name, "wrong number of values of key", key);
+                }
+                for (int i = 0; i < count; i++) {
+                        if (visited_values[i] != values[i]) {
+                                fail(name, "wrong value visited for key",
+                                     key);
+                        }
+                }
+        }
+        printf("%s: OK.\n", name);
+}
+
+/**
+ * test_round_trip() - Save, load and change a table.
+ * @n: Number of keys saved.
+ * @hash: Hash function of the table.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void test_round_trip(int n, hash_function *hash, const char *name)
+{
+        char test_name[100];
+        struct model m = { .n = n + EXTRA_KEYS };
+
+        m.values = malloc(m.n*MAX_DUPS*sizeof(*m.values));
+        m.counts = calloc(m.n, sizeof(*m.counts));
+        table *t = build_table(&m, hash);
+        snprintf(test_name, sizeof(test_name), "%s, built", name);
+        check_table(t, &m, test_name);
+
+        if (table_save(t, SAVE_PATH, int_serialize, int_serialize) != 0) {
+                fail(name, "could not save a table with n =", n);
+        }
+        table_kill(t);
+        table *loaded = table_load_mapped(SAVE_PATH, int_compare, hash);
+        remove(SAVE_PATH);
+        if (loaded == NULL) {
+                fail(name, "could not load a table with n =", n);
+        }
+        snprintf(test_name, sizeof(test_name), "%s, loaded", name);
+        check_table(loaded, &m, test_name);
+
+        // The first insert thaws the table. Keys after the saved ones
+        // are new, the last one gets another value for a saved key.
+        for (int i = 0; i <= EXTRA_KEYS; i++) {
+                extra_keys[i] = i < EXTRA_KEYS ? n + i : n/2;
+                extra_values[i] = 3*extra_keys[i];
+                table_insert(loaded, &extra_keys[i], &extra_values[i]);
+                model_insert(&m, extra_keys[i], extra_values[i]);
+        }
+        snprintf(test_name, sizeof(test_name), "%s, thawed by insert",
+                 name);
+        check_table(loaded, &m, test_name);
+
+        for (int key = 0; key < n; key += 2) {
+                table_remove(loaded, &key);
+                m.counts[key] = 0;
+        }
+        snprintf(test_name, sizeof(test_name), "%s, after removes", name);
+        check_table(loaded, &m, test_name);
+
+        table_kill(loaded);
+        free(m.values);
+        free(m.counts);
+}
+
+/**
+ * test_corrupted() - Check that a file with a corrupted header is
+ * not loaded.
+ * @keep: Number of bytes at the start of the file to keep, or -1 to
+ *        keep the whole file.
+ * @flip: Offset of a byte to change, or -1.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void test_corrupted(long keep, long flip, const char *name)
+{
+        table *t = table_empty_hashed(int_compare, int_hash, free, free);
+        table_insert(t, int_ptr_from_int(1), int_ptr_from_int(2));
+        if (table_save(t, SAVE_PATH, int_serialize, int_serialize) != 0) {
+                fail(name, "could not save a table with n =", 1);
+        }
+        table_kill(t);
+
+        FILE *f = fopen(SAVE_PATH, "r+b");
+        if (flip >= 0) {
+                fseek(f, flip, SEEK_SET);
+                int c = fgetc(f);
+                fseek(f, flip, SEEK_SET);
+                fputc(c ^ 0x5a, f);
+        }
+        if (keep >= 0) {
+                char buf[HEADER_BYTES];
+                rewind(f);
+                size_t n = fread(buf, 1, keep, f);
+                fclose(f);
+                f = fopen(SAVE_PATH, "wb");
+                fwrite(buf, 1, n, f);
+        }
+        fclose(f);
+
+        t = table_load_mapped(SAVE_PATH, int_compare, int_hash);
+        remove(SAVE_PATH);
+        if (t != NULL) {
+                table_kill(t);
+                fail(name, "loaded a corrupted file, byte", (int)flip);
+        }
+        printf("%s: OK.\n", name);
+}
+
+int main(int argc, char **argv)
+{
+        int n = DEFAULT_SIZE;
+        if (argc > 1) {
+                n = atoi(argv[1]);
+        }
+        if (n < 1) {
+                fprintf(stderr, "Usage: %s [n]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+
+        test_round_trip(0, int_hash, "Empty table");
+        test_round_trip(n, int_hash, "Distinct hash values");
+        test_round_trip(n < WEAK_SIZE ? n : WEAK_SIZE, weak_hash,
+                        "Shared hash values");
+
+        // The header starts with 8 magic bytes and then the version.
+        test_corrupted(-1, 0, "Corrupted magic");
+        test_corrupted(-1, 8, "Corrupted version");
+        test_corrupted(HEADER_BYTES/2, -1, "Truncated header");
+        test_corrupted(0, -1, "Empty file");
+        return 0;
+}
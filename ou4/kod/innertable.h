@@ -0,0 +1,101 @@
+#ifndef INNERTABLE_H
+#define INNERTABLE_H
+
+#include <stdbool.h>
+#include "util.h"
+
+/*
+ * Renamed table.h interface, used by implementations that wrap another
+ * implementation of table.h, e.g. bloomtable.c.
+ *
+ * Since table.h binds at link time, the wrapped implementation is
+ * compiled separately with INNER_TABLE_IMPLEMENTATION defined and this
+ * header forced in front of it, e.g.
+ *
+ *	gcc -c -DINNER_TABLE_IMPLEMENTATION -include innertable.h mtftable.c
+ *
+ * which renames table to inner_table and every table_xxx() function
+ * to inner_table_xxx(). The wrapper includes this header normally and
+ * calls the inner_table_xxx() functions declared below, which behave
+ * exactly as their counterparts in table.h.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added inner_table_stats().
+ *   2026-10-17: v1.2, added inner_table_empty_ex().
+ *   2026-10-17: v1.3, added inner_table_clear() and inner_table_drain().
+ *   2026-10-17: v1.4, added inner_table_lookup_all() and inner_table_count().
+ */
+
+#ifdef INNER_TABLE_IMPLEMENTATION
+
+#define table inner_table
+#define table_empty inner_table_empty
+#define table_empty_hashed inner_table_empty_hashed
+#define table_empty_ex inner_table_empty_ex
+#define table_is_empty inner_table_is_empty
+#define table_insert inner_table_insert
+#define table_lookup inner_table_lookup
+#define table_lookup_all inner_table_lookup_all
+#define table_count inner_table_count
+#define table_choose_key inner_table_choose_key
+#define table_remove inner_table_remove
+#define table_kill inner_table_kill
+#define table_clear inner_table_clear
+#define table_drain inner_table_drain
+#define table_print inner_table_print
+#define table_insert_many inner_table_insert_many
+#define table_lookup_many inner_table_lookup_many
+#define table_remove_many inner_table_remove_many
+#define table_stats inner_table_stats
+
+#include "table.h"
+
+#else
+
+#include "table.h"
+
+// ==========PUBLIC DATA TYPES============
+
+// Wrapped table type.
+typedef struct inner_table inner_table;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+inner_table *inner_table_empty(compare_function key_cmp_func,
+			       free_function key_free_func,
+			       free_function value_free_func);
+inner_table *inner_table_empty_hashed(compare_function key_cmp_func,
+				      hash_function key_hash_func,
+				      free_function key_free_func,
+				      free_function value_free_func);
+inner_table *inner_table_empty_ex(compare_function key_cmp_func,
+				  hash_function key_hash_func,
+				  free_function key_free_func,
+				  free_function value_free_func,
+				  unsigned int flags);
+bool inner_table_is_empty(const inner_table *t);
+void inner_table_insert(inner_table *t, void *key, void *value);
+void *inner_table_lookup(const inner_table *t, const void *key);
+void inner_table_lookup_all(const inner_table *t, const void *key,
+			    inspect_callback_pair func);
+unsigned long inner_table_count(const inner_table *t, const void *key);
+void *inner_table_choose_key(const inner_table *t);
+void inner_table_remove(inner_table *t, const void *key);
+void inner_table_kill(inner_table *t);
+void inner_table_clear(inner_table *t);
+void inner_table_drain(inner_table *t, consume_callback_pair func);
+void inner_table_print(const inner_table *t,
+		       inspect_callback_pair print_func);
+void inner_table_insert_many(inner_table *t, void **keys, void **values,
+			     int n);
+void inner_table_lookup_many(const inner_table *t, void **keys,
+			     void **values, int n);
+void inner_table_remove_many(inner_table *t, void **keys, int n);
+void inner_table_stats(const inner_table *t, table_statistics *out);
+
+#endif
+
+#endif
@@ -0,0 +1,613 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "table.h"
+#include "table_stats.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/*
+ * Implementation of a generic table using arrays, specialized for
+ * integer keys. Every key must be a pointer to an int. The key values
+ * are copied into a packed array of 32 bit integers that is searched
+ * with SIMD compares, 4 keys at a time with SSE2 or 16 at a time with
+ * AVX2. The kernel is chosen from what the CPU supports when a table
+ * is created, with a plain loop as fallback on other platforms. key_cmp_func is
+ * never called.
+ *
+ * The key pointers and values are kept in two arrays parallel to the
+ * packed keys. All three arrays double in size when full.
+ *
+ * Duplicates are handled by insert, as in arraytable.c. If the key
+ * already exists its key and value are replaced by the new ones.
+ *
+ * The correctness tests in tabletest use string keys, so run tabletest
+ * with -n for this table, and intarraytest for correctness.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added table_stats().
+ *   2026-10-17: v1.2, added table_empty_ex().
+ *   2026-10-17: v1.3, added table_clear() and table_drain().
+ *   2026-10-17: v1.4, added table_lookup_all() and table_count().
+ *   2026-10-18: v1.5, the search kernel is stored in the table instead
+ *                     of a static variable set on first use.
+ */
+
+// Number of pairs a newly created table has room for.
+#define INITIAL_CAPACITY 16
+
+// ===========INTERNAL DATA TYPES============
+
+// Function that returns the index of key in keys[0..n-1], or -1.
+typedef int find_function(const int32_t *keys, int n, int32_t key);
+
+struct table {
+	// Search kernel chosen for the CPU when the table was created.
+	find_function *find;
+	int size;
+	int capacity;
+	int32_t *int_keys;
+	void **keys;
+	void **values;
+	free_function key_free_func;
+	free_function value_free_func;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * find_scalar() - Find a key with a plain loop.
+ * @keys: Packed keys to search.
+ * @n: Number of keys.
+ * @key: Key to search for.
+ *
+ * Returns: Index of the first occurrence of key, or -1.
+ */
+static int find_scalar(const int32_t *keys, int n, int32_t key)
+{
+	for (int i = 0; i < n; i++) {
+		if (keys[i] == key) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+#ifdef HAVE_X86_SIMD
+
+/**
+ * find_sse2() - Find a key comparing 4 keys per instruction.
+ * @keys: Packed keys to search.
+ * @n: Number of keys.
+ * @key: Key to search for.
+ *
+ * Returns: Index of the first occurrence of key, or -1.
+ */
+__attribute__((target("sse2")))
+static int find_sse2(const int32_t *keys, int n, int32_t key)
+{
+	__m128i k = _mm_set1_epi32(key);
+	int i = 0;
+
+	for (; i + 4 <= n; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(keys + i));
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(v, k));
+		if (mask != 0) {
+			// Each 32 bit lane sets four bits of the mask.
+			return i + __builtin_ctz(mask) / 4;
+		}
+	}
+	int j = find_scalar(keys + i, n - i, key);
+	return j < 0 ? -1 : i + j;
+}
+
+/**
+ * find_avx2() - Find a key comparing 16 keys per loop iteration.
+ * @keys: Packed keys to search.
+ * @n: Number of keys.
+ * @key: Key to search for.
+ *
+ * Returns: Index of the first occurrence of key, or -1.
+ */
+__attribute__((target("avx2")))
+static int find_avx2(const int32_t *keys, int n, int32_t key)
+{
+	__m256i k = _mm256_set1_epi32(key);
+	int i = 0;
+
+	for (; i + 16 <= n; i += 16) {
+		__m256i lo = _mm256_loadu_si256((const __m256i *)(keys + i));
+		__m256i hi =
+			_mm256_loadu_si256((const __m256i *)(keys + i + 8));
+		__m256i eq_lo = _mm256_cmpeq_epi32(lo, k);
+		__m256i eq_hi = _mm256_cmpeq_epi32(hi, k);
+		// Test both halves with one branch, then find the lane.
+		if (!_mm256_testz_si256(_mm256_or_si256(eq_lo, eq_hi),
+					_mm256_or_si256(eq_lo, eq_hi))) {
+			unsigned mask = _mm256_movemask_epi8(eq_lo);
+			if (mask != 0) {
+				return i + __builtin_ctz(mask) / 4;
+			}
+			mask = _mm256_movemask_epi8(eq_hi);
+			return i + 8 + __builtin_ctz(mask) / 4;
+		}
+	}
+	int j = find_sse2(keys + i, n - i, key);
+	return j < 0 ? -1 : i + j;
+}
+
+#endif
+
+/**
+ * select_find() - Choose the fastest search kernel for this CPU.
+ *
+ * Returns: The search function to use.
+ */
+static find_function *select_find(void)
+{
+#ifdef HAVE_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return find_avx2;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		return find_sse2;
+	}
+#endif
+	return find_scalar;
+}
+
+/**
+ * scanned() - Compute the number of keys a search scanned.
+ * @t: Table that was searched.
+ * @i: Result of find_key().
+ *
+ * Returns: The number of packed keys up to and including key i, or
+ * all keys if i is -1.
+ */
+static unsigned long scanned(const table *t, int i)
+{
+	return i < 0 ? t->size : i + 1;
+}
+
+/**
+ * find_key() - Find the index of a key in a table.
+ * @t: Table to inspect.
+ * @key: Pointer to the int to search for.
+ *
+ * Returns: Index of key, or -1 if key is not in the table.
+ */
+static int find_key(const table *t, const void *key)
+{
+	return t->find(t->int_keys, t->size, *(const int *)key);
+}
+
+/**
+ * grow() - Double the capacity of the arrays.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+static void grow(table *t)
+{
+	t->capacity *= 2;
+	t->int_keys = realloc(t->int_keys,
+			      t->capacity * sizeof(*t->int_keys));
+	t->keys = realloc(t->keys, t->capacity * sizeof(*t->keys));
+	t->values = realloc(t->values, t->capacity * sizeof(*t->values));
+}
+
+/**
+ * empty_arrays() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * The arrays are shrunk back to INITIAL_CAPACITY.
+ *
+ * Returns: Nothing.
+ */
+static void empty_arrays(table *t, consume_callback_pair func)
+{
+	for (int i = 0; i < t->size; i++) {
+		if (func != NULL) {
+			func(t->keys[i], t->values[i]);
+			continue;
+		}
+		if (t->key_free_func != NULL) {
+			t->key_free_func(t->keys[i]);
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(t->values[i]);
+		}
+	}
+	t->size = 0;
+	t->capacity = INITIAL_CAPACITY;
+	t->int_keys = realloc(t->int_keys,
+			      t->capacity * sizeof(*t->int_keys));
+	t->keys = realloc(t->keys, t->capacity * sizeof(*t->keys));
+	t->values = realloc(t->values, t->capacity * sizeof(*t->values));
+}
+
+/**
+ * visit_key() - Visit the pair with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function to call for the pair, or NULL.
+ *
+ * Returns: The number of pairs with the key, 0 or 1.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	int i = find_key(t, key);
+
+	TABLE_STATS_LOOKUP(t, scanned(t, i), i >= 0);
+	if (i < 0) {
+		return 0;
+	}
+	if (func != NULL) {
+		func(t->keys[i], t->values[i]);
+	}
+	return 1;
+}
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: Ignored, keys are compared as ints.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	table *t = malloc(sizeof(*t));
+
+	t->find = select_find();
+	t->size = 0;
+	t->capacity = INITIAL_CAPACITY;
+	t->int_keys = malloc(t->capacity * sizeof(*t->int_keys));
+	t->keys = malloc(t->capacity * sizeof(*t->keys));
+	t->values = malloc(t->capacity * sizeof(*t->values));
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	TABLE_STATS_INIT(t);
+
+	return t;
+}
+
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: Ignored, keys are compared as ints.
+ * @key_hash_func: Ignored, the keys are searched linearly.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: Ignored, keys are compared as ints.
+ * @key_hash_func: Ignored, the keys are searched linearly.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: Ignored, keys are always unique since insert replaces the
+ *	   pair of a key already in the table.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to an int.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If key already exists in
+ * the table the existing key and value are replaced by the new ones.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	int i = find_key(t, key);
+
+	TABLE_STATS_INSERT(t, scanned(t, i));
+	if (i >= 0) {
+		// Free the previous key and value (if it is our business)
+		// unless they are the same memory as the new ones.
+		if (t->keys[i] != key && t->key_free_func != NULL) {
+			t->key_free_func(t->keys[i]);
+		}
+		if (t->values[i] != value && t->value_free_func != NULL) {
+			t->value_free_func(t->values[i]);
+		}
+		t->keys[i] = key;
+		t->values[i] = value;
+		return;
+	}
+	if (t->size == t->capacity) {
+		grow(t);
+	}
+	t->int_keys[t->size] = *(int *)key;
+	t->keys[t->size] = key;
+	t->values[t->size] = value;
+	t->size++;
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	int i = find_key(t, key);
+
+	TABLE_STATS_LOOKUP(t, scanned(t, i), i >= 0);
+	return i < 0 ? NULL : t->values[i];
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The keys of the table are unique, so func is called at most once.
+ * func must not change the table.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	// The last key is the cheapest one to remove.
+	return t->keys[t->size - 1];
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free functions set for keys/values. Does nothing if
+ * key is not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	int i = find_key(t, key);
+
+	TABLE_STATS_REMOVE(t, scanned(t, i));
+	if (i < 0) {
+		return;
+	}
+	if (t->key_free_func != NULL) {
+		t->key_free_func(t->keys[i]);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(t->values[i]);
+	}
+	// Move the last pair into the gap.
+	t->size--;
+	t->int_keys[i] = t->int_keys[t->size];
+	t->keys[i] = t->keys[t->size];
+	t->values[i] = t->values[t->size];
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	for (int i = 0; i < t->size; i++) {
+		if (t->key_free_func != NULL) {
+			t->key_free_func(t->keys[i]);
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(t->values[i]);
+		}
+	}
+	free(t->int_keys);
+	free(t->keys);
+	free(t->values);
+	TABLE_STATS_FREE(t);
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_arrays(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table.
+ *	  Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_arrays(t, func);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table and prints them.
+ * Will print all stored elements.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	for (int i = 0; i < t->size; i++) {
+		print_func(t->keys[i], t->values[i]);
+	}
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of an operation is the number of packed keys its
+ * search scanned, up to the key or to the end of the array. Keys are
+ * compared as ints, so the number of key compares is always 0.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
@@ -0,0 +1,273 @@
+/*
+ * intarraytest - test the int key search of the packed array table.
+ *
+ * Should be compiled together with intarraytable.c.
+ *
+ * Usage: intarraytest [n]
+ *
+ * Tests tables with int keys, which tabletest cannot do since its
+ * correctness tests use string keys. Tables of every size from 0 to
+ * MAX_SMALL pairs, and of n pairs, are filled with keys that include
+ * negative keys, INT_MIN and INT_MAX. Every key must then be found with
+ * its value, wherever it is in the packed array, and keys that differ
+ * from the stored ones only in a single bit must not be found. The
+ * small sizes put keys in the blocks of 16 keys searched with AVX2,
+ * the blocks of 4 searched with SSE2, and the tail searched with a
+ * plain loop, on CPUs that have those instructions. Inserting a key
+ * again must replace its value, and removes, which move the last pair
+ * into the gap, must keep all other keys. Every key and value must
+ * have been freed exactly once when a table is killed.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "table.h"
+
+// Default number of keys of the large table
+#define DEFAULT_SIZE 1000
+// Largest size tested with every key in every position, more than
+// two blocks of 16 keys and a tail
+#define MAX_SMALL 40
+
+// Number of keys and values allocated and freed by the tests
+unsigned long n_allocated;
+unsigned long n_freed;
+
+/**
+ * int_ptr_from_int() - Create a dynamic copy of an int.
+ * @i: Value to copy.
+ *
+ * Returns: Pointer to the copy of i.
+ */
+int *int_ptr_from_int(int i)
+{
+        int *ip = malloc(sizeof(int));
+        *ip = i;
+        n_allocated++;
+        return ip;
+}
+
+/**
+ * counting_free() - Free a key or value and count it.
+ * @p: Pointer from int_ptr_from_int().
+ *
+ * Returns: Nothing.
+ */
+void counting_free(void *p)
+{
+        free(p);
+        n_freed++;
+}
+
+int int_compare(const void *ip1,const void *ip2)
+{
+        const int *n1=ip1;
+        const int *n2=ip2;
+        return (*n1 > *n2) - (*n1 < *n2);
+}
+
+/**
+ * fail() - Print an error message and exit.
+ * @name: Name of the test that failed.
+ * @size: Size of the table.
+ * @what: What went wrong.
+ * @key: Key that went wrong.
+ *
+ * Returns: Never.
+ */
+void fail(const char *name, int size, const char *what, int key)
+{
+        fprintf(stderr, "FAIL: %s, %d keys: %s %d.\n", name, size, what,
+                key);
+        exit(EXIT_FAILURE);
+}
+
+/**
+ * key_at() - Compute the i:th key of the tests.
+ * @i: Index of the key.
+ *
+ * The first keys are INT_MIN, INT_MAX, -1 and 0, the rest are spread
+ * over the whole range of int by a multiplication that is one-to-one.
+ *
+ * Returns: The key.
+ */
+int key_at(int i)
+{
+        int first[] = { INT_MIN, INT_MAX, -1, 0 };
+
+        if (i < 4) {
+                return first[i];
+        }
+        return (int)((unsigned int)i * 2654435761u);
+}
+
+/**
+ * value_of() - Compute the value stored with a key.
+ * @key: The key.
+ * @round: Number of times the key has been inserted before.
+ *
+ * Returns: The value.
+ */
+int value_of(int key, int round)
+{
+        return (int)((unsigned int)key * 3u + round);
+}
+
+/**
+ * check_table() - Check that a table holds exactly some of the keys.
+ * @t: Table to check.
+ * @keys: Keys of the test.
+ * @stored: Whether each key is in the table.
+ * @rounds: Number of times each key has been inserted before its
+ *          current value.
+ * @n: Number of keys of the test.
+ * @name: Name of the test.
+ *
+ * Each key is looked up with table_lookup() and table_count(), as are
+ * keys that differ from it in one bit and are not in the test.
+ *
+ * Returns: Nothing.
+ */
+void check_table(const table *t, const int *keys, const bool *stored,
+                 const int *rounds, int n, const char *name)
+{
+        int size = 0;
+
+        for (int i = 0; i < n; i++) {
+                const int *v = table_lookup(t, &keys[i]);
+                if (stored[i]) {
+                        size++;
+                        if (v == NULL) {
+                                fail(name, n, "lost key", keys[i]);
+                        }
+                        if (*v != value_of(keys[i], rounds[i])) {
+                                fail(name, n, "wrong value of key",
+                                     keys[i]);
+                        }
+                } else if (v != NULL) {
+                        fail(name, n, "found removed key", keys[i]);
+                }
+                if (table_count(t, &keys[i]) != (stored[i] ? 1UL : 0UL)) {
+                        fail(name, n, "wrong count of key", keys[i]);
+                }
+        }
+        for (int i = 0; i < n && n <= MAX_SMALL; i++) {
+                for (int bit = 0; bit < 32; bit++) {
+                        int other = (int)((unsigned int)keys[i]
+                                          ^ (1u << bit));
+                        bool known = false;
+                        for (int j = 0; j < n; j++) {
+                                known = known || keys[j] == other;
+                        }
+                        if (!known && table_lookup(t, &other) != NULL) {
+                                fail(name, n, "found missing key", other);
+                        }
+                }
+        }
+        if (table_is_empty(t) != (size == 0)) {
+                fail(name, n, "wrong emptiness with keys left:", size);
+        }
+}
+
+/**
+ * test_size() - Fill a table, replace some values and remove the keys.
+ * @n: Number of keys.
+ * @check_all: Whether to check the whole table after every remove.
+ *
+ * Returns: Nothing.
+ */
+void test_size(int n, bool check_all)
+{
+        table *t = table_empty(int_compare, counting_free, counting_free);
+        int *keys = malloc((n + 1) * sizeof(*keys));
+        int *rounds = calloc(n + 1, sizeof(*rounds));
+        bool *stored = calloc(n + 1, sizeof(*stored));
+
+        for (int i = 0; i < n; i++) {
+                keys[i] = key_at(i);
+                table_insert(t, int_ptr_from_int(keys[i]),
+                             int_ptr_from_int(value_of(keys[i], 0)));
+                stored[i] = true;
+        }
+        check_table(t, keys, stored, rounds, n, "Filled");
+
+        // Replace every third value, which frees the old key and value
+        for (int i = 0; i < n; i += 3) {
+                unsigned long freed = n_freed;
+                rounds[i]++;
+                table_insert(t, int_ptr_from_int(keys[i]),
+                             int_ptr_from_int(value_of(keys[i], rounds[i])));
+                if (n_freed != freed + 2) {
+                        fail("Replaced", n, "did not free the pair of key",
+                             keys[i]);
+                }
+        }
+        check_table(t, keys, stored, rounds, n, "Replaced");
+
+        // Remove from the front, in the middle and at the end, so that
+        // the last pair is moved into gaps at every position
+        for (int step = 0; step < n; step++) {
+                int i = step % 3 == 0 ? step / 3
+                        : step % 3 == 1 ? n - 1 - step / 3 : n / 2;
+                while (!stored[i]) {
+                        i = (i + 1) % n;
+                }
+                table_remove(t, &keys[i]);
+                stored[i] = false;
+                if (check_all || step == n / 2) {
+                        check_table(t, keys, stored, rounds, n, "Removed");
+                }
+        }
+        check_table(t, keys, stored, rounds, n, "Removed all");
+
+        // Removing a missing key does nothing
+        unsigned long freed = n_freed;
+        table_remove(t, &keys[0]);
+        if (n_freed != freed) {
+                fail("Removed all", n, "freed a pair when removing", keys[0]);
+        }
+
+        for (int i = 0; i < n; i += 2) {
+                table_insert(t, int_ptr_from_int(keys[i]),
+                             int_ptr_from_int(value_of(keys[i], 0)));
+                stored[i] = true;
+                rounds[i] = 0;
+        }
+        check_table(t, keys, stored, rounds, n, "Refilled");
+        table_kill(t);
+        if (n_freed != n_allocated) {
+                fail("Killed", n, "keys and values not freed:",
+                     (int)(n_allocated - n_freed));
+        }
+        free(keys);
+        free(rounds);
+        free(stored);
+}
+
+int main(int argc, char **argv)
+{
+        int n = DEFAULT_SIZE;
+        if (argc > 1) {
+                n = atoi(argv[1]);
+        }
+        if (n < 0 || n > 100000000) {
+                fprintf(stderr, "Usage: %s [n]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+
+        for (int size = 0; size <= MAX_SMALL; size++) {
+                test_size(size, true);
+        }
+        printf("Sizes 0 to %d: OK.\n", MAX_SMALL);
+        test_size(n, false);
+        printf("Size %d: OK.\n", n);
+        return 0;
+}
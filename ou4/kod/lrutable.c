@@ -0,0 +1,727 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "table.h"
+#include "table_stats.h"
+#include "lrutable.h"
+
+/*
+ * Implementation of a generic table as a bounded least recently used
+ * (LRU) cache.
+ *
+ * Like the move-to-front list in mtftable.c, the pairs are kept in a
+ * list ordered by how recently they were inserted or found, with the
+ * most recently used pair first. The list is doubly linked with a
+ * sentinel, so a pair is moved to the front and the least recently
+ * used pair is unlinked from the back in constant time. An index of
+ * chained hash buckets locates the list entry of a key, so no
+ * operation walks the list. The buckets are doubled when there are
+ * more pairs than buckets.
+ *
+ * A table with a capacity never holds more pairs than that. Inserting
+ * a new key into a full table evicts the pair at the back of the list
+ * and calls any free functions on its key and value.
+ *
+ * The keys are always unique. Inserting a key that is already in the
+ * table replaces its key and value, as with TABLE_UNIQUE_KEYS, and
+ * moves the pair to the front.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added table_clear() and table_drain().
+ *   2026-10-17: v1.2, added table_lookup_all() and table_count().
+ */
+
+// Capacity used by table_empty(), 0 for no limit.
+#ifndef LRU_DEFAULT_CAPACITY
+#define LRU_DEFAULT_CAPACITY 0
+#endif
+
+// Number of buckets in a newly created table. Must be a power of two.
+#define INITIAL_BUCKETS 16
+
+// ===========INTERNAL DATA TYPES============
+
+struct table_entry {
+	void *key;
+	void *value;
+	// Mixed hash value of the key.
+	unsigned long hash;
+	// Neighbours in the recency list.
+	struct table_entry *prev;
+	struct table_entry *next;
+	// Next entry in the same bucket.
+	struct table_entry *chain;
+};
+
+struct table {
+	// Sentinel of the recency list. Its next entry is the most
+	// recently used pair and its prev entry the least recently used.
+	// Allocated separately, since table_lookup() relinks the list.
+	struct table_entry *head;
+	// Bucket array, its number of buckets (a power of two) and the
+	// number of pairs in the table.
+	struct table_entry **buckets;
+	unsigned long n_buckets;
+	size_t size;
+	// Maximum number of pairs, or 0 for no limit.
+	size_t capacity;
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	free_function key_free_func;
+	free_function value_free_func;
+	// Cache counters, updated by table_lookup().
+	lru_stats *counters;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * mix_hash() - Spread the bits of a user supplied hash value.
+ * @h: Hash value returned by the key hash function.
+ *
+ * Uses the finalizer of MurmurHash3, so that identity hashes of
+ * integer keys use all buckets.
+ *
+ * Returns: The mixed hash value.
+ */
+static unsigned long mix_hash(unsigned long h)
+{
+	unsigned long long x = h;
+
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+
+	return (unsigned long)x;
+}
+
+/**
+ * key_hash() - Compute the mixed hash value of a key.
+ * @t: Table the key belongs to.
+ * @key: Key to hash.
+ *
+ * A table created without a hash function puts every key in the same
+ * bucket. It still works, but every operation scans all pairs.
+ *
+ * Returns: The mixed hash value of the key.
+ */
+static unsigned long key_hash(const table *t, const void *key)
+{
+	if (t->key_hash_func == NULL) {
+		return 0;
+	}
+	return mix_hash(t->key_hash_func(key));
+}
+
+/**
+ * find_link() - Find the bucket link to the entry of a key.
+ * @t: Table to inspect.
+ * @key: Key to look for.
+ * @hash: Mixed hash value of key.
+ * @probes: Set to the number of entries examined.
+ *
+ * Returns: Address of the link that points to the entry of key, or of
+ * the NULL link that ends the bucket if key is not in the table.
+ */
+static struct table_entry **find_link(const table *t, const void *key,
+				      unsigned long hash,
+				      unsigned long *probes)
+{
+	struct table_entry **link = &t->buckets[hash & (t->n_buckets - 1)];
+
+	*probes = 0;
+	while (*link != NULL) {
+		(*probes)++;
+		if ((*link)->hash == hash
+		    && TABLE_KEY_CMP(t, (*link)->key, key) == 0) {
+			break;
+		}
+		link = &(*link)->chain;
+	}
+	return link;
+}
+
+/**
+ * unlink_entry() - Take an entry out of the recency list.
+ * @e: Entry to unlink.
+ *
+ * Returns: Nothing.
+ */
+static void unlink_entry(struct table_entry *e)
+{
+	e->prev->next = e->next;
+	e->next->prev = e->prev;
+}
+
+/**
+ * push_front() - Make an entry the most recently used one.
+ * @t: Table to manipulate.
+ * @e: Entry that is not in the recency list.
+ *
+ * Returns: Nothing.
+ */
+static void push_front(const table *t, struct table_entry *e)
+{
+	e->prev = t->head;
+	e->next = t->head->next;
+	t->head->next->prev = e;
+	t->head->next = e;
+}
+
+/**
+ * free_entry() - Free an entry that has been unlinked everywhere.
+ * @t: Table the entry belonged to.
+ * @e: Entry to free.
+ *
+ * Calls any free functions set for keys/values on the key and value
+ * of the entry.
+ *
+ * Returns: Nothing.
+ */
+static void free_entry(const table *t, struct table_entry *e)
+{
+	if (t->key_free_func != NULL) {
+		t->key_free_func(e->key);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(e->value);
+	}
+	free(e);
+}
+
+/**
+ * grow() - Double the number of buckets and rehash all entries.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+static void grow(table *t)
+{
+	unsigned long n_buckets = t->n_buckets * 2;
+	struct table_entry **buckets = calloc(n_buckets, sizeof(*buckets));
+
+	for (struct table_entry *e = t->head->next; e != t->head; e = e->next) {
+		unsigned long i = e->hash & (n_buckets - 1);
+		e->chain = buckets[i];
+		buckets[i] = e;
+	}
+	free(t->buckets);
+	t->buckets = buckets;
+	t->n_buckets = n_buckets;
+}
+
+/**
+ * evict() - Remove the least recently used pair.
+ * @t: Non-empty table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+static void evict(table *t)
+{
+	struct table_entry *e = t->head->prev;
+	struct table_entry **link = &t->buckets[e->hash & (t->n_buckets - 1)];
+
+	// Find the entry by address, the keys need not be compared.
+	while (*link != e) {
+		link = &(*link)->chain;
+	}
+	*link = e->chain;
+	unlink_entry(e);
+	free_entry(t, e);
+	t->size--;
+	t->counters->evictions++;
+}
+
+/**
+ * empty_list() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * The bucket array is shrunk back to INITIAL_BUCKETS. The cache
+ * counters are kept.
+ *
+ * Returns: Nothing.
+ */
+static void empty_list(table *t, consume_callback_pair func)
+{
+	struct table_entry *e = t->head->next;
+
+	while (e != t->head) {
+		struct table_entry *next = e->next;
+		if (func != NULL) {
+			func(e->key, e->value);
+			free(e);
+		} else {
+			free_entry(t, e);
+		}
+		e = next;
+	}
+	t->head->prev = t->head;
+	t->head->next = t->head;
+	free(t->buckets);
+	t->n_buckets = INITIAL_BUCKETS;
+	t->buckets = calloc(t->n_buckets, sizeof(*t->buckets));
+	t->size = 0;
+}
+
+/**
+ * visit_key() - Visit the pair with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function to call for the pair, or NULL.
+ *
+ * Unlike table_lookup(), the pair is not moved to the front and the
+ * hit and miss counters are not changed.
+ *
+ * Returns: The number of pairs with the key, 0 or 1.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	unsigned long probes;
+	struct table_entry *e = *find_link(t, key, key_hash(t, key), &probes);
+
+	TABLE_STATS_LOOKUP(t, probes, e != NULL);
+	if (e == NULL) {
+		return 0;
+	}
+	if (func != NULL) {
+		func(e->key, e->value);
+	}
+	return 1;
+}
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty_lru() - Create an empty table with a fixed capacity.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill/eviction.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill/eviction.
+ * @capacity: Maximum number of pairs, or 0 for no limit.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_lru(compare_function *key_cmp_func,
+		       hash_function *key_hash_func,
+		       free_function key_free_func,
+		       free_function value_free_func,
+		       size_t capacity)
+{
+	// Allocate the table header.
+	table *t = calloc(1, sizeof(*t));
+	// Create the sentinel of the empty recency list.
+	t->head = calloc(1, sizeof(*t->head));
+	t->head->prev = t->head;
+	t->head->next = t->head;
+	// Allocate the bucket array. All buckets start out empty.
+	t->n_buckets = INITIAL_BUCKETS;
+	t->buckets = calloc(t->n_buckets, sizeof(*t->buckets));
+	t->capacity = capacity;
+	// Store the key compare/hash functions and key/value free functions.
+	t->key_cmp_func = key_cmp_func;
+	t->key_hash_func = key_hash_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	t->counters = calloc(1, sizeof(*t->counters));
+	TABLE_STATS_INIT(t);
+
+	return t;
+}
+
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table with the capacity
+ * LRU_DEFAULT_CAPACITY.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return table_empty_lru(key_cmp_func, key_hash_func, key_free_func,
+			       value_free_func, LRU_DEFAULT_CAPACITY);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: Ignored, the keys of this table are always unique.
+ *
+ * Returns: Pointer to a new table with the capacity
+ * LRU_DEFAULT_CAPACITY.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	return table_empty_hashed(key_cmp_func, key_hash_func,
+				  key_free_func, value_free_func);
+}
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Without a hash function all keys share one bucket, so use
+ * table_empty_hashed() or table_empty_lru() to get constant time
+ * operations.
+ *
+ * Returns: Pointer to a new table with the capacity
+ * LRU_DEFAULT_CAPACITY.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return table_empty_hashed(key_cmp_func, NULL, key_free_func,
+				  value_free_func);
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table as the most recently used
+ * pair. If the key already is in the table, its key and value are
+ * replaced, and any free functions are called on the replaced ones
+ * unless they are the same memory as the new ones. Otherwise, if the
+ * table is full, the least recently used pair is evicted first.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	unsigned long hash = key_hash(t, key);
+	unsigned long probes;
+	struct table_entry **link = find_link(t, key, hash, &probes);
+	struct table_entry *e = *link;
+
+	TABLE_STATS_INSERT(t, probes);
+	if (e != NULL) {
+		if (t->key_free_func != NULL && e->key != key) {
+			t->key_free_func(e->key);
+		}
+		if (t->value_free_func != NULL && e->value != value) {
+			t->value_free_func(e->value);
+		}
+		e->key = key;
+		e->value = value;
+		unlink_entry(e);
+		push_front(t, e);
+		return;
+	}
+
+	if (t->capacity > 0 && t->size == t->capacity) {
+		evict(t);
+	}
+	e = malloc(sizeof(*e));
+	e->key = key;
+	e->value = value;
+	e->hash = hash;
+	// Put the entry first in its bucket. The eviction may have
+	// changed the bucket, so the link is not reused.
+	struct table_entry **bucket = &t->buckets[hash & (t->n_buckets - 1)];
+	e->chain = *bucket;
+	*bucket = e;
+	push_front(t, e);
+	t->size++;
+	if (t->size > t->n_buckets) {
+		grow(t);
+	}
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * A found pair becomes the most recently used one. Counts the lookup
+ * as a hit or a miss.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	unsigned long probes;
+	struct table_entry *e = *find_link(t, key, key_hash(t, key), &probes);
+
+	TABLE_STATS_LOOKUP(t, probes, e != NULL);
+	if (e == NULL) {
+		t->counters->misses++;
+		return NULL;
+	}
+	t->counters->hits++;
+	if (e != t->head->next) {
+		unlink_entry(e);
+		push_front(t, e);
+	}
+	return e->value;
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The keys of the table are unique, so func is called at most once.
+ * Unlike table_lookup(), the pair is not moved to the front. func
+ * must not change the table.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: The key of the most recently used pair.
+ */
+void *table_choose_key(const table *t)
+{
+	return t->head->next->key;
+}
+
+/**
+ * table_remove() - Remove a pair from a table.
+ * @t: Table to manipulate.
+ * @key: Key of the pair to remove.
+ *
+ * Any matching key/value pair is removed from the table. Calls any
+ * free functions set for keys/values. Does nothing if key is not
+ * found in the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	unsigned long probes;
+	struct table_entry **link = find_link(t, key, key_hash(t, key),
+					      &probes);
+	struct table_entry *e = *link;
+
+	TABLE_STATS_REMOVE(t, probes);
+	if (e == NULL) {
+		return;
+	}
+	*link = e->chain;
+	unlink_entry(e);
+	free_entry(t, e);
+	t->size--;
+}
+
+/**
+ * table_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	struct table_entry *e = t->head->next;
+
+	while (e != t->head) {
+		struct table_entry *next = e->next;
+		free_entry(t, e);
+		e = next;
+	}
+	free(t->head);
+	free(t->buckets);
+	free(t->counters);
+	TABLE_STATS_FREE(t);
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_list(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table.
+ *	  Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_list(t, func);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table, from the most
+ * recently used to the least recently used, and prints them. Will
+ * print all stored elements.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	for (struct table_entry *e = t->head->next; e != t->head; e = e->next) {
+		print_func(e->key, e->value);
+	}
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of an operation is the number of entries in the
+ * bucket of the key it examined.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
+
+/**
+ * table_lru_stats() - Get the cache counters of a table.
+ * @t: Table to inspect.
+ * @out: Set to the counters since the table was created.
+ *
+ * Returns: Nothing.
+ */
+void table_lru_stats(const table *t, lru_stats *out)
+{
+	*out = *t->counters;
+	out->size = t->size;
+	out->capacity = t->capacity;
+}
@@ -0,0 +1,69 @@
+#ifndef LRUTABLE_H
+#define LRUTABLE_H
+
+#include <stddef.h>
+
+#include "table.h"
+
+/*
+ * Extra operations for the bounded LRU cache implementation of
+ * table.h in lrutable.c.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+
+// Cache counters of a table.
+typedef struct lru_stats {
+	// Lookups that found their key.
+	unsigned long hits;
+	// Lookups that did not find their key.
+	unsigned long misses;
+	// Pairs removed by inserts into a full table.
+	unsigned long evictions;
+	// Number of pairs in the table.
+	size_t size;
+	// Maximum number of pairs in the table, or 0 if unbounded.
+	size_t capacity;
+} lru_stats;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_empty_lru() - Create an empty table with a fixed capacity.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill/eviction.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill/eviction.
+ * @capacity: Maximum number of pairs, or 0 for no limit.
+ *
+ * Inserting a new key into a table holding capacity pairs first
+ * evicts the least recently used pair and calls any free functions
+ * on its key and value. table_empty(), table_empty_hashed() and
+ * table_empty_ex() create tables with the capacity
+ * LRU_DEFAULT_CAPACITY, which is 0 unless defined at compile time.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_lru(compare_function *key_cmp_func,
+		       hash_function *key_hash_func,
+		       free_function key_free_func,
+		       free_function value_free_func,
+		       size_t capacity);
+
+/**
+ * table_lru_stats() - Get the cache counters of a table.
+ * @t: Table to inspect.
+ * @out: Set to the counters since the table was created.
+ *
+ * Returns: Nothing.
+ */
+void table_lru_stats(const table *t, lru_stats *out);
+
+#endif
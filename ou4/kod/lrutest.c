@@ -0,0 +1,402 @@
+/*
+ * lrutest - test the bounded capacity of the LRU cache table.
+ *
+ * Should be compiled together with lrutable.c.
+ *
+ * Usage: lrutest [n]
+ *
+ * Tests that a table with a capacity of n pairs never holds more than
+ * that, and that inserting a new key into a full table evicts the
+ * least recently used pair and frees its key and value. It is checked
+ * that a lookup that finds a key, or an insert that replaces it,
+ * protects it from the next eviction, while table_lookup_all(),
+ * table_count() and lookups of missing keys do not. The counters of
+ * table_lru_stats() are checked after every step, and at the end every
+ * key and value must have been freed exactly once. Tables with a
+ * capacity of a single pair and without a capacity are tested as well.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "table.h"
+#include "lrutable.h"
+
+// Default capacity
+#define DEFAULT_SIZE 1000
+
+// Number of keys and values allocated and freed by the tests
+unsigned long n_allocated;
+unsigned long n_freed;
+
+/**
+ * int_ptr_from_int() - Create a dynamic copy of an int.
+ * @i: Value to copy.
+ *
+ * Returns: Pointer to the copy of i.
+ */
+int *int_ptr_from_int(int i)
+{
+        int *ip = malloc(sizeof(int));
+        *ip = i;
+        n_allocated++;
+        return ip;
+}
+
+/**
+ * counting_free() - Free a key or value and count it.
+ * @p: Pointer from int_ptr_from_int().
+ *
+ * Returns: Nothing.
+ */
+void counting_free(void *p)
+{
+        free(p);
+        n_freed++;
+}
+
+// Callback of table_lookup_all() that does nothing.
+void ignore_pair(const void *key, const void *value)
+{
+}
+
+int int_compare(const void *ip1,const void *ip2)
+{
+        const int *n1=ip1;
+        const int *n2=ip2;
+        return (*n1 > *n2) - (*n1 < *n2);
+}
+
+unsigned long int_hash(const void *ip)
+{
+        return *(const int *)ip;
+}
+
+/**
+ * fail() - Print an error message and exit.
+ * @name: Name of the test that failed.
+ * @what: What went wrong.
+ * @n: Number that went wrong.
+ *
+ * Returns: Never.
+ */
+void fail(const char *name, const char *what, unsigned long n)
+{
+        fprintf(stderr, "FAIL: %s: %s %lu.\n", name, what, n);
+        exit(EXIT_FAILURE);
+}
+
+/* Keys the test expects to be in a table, in order of use.
+ *    keys - the keys, least recently used first
+ *    size - the number of keys
+ *    capacity - the capacity of the table
+ *    hits, misses, evictions - the expected cache counters
+ *    freed - the expected number of keys and values freed
+ */
+struct model {
+        int *keys;
+        int size;
+        int capacity;
+        unsigned long hits;
+        unsigned long misses;
+        unsigned long evictions;
+        unsigned long freed;
+};
+
+/**
+ * model_find() - Find a key in the model.
+ * @m: Model of the table.
+ * @key: Key to find.
+ *
+ * Returns: The position of the key, or -1 if it is not in the model.
+ */
+int model_find(const struct model *m, int key)
+{
+        for (int i = 0; i < m->size; i++) {
+                if (m->keys[i] == key) {
+                        return i;
+                }
+        }
+        return -1;
+}
+
+/**
+ * model_drop() - Remove the key at a position from the model.
+ * @m: Model of the table.
+ * @i: Position of the key.
+ *
+ * Returns: Nothing.
+ */
+void model_drop(struct model *m, int i)
+{
+        for (; i < m->size - 1; i++) {
+                m->keys[i] = m->keys[i + 1];
+        }
+        m->size--;
+}
+
+/**
+ * insert_key() - Insert a key with the value 2*key into a table and
+ * its model.
+ * @t: Table to insert into.
+ * @m: Model of the table.
+ * @key: Key to insert.
+ *
+ * A key already in the table is replaced, otherwise the least
+ * recently used key is evicted if the table is full. Either way a
+ * key and a value are freed.
+ *
+ * Returns: Nothing.
+ */
+void insert_key(table *t, struct model *m, int key)
+{
+        int i = model_find(m, key);
+
+        table_insert(t, int_ptr_from_int(key), int_ptr_from_int(2*key));
+        if (i >= 0) {
+                model_drop(m, i);
+                m->freed += 2;
+        } else if (m->capacity > 0 && m->size == m->capacity) {
+                model_drop(m, 0);
+                m->evictions++;
+                m->freed += 2;
+        }
+        m->keys[m->size++] = key;
+}
+
+/**
+ * lookup_key() - Look up a key in a table and its model.
+ * @t: Table to look up in.
+ * @m: Model of the table.
+ * @key: Key to look up.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void lookup_key(const table *t, struct model *m, int key, const char *name)
+{
+        int i = model_find(m, key);
+        const int *v = table_lookup(t, &key);
+
+        if (i < 0) {
+                if (v != NULL) {
+                        fail(name, "found missing key", key);
+                }
+                m->misses++;
+                return;
+        }
+        if (v == NULL || *v != 2*key) {
+                fail(name, "lost key", key);
+        }
+        model_drop(m, i);
+        m->keys[m->size++] = key;
+        m->hits++;
+}
+
+/**
+ * check_counters() - Check the cache counters of a table and the
+ * number of keys and values freed.
+ * @t: Table to check.
+ * @m: Model of the table.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void check_counters(const table *t, const struct model *m, const char *name)
+{
+        lru_stats stats;
+
+        table_lru_stats(t, &stats);
+        if (stats.hits != m->hits) {
+                fail(name, "wrong number of hits,", stats.hits);
+        }
+        if (stats.misses != m->misses) {
+                fail(name, "wrong number of misses,", stats.misses);
+        }
+        if (stats.evictions != m->evictions) {
+                fail(name, "wrong number of evictions,", stats.evictions);
+        }
+        if (stats.size != (size_t)m->size) {
+                fail(name, "wrong size,", stats.size);
+        }
+        if (stats.capacity != (size_t)m->capacity) {
+                fail(name, "wrong capacity,", stats.capacity);
+        }
+        if (n_freed != m->freed) {
+                fail(name, "wrong number of keys and values freed,", n_freed);
+        }
+}
+
+/**
+ * check_table() - Check the keys and cache counters of a table and
+ * the number of keys and values freed.
+ * @t: Table to check.
+ * @m: Model of the table.
+ * @max_key: Largest key that may have been inserted.
+ * @name: Name of the test.
+ *
+ * The keys are looked up with table_count(), which does not change
+ * the order of use.
+ *
+ * Returns: Nothing.
+ */
+void check_table(const table *t, const struct model *m, int max_key,
+                 const char *name)
+{
+        for (int key = 0; key <= max_key; key++) {
+                bool expected = model_find(m, key) >= 0;
+                if (table_count(t, &key) != (expected ? 1 : 0)) {
+                        fail(name, expected ? "lost key" : "kept key", key);
+                }
+        }
+        check_counters(t, m, name);
+}
+
+/**
+ * check_kill() - Kill a table and check that all keys and values have
+ * been freed.
+ * @t: Table to kill.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void check_kill(table *t, const char *name)
+{
+        table_kill(t);
+        if (n_freed != n_allocated) {
+                fail(name, "keys and values not freed:",
+                     n_allocated - n_freed);
+        }
+        printf("%s: OK.\n", name);
+}
+
+/**
+ * test_capacity() - Fill a table past its capacity.
+ * @capacity: Capacity of the table, at least 1.
+ *
+ * Returns: Nothing.
+ */
+void test_capacity(int capacity)
+{
+        table *t = table_empty_lru(int_compare, int_hash, counting_free,
+                                   counting_free, capacity);
+        struct model m = { .capacity = capacity, .freed = n_freed };
+        int c = capacity;
+        int max_key = 3*c + 2;
+        int key;
+
+        m.keys = malloc(capacity*sizeof(*m.keys));
+        for (key = 0; key < c; key++) {
+                insert_key(t, &m, key);
+        }
+        check_table(t, &m, max_key, "Full table");
+
+        // A hit on the least recently used key protects it, while a
+        // miss, table_count() and table_lookup_all() do not change
+        // the order of use
+        lookup_key(t, &m, 0, "Hit protects key");
+        lookup_key(t, &m, max_key, "Hit protects key");
+        key = c > 1 ? 1 : 0;
+        table_count(t, &key);
+        table_lookup_all(t, &key, ignore_pair);
+        insert_key(t, &m, c);
+        check_table(t, &m, max_key, "Hit protects key");
+        key = 1;
+        if (c > 1 && (table_count(t, &key) != 0 || m.evictions != 1)) {
+                fail("Hit protects key", "did not evict key", key);
+        }
+        key = 0;
+        if (c > 1 && table_count(t, &key) != 1) {
+                fail("Hit protects key", "evicted key", key);
+        }
+
+        // Replacing the least recently used key protects it too, and
+        // frees the replaced key and value without evicting
+        insert_key(t, &m, m.keys[0]);
+        check_table(t, &m, max_key, "Replace protects key");
+        insert_key(t, &m, c + 1);
+        check_table(t, &m, max_key, "Replace protects key");
+
+        // Each new key evicts the least recently used one
+        for (key = c + 2; key < 3*c + 2; key++) {
+                int lru = m.keys[0];
+                insert_key(t, &m, key);
+                if (table_count(t, &lru) != 0) {
+                        fail("Evict all", "did not evict key", lru);
+                }
+                if (key % 3 == 0) {
+                        lookup_key(t, &m, m.keys[0], "Evict all");
+                }
+                check_counters(t, &m, "Evict all");
+        }
+        check_table(t, &m, max_key, "Evict all");
+
+        // A remove makes room, so the next insert does not evict
+        key = m.keys[m.size/2];
+        table_remove(t, &key);
+        model_drop(&m, m.size/2);
+        m.freed += 2;
+        insert_key(t, &m, max_key);
+        check_table(t, &m, max_key, "Remove makes room");
+
+        free(m.keys);
+        char name[40];
+        snprintf(name, sizeof(name), "Capacity %d", capacity);
+        check_kill(t, name);
+}
+
+/**
+ * test_unbounded() - Test a table created by table_empty(), which has
+ * no capacity unless LRU_DEFAULT_CAPACITY is defined.
+ * @n: Number of keys to insert.
+ *
+ * Returns: Nothing.
+ */
+void test_unbounded(int n)
+{
+        table *t = table_empty(int_compare, counting_free, counting_free);
+        struct model m = { .freed = n_freed };
+        lru_stats stats;
+
+        table_lru_stats(t, &stats);
+        if (stats.capacity != 0) {
+                printf("Default capacity %zu, skipped test of unbounded "
+                       "table.\n", stats.capacity);
+                table_kill(t);
+                return;
+        }
+        m.keys = malloc(n*sizeof(*m.keys));
+        for (int key = 0; key < n; key++) {
+                insert_key(t, &m, key);
+        }
+        for (int key = 0; key < n; key += 2) {
+                lookup_key(t, &m, key, "Unbounded table");
+        }
+        check_table(t, &m, n, "Unbounded table");
+        free(m.keys);
+        check_kill(t, "Unbounded table");
+}
+
+int main(int argc, char **argv)
+{
+        int n = DEFAULT_SIZE;
+        if (argc > 1) {
+                n = atoi(argv[1]);
+        }
+        if (n < 1) {
+                fprintf(stderr, "Usage: %s [n]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+
+        int sizes[] = { 1, 2, 3, 4, 17, n };
+        for (int i = 0; i < (int)(sizeof(sizes)/sizeof(sizes[0])); i++) {
+                test_capacity(sizes[i]);
+        }
+        test_unbounded(2*n);
+        return 0;
+}
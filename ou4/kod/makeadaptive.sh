@@ -0,0 +1,4 @@
+gcc -g -std=c99 -Wall -pthread -o adaptivetable_test -I ../../datastructures-v1.0.8.2/include/ adaptivetable.c tabletest-1.9.c workload.c -lm
+valgrind --leak-check=full --show-reachable=yes ./adaptivetable_test 1000
+gcc -g -std=c99 -Wall -o adaptivelayout_test -I ../../datastructures-v1.0.8.2/include/ adaptivetable.c adaptivetest.c
+valgrind --leak-check=full --show-reachable=yes ./adaptivelayout_test 1000
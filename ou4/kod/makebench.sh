@@ -0,0 +1,13 @@
+# Builds one tabletest with every implementation of table.h, selected at
+# runtime with --impl, see tableops.h. Extra gcc flags such as
+# -DTABLE_STATS can be given as arguments. The allocation functions are
+# wrapped so that tabletest -M can count the memory of each backend.
+I=../../datastructures-v1.0.8.2
+FLAGS="-g -std=c99 -Wall -pthread -I $I/include/ -I . $*"
+gcc $FLAGS -c -o mtftable_inner.o -DINNER_TABLE_IMPLEMENTATION -include innertable.h mtftable.c
+for impl in table:$I/src/table/table.c dlist:table2.c array:arraytable.c mtf:mtftable.c hash:hashtable.c sorted:sortedtable.c btree:btreetable.c intarray:intarraytable.c concurrent:concurrenttable.c lru:lrutable.c radix:radixtable.c bitmap:bitmaptable.c adaptive:adaptivetable.c bloom:bloomtable.c
+do
+	gcc $FLAGS -c -o ${impl%%:*}_ops.o -DTABLE_OPS_PREFIX=${impl%%:*} -include tableops.h ${impl#*:} || exit 1
+done
+gcc $FLAGS -DTABLE_OPS -DALLOC_STATS -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=posix_memalign,--wrap=free -o bench_test tableops.c tabletest-1.9.c workload.c *_ops.o mtftable_inner.o $I/src/dlist/dlist.c $I/src/array_1d/array_1d.c -lm
+valgrind --leak-check=full --show-reachable=yes ./bench_test -c 1000
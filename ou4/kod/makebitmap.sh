@@ -0,0 +1,4 @@
+gcc -g -std=c99 -Wall -pthread -o bitmaptable_test -I ../../datastructures-v1.0.8.2/include/ bitmaptable.c tabletest-1.9.c workload.c -lm
+valgrind --leak-check=full --show-reachable=yes ./bitmaptable_test -n 1000
+gcc -g -std=c99 -Wall -o bitmapdomain_test -I ../../datastructures-v1.0.8.2/include/ bitmaptable.c bitmaptest.c
+valgrind --leak-check=full --show-reachable=yes ./bitmapdomain_test 1000
@@ -0,0 +1,4 @@
+gcc -g -std=c99 -Wall -c -o mtftable_inner.o -I ../../datastructures-v1.0.8.2/include/ -I . -DINNER_TABLE_IMPLEMENTATION -include innertable.h mtftable.c
+gcc -g -std=c99 -Wall -pthread -DBLOOM_TABLE -o bloomtable_test -I ../../datastructures-v1.0.8.2/include/ bloomtable.c mtftable_inner.o tabletest-1.9.c workload.c ../../datastructures-v1.0.8.2/src/dlist/dlist.c -lm
+valgrind --leak-check=full --show-reachable=yes ./bloomtable_test 1000
+valgrind --leak-check=full --show-reachable=yes ./bloomtable_test -n -s 1000
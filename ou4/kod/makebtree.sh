@@ -0,0 +1,4 @@
+gcc -g -std=c99 -Wall -pthread -o btreetable_test -I ../../datastructures-v1.0.8.2/include/ btreetable.c tabletest-1.9.c workload.c -lm
+valgrind --leak-check=full --show-reachable=yes ./btreetable_test 1000
+gcc -g -std=c99 -Wall -o btreeordered_test -I ../../datastructures-v1.0.8.2/include/ btreetable.c orderedtest.c
+valgrind --leak-check=full --show-reachable=yes ./btreeordered_test 1000
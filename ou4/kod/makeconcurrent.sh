@@ -0,0 +1,3 @@
+gcc -g -std=c99 -Wall -pthread -DTHREAD_SAFE_TABLE -o concurrenttable_test -I ../../datastructures-v1.0.8.2/include/ concurrenttable.c tabletest-1.9.c workload.c -lm
+valgrind --leak-check=full --show-reachable=yes ./concurrenttable_test 1000
+valgrind --tool=helgrind ./concurrenttable_test -n -j 4 1000
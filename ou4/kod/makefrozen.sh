@@ -0,0 +1,2 @@
+gcc -g -std=c99 -Wall -pthread -o frozentable_test -I ../../datastructures-v1.0.8.2/include/ hashtable.c frozentable.c frozentest.c
+valgrind --leak-check=full --show-reachable=yes ./frozentable_test 1000
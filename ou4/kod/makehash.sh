@@ -0,0 +1,4 @@
+gcc -g -std=c99 -Wall -pthread -o hashtable_test -I ../../datastructures-v1.0.8.2/include/ hashtable.c tabletest-1.9.c workload.c -lm
+valgrind --leak-check=full --show-reachable=yes ./hashtable_test 1000
+gcc -g -std=c99 -Wall -o hashsave_test -I ../../datastructures-v1.0.8.2/include/ hashtable.c hashtest.c
+valgrind --leak-check=full --show-reachable=yes ./hashsave_test 1000
@@ -0,0 +1,4 @@
+gcc -g -std=c99 -Wall -pthread -o intarraytable_test -I ../../datastructures-v1.0.8.2/include/ intarraytable.c tabletest-1.9.c workload.c -lm
+valgrind --leak-check=full --show-reachable=yes ./intarraytable_test -n 1000
+gcc -g -std=c99 -Wall -o intarraykeys_test -I ../../datastructures-v1.0.8.2/include/ intarraytable.c intarraytest.c
+valgrind --leak-check=full --show-reachable=yes ./intarraykeys_test 1000
@@ -0,0 +1,4 @@
+gcc -g -std=c99 -Wall -pthread -o lrutable_test -I ../../datastructures-v1.0.8.2/include/ lrutable.c tabletest-1.9.c workload.c -lm
+valgrind --leak-check=full --show-reachable=yes ./lrutable_test 1000
+gcc -g -std=c99 -Wall -o lrucapacity_test -I ../../datastructures-v1.0.8.2/include/ lrutable.c lrutest.c
+valgrind --leak-check=full --show-reachable=yes ./lrucapacity_test 1000
@@ -1,2 +1,6 @@
-gcc -g -std=c99 -Wall -o mtftable_test -I ../../datastructures-v1.0.8.2/include/ mtftable.c tabletest-1.9.c ../../datastructures-v1.0.8.2/src/dlist/dlist.c
+gcc -g -std=c99 -Wall -pthread -o mtftable_test -I ../../datastructures-v1.0.8.2/include/ mtftable.c tabletest-1.9.c workload.c ../../datastructures-v1.0.8.2/src/dlist/dlist.c -lm
 valgrind ./mtftable_test --leak-check=full --show-reachable=yes
+gcc -g -std=c99 -Wall -pthread -DMTF_DEFAULT_POLICY=MTF_TRANSPOSE -o mtftranspose_test -I ../../datastructures-v1.0.8.2/include/ mtftable.c tabletest-1.9.c workload.c ../../datastructures-v1.0.8.2/src/dlist/dlist.c -lm
+valgrind --leak-check=full --show-reachable=yes ./mtftranspose_test 1000
+gcc -g -std=c99 -Wall -pthread -DMTF_DEFAULT_POLICY=MTF_FREQUENCY_COUNT -o mtffrequency_test -I ../../datastructures-v1.0.8.2/include/ mtftable.c tabletest-1.9.c workload.c ../../datastructures-v1.0.8.2/src/dlist/dlist.c -lm
+valgrind --leak-check=full --show-reachable=yes ./mtffrequency_test 1000
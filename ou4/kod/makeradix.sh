@@ -0,0 +1,4 @@
+gcc -g -std=c99 -Wall -pthread -o radixtable_test -I ../../datastructures-v1.0.8.2/include/ radixtable.c tabletest-1.9.c workload.c -lm
+valgrind --leak-check=full --show-reachable=yes ./radixtable_test -c 1000
+gcc -g -std=c99 -Wall -o radixprefix_test -I ../../datastructures-v1.0.8.2/include/ radixtable.c radixtest.c
+valgrind --leak-check=full --show-reachable=yes ./radixprefix_test 1000
@@ -0,0 +1,7 @@
+gcc -g -std=c99 -Wall -pthread -DEYTZINGER_TABLE -o sortedtable_test -I ../../datastructures-v1.0.8.2/include/ sortedtable.c tabletest-1.9.c workload.c ../../datastructures-v1.0.8.2/src/array_1d/array_1d.c -lm
+valgrind --leak-check=full --show-reachable=yes ./sortedtable_test 1000
+valgrind --leak-check=full --show-reachable=yes ./sortedtable_test -n -e -b 1000
+gcc -g -std=c99 -Wall -o eytzinger_test -I ../../datastructures-v1.0.8.2/include/ sortedtable.c sortedtest.c ../../datastructures-v1.0.8.2/src/array_1d/array_1d.c
+valgrind --leak-check=full --show-reachable=yes ./eytzinger_test 1000
+gcc -g -std=c99 -Wall -o sortedordered_test -I ../../datastructures-v1.0.8.2/include/ sortedtable.c orderedtest.c ../../datastructures-v1.0.8.2/src/array_1d/array_1d.c
+valgrind --leak-check=full --show-reachable=yes ./sortedordered_test 1000
@@ -2,13 +2,26 @@
 #include <stdio.h>
 
 #include "table.h"
+#include "table_stats.h"
 #include "dlist.h"
+#include "mtftable.h"
 
 /*
  * Implementation of a table using directional lists which moves the most recently
  * looked up key pair to the front of the internal list.
  *
- * Duplicates are handled by inspect and remove.
+ * The move is done with dlist_move(), which relinks the list cell
+ * instead of freeing it and allocating a new one. Instead of moving to
+ * the front, a table created by table_empty_policy() can move the found
+ * pair one step forward (transpose), or keep the pairs ordered by how
+ * many times they have been looked up (frequency count). All policies
+ * only move the first matching pair forward, so the latest added pair
+ * for a key stays ahead of older duplicates.
+ *
+ * Duplicates are handled by inspect and remove. Tables created with
+ * TABLE_UNIQUE_KEYS have no duplicates. Their insert replaces the pair
+ * of a key already in the list where it is, and remove stops at the
+ * first match.
  *
  * Author: Rasmus Lyxell (c19rll@umu.cs.se)
  *
@@ -18,24 +31,274 @@
  *   2018-02-06: v1.0, first public version.
  *   2019-02-21: v1.1, second version without dlist/memfreehandler.
  *   2019-03-04: v1.2, bugfix in table_remove.
+ *   2026-10-17: v1.3, added batched insert/lookup/remove.
+ *   2026-10-17: v1.4, reorder with dlist_move(), added policies.
+ *   2026-10-17: v1.5, added table_stats().
+ *   2026-10-17: v1.6, added table_empty_ex().
+ *   2026-10-17: v1.7, added table_clear() and table_drain().
+ *   2026-10-17: v1.8, added table_lookup_all() and table_count().
  */
 
+// Policy used by table_empty().
+#ifndef MTF_DEFAULT_POLICY
+#define MTF_DEFAULT_POLICY MTF_MOVE_TO_FRONT
+#endif
+
+// Number of keys handled per walk of the list by
+// table_remove_many().
+#define BATCH_SIZE 64
+
 // ===========INTERNAL DATA TYPES============
 
 struct table {
     dlist *entries;
+    mtf_policy policy;
     compare_function *key_cmp_func;
     free_function key_free_func;
     free_function value_free_func;
+    // True if created with TABLE_UNIQUE_KEYS.
+    bool unique_keys;
+#ifdef TABLE_STATS
+    table_statistics *stats;
+#endif
 };
 
 struct table_entry {
     void *key;
     void *value;
+    // Number of times the pair has been found by table_lookup().
+    int count;
 };
 
 // ===========INTERNAL FUNCTION IMPLEMENTATIONS============
 
+/**
+ * batch_index() - Find the batch key that matches a key.
+ * @t: Table whose compare function is used.
+ * @key: Key to compare.
+ * @keys: Batch of keys.
+ * @done: Flags for keys that should be skipped, or NULL.
+ * @n: Number of keys in the batch.
+ *
+ * Returns: Index of the first matching key not flagged in done, or -1.
+ */
+static int batch_index(const table *t, const void *key, void **keys,
+                       const bool *done, int n)
+{
+    for (int i = 0; i < n; i++) {
+        if ((done == NULL || !done[i])
+            && TABLE_KEY_CMP(t, key, keys[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * is_batch_pointer() - Check if a pointer is one of the batch keys.
+ * @p: Pointer to check.
+ * @keys: Batch of keys.
+ * @n: Number of keys in the batch.
+ *
+ * Returns: True if p points to the same memory as one of the keys.
+ */
+static bool is_batch_pointer(const void *p, void **keys, int n)
+{
+    for (int i = 0; i < n; i++) {
+        if (keys[i] == p) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * remove_batch() - Remove at most BATCH_SIZE keys in one list walk.
+ * @t: Table to manipulate.
+ * @keys: Keys to remove.
+ * @n: Number of keys, at most BATCH_SIZE.
+ *
+ * Returns: Nothing.
+ */
+static void remove_batch(table *t, void **keys, int n)
+{
+    // Stored keys that are also batch keys. They are still compared
+    // with, so they are freed after the walk.
+    void *deferred[BATCH_SIZE];
+    int n_deferred = 0;
+    unsigned long walked = 0;
+    // With unique keys, each batch key matches at most one entry, so
+    // the walk stops when all of them have been removed.
+    bool removed[BATCH_SIZE] = { false };
+    int left = n;
+
+    dlist_pos pos = dlist_first(t->entries);
+    while (left > 0 && !dlist_is_end(t->entries, pos)) {
+        struct table_entry *entry = dlist_inspect(t->entries, pos);
+        const bool *done = t->unique_keys ? removed : NULL;
+        int i = batch_index(t, entry->key, keys, done, n);
+
+        walked++;
+        if (i < 0) {
+            pos = dlist_next(t->entries, pos);
+            continue;
+        }
+        // Equal keys in the batch are all done with this entry.
+        while (t->unique_keys && i >= 0) {
+            removed[i] = true;
+            left--;
+            i = batch_index(t, entry->key, keys, removed, n);
+        }
+        if (t->key_free_func != NULL) {
+            if (is_batch_pointer(entry->key, keys, n)) {
+                deferred[n_deferred++] = entry->key;
+            } else {
+                t->key_free_func(entry->key);
+            }
+        }
+        if (t->value_free_func != NULL) {
+            t->value_free_func(entry->value);
+        }
+        // Remove the list element itself.
+        pos = dlist_remove(t->entries, pos);
+        // Deallocate the table entry structure.
+        free(entry);
+    }
+    for (int i = 0; i < n_deferred; i++) {
+        t->key_free_func(deferred[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        TABLE_STATS_REMOVE(t, walked);
+    }
+}
+
+/**
+ * frequency_position() - Find where a looked up pair should be moved.
+ * @t: Table to inspect.
+ * @pos: Position of the pair, whose count has just been increased.
+ *
+ * Returns: The position of the first pair with a count not larger than
+ * the count of the pair at pos, or pos itself if there is none before
+ * it.
+ */
+static dlist_pos frequency_position(const table *t, dlist_pos pos)
+{
+    struct table_entry *entry = dlist_inspect(t->entries, pos);
+    dlist_pos q = dlist_first(t->entries);
+
+    while (q != pos) {
+        struct table_entry *e = dlist_inspect(t->entries, q);
+        if (e->count <= entry->count) {
+            break;
+        }
+        q = dlist_next(t->entries, q);
+    }
+    return q;
+}
+
+/**
+ * replace_pair() - Replace the pair of a key that is in a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * The pair keeps its place in the list. Calls any free functions set
+ * for keys/values on the replaced key and value, unless they are the
+ * same memory as the new ones.
+ *
+ * Returns: True if the pair was replaced, false if key is not in the
+ * table.
+ */
+static bool replace_pair(table *t, void *key, void *value)
+{
+    dlist_pos pos = dlist_first(t->entries);
+
+    while (!dlist_is_end(t->entries, pos)) {
+        struct table_entry *entry = dlist_inspect(t->entries, pos);
+        if (TABLE_KEY_CMP(t, entry->key, key) == 0) {
+            if (t->key_free_func != NULL && entry->key != key) {
+                t->key_free_func(entry->key);
+            }
+            if (t->value_free_func != NULL && entry->value != value) {
+                t->value_free_func(entry->value);
+            }
+            entry->key = key;
+            entry->value = value;
+            return true;
+        }
+        pos = dlist_next(t->entries, pos);
+    }
+    return false;
+}
+
+/**
+ * empty_list() - Remove all pairs from the list of a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * Always removes the first cell, so each removal takes constant time.
+ *
+ * Returns: Nothing.
+ */
+static void empty_list(table *t, consume_callback_pair func)
+{
+    dlist_pos pos = dlist_first(t->entries);
+
+    while (!dlist_is_end(t->entries, pos)) {
+        struct table_entry *entry = dlist_inspect(t->entries, pos);
+        if (func != NULL) {
+            func(entry->key, entry->value);
+        } else {
+            if (t->key_free_func != NULL) {
+                t->key_free_func(entry->key);
+            }
+            if (t->value_free_func != NULL) {
+                t->value_free_func(entry->value);
+            }
+        }
+        // Deallocate the table entry structure.
+        free(entry);
+        pos = dlist_remove(t->entries, pos);
+    }
+}
+
+/**
+ * visit_key() - Visit the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function to call for each pair, or NULL.
+ *
+ * Walks the whole list, since duplicates are separate entries. Tables
+ * with unique keys stop at the first match. Unlike table_lookup(), the
+ * list is not reordered.
+ *
+ * Returns: The number of pairs with the key.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+                               inspect_callback_pair func)
+{
+    dlist_pos pos = dlist_first(t->entries);
+    unsigned long mark = TABLE_STATS_COMPARES(t);
+    unsigned long n = 0;
+
+    while (!dlist_is_end(t->entries, pos)) {
+        struct table_entry *entry = dlist_inspect(t->entries, pos);
+        if (TABLE_KEY_CMP(t, entry->key, key) == 0) {
+            if (func != NULL) {
+                func(entry->key, entry->value);
+            }
+            n++;
+            if (t->unique_keys) {
+                break;
+            }
+        }
+        pos = dlist_next(t->entries, pos);
+    }
+    TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, n > 0);
+    return n;
+}
+
 /**
  * table_empty() - Create an empty table.
  * @key_cmp_func: A pointer to a function to be used to compare keys.
@@ -49,19 +312,84 @@ struct table_entry {
 table *table_empty(compare_function *key_cmp_func,
                    free_function key_free_func,
                    free_function value_free_func)
+{
+    return table_empty_policy(key_cmp_func, key_free_func,
+                              value_free_func, MTF_DEFAULT_POLICY);
+}
+
+/**
+ * table_empty_policy() - Create an empty table with a given policy.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @policy: How the list is reordered on a successful lookup.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_policy(compare_function *key_cmp_func,
+                          free_function key_free_func,
+                          free_function value_free_func,
+                          mtf_policy policy)
 {
     // Allocate the table header.
     table *t = calloc(1, sizeof(table));
     // Create the list to hold the table_entry-ies.
     t->entries = dlist_empty(NULL);
+    t->policy = policy;
     // Store the key compare function and key/value free functions.
     t->key_cmp_func = key_cmp_func;
     t->key_free_func = key_free_func;
     t->value_free_func = value_free_func;
+    TABLE_STATS_INIT(t);
 
     return t;
 }
 
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the list is searched linearly.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+                          hash_function *key_hash_func,
+                          free_function key_free_func,
+                          free_function value_free_func)
+{
+    return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the list is searched linearly.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: TABLE_UNIQUE_KEYS or 0.
+ *
+ * Returns: Pointer to a new table with the policy MTF_DEFAULT_POLICY.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+                      hash_function *key_hash_func,
+                      free_function key_free_func,
+                      free_function value_free_func,
+                      unsigned int flags)
+{
+    table *t = table_empty(key_cmp_func, key_free_func, value_free_func);
+
+    t->unique_keys = (flags & TABLE_UNIQUE_KEYS) != 0;
+    return t;
+}
+
 /**
  * table_is_empty() - Check if a table is empty.
  * @table: Table to check.
@@ -82,12 +410,21 @@ bool table_is_empty(const table *t)
  * Insert the key/value pair into the table. No test is performed to
  * check if key is a duplicate. table_lookup() will return the latest
  * added value for a duplicate key. table_remove() will remove all
- * duplicates for a given key.
+ * duplicates for a given key. If the table was created with
+ * TABLE_UNIQUE_KEYS, the pair of a key already in the table is
+ * replaced instead.
  *
  * Returns: Nothing.
  */
 void table_insert(table *t, void *key, void *value)
 {
+    unsigned long mark = TABLE_STATS_COMPARES(t);
+
+    if (t->unique_keys && replace_pair(t, key, value)) {
+        TABLE_STATS_INSERT(t, TABLE_STATS_COMPARES(t) - mark);
+        return;
+    }
+
     // Allocate the key/value structure.
     struct table_entry *entry = malloc(sizeof(struct table_entry));
 
@@ -95,7 +432,9 @@ void table_insert(table *t, void *key, void *value)
     // cause table_lookup() to find the latest added value.
     entry->key = key;
     entry->value = value;
+    entry->count = 0;
     dlist_insert(t->entries, entry, dlist_first(t->entries));
+    TABLE_STATS_INSERT(t, TABLE_STATS_COMPARES(t) - mark);
 }
 
 /**
@@ -112,27 +451,72 @@ void *table_lookup(const table *t, const void *key)
     // Iterate over the list. Return first match.
 
     dlist_pos pos = dlist_first(t->entries);
+    // Position of the element before pos, used by transpose.
+    dlist_pos prev = pos;
+    unsigned long mark = TABLE_STATS_COMPARES(t);
 
     while (!dlist_is_end(t->entries, pos)) {
         // Inspect the table entry
         struct table_entry *entry = dlist_inspect(t->entries, pos);
         // Check if the entry key matches the search key.
-        if (t->key_cmp_func(entry->key, key) == 0) {
+        if (TABLE_KEY_CMP(t, entry->key, key) == 0) {
             // If yes, return the corresponding value pointer.
+            TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, true);
 
-            //Remove element from the internal list
-            dlist_remove(t->entries, pos);
-            //Place element at the first position in the list
-            dlist_insert(t->entries, entry, dlist_first(t->entries));
+            // Move the element forward in the internal list.
+            switch (t->policy) {
+            case MTF_MOVE_TO_FRONT:
+                dlist_move(t->entries, pos, dlist_first(t->entries));
+                break;
+            case MTF_TRANSPOSE:
+                dlist_move(t->entries, pos, prev);
+                break;
+            case MTF_FREQUENCY_COUNT:
+                entry->count++;
+                dlist_move(t->entries, pos, frequency_position(t, pos));
+                break;
+            }
             return entry->value;
         }
         // Continue with the next position.
+        prev = pos;
         pos = dlist_next(t->entries, pos);
     }
     // No match found. Return NULL.
+    TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, false);
     return NULL;
 }
 
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The pairs are visited latest inserted first, so the first value
+ * equals the one returned by table_lookup(). func must not change the
+ * table.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+                      inspect_callback_pair func)
+{
+    visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+    return visit_key(t, key, NULL);
+}
+
 /**
  * table_choose_key() - Return an arbitrary key.
  * @t: Table to inspect.
@@ -167,6 +551,7 @@ void table_remove(table *t, const void *key)
 {
     // Will be set if we need to delay a free.
     void *deferred_ptr = NULL;
+    unsigned long mark = TABLE_STATS_COMPARES(t);
 
     // Start at beginning of the list.
     dlist_pos pos = dlist_first(t->entries);
@@ -177,7 +562,7 @@ void table_remove(table *t, const void *key)
         struct table_entry *entry = dlist_inspect(t->entries, pos);
 
         // Compare the supplied key with the key of this entry.
-        if (t->key_cmp_func(entry->key, key) == 0) {
+        if (TABLE_KEY_CMP(t, entry->key, key) == 0) {
             // If we have a match, call free on the key
             // and/or value if given the responsiblity
             if (t->key_free_func != NULL) {
@@ -199,6 +584,10 @@ void table_remove(table *t, const void *key)
             pos = dlist_remove(t->entries, pos);
             // Deallocate the table entry structure.
             free(entry);
+            if (t->unique_keys) {
+                // There are no more matches.
+                break;
+            }
         } else {
             // No match, move on to next element in the list.
             pos = dlist_next(t->entries, pos);
@@ -208,6 +597,7 @@ void table_remove(table *t, const void *key)
         // Take care of the delayed free.
         t->key_free_func(deferred_ptr);
     }
+    TABLE_STATS_REMOVE(t, TABLE_STATS_COMPARES(t) - mark);
 }
 
 /*
@@ -245,9 +635,39 @@ void table_kill(table *t)
     // Kill what's left of the list...
     dlist_kill(t->entries);
     // ...and the table.
+    TABLE_STATS_FREE(t);
     free(t);
 }
 
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+    empty_list(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table,
+ *	  including duplicates. Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+    empty_list(t, func);
+}
+
 /**
  * table_print() - Print the given table.
  * @t: Table to print.
@@ -270,3 +690,72 @@ void table_print(const table *t, inspect_callback_pair print_func)
         pos = dlist_next(t->entries, pos);
     }
 }
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+    for (int i = 0; i < n; i++) {
+        table_insert(t, keys[i], values[i]);
+    }
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * The keys are looked up one at a time, in order, since each found
+ * key is moved forward in the list.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+    for (int i = 0; i < n; i++) {
+        values[i] = table_lookup(t, keys[i]);
+    }
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Removes BATCH_SIZE keys per walk of the list.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+    for (int first = 0; first < n; first += BATCH_SIZE) {
+        int m = n - first < BATCH_SIZE ? n - first : BATCH_SIZE;
+        remove_batch(t, keys + first, m);
+    }
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of an operation is the number of list entries it
+ * compared with. Inserts have probe length 0, except in tables with
+ * unique keys where they look for the key first.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+    TABLE_STATS_GET(t, out);
+}
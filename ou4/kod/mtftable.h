@@ -0,0 +1,50 @@
+#ifndef MTFTABLE_H
+#define MTFTABLE_H
+
+#include "table.h"
+
+/*
+ * Extra operations for the self-organizing list implementation of
+ * table.h in mtftable.c.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+
+// How a table reorders its list when a key is found by table_lookup().
+typedef enum mtf_policy {
+    // Move the found pair to the front of the list.
+    MTF_MOVE_TO_FRONT,
+    // Swap the found pair with the pair before it.
+    MTF_TRANSPOSE,
+    // Count the lookups of each pair and keep the pairs with the
+    // highest counts first.
+    MTF_FREQUENCY_COUNT
+} mtf_policy;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_empty_policy() - Create an empty table with a given policy.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @policy: How the list is reordered on a successful lookup.
+ *
+ * table_empty() creates a table with the policy MTF_DEFAULT_POLICY,
+ * which is MTF_MOVE_TO_FRONT unless defined at compile time.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_policy(compare_function *key_cmp_func,
+                          free_function key_free_func,
+                          free_function value_free_func,
+                          mtf_policy policy);
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef ORDEREDTABLE_H
+#define ORDEREDTABLE_H
+
+#include <stdbool.h>
+#include "table.h"
+
+/*
+ * Ordered operations for table implementations that keep their keys
+ * sorted by key_cmp_func, e.g. btreetable.c and sortedtable.c. The
+ * comparison function must define a total order, not only equality.
+ *
+ * All operations see one pair per distinct key, namely the one that
+ * table_lookup() would return. Positions are invalidated by
+ * table_insert() and table_remove().
+ *
+ * Prefix scans over string keys are range scans from the prefix up to,
+ * but not including, the prefix with its last character incremented.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+
+// Table position type. The fields are private to the implementation.
+typedef struct table_pos {
+	void *node;
+	int index;
+} table_pos;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_first() - Return the position of the smallest key in a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The first position in key order. Equal to the end position
+ * if the table is empty.
+ */
+table_pos table_first(const table *t);
+
+/**
+ * table_next() - Return the next position in key order.
+ * @t: Table to inspect.
+ * @pos: Any valid position except the end position.
+ *
+ * Returns: The position of the next larger key.
+ */
+table_pos table_next(const table *t, table_pos pos);
+
+/**
+ * table_is_end() - Check if a position is past the largest key.
+ * @t: Table to inspect.
+ * @pos: Any valid position.
+ *
+ * Returns: True if pos is the end position.
+ */
+bool table_is_end(const table *t, table_pos pos);
+
+/**
+ * table_inspect_key() - Return the key at a position.
+ * @t: Table to inspect.
+ * @pos: Any valid position except the end position.
+ *
+ * Returns: The key stored at pos.
+ */
+void *table_inspect_key(const table *t, table_pos pos);
+
+/**
+ * table_inspect_value() - Return the value at a position.
+ * @t: Table to inspect.
+ * @pos: Any valid position except the end position.
+ *
+ * Returns: The latest value stored for the key at pos.
+ */
+void *table_inspect_value(const table *t, table_pos pos);
+
+/**
+ * table_first_ge() - Find the smallest key not less than a given key.
+ * @t: Table to inspect.
+ * @key: Key to compare with.
+ *
+ * Returns: The smallest stored key that is greater than or equal to
+ * key, or NULL if there is no such key.
+ */
+void *table_first_ge(const table *t, const void *key);
+
+/**
+ * table_range() - Visit the pairs with keys in a half-open range.
+ * @t: Table to inspect.
+ * @lo: Smallest key to visit, or NULL to start at the smallest key.
+ * @hi: Key to stop before, or NULL to continue to the largest key.
+ * @func: Function called for each key/value pair in the range.
+ *
+ * Calls func for every key k with lo <= k < hi, in key order.
+ *
+ * Returns: Nothing.
+ */
+void table_range(const table *t, const void *lo, const void *hi,
+		 inspect_callback_pair func);
+
+#endif
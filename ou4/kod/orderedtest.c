@@ -0,0 +1,361 @@
+/*
+ * orderedtest - test the ordered operations of a table implementation.
+ *
+ * Should be compiled together with a table implementation that also
+ * implements orderedtable.h, i.e. btreetable.c or sortedtable.c.
+ *
+ * Usage: orderedtest [n]
+ *
+ * Fills a table with n even int keys, some of them inserted twice, and
+ * checks that iterating from table_first() visits every key once, in
+ * order and with its latest value. table_first_ge() is checked for
+ * every key from below the smallest to past the largest, and
+ * table_range() for ranges whose bounds are missing, stored, equal,
+ * outside the keys or NULL, where the upper bound must not be visited.
+ * The checks are repeated after most keys are removed in a scattered
+ * order, which makes a B+tree merge its nodes, after the smallest and
+ * largest keys are removed, after more duplicates are inserted and
+ * once the table is empty. Every test is run on a table that keeps
+ * duplicates and on one created with TABLE_UNIQUE_KEYS.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "table.h"
+#include "orderedtable.h"
+
+// Default number of keys
+#define DEFAULT_SIZE 1000
+
+/* Keys the test expects to be in the table, the even keys from 0 to
+ * 2n-2.
+ *    n - the number of possible keys
+ *    values - the latest value of each key, or -1 if the key is not in
+ *             the table, indexed by key/2
+ */
+struct model {
+        int n;
+        int *values;
+};
+
+// Pairs visited by table_range(), in the order they were visited
+int *visited_keys;
+int *visited_values;
+int n_visited;
+
+/**
+ * int_ptr_from_int() - Create a dynamic copy of an int.
+ * @i: Value to copy.
+ *
+ * Returns: Pointer to the copy of i.
+ */
+int *int_ptr_from_int(int i)
+{
+        int *ip = malloc(sizeof(int));
+        *ip = i;
+        return ip;
+}
+
+int int_compare(const void *ip1,const void *ip2)
+{
+        const int *n1=ip1;
+        const int *n2=ip2;
+        return (*n1 > *n2) - (*n1 < *n2);
+}
+
+/**
+ * fail() - Print an error message and exit.
+ * @name: Name of the test that failed.
+ * @what: What went wrong.
+ * @key: Key that went wrong.
+ *
+ * Returns: Never.
+ */
+void fail(const char *name, const char *what, int key)
+{
+        fprintf(stderr, "FAIL: %s: %s %d.\n", name, what, key);
+        exit(EXIT_FAILURE);
+}
+
+/**
+ * visit_pair() - Record a pair visited by table_range().
+ * @key: Key of the pair.
+ * @value: Value of the pair.
+ *
+ * Returns: Nothing.
+ */
+void visit_pair(const void *key, const void *value)
+{
+        visited_keys[n_visited] = *(const int *)key;
+        visited_values[n_visited] = *(const int *)value;
+        n_visited++;
+}
+
+/**
+ * insert_key() - Insert a key into the table and the model.
+ * @t: Table to insert into.
+ * @m: Model of the table.
+ * @key: Even key from 0 to 2n-2.
+ * @value: Value of the key.
+ *
+ * Returns: Nothing.
+ */
+void insert_key(table *t, struct model *m, int key, int value)
+{
+        table_insert(t, int_ptr_from_int(key), int_ptr_from_int(value));
+        m->values[key/2] = value;
+}
+
+/**
+ * remove_key() - Remove a key from the table and the model.
+ * @t: Table to remove from.
+ * @m: Model of the table.
+ * @key: Even key from 0 to 2n-2.
+ *
+ * Returns: Nothing.
+ */
+void remove_key(table *t, struct model *m, int key)
+{
+        table_remove(t, &key);
+        m->values[key/2] = -1;
+}
+
+/**
+ * expected_ge() - Find the smallest key in the model not less than a
+ * given key.
+ * @m: Model of the table.
+ * @key: Key to compare with.
+ *
+ * Returns: The key, or -1 if there is none.
+ */
+int expected_ge(const struct model *m, int key)
+{
+        for (int i = key < 0 ? 0 : (key + 1)/2; i < m->n; i++) {
+                if (m->values[i] != -1) {
+                        return 2*i;
+                }
+        }
+        return -1;
+}
+
+/**
+ * check_iteration() - Check that iterating visits the keys of the
+ * model once each, in order and with their latest values.
+ * @t: Table to check.
+ * @m: Model of the table.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void check_iteration(const table *t, const struct model *m,
+                     const char *name)
+{
+        int key = expected_ge(m, 0);
+
+        for (table_pos pos = table_first(t); !table_is_end(t, pos);
+             pos = table_next(t, pos)) {
+                int found = *(const int *)table_inspect_key(t, pos);
+                if (found != key) {
+                        fail(name, "iteration visited key", found);
+                }
+                if (*(const int *)table_inspect_value(t, pos)
+                    != m->values[key/2]) {
+                        fail(name, "iteration found an old value of key",
+                             key);
+                }
+                key = expected_ge(m, key + 1);
+        }
+        if (key != -1) {
+                fail(name, "iteration ended before key", key);
+        }
+}
+
+/**
+ * check_first_ge() - Check table_first_ge() for every key from below
+ * the smallest key to past the largest.
+ * @t: Table to check.
+ * @m: Model of the table.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void check_first_ge(const table *t, const struct model *m,
+                    const char *name)
+{
+        for (int key = -2; key <= 2*m->n + 1; key++) {
+                const int *found = table_first_ge(t, &key);
+                int expected = expected_ge(m, key);
+                if (expected == -1 && found != NULL) {
+                        fail(name, "table_first_ge() found a key after", key);
+                }
+                if (expected != -1 && (found == NULL || *found != expected)) {
+                        fail(name, "table_first_ge() missed the key after",
+                             key);
+                }
+        }
+}
+
+/**
+ * check_range() - Check that table_range() visits the keys of the
+ * model from lo up to but not including hi.
+ * @t: Table to check.
+ * @m: Model of the table.
+ * @lo: Smallest key to visit, or NULL.
+ * @hi: Key to stop before, or NULL.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void check_range(const table *t, const struct model *m, const int *lo,
+                 const int *hi, const char *name)
+{
+        int key = expected_ge(m, lo != NULL ? *lo : 0);
+
+        n_visited = 0;
+        table_range(t, lo, hi, visit_pair);
+        for (int i = 0; i < n_visited; i++) {
+                if (visited_keys[i] != key ||
+                    (hi != NULL && visited_keys[i] >= *hi)) {
+                        fail(name, "table_range() visited key",
+                             visited_keys[i]);
+                }
+                if (visited_values[i] != m->values[key/2]) {
+                        fail(name, "table_range() found an old value of key",
+                             key);
+                }
+                key = expected_ge(m, key + 1);
+        }
+        if (key != -1 && (hi == NULL || key < *hi)) {
+                fail(name, "table_range() ended before key", key);
+        }
+}
+
+/**
+ * check_table() - Run all checks on a table.
+ * @t: Table to check.
+ * @m: Model of the table.
+ * @name: Name of the test.
+ *
+ * Exits the program if any check fails.
+ *
+ * Returns: Nothing.
+ */
+void check_table(const table *t, const struct model *m, const char *name)
+{
+        int last = 2*m->n - 2;
+        int mid = m->n/2*2;
+        int bounds[] = { -1, 0, 1, 2, mid - 1, mid, mid + 1, last - 1,
+                         last, last + 1, last + 2 };
+        int n_bounds = sizeof(bounds)/sizeof(bounds[0]);
+
+        check_iteration(t, m, name);
+        check_first_ge(t, m, name);
+        for (int i = -1; i < n_bounds; i++) {
+                for (int j = -1; j < n_bounds; j++) {
+                        check_range(t, m, i >= 0 ? &bounds[i] : NULL,
+                                    j >= 0 ? &bounds[j] : NULL, name);
+                }
+        }
+}
+
+/**
+ * test_ordered() - Run all tests on a table with a number of keys.
+ * @n: Number of keys.
+ * @flags: Flags of table_empty_ex().
+ *
+ * Returns: Nothing.
+ */
+void test_ordered(int n, unsigned int flags)
+{
+        table *t = table_empty_ex(int_compare, NULL, free, free, flags);
+        struct model m = { .n = n };
+
+        m.values = malloc(n*sizeof(*m.values));
+        for (int i = 0; i < n; i++) {
+                m.values[i] = -1;
+        }
+        check_table(t, &m, "Empty table");
+
+        // Insert from both ends in turn, every third key twice
+        for (int i = 0; i < n; i++) {
+                int key = 2*(i % 2 == 0 ? i/2 : n - 1 - i/2);
+                if (key % 3 == 0) {
+                        insert_key(t, &m, key, -2);
+                }
+                insert_key(t, &m, key, key + 1);
+        }
+        check_table(t, &m, "Filled table");
+
+        // Remove two keys out of three, striding through the keys
+        for (int i = 0; i < n; i++) {
+                int key = 2*(int)((i*7L) % n);
+                if (key % 3 != 0) {
+                        remove_key(t, &m, key);
+                }
+        }
+        check_table(t, &m, "After removes");
+
+        if (n > 0) {
+                remove_key(t, &m, 0);
+                remove_key(t, &m, 2*n - 2);
+        }
+        check_table(t, &m, "Without the smallest and largest keys");
+
+        for (int key = 0; key < 2*n; key += 4) {
+                insert_key(t, &m, key, 3*key);
+        }
+        check_table(t, &m, "After more duplicates");
+
+        for (int key = 0; key < 2*n; key += 2) {
+                if (m.values[key/2] != -1) {
+                        remove_key(t, &m, key);
+                }
+        }
+        check_table(t, &m, "After removing all keys");
+        if (!table_is_empty(t)) {
+                fail("After removing all keys", "table not empty, n =", n);
+        }
+
+        table_kill(t);
+        free(m.values);
+}
+
+int main(int argc, char **argv)
+{
+        int sizes[] = { 0, 1, 2, 3, 10, 11, 100, DEFAULT_SIZE };
+        int n_sizes = sizeof(sizes)/sizeof(sizes[0]);
+
+        if (argc > 1) {
+                sizes[n_sizes - 1] = atoi(argv[1]);
+        }
+        if (sizes[n_sizes - 1] < 0) {
+                fprintf(stderr, "Usage: %s [n]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+
+        int max = 0;
+        for (int i = 0; i < n_sizes; i++) {
+                max = sizes[i] > max ? sizes[i] : max;
+        }
+        visited_keys = malloc((max + 1)*sizeof(*visited_keys));
+        visited_values = malloc((max + 1)*sizeof(*visited_values));
+
+        for (int i = 0; i < n_sizes; i++) {
+                test_ordered(sizes[i], 0);
+        }
+        printf("Ordered operations with duplicates: OK.\n");
+        for (int i = 0; i < n_sizes; i++) {
+                test_ordered(sizes[i], TABLE_UNIQUE_KEYS);
+        }
+        printf("Ordered operations with TABLE_UNIQUE_KEYS: OK.\n");
+
+        free(visited_keys);
+        free(visited_values);
+        return 0;
+}
@@ -0,0 +1,845 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "table.h"
+#include "table_stats.h"
+#include "radixtable.h"
+
+/*
+ * Implementation of a generic table as a compressed radix tree,
+ * specialized for string keys. Every key must be a NUL-terminated
+ * string. The keys are compared byte by byte while walking the tree,
+ * so lookup, insert and remove take time proportional to the length
+ * of the key, independent of the number of pairs. key_cmp_func is
+ * never called and the hash function is ignored.
+ *
+ * Each node has a label, the bytes on the edge from its parent. Chains
+ * of nodes with a single child and no pair are merged into one node
+ * with a longer label, so the tree has at most two nodes per key. A
+ * node with few children keeps them in small sorted arrays inside the
+ * node, searched by their first label byte. A node that gets more than
+ * SMALL_FANOUT children switches to an array of 256 children indexed
+ * by the first label byte, and switches back when half of the small
+ * arrays would suffice.
+ *
+ * Duplicates are handled by insert. If the key already exists its key
+ * and value are replaced by the new ones.
+ *
+ * The timings in tabletest use int keys, so run tabletest with -c for
+ * this table.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added table_clear() and table_drain().
+ *   2026-10-17: v1.2, added table_lookup_all() and table_count().
+ */
+
+// Maximum number of children kept in the small arrays of a node.
+#define SMALL_FANOUT 8
+
+// Number of children of a node with a full child array.
+#define FULL_FANOUT 256
+
+// ===========INTERNAL DATA TYPES============
+
+struct radix_node {
+	// Bytes on the edge from the parent, never NUL. Empty for the root.
+	unsigned char *label;
+	int label_len;
+	// True if a key ends at this node.
+	bool has_pair;
+	void *key;
+	void *value;
+	int n_children;
+	// Children of a node with at most SMALL_FANOUT children, sorted by
+	// the first byte of their labels.
+	unsigned char bytes[SMALL_FANOUT];
+	struct radix_node *small[SMALL_FANOUT];
+	// Children indexed by the first byte of their labels, or NULL if
+	// the small arrays are used.
+	struct radix_node **full;
+};
+
+struct table {
+	struct radix_node *root;
+	// Number of keys in the table.
+	int size;
+	compare_function *key_cmp_func;
+	free_function key_free_func;
+	free_function value_free_func;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * new_node() - Create a node without pair and children.
+ * @label: Bytes of the label.
+ * @len: Number of bytes in the label.
+ *
+ * Returns: Pointer to the new node.
+ */
+static struct radix_node *new_node(const unsigned char *label, int len)
+{
+	struct radix_node *n = calloc(1, sizeof(*n));
+
+	n->label = malloc(len > 0 ? len : 1);
+	memcpy(n->label, label, len);
+	n->label_len = len;
+	return n;
+}
+
+/**
+ * child_link() - Find the link to the child for a byte.
+ * @n: Node to inspect.
+ * @b: First byte of the label of the child.
+ *
+ * Returns: Address of the pointer to the child, or NULL if a node with
+ * small arrays has no such child. The pointer in a full array is NULL
+ * if there is no such child.
+ */
+static struct radix_node **child_link(struct radix_node *n, unsigned char b)
+{
+	if (n->full != NULL) {
+		return &n->full[b];
+	}
+	for (int i = 0; i < n->n_children && n->bytes[i] <= b; i++) {
+		if (n->bytes[i] == b) {
+			return &n->small[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * child_of() - Find the child for a byte.
+ * @n: Node to inspect.
+ * @b: First byte of the label of the child.
+ *
+ * Returns: The child, or NULL if there is no such child.
+ */
+static struct radix_node *child_of(const struct radix_node *n,
+				   unsigned char b)
+{
+	struct radix_node **link = child_link((struct radix_node *)n, b);
+
+	return link == NULL ? NULL : *link;
+}
+
+/**
+ * first_child() - Find the child with the smallest label.
+ * @n: Node with at least one child.
+ *
+ * Returns: The first child.
+ */
+static struct radix_node *first_child(const struct radix_node *n)
+{
+	if (n->full == NULL) {
+		return n->small[0];
+	}
+	int b = 0;
+	while (n->full[b] == NULL) {
+		b++;
+	}
+	return n->full[b];
+}
+
+/**
+ * add_child() - Add a child to a node.
+ * @n: Node to manipulate.
+ * @c: Child to add. n must not have a child with the same first label
+ *     byte.
+ *
+ * Switches n to a full child array if the small arrays are full.
+ *
+ * Returns: Nothing.
+ */
+static void add_child(struct radix_node *n, struct radix_node *c)
+{
+	unsigned char b = c->label[0];
+
+	if (n->full == NULL && n->n_children == SMALL_FANOUT) {
+		n->full = calloc(FULL_FANOUT, sizeof(*n->full));
+		for (int i = 0; i < n->n_children; i++) {
+			n->full[n->bytes[i]] = n->small[i];
+		}
+	}
+	if (n->full != NULL) {
+		n->full[b] = c;
+	} else {
+		// Shift the larger bytes up to keep the arrays sorted.
+		int i = n->n_children;
+		while (i > 0 && n->bytes[i - 1] > b) {
+			n->bytes[i] = n->bytes[i - 1];
+			n->small[i] = n->small[i - 1];
+			i--;
+		}
+		n->bytes[i] = b;
+		n->small[i] = c;
+	}
+	n->n_children++;
+}
+
+/**
+ * remove_child() - Remove a child from a node.
+ * @n: Node to manipulate.
+ * @b: First byte of the label of the child. The child must exist.
+ *
+ * Switches n back to the small arrays if they are at most half full
+ * afterwards. The child itself is not freed.
+ *
+ * Returns: Nothing.
+ */
+static void remove_child(struct radix_node *n, unsigned char b)
+{
+	n->n_children--;
+	if (n->full != NULL) {
+		n->full[b] = NULL;
+		if (n->n_children <= SMALL_FANOUT / 2) {
+			int i = 0;
+			for (int c = 0; c < FULL_FANOUT; c++) {
+				if (n->full[c] != NULL) {
+					n->bytes[i] = c;
+					n->small[i] = n->full[c];
+					i++;
+				}
+			}
+			free(n->full);
+			n->full = NULL;
+		}
+		return;
+	}
+	int i = 0;
+	while (n->bytes[i] != b) {
+		i++;
+	}
+	for (; i < n->n_children; i++) {
+		n->bytes[i] = n->bytes[i + 1];
+		n->small[i] = n->small[i + 1];
+	}
+}
+
+/**
+ * match_label() - Count the label bytes at the start of a string.
+ * @n: Node whose label is compared.
+ * @s: Rest of a key.
+ *
+ * Returns: The number of leading bytes of the label equal to the
+ * bytes of s. The label has no NUL, so the count stops at the end of s.
+ */
+static int match_label(const struct radix_node *n, const unsigned char *s)
+{
+	int i = 0;
+
+	while (i < n->label_len && n->label[i] == s[i]) {
+		i++;
+	}
+	return i;
+}
+
+/**
+ * merge_child() - Merge a node with its only child.
+ * @n: Node without pair and with one child.
+ *
+ * The child is freed and n takes its pair and children, with the
+ * label of the child appended to its own.
+ *
+ * Returns: Nothing.
+ */
+static void merge_child(struct radix_node *n)
+{
+	struct radix_node *c = first_child(n);
+	int len = n->label_len + c->label_len;
+	unsigned char *label = malloc(len);
+
+	memcpy(label, n->label, n->label_len);
+	memcpy(label + n->label_len, c->label, c->label_len);
+	free(n->label);
+	free(n->full);
+	*n = *c;
+	n->label = label;
+	n->label_len = len;
+	free(c->label);
+	free(c);
+}
+
+/**
+ * find_node() - Find the node where a key ends.
+ * @t: Table to inspect.
+ * @key: Key to look for.
+ * @probes: Set to the number of nodes visited.
+ *
+ * Returns: The node holding the pair of key, or NULL if key is not in
+ * the table.
+ */
+static struct radix_node *find_node(const table *t, const void *key,
+				    unsigned long *probes)
+{
+	const unsigned char *s = key;
+	const struct radix_node *n = t->root;
+
+	*probes = 1;
+	while (*s != '\0') {
+		n = child_of(n, *s);
+		if (n == NULL) {
+			return NULL;
+		}
+		(*probes)++;
+		int m = match_label(n, s);
+		if (m < n->label_len) {
+			return NULL;
+		}
+		s += m;
+	}
+	return n->has_pair ? (struct radix_node *)n : NULL;
+}
+
+/**
+ * visit() - Call a function for all pairs in a subtree.
+ * @n: Root of the subtree.
+ * @func: Function called for each key/value pair.
+ *
+ * Visits the pair of n before the subtrees of its children, in the
+ * order of their labels, which is the order of the keys.
+ *
+ * Returns: Nothing.
+ */
+static void visit(const struct radix_node *n, inspect_callback_pair func)
+{
+	if (n->has_pair) {
+		func(n->key, n->value);
+	}
+	if (n->full != NULL) {
+		for (int b = 0; b < FULL_FANOUT; b++) {
+			if (n->full[b] != NULL) {
+				visit(n->full[b], func);
+			}
+		}
+	} else {
+		for (int i = 0; i < n->n_children; i++) {
+			visit(n->small[i], func);
+		}
+	}
+}
+
+/**
+ * free_pair() - Free the key and value of a node.
+ * @t: Table the node belongs to.
+ * @n: Node with a pair.
+ *
+ * Calls any free functions set for keys/values.
+ *
+ * Returns: Nothing.
+ */
+static void free_pair(const table *t, struct radix_node *n)
+{
+	if (t->key_free_func != NULL) {
+		t->key_free_func(n->key);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(n->value);
+	}
+}
+
+/**
+ * free_subtree() - Free a subtree and its pairs.
+ * @t: Table the subtree belongs to.
+ * @n: Root of the subtree.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * Returns: Nothing.
+ */
+static void free_subtree(const table *t, struct radix_node *n,
+			 consume_callback_pair func)
+{
+	if (n->has_pair && func != NULL) {
+		func(n->key, n->value);
+	} else if (n->has_pair) {
+		free_pair(t, n);
+	}
+	if (n->full != NULL) {
+		for (int b = 0; b < FULL_FANOUT; b++) {
+			if (n->full[b] != NULL) {
+				free_subtree(t, n->full[b], func);
+			}
+		}
+		free(n->full);
+	} else {
+		for (int i = 0; i < n->n_children; i++) {
+			free_subtree(t, n->small[i], func);
+		}
+	}
+	free(n->label);
+	free(n);
+}
+
+/**
+ * empty_tree() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * Returns: Nothing.
+ */
+static void empty_tree(table *t, consume_callback_pair func)
+{
+	free_subtree(t, t->root, func);
+	t->root = new_node((const unsigned char *)"", 0);
+	t->size = 0;
+}
+
+/**
+ * visit_key() - Visit the pair with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function to call for the pair, or NULL.
+ *
+ * Returns: The number of pairs with the key, 0 or 1.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	unsigned long probes;
+	struct radix_node *n = find_node(t, key, &probes);
+
+	TABLE_STATS_LOOKUP(t, probes, n != NULL);
+	if (n == NULL) {
+		return 0;
+	}
+	if (func != NULL) {
+		func(n->key, n->value);
+	}
+	return 1;
+}
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: Ignored, the keys are compared as strings.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	// Allocate the table header.
+	table *t = calloc(1, sizeof(*t));
+	// Create the root, which has an empty label.
+	t->root = new_node((const unsigned char *)"", 0);
+	// Store the key compare function and key/value free functions.
+	t->key_cmp_func = key_cmp_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	TABLE_STATS_INIT(t);
+
+	return t;
+}
+
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: Ignored, the keys are compared as strings.
+ * @key_hash_func: Ignored, the keys are not hashed.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: Ignored, the keys are compared as strings.
+ * @key_hash_func: Ignored, the keys are not hashed.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: Ignored, the keys of this table are always unique.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value, a NUL-terminated string.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key already is in
+ * the table, its key and value are replaced, and any free functions
+ * are called on the replaced ones unless they are the same memory as
+ * the new ones.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	const unsigned char *s = key;
+	struct radix_node *n = t->root;
+	unsigned long probes = 1;
+
+	while (*s != '\0') {
+		struct radix_node **link = child_link(n, *s);
+		struct radix_node *c = link == NULL ? NULL : *link;
+		if (c == NULL) {
+			// The rest of the key becomes the label of a new leaf.
+			int len = strlen((const char *)s);
+			c = new_node(s, len);
+			add_child(n, c);
+			n = c;
+			break;
+		}
+		probes++;
+		int m = match_label(c, s);
+		if (m < c->label_len) {
+			// Split the label of c after the matching bytes.
+			struct radix_node *mid = new_node(c->label, m);
+			memmove(c->label, c->label + m, c->label_len - m);
+			c->label_len -= m;
+			add_child(mid, c);
+			*link = mid;
+			c = mid;
+		}
+		n = c;
+		s += m;
+	}
+
+	TABLE_STATS_INSERT(t, probes);
+	if (n->has_pair) {
+		if (t->key_free_func != NULL && n->key != key) {
+			t->key_free_func(n->key);
+		}
+		if (t->value_free_func != NULL && n->value != value) {
+			t->value_free_func(n->value);
+		}
+	} else {
+		n->has_pair = true;
+		t->size++;
+	}
+	n->key = key;
+	n->value = value;
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up, a NUL-terminated string.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	unsigned long probes;
+	struct radix_node *n = find_node(t, key, &probes);
+
+	TABLE_STATS_LOOKUP(t, probes, n != NULL);
+	return n == NULL ? NULL : n->value;
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The keys of the table are unique, so func is called at most once.
+ * func must not change the table.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: The smallest key in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	const struct radix_node *n = t->root;
+
+	// Every node without pair has children, except an empty root.
+	while (!n->has_pair) {
+		n = first_child(n);
+	}
+	return n->key;
+}
+
+/**
+ * table_remove() - Remove a pair from a table.
+ * @t: Table to manipulate.
+ * @key: Key of the pair to remove, a NUL-terminated string.
+ *
+ * Any matching key/value pair is removed from the table. Calls any
+ * free functions set for keys/values. Does nothing if key is not
+ * found in the table. Nodes left without a pair are merged with their
+ * only child or removed.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	const unsigned char *s = key;
+	struct radix_node *parent = NULL;
+	struct radix_node *n = t->root;
+	unsigned long probes = 1;
+
+	while (*s != '\0') {
+		struct radix_node *c = child_of(n, *s);
+		if (c == NULL) {
+			break;
+		}
+		probes++;
+		int m = match_label(c, s);
+		if (m < c->label_len) {
+			break;
+		}
+		parent = n;
+		n = c;
+		s += m;
+	}
+	TABLE_STATS_REMOVE(t, probes);
+	if (*s != '\0' || !n->has_pair) {
+		return;
+	}
+
+	free_pair(t, n);
+	n->has_pair = false;
+	t->size--;
+	if (parent == NULL) {
+		// The root is kept even without pair and children.
+		return;
+	}
+	if (n->n_children == 0) {
+		remove_child(parent, n->label[0]);
+		free(n->label);
+		free(n);
+		if (parent != t->root && !parent->has_pair
+		    && parent->n_children == 1) {
+			merge_child(parent);
+		}
+	} else if (n->n_children == 1) {
+		merge_child(n);
+	}
+}
+
+/**
+ * table_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	free_subtree(t, t->root, NULL);
+	TABLE_STATS_FREE(t);
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_tree(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table.
+ *	  Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_tree(t, func);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table, in key order, and
+ * prints them. Will print all stored elements.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	visit(t->root, print_func);
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of an operation is the number of nodes it visited,
+ * including the root. No keys are compared with key_cmp_func.
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
+
+/**
+ * table_prefix_scan() - Visit the pairs whose keys start with a prefix.
+ * @t: Table to inspect.
+ * @prefix: String that the visited keys start with. The empty string
+ *	    visits all pairs.
+ * @func: Function called for each key/value pair with the prefix.
+ *
+ * Walks down the tree as a lookup of prefix does, and visits the
+ * subtree of the node whose path starts with all of prefix.
+ *
+ * Returns: Nothing.
+ */
+void table_prefix_scan(const table *t, const char *prefix,
+		       inspect_callback_pair func)
+{
+	const unsigned char *s = (const unsigned char *)prefix;
+	const struct radix_node *n = t->root;
+
+	while (*s != '\0') {
+		n = child_of(n, *s);
+		if (n == NULL) {
+			return;
+		}
+		int m = match_label(n, s);
+		if (s[m] == '\0') {
+			// The prefix ends within or at the end of the label.
+			break;
+		}
+		if (m < n->label_len) {
+			return;
+		}
+		s += m;
+	}
+	visit(n, func);
+}
@@ -0,0 +1,34 @@
+#ifndef RADIXTABLE_H
+#define RADIXTABLE_H
+
+#include "table.h"
+
+/*
+ * Extra operations for the radix tree implementation of table.h in
+ * radixtable.c.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_prefix_scan() - Visit the pairs whose keys start with a prefix.
+ * @t: Table to inspect.
+ * @prefix: String that the visited keys start with. The empty string
+ *	    visits all pairs.
+ * @func: Function called for each key/value pair with the prefix.
+ *
+ * The pairs are visited in the order of their keys, compared as
+ * strings of unsigned chars like strcmp() does. The table must not be
+ * changed by func.
+ *
+ * Returns: Nothing.
+ */
+void table_prefix_scan(const table *t, const char *prefix,
+		       inspect_callback_pair func);
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * radixtest - test the prefix scan of the radix tree table.
+ *
+ * Should be compiled together with radixtable.c.
+ *
+ * Usage: radixtest [n]
+ *
+ * Tests that table_prefix_scan() visits exactly the pairs whose keys
+ * start with a prefix, in strcmp() order. The table holds words that
+ * share prefixes, the empty string, keys with bytes above 127 and n
+ * keys "key0", "key1", ..., so that a node gets more than eight
+ * children and switches to its full child array. The prefixes include
+ * the empty prefix, prefixes that are themselves keys, prefixes that
+ * end at a node or in the middle of a label, and prefixes without a
+ * match that leave the tree at a node, in the middle of a label or
+ * after the end of a key. The scans are repeated after most keys are
+ * removed, which switches a full child array back, and once the
+ * table is empty.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "table.h"
+#include "radixtable.h"
+
+// Default number of keys "key0", "key1", ...
+#define DEFAULT_SIZE 1000
+// Longest key of the test, including the NUL
+#define MAX_KEY 20
+
+// Keys inserted besides the generated ones
+const char *words[] = {
+        "", "a", "app", "apple", "applet", "application", "apply",
+        "banana", "band", "bandana", "can", "candy", "cane",
+        "x0", "x9", "xa", "xb", "xm", "xz", "xA", "xZ", "x-", "x~",
+        "x\xc3\xa5", "x\xe5", "x\xff\x01",
+};
+
+// Prefixes scanned by the test
+const char *prefixes[] = {
+        "", "a", "ap", "app", "appl", "apple", "applica", "application",
+        "applications", "applicb", "apq", "b", "ba", "bad", "ban", "band",
+        "bandan", "bandanas", "banx", "c", "can", "cand", "d", "key",
+        "key1", "key99", "key1000", "keyx", "x", "x\xc3", "x\xe5", "x\xff",
+        "y", "\xff",
+};
+
+/* Keys the test expects to be in the table.
+ *    keys - the keys, sorted in strcmp() order
+ *    n - the number of keys
+ */
+struct model {
+        char **keys;
+        int n;
+};
+
+// Keys visited by table_prefix_scan(), in the order they were visited
+const char **visited_keys;
+int n_visited;
+
+/**
+ * copy_string() - Create a dynamic copy of a string.
+ * @s: String to copy.
+ *
+ * Returns: Pointer to the copy of s.
+ */
+char *copy_string(const char *s)
+{
+        char *c = malloc(strlen(s) + 1);
+        strcpy(c, s);
+        return c;
+}
+
+int string_compare(const void *ip1,const void *ip2)
+{
+        return strcmp(ip1, ip2);
+}
+
+// Compares two pointers to strings, for qsort().
+int string_ptr_compare(const void *ip1,const void *ip2)
+{
+        return strcmp(*(char * const *)ip1, *(char * const *)ip2);
+}
+
+/**
+ * visit_pair() - Record a pair visited by table_prefix_scan().
+ * @key: Key of the pair.
+ * @value: Value of the pair, a copy of the key.
+ *
+ * Returns: Nothing.
+ */
+void visit_pair(const void *key, const void *value)
+{
+        if (strcmp(key, value) != 0) {
+                fprintf(stderr, "FAIL: key \"%s\" has the value \"%s\".\n",
+                        (const char *)key, (const char *)value);
+                exit(EXIT_FAILURE);
+        }
+        visited_keys[n_visited++] = key;
+}
+
+/**
+ * fail() - Print an error message and exit.
+ * @name: Name of the test that failed.
+ * @what: What went wrong.
+ * @prefix: Prefix that was scanned.
+ * @key: Key that went wrong, or NULL.
+ *
+ * Returns: Never.
+ */
+void fail(const char *name, const char *what, const char *prefix,
+          const char *key)
+{
+        fprintf(stderr, "FAIL: %s: prefix \"%s\" %s", name, prefix, what);
+        if (key != NULL) {
+                fprintf(stderr, " \"%s\"", key);
+        }
+        fprintf(stderr, ".\n");
+        exit(EXIT_FAILURE);
+}
+
+/**
+ * check_scan() - Check that a prefix scan visits the keys of the model
+ * with the prefix, in order.
+ * @t: Table to check.
+ * @m: Model of the table.
+ * @prefix: Prefix to scan.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void check_scan(const table *t, const struct model *m, const char *prefix,
+                const char *name)
+{
+        size_t len = strlen(prefix);
+        int next = 0;
+
+        n_visited = 0;
+        table_prefix_scan(t, prefix, visit_pair);
+        for (int i = 0; i < m->n; i++) {
+                if (strncmp(m->keys[i], prefix, len) != 0) {
+                        continue;
+                }
+                if (next == n_visited) {
+                        fail(name, "did not visit", prefix, m->keys[i]);
+                }
+                if (strcmp(visited_keys[next], m->keys[i]) != 0) {
+                        fail(name, "visited out of order", prefix,
+                             visited_keys[next]);
+                }
+                next++;
+        }
+        if (next != n_visited) {
+                fail(name, "visited a key without the prefix,", prefix,
+                     visited_keys[next]);
+        }
+}
+
+/**
+ * check_table() - Scan all prefixes of the test.
+ * @t: Table to check.
+ * @m: Model of the table.
+ * @name: Name of the test.
+ *
+ * Returns: Nothing.
+ */
+void check_table(const table *t, const struct model *m, const char *name)
+{
+        for (size_t i = 0; i < sizeof(prefixes)/sizeof(prefixes[0]); i++) {
+                check_scan(t, m, prefixes[i], name);
+        }
+        printf("%s: OK.\n", name);
+}
+
+int main(int argc, char **argv)
+{
+        int n = DEFAULT_SIZE;
+        if (argc > 1) {
+                n = atoi(argv[1]);
+        }
+        if (n < 0 || n > 100000000) {
+                fprintf(stderr, "Usage: %s [n]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+
+        int n_words = sizeof(words)/sizeof(words[0]);
+        struct model m = { .n = 0 };
+        m.keys = malloc((n_words + n)*sizeof(*m.keys));
+        visited_keys = malloc((n_words + n)*sizeof(*visited_keys));
+        for (int i = 0; i < n_words; i++) {
+                m.keys[m.n++] = copy_string(words[i]);
+        }
+        for (int i = 0; i < n; i++) {
+                char key[MAX_KEY];
+                sprintf(key, "key%d", i);
+                m.keys[m.n++] = copy_string(key);
+        }
+
+        // Insert the keys in an order unlike the sorted one, the words
+        // with a wrong value first that the second insert replaces
+        table *t = table_empty(string_compare, free, free);
+        for (int i = 0; i < n_words; i++) {
+                table_insert(t, copy_string(m.keys[i]), copy_string("?"));
+        }
+        for (int i = m.n - 1; i >= 0; i--) {
+                table_insert(t, copy_string(m.keys[i]),
+                             copy_string(m.keys[i]));
+        }
+        qsort(m.keys, m.n, sizeof(*m.keys), string_ptr_compare);
+        check_table(t, &m, "Filled table");
+
+        // Remove all but every seventh key, keeping the model sorted
+        int kept = 0;
+        for (int i = 0; i < m.n; i++) {
+                if (i % 7 != 3) {
+                        table_remove(t, m.keys[i]);
+                        free(m.keys[i]);
+                } else {
+                        m.keys[kept++] = m.keys[i];
+                }
+        }
+        m.n = kept;
+        check_table(t, &m, "After removes");
+
+        for (int i = 0; i < m.n; i++) {
+                table_remove(t, m.keys[i]);
+                free(m.keys[i]);
+        }
+        m.n = 0;
+        check_table(t, &m, "Empty table");
+        if (!table_is_empty(t)) {
+                fprintf(stderr, "FAIL: table not empty after removes.\n");
+                exit(EXIT_FAILURE);
+        }
+
+        table_kill(t);
+        free(m.keys);
+        free(visited_keys);
+        return 0;
+}
@@ -0,0 +1,1188 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "table.h"
+#include "table_stats.h"
+#include "array_1d.h"
+#include "sortedtable.h"
+#include "orderedtable.h"
+
+/*
+ * Implementation of a generic table as a key-sorted array, searched
+ * by binary search. Keys and values are kept in two parallel
+ * one-dimensional arrays that are doubled in size when full.
+ *
+ * Inserts are appended to an unsorted tail, which is sorted and
+ * merged into the sorted part the next time the table is searched.
+ * Filling a table and then reading it therefore costs O(n log n)
+ * instead of O(n^2).
+ *
+ * Removed pairs have their value freed at once but are only marked,
+ * and the array is compacted when half of it is marked. The key of a
+ * marked pair is freed at compaction, since binary search still needs
+ * it. Removing a key therefore does not shift the array every time.
+ *
+ * table_build_eytzinger() (see sortedtable.h) adds a read-only copy
+ * of the table in Eytzinger order for tables that are filled once and
+ * then only looked up. table_lookup_many() searches that copy with a
+ * group of keys in lock step and prefetches ahead for all of them. The
+ * ordered operations in orderedtable.h are supported as well.
+ *
+ * Duplicates are handled by lookup and remove. Duplicates are kept in
+ * insertion order, so the latest one is the last of its run. In tables
+ * created with TABLE_UNIQUE_KEYS, inserts still go to the tail, and
+ * the pairs they replace are dropped when the tail is merged.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ *   2026-10-17: v1.1, added the operations in orderedtable.h.
+ *   2026-10-17: v1.2, added batched insert/lookup/remove.
+ *   2026-10-17: v1.3, added table_stats().
+ *   2026-10-17: v1.4, added table_empty_ex().
+ *   2026-10-17: v1.5, added table_clear() and table_drain().
+ *   2026-10-17: v1.6, added table_lookup_all() and table_count().
+ *   2026-10-18: v1.7, table_kill(), table_clear() and table_drain()
+ *                     merge the tail first, so that pairs replaced in a
+ *                     table with unique keys are freed once.
+ */
+
+// Number of pairs a newly created table has room for.
+#define INITIAL_CAPACITY 16
+
+// Number of keys searched together in the Eytzinger copy by
+// table_lookup_many().
+#define BATCH_SIZE 16
+
+// Prefetch a cache line that will soon be read, if the compiler can.
+#ifdef __GNUC__
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p)
+#endif
+
+// Value stored in place of the value of a removed pair. Its address
+// cannot be the address of any value inserted by the user.
+static char removed_marker;
+#define REMOVED ((void *)&removed_marker)
+
+// ===========INTERNAL DATA TYPES============
+
+struct table_entry {
+	void *key;
+	void *value;
+};
+
+struct table {
+	array_1d *keys;
+	array_1d *values;
+	// Number of stored pairs, including removed ones.
+	int size;
+	// Number of pairs marked as removed.
+	int removed;
+	// Pairs [0, sorted) are sorted, pairs [sorted, size) are not.
+	int sorted;
+	// Eytzinger copy, indexed from 1, or NULL if there is none.
+	void **eyt_keys;
+	void **eyt_values;
+	int eyt_size;
+	compare_function *key_cmp_func;
+	free_function key_free_func;
+	free_function value_free_func;
+	// True if created with TABLE_UNIQUE_KEYS.
+	bool unique_keys;
+#ifdef TABLE_STATS
+	table_statistics *stats;
+#endif
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * drop_eytzinger() - Remove the Eytzinger copy of a table, if any.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+static void drop_eytzinger(table *t)
+{
+	free(t->eyt_keys);
+	free(t->eyt_values);
+	t->eyt_keys = NULL;
+	t->eyt_values = NULL;
+	t->eyt_size = 0;
+}
+
+/**
+ * ensure_capacity() - Make sure the arrays can hold a number of pairs.
+ * @t: Table to manipulate.
+ * @n: Number of pairs the arrays must have room for.
+ *
+ * Returns: Nothing.
+ */
+static void ensure_capacity(table *t, int n)
+{
+	int capacity = array_1d_high(t->keys) + 1;
+
+	if (n <= capacity) {
+		return;
+	}
+	while (capacity < n) {
+		capacity *= 2;
+	}
+
+	array_1d *keys = array_1d_create(0, capacity - 1, NULL);
+	array_1d *values = array_1d_create(0, capacity - 1, NULL);
+	for (int i = 0; i < t->size; i++) {
+		array_1d_set_value(keys, array_1d_inspect_value(t->keys, i), i);
+		array_1d_set_value(values,
+				   array_1d_inspect_value(t->values, i), i);
+	}
+	array_1d_kill(t->keys);
+	array_1d_kill(t->values);
+	t->keys = keys;
+	t->values = values;
+}
+
+/**
+ * merge_sort() - Stable sort of key/value pairs.
+ * @t: Table whose compare function is used.
+ * @pairs: Pairs to sort.
+ * @tmp: Scratch space for at least n pairs.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+static void merge_sort(const table *t, struct table_entry *pairs,
+		       struct table_entry *tmp, int n)
+{
+	if (n < 2) {
+		return;
+	}
+	int half = n / 2;
+	merge_sort(t, pairs, tmp, half);
+	merge_sort(t, pairs + half, tmp, n - half);
+
+	int i = 0;
+	int j = half;
+	int k = 0;
+	while (i < half && j < n) {
+		// Take from the left run on ties to keep the sort stable.
+		if (TABLE_KEY_CMP(t, pairs[j].key, pairs[i].key) < 0) {
+			tmp[k++] = pairs[j++];
+		} else {
+			tmp[k++] = pairs[i++];
+		}
+	}
+	while (i < half) {
+		tmp[k++] = pairs[i++];
+	}
+	while (j < n) {
+		tmp[k++] = pairs[j++];
+	}
+	for (k = 0; k < n; k++) {
+		pairs[k] = tmp[k];
+	}
+}
+
+/**
+ * drop_replaced() - Keep only the latest pair of each key.
+ * @t: Table with unique keys to manipulate. Must not have an unsorted
+ *     tail.
+ *
+ * Calls any free functions set for keys/values on the dropped keys and
+ * values, unless they are the same memory as the kept ones.
+ *
+ * Returns: Nothing.
+ */
+static void drop_replaced(table *t)
+{
+	int n = 0;
+
+	for (int i = 0; i < t->size; i++) {
+		void *key = array_1d_inspect_value(t->keys, i);
+		void *value = array_1d_inspect_value(t->values, i);
+		void *prev = n > 0 ? array_1d_inspect_value(t->keys, n - 1)
+			: NULL;
+		if (n > 0 && TABLE_KEY_CMP(t, prev, key) == 0) {
+			// Pair n - 1 is replaced by pair i.
+			void *prev_value = array_1d_inspect_value(t->values,
+								  n - 1);
+			if (t->key_free_func != NULL && prev != key) {
+				t->key_free_func(prev);
+			}
+			if (prev_value == REMOVED) {
+				t->removed--;
+			} else if (t->value_free_func != NULL
+				   && prev_value != value) {
+				t->value_free_func(prev_value);
+			}
+			n--;
+		}
+		array_1d_set_value(t->keys, key, n);
+		array_1d_set_value(t->values, value, n);
+		n++;
+	}
+	t->size = n;
+	t->sorted = n;
+}
+
+/**
+ * merge_tail() - Sort the unsorted tail into the sorted part.
+ * @t: Table to manipulate.
+ *
+ * Pairs in the tail are newer than all pairs in the sorted part, so
+ * equal keys from the tail are placed after those already sorted.
+ *
+ * Returns: Nothing.
+ */
+static void merge_tail(table *t)
+{
+	int n = t->size - t->sorted;
+
+	if (n == 0) {
+		return;
+	}
+
+	struct table_entry *tail = malloc(n * sizeof(*tail));
+	struct table_entry *tmp = malloc(n * sizeof(*tmp));
+	for (int j = 0; j < n; j++) {
+		tail[j].key = array_1d_inspect_value(t->keys, t->sorted + j);
+		tail[j].value = array_1d_inspect_value(t->values,
+						       t->sorted + j);
+	}
+	merge_sort(t, tail, tmp, n);
+
+	// Merge from the back so that no sorted pair is overwritten
+	// before it has been moved.
+	int i = t->sorted - 1;
+	int j = n - 1;
+	for (int dst = t->size - 1; j >= 0; dst--) {
+		void *key = i >= 0 ? array_1d_inspect_value(t->keys, i) : NULL;
+		if (i >= 0 && TABLE_KEY_CMP(t, key, tail[j].key) > 0) {
+			array_1d_set_value(t->keys, key, dst);
+			array_1d_set_value(t->values,
+					   array_1d_inspect_value(t->values, i),
+					   dst);
+			i--;
+		} else {
+			array_1d_set_value(t->keys, tail[j].key, dst);
+			array_1d_set_value(t->values, tail[j].value, dst);
+			j--;
+		}
+	}
+	t->sorted = t->size;
+
+	free(tail);
+	free(tmp);
+	if (t->unique_keys) {
+		drop_replaced(t);
+	}
+}
+
+/**
+ * sort_pending() - Merge any unsorted tail of a read-only table.
+ * @t: Table to inspect.
+ *
+ * Merging only changes the order of the pairs, except in a table with
+ * unique keys where it also drops the replaced ones. Neither changes
+ * what the operations can observe, so it is done on behalf of the
+ * const operations too.
+ *
+ * Returns: Nothing.
+ */
+static void sort_pending(const table *t)
+{
+	merge_tail((table *)t);
+}
+
+/**
+ * lower_bound() - Find the first pair with a key not less than key.
+ * @t: Table to inspect. Must not have an unsorted tail.
+ * @key: Key to search for.
+ *
+ * Returns: Index of the first pair whose key is not less than key, or
+ * the number of pairs if there is no such pair.
+ */
+static int lower_bound(const table *t, const void *key)
+{
+	int lo = 0;
+	int hi = t->size;
+
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		if (TABLE_KEY_CMP(t, array_1d_inspect_value(t->keys, mid),
+				  key) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * upper_bound() - Find the first pair with a key greater than key.
+ * @t: Table to inspect. Must not have an unsorted tail.
+ * @key: Key to search for.
+ *
+ * Returns: Index of the first pair whose key is greater than key, or
+ * the number of pairs if there is no such pair.
+ */
+static int upper_bound(const table *t, const void *key)
+{
+	int lo = 0;
+	int hi = t->size;
+
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		if (TABLE_KEY_CMP(t, array_1d_inspect_value(t->keys, mid),
+				  key) <= 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * eytzinger_fill() - Copy sorted pairs into Eytzinger order.
+ * @t: Table to manipulate.
+ * @src: Sorted pairs with distinct keys.
+ * @next: Index of the next pair in src to place.
+ * @k: Eytzinger index of the subtree to fill.
+ *
+ * An in-order walk of the implicit tree visits the indices in key
+ * order, so placing the pairs in that walk gives the layout.
+ *
+ * Returns: Nothing.
+ */
+static void eytzinger_fill(table *t, const struct table_entry *src,
+			   int *next, int k)
+{
+	if (k > t->eyt_size) {
+		return;
+	}
+	eytzinger_fill(t, src, next, 2 * k);
+	t->eyt_keys[k] = src[*next].key;
+	t->eyt_values[k] = src[*next].value;
+	(*next)++;
+	eytzinger_fill(t, src, next, 2 * k + 1);
+}
+
+/**
+ * eytzinger_lookup() - Look up a key in the Eytzinger copy.
+ * @t: Table to inspect. Must have an Eytzinger copy.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to key, or NULL if not found.
+ */
+static void *eytzinger_lookup(const table *t, const void *key)
+{
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+	int k = 1;
+
+	while (k <= t->eyt_size) {
+		// Eight pointers fit in a cache line, so this fetches the
+		// line holding all descendants three levels down.
+		PREFETCH(t->eyt_keys + 8 * k);
+		k = 2 * k + (TABLE_KEY_CMP(t, t->eyt_keys[k], key) < 0);
+	}
+	// Undo the right turns taken after the last left turn. The last
+	// left turn was made at the first key not less than key.
+	while (k & 1) {
+		k >>= 1;
+	}
+	k >>= 1;
+
+	if (k == 0 || TABLE_KEY_CMP(t, t->eyt_keys[k], key) != 0) {
+		TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, false);
+		return NULL;
+	}
+	TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, true);
+	return t->eyt_values[k];
+}
+
+/**
+ * tree_depth() - Compute the depth of an Eytzinger index.
+ * @k: Eytzinger index, at least 1.
+ *
+ * Returns: The number of steps from the root to k.
+ */
+static unsigned long tree_depth(int k)
+{
+	unsigned long depth = 0;
+
+	while (k > 1) {
+		k >>= 1;
+		depth++;
+	}
+	return depth;
+}
+
+/**
+ * eytzinger_lookup_batch() - Look up a batch of keys in the Eytzinger
+ *			      copy.
+ * @t: Table to inspect. Must have an Eytzinger copy.
+ * @keys: Keys to look up.
+ * @values: Set to the value for each key, or NULL.
+ * @n: Number of keys, at most BATCH_SIZE.
+ *
+ * Takes one step for every key of the batch before taking the next
+ * step for any of them, so the prefetches of all keys are in flight
+ * at the same time.
+ *
+ * Returns: Nothing.
+ */
+static void eytzinger_lookup_batch(const table *t, void **keys,
+				   void **values, int n)
+{
+	int k[BATCH_SIZE];
+	int active = n;
+
+	for (int j = 0; j < n; j++) {
+		k[j] = 1;
+	}
+	while (active > 0) {
+		active = 0;
+		for (int j = 0; j < n; j++) {
+			if (k[j] > t->eyt_size) {
+				continue;
+			}
+			PREFETCH(t->eyt_keys + 8 * k[j]);
+			k[j] = 2 * k[j]
+				+ (TABLE_KEY_CMP(t, t->eyt_keys[k[j]],
+						 keys[j]) < 0);
+			active++;
+		}
+	}
+	for (int j = 0; j < n; j++) {
+		int i = k[j];
+		while (i & 1) {
+			i >>= 1;
+		}
+		i >>= 1;
+		if (i == 0 || TABLE_KEY_CMP(t, t->eyt_keys[i], keys[j]) != 0) {
+			values[j] = NULL;
+		} else {
+			values[j] = t->eyt_values[i];
+		}
+		TABLE_STATS_LOOKUP(t, tree_depth(k[j]) + (i != 0),
+				   values[j] != NULL);
+	}
+}
+
+/**
+ * free_pair() - Call any free functions set for keys/values.
+ * @t: Table the pair belongs to.
+ * @i: Index of the pair.
+ *
+ * Returns: Nothing.
+ */
+static void free_pair(const table *t, int i)
+{
+	void *value = array_1d_inspect_value(t->values, i);
+
+	if (t->key_free_func != NULL) {
+		t->key_free_func(array_1d_inspect_value(t->keys, i));
+	}
+	// The value of a removed pair has already been freed.
+	if (t->value_free_func != NULL && value != REMOVED) {
+		t->value_free_func(value);
+	}
+}
+
+/**
+ * trim_removed() - Drop removed pairs from the end of a table.
+ * @t: Table to manipulate. Must not have an unsorted tail.
+ *
+ * Dropping them needs no shifting, and keeps table_choose_key() from
+ * stepping over them.
+ *
+ * Returns: Nothing.
+ */
+static void trim_removed(table *t)
+{
+	while (t->size > 0
+	       && array_1d_inspect_value(t->values, t->size - 1) == REMOVED) {
+		t->size--;
+		free_pair(t, t->size);
+		t->removed--;
+	}
+	t->sorted = t->size;
+}
+
+/**
+ * compact() - Free removed pairs and close the gaps they leave.
+ * @t: Table to manipulate. Must not have an unsorted tail.
+ *
+ * Returns: Nothing.
+ */
+static void compact(table *t)
+{
+	int n = 0;
+
+	for (int i = 0; i < t->size; i++) {
+		void *value = array_1d_inspect_value(t->values, i);
+		if (value == REMOVED) {
+			free_pair(t, i);
+			continue;
+		}
+		array_1d_set_value(t->keys, array_1d_inspect_value(t->keys, i),
+				   n);
+		array_1d_set_value(t->values, value, n);
+		n++;
+	}
+	t->size = n;
+	t->sorted = n;
+	t->removed = 0;
+}
+
+/**
+ * empty_arrays() - Remove all pairs from a table.
+ * @t: Table to manipulate.
+ * @func: Function that takes over each pair, or NULL to call the free
+ *	  functions set for keys/values.
+ *
+ * The tail is merged first, so that a table with unique keys drops
+ * and frees the pairs that were replaced. The keys of pairs marked as
+ * removed are still owned by the table, so they are freed even if func
+ * is given. The arrays are replaced by arrays with room for
+ * INITIAL_CAPACITY pairs.
+ *
+ * Returns: Nothing.
+ */
+static void empty_arrays(table *t, consume_callback_pair func)
+{
+	merge_tail(t);
+	for (int i = 0; i < t->size; i++) {
+		void *value = array_1d_inspect_value(t->values, i);
+		if (func != NULL && value != REMOVED) {
+			func(array_1d_inspect_value(t->keys, i), value);
+		} else {
+			free_pair(t, i);
+		}
+	}
+	drop_eytzinger(t);
+	array_1d_kill(t->keys);
+	array_1d_kill(t->values);
+	t->keys = array_1d_create(0, INITIAL_CAPACITY - 1, NULL);
+	t->values = array_1d_create(0, INITIAL_CAPACITY - 1, NULL);
+	t->size = 0;
+	t->removed = 0;
+	t->sorted = 0;
+}
+
+/**
+ * visible_from() - Find the next pair that table_lookup() could return.
+ * @t: Table to inspect. Must not have an unsorted tail.
+ * @i: Index to start at.
+ *
+ * Such a pair is the last of its run of equal keys and not removed.
+ *
+ * Returns: Index of the first such pair at or after i, or the number
+ * of pairs if there is none.
+ */
+static int visible_from(const table *t, int i)
+{
+	for (; i < t->size; i++) {
+		if (array_1d_inspect_value(t->values, i) == REMOVED) {
+			continue;
+		}
+		if (i == t->size - 1
+		    || TABLE_KEY_CMP(t, array_1d_inspect_value(t->keys, i),
+				     array_1d_inspect_value(t->keys, i + 1))
+		    != 0) {
+			return i;
+		}
+	}
+	return t->size;
+}
+
+/**
+ * visit_key() - Visit the pairs of a key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each pair of key, or NULL.
+ *
+ * The run of pairs with key is found by binary search and walked from
+ * its end, so the latest duplicate comes first. Counted as a lookup by
+ * table_stats().
+ *
+ * Returns: The number of pairs of key.
+ */
+static unsigned long visit_key(const table *t, const void *key,
+			       inspect_callback_pair func)
+{
+	sort_pending(t);
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+	unsigned long n = 0;
+
+	for (int i = upper_bound(t, key) - 1; i >= 0; i--) {
+		void *k = array_1d_inspect_value(t->keys, i);
+		void *value = array_1d_inspect_value(t->values, i);
+		if (TABLE_KEY_CMP(t, k, key) != 0) {
+			break;
+		}
+		if (value == REMOVED) {
+			continue;
+		}
+		n++;
+		if (func != NULL) {
+			func(k, value);
+		}
+	}
+	TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, n > 0);
+	return n;
+}
+
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	// Allocate the table header.
+	table *t = calloc(1, sizeof(*t));
+	// Create the arrays holding keys and values.
+	t->keys = array_1d_create(0, INITIAL_CAPACITY - 1, NULL);
+	t->values = array_1d_create(0, INITIAL_CAPACITY - 1, NULL);
+	// Store the key compare function and key/value free functions.
+	t->key_cmp_func = key_cmp_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	TABLE_STATS_INIT(t);
+
+	return t;
+}
+
+/**
+ * table_empty_hashed() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the array is searched by binary search.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hashed(compare_function *key_cmp_func,
+			  hash_function *key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return table_empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+/**
+ * table_empty_ex() - Create an empty table with options.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: Ignored, the array is searched by binary search.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @flags: TABLE_UNIQUE_KEYS or 0.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_ex(compare_function *key_cmp_func,
+		      hash_function *key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	table *t = table_empty(key_cmp_func, key_free_func, value_free_func);
+
+	t->unique_keys = (flags & TABLE_UNIQUE_KEYS) != 0;
+	return t;
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @table: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == t->removed;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @table: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. No test is performed to
+ * check if key is a duplicate. table_lookup() will return the latest
+ * added value for a duplicate key. table_remove() will remove all
+ * duplicates for a given key.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	drop_eytzinger(t);
+	ensure_capacity(t, t->size + 1);
+
+	// Append to the unsorted tail.
+	array_1d_set_value(t->keys, key, t->size);
+	array_1d_set_value(t->values, value, t->size);
+	t->size++;
+	TABLE_STATS_INSERT(t, 0);
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @table: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table. If the table contains duplicate keys,
+ * the value that was latest inserted will be returned.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	if (t->eyt_keys != NULL) {
+		return eytzinger_lookup(t, key);
+	}
+
+	sort_pending(t);
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+
+	// The latest duplicate is the last pair of the run of equal keys.
+	// Duplicates are removed together, so if it is marked as removed
+	// the key is not in the table.
+	int i = upper_bound(t, key) - 1;
+	if (i < 0
+	    || TABLE_KEY_CMP(t, array_1d_inspect_value(t->keys, i), key) != 0) {
+		TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark, false);
+		return NULL;
+	}
+	void *value = array_1d_inspect_value(t->values, i);
+	TABLE_STATS_LOOKUP(t, TABLE_STATS_COMPARES(t) - mark,
+			   value != REMOVED);
+	if (value == REMOVED) {
+		return NULL;
+	}
+	return value;
+}
+
+/**
+ * table_lookup_all() - Visit all pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ * @func: Function called for each key/value pair with the key.
+ *
+ * The pairs are visited latest inserted first. Only the run of pairs
+ * with the key is examined after the binary search.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	visit_key(t, key, func);
+}
+
+/**
+ * table_count() - Count the pairs with a given key.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The number of pairs with the key, including duplicates.
+ */
+unsigned long table_count(const table *t, const void *key)
+{
+	return visit_key(t, key, NULL);
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	// Return the last key. Removing it does not move any other pair,
+	// and table_remove() never leaves a removed pair last.
+	sort_pending(t);
+	return array_1d_inspect_value(t->keys, t->size - 1);
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @table: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Any matching duplicates will be removed. Will call any free
+ * functions set for keys/values. Does nothing if key is not found in
+ * the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	merge_tail(t);
+
+	unsigned long mark = TABLE_STATS_COMPARES(t);
+	bool found = false;
+	for (int i = lower_bound(t, key); i < t->size; i++) {
+		void *k = array_1d_inspect_value(t->keys, i);
+		void *value = array_1d_inspect_value(t->values, i);
+		if (TABLE_KEY_CMP(t, k, key) != 0) {
+			break;
+		}
+		if (value == REMOVED) {
+			continue;
+		}
+		// Free the value now, the key is freed when the pair is
+		// dropped from the array.
+		if (t->value_free_func != NULL) {
+			t->value_free_func(value);
+		}
+		array_1d_set_value(t->values, REMOVED, i);
+		t->removed++;
+		found = true;
+		if (t->unique_keys) {
+			// There are no more matches.
+			break;
+		}
+	}
+	TABLE_STATS_REMOVE(t, TABLE_STATS_COMPARES(t) - mark);
+	if (!found) {
+		return;
+	}
+	drop_eytzinger(t);
+
+	// The key may point to the same memory as one of the keys freed
+	// below, but it is not used again.
+	trim_removed(t);
+	if (t->removed * 2 > t->size) {
+		compact(t);
+	}
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @table: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	// Frees the pairs replaced in a table with unique keys, once.
+	merge_tail(t);
+	for (int i = 0; i < t->size; i++) {
+		free_pair(t, i);
+	}
+	drop_eytzinger(t);
+	array_1d_kill(t->keys);
+	array_1d_kill(t->values);
+	TABLE_STATS_FREE(t);
+	free(t);
+}
+
+/**
+ * table_clear() - Remove all key/value pairs from a table.
+ * @t: Table to manipulate.
+ *
+ * Calls any free functions set for keys/values on all pairs. The
+ * table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_clear(table *t)
+{
+	empty_arrays(t, NULL);
+}
+
+/**
+ * table_drain() - Hand all key/value pairs to the caller.
+ * @t: Table to manipulate.
+ * @func: Function called once for each key/value pair in the table,
+ *	  including duplicates. Takes over the key and value.
+ *
+ * The table stays valid and empty.
+ *
+ * Returns: Nothing.
+ */
+void table_drain(table *t, consume_callback_pair func)
+{
+	empty_arrays(t, func);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table in key order and
+ * prints them. Will print all stored elements, including duplicates.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	sort_pending(t);
+	for (int i = 0; i < t->size; i++) {
+		void *value = array_1d_inspect_value(t->values, i);
+		if (value != REMOVED) {
+			print_func(array_1d_inspect_value(t->keys, i), value);
+		}
+	}
+}
+
+/**
+ * table_build_eytzinger() - Add a read-optimized copy of a table.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+void table_build_eytzinger(table *t)
+{
+	merge_tail(t);
+	drop_eytzinger(t);
+
+	// Keep only the latest pair of each run of equal keys, and only if
+	// that pair has not been removed.
+	struct table_entry *latest = malloc((t->size + 1) * sizeof(*latest));
+	int n = 0;
+	for (int i = 0; i < t->size; i++) {
+		void *key = array_1d_inspect_value(t->keys, i);
+		if (n > 0 && TABLE_KEY_CMP(t, latest[n - 1].key, key) == 0) {
+			n--;
+		}
+		latest[n].key = key;
+		latest[n].value = array_1d_inspect_value(t->values, i);
+		n++;
+	}
+	int live = 0;
+	for (int i = 0; i < n; i++) {
+		if (latest[i].value != REMOVED) {
+			latest[live++] = latest[i];
+		}
+	}
+	n = live;
+
+	t->eyt_size = n;
+	t->eyt_keys = malloc((n + 1) * sizeof(*t->eyt_keys));
+	t->eyt_values = malloc((n + 1) * sizeof(*t->eyt_values));
+	int next = 0;
+	eytzinger_fill(t, latest, &next, 1);
+
+	free(latest);
+}
+
+/**
+ * table_first() - Return the position of the smallest key in a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The first position in key order.
+ */
+table_pos table_first(const table *t)
+{
+	sort_pending(t);
+
+	table_pos pos = { NULL, visible_from(t, 0) };
+	return pos;
+}
+
+/**
+ * table_next() - Return the next position in key order.
+ * @t: Table to inspect.
+ * @pos: Any valid position except the end position.
+ *
+ * Returns: The position of the next larger key.
+ */
+table_pos table_next(const table *t, table_pos pos)
+{
+	pos.index = visible_from(t, pos.index + 1);
+	return pos;
+}
+
+/**
+ * table_is_end() - Check if a position is past the largest key.
+ * @t: Table to inspect.
+ * @pos: Any valid position.
+ *
+ * Returns: True if pos is the end position.
+ */
+bool table_is_end(const table *t, table_pos pos)
+{
+	return pos.index >= t->size;
+}
+
+/**
+ * table_inspect_key() - Return the key at a position.
+ * @t: Table to inspect.
+ * @pos: Any valid position except the end position.
+ *
+ * Returns: The key stored at pos.
+ */
+void *table_inspect_key(const table *t, table_pos pos)
+{
+	return array_1d_inspect_value(t->keys, pos.index);
+}
+
+/**
+ * table_inspect_value() - Return the value at a position.
+ * @t: Table to inspect.
+ * @pos: Any valid position except the end position.
+ *
+ * Returns: The latest value stored for the key at pos.
+ */
+void *table_inspect_value(const table *t, table_pos pos)
+{
+	return array_1d_inspect_value(t->values, pos.index);
+}
+
+/**
+ * table_first_ge() - Find the smallest key not less than a given key.
+ * @t: Table to inspect.
+ * @key: Key to compare with.
+ *
+ * Returns: The smallest stored key that is greater than or equal to
+ * key, or NULL if there is no such key.
+ */
+void *table_first_ge(const table *t, const void *key)
+{
+	sort_pending(t);
+
+	int i = visible_from(t, lower_bound(t, key));
+	if (i == t->size) {
+		return NULL;
+	}
+	return array_1d_inspect_value(t->keys, i);
+}
+
+/**
+ * table_range() - Visit the pairs with keys in a half-open range.
+ * @t: Table to inspect.
+ * @lo: Smallest key to visit, or NULL to start at the smallest key.
+ * @hi: Key to stop before, or NULL to continue to the largest key.
+ * @func: Function called for each key/value pair in the range.
+ *
+ * Returns: Nothing.
+ */
+void table_range(const table *t, const void *lo, const void *hi,
+		 inspect_callback_pair func)
+{
+	sort_pending(t);
+
+	int i = visible_from(t, lo != NULL ? lower_bound(t, lo) : 0);
+	while (i < t->size) {
+		void *key = array_1d_inspect_value(t->keys, i);
+		if (hi != NULL && TABLE_KEY_CMP(t, key, hi) >= 0) {
+			break;
+		}
+		func(key, array_1d_inspect_value(t->values, i));
+		i = visible_from(t, i + 1);
+	}
+}
+
+/**
+ * table_insert_many() - Add several key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n key pointers.
+ * @values: Array of n value pointers.
+ * @n: Number of pairs.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	drop_eytzinger(t);
+	ensure_capacity(t, t->size + n);
+
+	// Append all pairs to the unsorted tail.
+	for (int i = 0; i < n; i++) {
+		array_1d_set_value(t->keys, keys[i], t->size);
+		array_1d_set_value(t->values, values[i], t->size);
+		t->size++;
+		TABLE_STATS_INSERT(t, 0);
+	}
+}
+
+/**
+ * table_lookup_many() - Look up several keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the result of each lookup.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	if (t->eyt_keys == NULL) {
+		for (int i = 0; i < n; i++) {
+			values[i] = table_lookup(t, keys[i]);
+		}
+		return;
+	}
+	for (int first = 0; first < n; first += BATCH_SIZE) {
+		int m = n - first < BATCH_SIZE ? n - first : BATCH_SIZE;
+		eytzinger_lookup_batch(t, keys + first, values + first, m);
+	}
+}
+
+/**
+ * table_remove_many() - Remove several keys from a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n keys to remove.
+ * @n: Number of keys.
+ *
+ * Returns: Nothing.
+ */
+void table_remove_many(table *t, void **keys, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_remove(t, keys[i]);
+	}
+}
+
+/**
+ * table_stats() - Get statistics of the operations on a table.
+ * @t: Table to inspect.
+ * @out: Set to the statistics since the table was created.
+ *
+ * The probe length of a lookup or remove is the number of keys it
+ * compared, not counting the compares made when sorting the unsorted
+ * tail, which are only included in the total number of compares.
+ * Inserts are appended to the tail and have probe length 0. A lookup
+ * in the Eytzinger copy by table_lookup_many() has the probe length
+ * of the same lookup by table_lookup().
+ *
+ * Returns: Nothing.
+ */
+void table_stats(const table *t, table_statistics *out)
+{
+	TABLE_STATS_GET(t, out);
+}
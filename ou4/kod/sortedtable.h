@@ -0,0 +1,32 @@
+#ifndef SORTEDTABLE_H
+#define SORTEDTABLE_H
+
+#include "table.h"
+
+/*
+ * Extra operations for the sorted array implementation of table.h in
+ * sortedtable.c. The table keeps its pairs ordered by key_cmp_func,
+ * so the comparison function must define a total order, not only
+ * equality.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-17: v1.0, first version.
+ */
+
+/**
+ * table_build_eytzinger() - Add a read-optimized copy of a table.
+ * @t: Table to manipulate.
+ *
+ * Stores the latest value of each distinct key in Eytzinger (BFS)
+ * order, which table_lookup() then searches without data dependent
+ * branches and with the next levels prefetched. The copy is dropped
+ * by the next table_insert() or table_remove(), so call this once the
+ * table has been filled.
+ *
+ * Returns: Nothing.
+ */
+void table_build_eytzinger(table *t);
+
+#endif
@@ -0,0 +1,235 @@
+/*
+ * sortedtest - test the Eytzinger copy of the sorted array table.
+ *
+ * Should be compiled together with sortedtable.c.
+ *
+ * Usage: sortedtest [n]
+ *
+ * Tests that table_lookup() and table_lookup_many() give the same
+ * results after table_build_eytzinger() as before it, for tables of
+ * a few sizes up to n int keys. Some keys are inserted twice, some are
+ * removed and some are never inserted. The tables are then changed
+ * after the copy is built, which must drop it. Every test is run on a
+ * table that keeps duplicates and on one created with
+ * TABLE_UNIQUE_KEYS.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "table.h"
+#include "sortedtable.h"
+
+// Default number of keys
+#define DEFAULT_SIZE 10000
+// Largest number of keys given to one call to table_lookup_many(),
+// one more than the batch of the Eytzinger search
+#define MAX_BATCH 17
+
+/**
+ * int_ptr_from_int() - Create a dynamic copy of an int.
+ * @i: Value to copy.
+ *
+ * Returns: Pointer to the copy of i.
+ */
+int *int_ptr_from_int(int i)
+{
+        int *ip = malloc(sizeof(int));
+        *ip = i;
+        return ip;
+}
+
+int int_compare(const void *ip1,const void *ip2)
+{
+        const int *n1=ip1;
+        const int *n2=ip2;
+        return (*n1 > *n2) - (*n1 < *n2);
+}
+
+/**
+ * expected_value() - Return the value a key should have.
+ * @key: Key to look up.
+ * @n: Number of keys inserted by build_table().
+ * @removed: Key removed after the table was built, or -1.
+ *
+ * Returns: The value, or -1 if the key should be missing.
+ */
+int expected_value(int key, int n, int removed)
+{
+        if (key < 0 || key >= 2*n || key % 2 != 0 || key % 10 == 0 ||
+            key == removed) {
+                return -1;
+        }
+        return 3*key;
+}
+
+/**
+ * build_table() - Create a table with the even keys below 2n.
+ * @n: Number of keys.
+ * @flags: Flags of table_empty_ex().
+ *
+ * The keys are inserted from both ends in turn towards the middle, so
+ * that they are not already sorted. Every third key is first
+ * inserted with the value -1 and then again with its final value 3*key.
+ * Every key divisible by 10 is removed after all inserts.
+ *
+ * Returns: The table.
+ */
+table *build_table(int n, unsigned int flags)
+{
+        table *t = table_empty_ex(int_compare, NULL, free, free, flags);
+        for (int i = 0; i < n; i++) {
+                int key = 2*(i % 2 == 0 ? i/2 : n - 1 - i/2);
+                if (key % 3 == 0) {
+                        table_insert(t, int_ptr_from_int(key),
+                                     int_ptr_from_int(-1));
+                }
+                table_insert(t, int_ptr_from_int(key),
+                             int_ptr_from_int(3*key));
+        }
+        for (int key = 0; key < 2*n; key += 10) {
+                table_remove(t, &key);
+        }
+        return t;
+}
+
+/**
+ * check_value() - Check the value found for a key.
+ * @v: Value found, or NULL.
+ * @key: Key that was looked up.
+ * @n: Number of keys inserted by build_table().
+ * @removed: Key removed after the table was built, or -1.
+ * @name: Name of the test.
+ *
+ * Exits the program if the value is not the expected one.
+ *
+ * Returns: Nothing.
+ */
+void check_value(const int *v, int key, int n, int removed,
+                 const char *name)
+{
+        int expected = expected_value(key, n, removed);
+
+        if (expected == -1 && v != NULL) {
+                fprintf(stderr, "FAIL: %s, n=%d, found missing key %d.\n",
+                        name, n, key);
+                exit(EXIT_FAILURE);
+        }
+        if (expected != -1 && (v == NULL || *v != expected)) {
+                fprintf(stderr, "FAIL: %s, n=%d, lost key %d.\n", name, n,
+                        key);
+                exit(EXIT_FAILURE);
+        }
+}
+
+/**
+ * check_lookups() - Look up every key with table_lookup() and in
+ * batches of 1 to MAX_BATCH keys with table_lookup_many().
+ * @t: Table built by build_table().
+ * @n: Number of keys inserted by build_table().
+ * @removed: Key removed after the table was built, or -1.
+ * @name: Name of the test.
+ *
+ * The keys looked up go from below the smallest key to above the
+ * largest, so the keys at both ends and missing keys between them are
+ * included. Exits the program if any lookup gives the wrong value.
+ *
+ * Returns: Nothing.
+ */
+void check_lookups(const table *t, int n, int removed, const char *name)
+{
+        int keys[MAX_BATCH];
+        void *key_ptrs[MAX_BATCH];
+        void *values[MAX_BATCH];
+        int batch = 1;
+
+        for (int key = -2; key <= 2*n + 1; key++) {
+                check_value(table_lookup(t, &key), key, n, removed, name);
+        }
+        for (int first = -2; first <= 2*n + 1; first += batch) {
+                batch = batch % MAX_BATCH + 1;
+                int m = 0;
+                while (m < batch && first + m <= 2*n + 1) {
+                        keys[m] = first + m;
+                        key_ptrs[m] = &keys[m];
+                        m++;
+                }
+                table_lookup_many(t, key_ptrs, values, m);
+                for (int i = 0; i < m; i++) {
+                        check_value(values[i], keys[i], n, removed, name);
+                }
+        }
+}
+
+/**
+ * test_size() - Run all tests on tables with a number of keys.
+ * @n: Number of keys.
+ * @flags: Flags of table_empty_ex().
+ *
+ * Returns: Nothing.
+ */
+void test_size(int n, unsigned int flags)
+{
+        table *t = build_table(n, flags);
+        int removed = -1;
+
+        check_lookups(t, n, removed, "Before building");
+        table_build_eytzinger(t);
+        check_lookups(t, n, removed, "Eytzinger copy");
+
+        // An insert must drop the copy, so the new key is found
+        table_insert(t, int_ptr_from_int(2*n + 1), int_ptr_from_int(0));
+        int key = 2*n + 1;
+        const int *v = table_lookup(t, &key);
+        if (v == NULL || *v != 0) {
+                fprintf(stderr, "FAIL: n=%d, key inserted after building "
+                        "not found.\n", n);
+                exit(EXIT_FAILURE);
+        }
+        table_remove(t, &key);
+
+        // So must a remove, after which the copy can be built again
+        table_build_eytzinger(t);
+        removed = 2*(n/2);
+        if (removed % 10 == 0) {
+                removed += 2;
+        }
+        if (removed < 2*n) {
+                table_remove(t, &removed);
+        } else {
+                removed = -1;
+        }
+        check_lookups(t, n, removed, "After remove");
+        table_build_eytzinger(t);
+        check_lookups(t, n, removed, "Rebuilt Eytzinger copy");
+        table_kill(t);
+}
+
+int main(int argc, char **argv)
+{
+        int sizes[] = { 0, 1, 2, 3, 15, 16, 17, 100, DEFAULT_SIZE };
+        int n_sizes = sizeof(sizes)/sizeof(sizes[0]);
+
+        if (argc > 1) {
+                sizes[n_sizes - 1] = atoi(argv[1]);
+        }
+        if (sizes[n_sizes - 1] < 0) {
+                fprintf(stderr, "Usage: %s [n]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+
+        for (int i = 0; i < n_sizes; i++) {
+                test_size(sizes[i], 0);
+        }
+        printf("Lookups with duplicates: OK.\n");
+        for (int i = 0; i < n_sizes; i++) {
+                test_size(sizes[i], TABLE_UNIQUE_KEYS);
+        }
+        printf("Lookups with TABLE_UNIQUE_KEYS: OK.\n");
+        return 0;
+}
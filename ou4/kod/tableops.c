@@ -0,0 +1,228 @@
+#include <string.h>
+
+#include "tableops.h"
+
+/*
+ * Registry of the implementations of table.h linked into a program,
+ * and an implementation of table.h that forwards each call to the
+ * selected one. See tableops.h for how the implementations are
+ * compiled.
+ *
+ * Every implementation in the registry must be linked in. A new
+ * implementation is added to the list below and to makebench.sh.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+// ===========INTERNAL DATA TYPES============
+
+extern const struct table_ops table_table_ops;
+extern const struct table_ops dlist_table_ops;
+extern const struct table_ops array_table_ops;
+extern const struct table_ops mtf_table_ops;
+extern const struct table_ops hash_table_ops;
+extern const struct table_ops sorted_table_ops;
+extern const struct table_ops btree_table_ops;
+extern const struct table_ops intarray_table_ops;
+extern const struct table_ops concurrent_table_ops;
+extern const struct table_ops lru_table_ops;
+extern const struct table_ops radix_table_ops;
+extern const struct table_ops bitmap_table_ops;
+extern const struct table_ops adaptive_table_ops;
+extern const struct table_ops bloom_table_ops;
+
+static const struct table_impl impls[] = {
+	{ "table", &table_table_ops, 0 },
+	{ "dlist", &dlist_table_ops, 0 },
+	{ "array", &array_table_ops, 0 },
+	{ "mtf", &mtf_table_ops, 0 },
+	{ "hash", &hash_table_ops, 0 },
+	{ "sorted", &sorted_table_ops, 0 },
+	{ "btree", &btree_table_ops, 0 },
+	{ "intarray", &intarray_table_ops, TABLE_IMPL_INT_KEYS },
+	{ "concurrent", &concurrent_table_ops, TABLE_IMPL_THREAD_SAFE },
+	{ "lru", &lru_table_ops, 0 },
+	{ "radix", &radix_table_ops, TABLE_IMPL_STRING_KEYS },
+	{ "bitmap", &bitmap_table_ops, TABLE_IMPL_INT_KEYS },
+	{ "adaptive", &adaptive_table_ops, 0 },
+	{ "bloom", &bloom_table_ops, 0 },
+};
+
+#define N_IMPLS ((int)(sizeof(impls) / sizeof(impls[0])))
+
+// The selected implementation and its functions.
+static const struct table_impl *selected = &impls[0];
+static const struct table_ops *ops = &table_table_ops;
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_impl_count() - Get the number of registered implementations.
+ *
+ * Returns: The number of implementations.
+ */
+int table_impl_count(void)
+{
+	return N_IMPLS;
+}
+
+/**
+ * table_impl_get() - Get a registered implementation.
+ * @i: Index of the implementation, from 0 to table_impl_count()-1.
+ *
+ * Returns: The implementation.
+ */
+const struct table_impl *table_impl_get(int i)
+{
+	return &impls[i];
+}
+
+/**
+ * table_impl_find() - Find a registered implementation by name.
+ * @name: Name of the implementation.
+ *
+ * Returns: The implementation, or NULL if no implementation has the
+ * name.
+ */
+const struct table_impl *table_impl_find(const char *name)
+{
+	for (int i = 0; i < N_IMPLS; i++) {
+		if (strcmp(impls[i].name, name) == 0) {
+			return &impls[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * table_impl_select() - Select the implementation of table.h.
+ * @impl: Implementation that the table_xxx() functions call from now
+ *	  on.
+ *
+ * Returns: Nothing.
+ */
+void table_impl_select(const struct table_impl *impl)
+{
+	selected = impl;
+	ops = impl->ops;
+}
+
+/**
+ * table_impl_selected() - Get the selected implementation.
+ *
+ * Returns: The implementation that the table_xxx() functions call.
+ */
+const struct table_impl *table_impl_selected(void)
+{
+	return selected;
+}
+
+/*
+ * The functions of table.h. Each one calls its counterpart in the
+ * selected implementation, see table.h for their descriptions.
+ */
+
+table *table_empty(compare_function key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return ops->empty(key_cmp_func, key_free_func, value_free_func);
+}
+
+table *table_empty_hashed(compare_function key_cmp_func,
+			  hash_function key_hash_func,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	return ops->empty_hashed(key_cmp_func, key_hash_func, key_free_func,
+				 value_free_func);
+}
+
+table *table_empty_ex(compare_function key_cmp_func,
+		      hash_function key_hash_func,
+		      free_function key_free_func,
+		      free_function value_free_func,
+		      unsigned int flags)
+{
+	return ops->empty_ex(key_cmp_func, key_hash_func, key_free_func,
+			     value_free_func, flags);
+}
+
+bool table_is_empty(const table *t)
+{
+	return ops->is_empty(t);
+}
+
+void table_insert(table *t, void *key, void *value)
+{
+	ops->insert(t, key, value);
+}
+
+void *table_lookup(const table *t, const void *key)
+{
+	return ops->lookup(t, key);
+}
+
+void table_lookup_all(const table *t, const void *key,
+		      inspect_callback_pair func)
+{
+	ops->lookup_all(t, key, func);
+}
+
+unsigned long table_count(const table *t, const void *key)
+{
+	return ops->count(t, key);
+}
+
+void *table_choose_key(const table *t)
+{
+	return ops->choose_key(t);
+}
+
+void table_remove(table *t, const void *key)
+{
+	ops->remove(t, key);
+}
+
+void table_kill(table *t)
+{
+	ops->kill(t);
+}
+
+void table_clear(table *t)
+{
+	ops->clear(t);
+}
+
+void table_drain(table *t, consume_callback_pair func)
+{
+	ops->drain(t, func);
+}
+
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	ops->print(t, print_func);
+}
+
+void table_insert_many(table *t, void **keys, void **values, int n)
+{
+	ops->insert_many(t, keys, values, n);
+}
+
+void table_lookup_many(const table *t, void **keys, void **values, int n)
+{
+	ops->lookup_many(t, keys, values, n);
+}
+
+void table_remove_many(table *t, void **keys, int n)
+{
+	ops->remove_many(t, keys, n);
+}
+
+void table_stats(const table *t, table_statistics *out)
+{
+	ops->stats(t, out);
+}
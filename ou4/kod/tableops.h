@@ -0,0 +1,181 @@
+#ifndef TABLEOPS_H
+#define TABLEOPS_H
+
+/*
+ * Runtime selection of an implementation of table.h.
+ *
+ * Since table.h binds at link time, each implementation is compiled
+ * separately with TABLE_OPS_PREFIX set to its name and this header
+ * forced in front of it, e.g.
+ *
+ *	gcc -c -DTABLE_OPS_PREFIX=mtf -include tableops.h mtftable.c
+ *
+ * which renames every table_xxx() function of table.h, and the extra
+ * functions that more than one implementation defines, to
+ * mtf_table_xxx(). It also defines mtf_table_ops, a struct table_ops
+ * that points to them. Any number of implementations can then be
+ * linked into one program together with tableops.c, which keeps a
+ * registry of them and itself implements table.h by forwarding each
+ * call to the selected one.
+ *
+ * All implementations share the opaque table type. A table must only
+ * be used while the implementation it was created by is selected.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ */
+
+#ifdef TABLE_OPS_PREFIX
+
+#define TABLE_OPS_PASTE2(prefix, name) prefix##_##name
+#define TABLE_OPS_PASTE(prefix, name) TABLE_OPS_PASTE2(prefix, name)
+#define TABLE_OPS_RENAME(name) TABLE_OPS_PASTE(TABLE_OPS_PREFIX, name)
+
+#define table_empty TABLE_OPS_RENAME(table_empty)
+#define table_empty_hashed TABLE_OPS_RENAME(table_empty_hashed)
+#define table_empty_ex TABLE_OPS_RENAME(table_empty_ex)
+#define table_is_empty TABLE_OPS_RENAME(table_is_empty)
+#define table_insert TABLE_OPS_RENAME(table_insert)
+#define table_lookup TABLE_OPS_RENAME(table_lookup)
+#define table_lookup_all TABLE_OPS_RENAME(table_lookup_all)
+#define table_count TABLE_OPS_RENAME(table_count)
+#define table_choose_key TABLE_OPS_RENAME(table_choose_key)
+#define table_remove TABLE_OPS_RENAME(table_remove)
+#define table_kill TABLE_OPS_RENAME(table_kill)
+#define table_clear TABLE_OPS_RENAME(table_clear)
+#define table_drain TABLE_OPS_RENAME(table_drain)
+#define table_print TABLE_OPS_RENAME(table_print)
+#define table_insert_many TABLE_OPS_RENAME(table_insert_many)
+#define table_lookup_many TABLE_OPS_RENAME(table_lookup_many)
+#define table_remove_many TABLE_OPS_RENAME(table_remove_many)
+#define table_stats TABLE_OPS_RENAME(table_stats)
+
+// Extra functions that several implementations define.
+#define table_first TABLE_OPS_RENAME(table_first)
+#define table_next TABLE_OPS_RENAME(table_next)
+#define table_is_end TABLE_OPS_RENAME(table_is_end)
+#define table_inspect_key TABLE_OPS_RENAME(table_inspect_key)
+#define table_inspect_value TABLE_OPS_RENAME(table_inspect_value)
+#define table_first_ge TABLE_OPS_RENAME(table_first_ge)
+#define table_range TABLE_OPS_RENAME(table_range)
+#define table_empty_policy TABLE_OPS_RENAME(table_empty_policy)
+
+#endif
+
+#include "table.h"
+
+// ==========PUBLIC DATA TYPES============
+
+// The keys of the implementation must be pointers to ints.
+#define TABLE_IMPL_INT_KEYS 0x1
+
+// The keys of the implementation must be strings.
+#define TABLE_IMPL_STRING_KEYS 0x2
+
+// Tables of the implementation may be shared by threads without a
+// lock.
+#define TABLE_IMPL_THREAD_SAFE 0x4
+
+// The functions of one implementation of table.h.
+struct table_ops {
+	table *(*empty)(compare_function key_cmp_func,
+			free_function key_free_func,
+			free_function value_free_func);
+	table *(*empty_hashed)(compare_function key_cmp_func,
+			       hash_function key_hash_func,
+			       free_function key_free_func,
+			       free_function value_free_func);
+	table *(*empty_ex)(compare_function key_cmp_func,
+			   hash_function key_hash_func,
+			   free_function key_free_func,
+			   free_function value_free_func,
+			   unsigned int flags);
+	bool (*is_empty)(const table *t);
+	void (*insert)(table *t, void *key, void *value);
+	void *(*lookup)(const table *t, const void *key);
+	void (*lookup_all)(const table *t, const void *key,
+			   inspect_callback_pair func);
+	unsigned long (*count)(const table *t, const void *key);
+	void *(*choose_key)(const table *t);
+	void (*remove)(table *t, const void *key);
+	void (*kill)(table *t);
+	void (*clear)(table *t);
+	void (*drain)(table *t, consume_callback_pair func);
+	void (*print)(const table *t, inspect_callback_pair print_func);
+	void (*insert_many)(table *t, void **keys, void **values, int n);
+	void (*lookup_many)(const table *t, void **keys, void **values,
+			    int n);
+	void (*remove_many)(table *t, void **keys, int n);
+	void (*stats)(const table *t, table_statistics *out);
+};
+
+// A registered implementation.
+struct table_impl {
+	// Name used to select the implementation, e.g. "mtf".
+	const char *name;
+	const struct table_ops *ops;
+	// TABLE_IMPL_xxx flags, or 0.
+	unsigned int flags;
+};
+
+#ifdef TABLE_OPS_PREFIX
+
+const struct table_ops TABLE_OPS_RENAME(table_ops) = {
+	table_empty, table_empty_hashed, table_empty_ex, table_is_empty,
+	table_insert, table_lookup, table_lookup_all, table_count,
+	table_choose_key, table_remove, table_kill, table_clear,
+	table_drain, table_print, table_insert_many, table_lookup_many,
+	table_remove_many, table_stats
+};
+
+#else
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_impl_count() - Get the number of registered implementations.
+ *
+ * Returns: The number of implementations.
+ */
+int table_impl_count(void);
+
+/**
+ * table_impl_get() - Get a registered implementation.
+ * @i: Index of the implementation, from 0 to table_impl_count()-1.
+ *
+ * Returns: The implementation.
+ */
+const struct table_impl *table_impl_get(int i);
+
+/**
+ * table_impl_find() - Find a registered implementation by name.
+ * @name: Name of the implementation.
+ *
+ * Returns: The implementation, or NULL if no implementation has the
+ * name.
+ */
+const struct table_impl *table_impl_find(const char *name);
+
+/**
+ * table_impl_select() - Select the implementation of table.h.
+ * @impl: Implementation that the table_xxx() functions call from now
+ *	  on.
+ *
+ * The first registered implementation is selected from the start.
+ *
+ * Returns: Nothing.
+ */
+void table_impl_select(const struct table_impl *impl);
+
+/**
+ * table_impl_selected() - Get the selected implementation.
+ *
+ * Returns: The implementation that the table_xxx() functions call.
+ */
+const struct table_impl *table_impl_selected(void);
+
+#endif
+
+#endif
@@ -29,10 +29,53 @@
  *                 Bugfix in get_skewed_lookup_speed.
  * 2019-02-12 v1.8 Reverted back to single-parameter version v1.6.
  * 2019-04-17 v1.9 Added -m for machine-readable results.
+ * 2026-10-17 v1.10 Tables are created with table_empty_hashed() so that
+ *                 hashed implementations can be tested.
+ * 2026-10-17 v1.11 Added test of the batched operations and -b to time
+ *                 lookups done with table_lookup_many().
+ * 2026-10-17 v1.12 Added -j to measure the throughput of a table shared
+ *                 by 1 up to a given number of threads.
+ * 2026-10-17 v1.13 Added test of table_stats() and -s to print the
+ *                 statistics of each timed table.
+ * 2026-10-17 v1.14 Added test of tables created with TABLE_UNIQUE_KEYS.
+ * 2026-10-17 v1.15 Added -c to skip the timings, which use int keys, for
+ *                 tables that only take string keys.
+ * 2026-10-17 v1.16 Added test of table_drain() and table_clear().
+ * 2026-10-17 v1.17 Added test of table_lookup_all() and table_count().
+ * 2026-10-18 v1.18 Timings use a monotonic clock in nanoseconds. Added -w
+ *                 and -r to run warm-up and repeated trials, -l for
+ *                 latency histograms and -J for JSON output. -t now
+ *                 outputs CSV with min/median/p99/stddev per phase.
+ * 2026-10-18 v1.19 Added --impl to test several implementations in one
+ *                 program built with makebench.sh, see tableops.h.
+ * 2026-10-18 v1.20 Random numbers come from the seeded generator of
+ *                 workload.h and shuffles are unbiased. Added --ycsb,
+ *                 --dist, --mix and --trace to time a workload of mixed
+ *                 operations instead of the phases, and --seed.
+ * 2026-10-18 v1.21 Removed the limit of 40000 items. Keys are computed
+ *                 on demand instead of kept in arrays for large n.
+ *                 Added -M to print the memory used by each phase, and
+ *                 memory columns to the CSV and JSON output.
+ * 2026-10-18 v1.22 Added --sweep and --runs to time a range of n in one
+ *                 process and print the mean and 95% confidence
+ *                 interval of repeated runs as CSV or JSON.
+ * 2026-10-18 v1.23 Added -e to time the lookups of sortedtable.c in its
+ *                 Eytzinger copy.
+ * 2026-10-18 v1.24 The test of the batched operations also looks up
+ *                 the keys in the Eytzinger copy of sortedtable.c.
+ * 2026-10-18 v1.25 Added test of duplicates in tables that reorder
+ *                 their pairs on lookup.
+ * 2026-10-18 v1.26 -s prints the false positive rates of bloomtable.c.
+ *                 Added test of the rates after its filter is rebuilt.
+ * 2026-10-18 v1.27 The test of unique keys inserts the same pair twice
+ *                 and drains and kills tables with replaced pairs.
+ * 2026-10-18 v1.28 The critical values of Student's t distribution
+ *                 above 30 degrees of freedom use three terms of the
+ *                 Cornish-Fisher expansion instead of one.
 */
 
-#define VERSION "v1.9"
-#define VERSION_DATE "2019-04-17"
+#define VERSION "v1.28"
+#define VERSION_DATE "2026-10-18"
 
 /*
  * Correctness testing algorithm:
@@ -61,19 +104,338 @@
  *    that it is gone and that the other key returns the cocorrect
  *    value. The second key is removed and it is checked that the
  *    table is empty.
+ * 9. Tests the batched operations by inserting four key-value-pairs,
+ *    two of them with the same key, with one call. All keys and a
+ *    missing key are then looked up with one call, after which the
+ *    keys are removed with one call and it is checked that the table
+ *    is empty. In programs built with -DEYTZINGER_TABLE, the keys are
+ *    also looked up in the Eytzinger copy of sortedtable.c.
+ * 10. Tests table_stats() by inserting three key-value-pairs, looking
+ *    up two of them and a missing key, and removing one of them. It is
+ *    checked that the operations are counted, unless the table is
+ *    compiled without statistics.
+ * 11. Tests a table created with TABLE_UNIQUE_KEYS by inserting two
+ *    keys twice each. It is checked that lookups return the latest
+ *    values and that the table holds two pairs. The keys are then
+ *    removed, one with table_remove() and one with
+ *    table_remove_many(), and it is checked that the table is empty.
+ *    Finally the same key and value are inserted twice and another key
+ *    is replaced. It is checked that table_drain() hands over only the
+ *    latest pairs, and the same is then inserted and the table killed,
+ *    which must free every pair once.
+ * 12. Tests table_drain() and table_clear() by inserting three
+ *    key-value-pairs and draining them. It is checked that every pair
+ *    is handed over once and that the table is empty. A pair is then
+ *    inserted and looked up, after which the table is cleared and it
+ *    is checked that it is empty.
+ * 13. Tests table_lookup_all() and table_count() by inserting three
+ *    key-value-pairs, two of them with the same key. It is checked
+ *    that the values of the duplicate key are visited latest inserted
+ *    first and that the counts match. Implementations that replace
+ *    duplicates may hold a single pair for the key.
+ * 14. Tests that lookups that reorder a table, such as those of
+ *    mtftable.c with each of its policies, keep the latest value of a
+ *    duplicate key. Three keys are inserted and looked up repeatedly,
+ *    two of them are inserted again and every key is looked up in turn
+ *    several times, checking the latest values. The keys are then
+ *    removed one at a time, checking that the others are left and
+ *    that the table ends up empty.
+ * 15. Tests the false positive rate of the filter of bloomtable.c, in
+ *    programs built with -DBLOOM_TABLE. Missing keys are looked up in
+ *    a filled table, and again after most keys have been removed so
+ *    that the filter is rebuilt. Each time the rate observed must stay
+ *    within a few times the estimated rate, and the rebuild must lower
+ *    the estimate.
  *
  * There is also a module measuring time for insertions, lookups etc.
+ * Each phase is run on a new table for a number of untimed warm-up
+ * trials and then for a number of timed trials, measured with
+ * CLOCK_MONOTONIC in nanoseconds. The min, median, 99th percentile and
+ * standard deviation of the trials are printed, as text, CSV or JSON.
+ *
+ * With -j, the module instead measures how many operations per second
+ * a table shared by several threads manages. Unless the program is
+ * compiled with -DTHREAD_SAFE_TABLE, which should only be done for
+ * thread-safe implementations such as concurrenttable.c, every call to
+ * the table is protected by a single global lock.
+ *
+ * With -e, the lookup phases search the Eytzinger copy that
+ * table_build_eytzinger() of sortedtable.c adds once the table is
+ * filled. The copy is built before the timing. This needs a program
+ * compiled with -DEYTZINGER_TABLE and sortedtable.c, as makesorted.sh
+ * does.
+ *
+ * A program built with makebench.sh holds every implementation, see
+ * tableops.h. The tests and timings are then run for each
+ * implementation chosen with --impl, and each timed phase is run for
+ * all of them in turn on the same keys with the same random numbers.
+ *
+ * With --ycsb, --dist, --mix or --trace, a single workload phase is
+ * timed instead, see workload.h. The table is created with
+ * TABLE_UNIQUE_KEYS and filled with n items, after which n operations
+ * generated from a mix of reads, updates, inserts, scans and
+ * read-modify-writes on records chosen from a distribution are
+ * replayed. The operations are generated before the timing. A trace
+ * is replayed on a table filled with every key of the trace that is
+ * used before it is inserted. All random numbers, including those of
+ * the phases, come from a generator seeded with --seed.
+ *
+ * The keys of the timings are a random permutation of 0 to 2n-1. Up to
+ * MAX_KEY_ARRAY keys are shuffled into an array. Larger sets of keys
+ * are computed on demand by a mixing function, so that n can be in the
+ * tens of millions without arrays of keys taking up memory.
+ *
+ * The memory of each phase is measured on its last trial: the peak
+ * resident set size of the process and, if the program is built with
+ * -DALLOC_STATS and linked with the --wrap option of ld for malloc,
+ * calloc, realloc, posix_memalign and free as done by makebench.sh,
+ * the number of allocations and bytes allocated by the timed
+ * operations and the bytes held by the table when it holds its items.
+ * The bytes per entry are those of the table besides the ints
+ * allocated for the key and value of each item.
+ *
+ * With --sweep, the timings are run for every n from start to stop in
+ * steps, each a number of times given with --runs, in one process.
+ * Every run uses new keys. The time of a run is the median of its
+ * trials, and for each implementation, phase and n the mean of the
+ * runs is printed together with its standard deviation and 95%
+ * confidence interval from Student's t distribution, one row per
+ * line of CSV, so that the result can be plotted as it is.
  * */
+#define _POSIX_C_SOURCE 200112L
+
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/time.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef ALLOC_STATS
+#include <malloc.h>
+#endif
 #include "table.h"
-
-// Maximum size of the table to generate
-#define TABLESIZE 40000
-#define SAMPLESIZE TABLESIZE*2
+#include "workload.h"
+#ifdef TABLE_OPS
+#include "tableops.h"
+#endif
+#ifdef BLOOM_TABLE
+#ifdef TABLE_OPS
+#error "BLOOM_TABLE needs a program linked with bloomtable.c only"
+#endif
+#include "bloomtable.h"
+#endif
+#ifdef EYTZINGER_TABLE
+#ifdef TABLE_OPS
+#error "EYTZINGER_TABLE needs a program linked with sortedtable.c only"
+#endif
+#include "sortedtable.h"
+#endif
+
+// Largest set of keys that is kept in an array. Larger sets are
+// computed on demand.
+#ifndef MAX_KEY_ARRAY
+#define MAX_KEY_ARRAY (1 << 22)
+#endif
+// Number of keys per call to table_lookup_many() when using -b
+#define LOOKUP_BATCH 64
+// Number of keys, and of missing keys looked up, in the test of the
+// filter of bloomtable.c
+#define BLOOM_TEST_KEYS 2000
+#define BLOOM_TEST_LOOKUPS 20000
+// Maximum number of threads when using -j
+#define MAX_THREADS 64
+#ifdef TABLE_OPS
+// Implementations to test, chosen with --impl
+const struct table_impl **impls;
+int n_impls;
+#endif
+
+// Random numbers of the tests, seeded with --seed
+workload_rng rng;
+
+// Number of buckets in the latency histograms of -l. Bucket b holds
+// latencies from 2^(b-1) to 2^b - 1 ns, bucket 0 latencies of 0 ns.
+#define LATENCY_BUCKETS 40
+
+/* Timed phases, numbered as in the test column of the machine-readable
+ * output.
+ */
+enum phase {
+        PHASE_INSERT = 1,
+        PHASE_REMOVE,
+        PHASE_MISSING_LOOKUP,
+        PHASE_RANDOM_LOOKUP,
+        PHASE_SKEWED_LOOKUP,
+        PHASE_THREADS,
+        PHASE_WORKLOAD
+};
+
+// Names of the phases in the machine-readable output
+const char *phase_names[] = { NULL, "insert", "remove", "lookup_missing",
+                              "lookup_random", "lookup_skewed", "threads",
+                              "workload" };
+
+// Labels of the phases in the human-readable output, given n
+const char *phase_labels[] = {
+        NULL,
+        "Insert %5d items                   : ",
+        "Remove all items                     : ",
+        "%5d lookups with non-existent keys : ",
+        "%5d random lookups                 : ",
+        "%5d skewed lookups                 : ",
+        NULL,
+        "%5d workload operations            : "
+};
+
+/* How to print the timings. */
+enum output_format {
+        OUTPUT_TEXT,
+        OUTPUT_CSV,
+        OUTPUT_JSON
+};
+
+/* Settings of the timings.
+ *    warmups - the number of untimed trials before the measured ones
+ *    trials - the number of measured trials of each phase
+ *    latency - true if the latency of each table call is recorded
+ *    batch_lookups - true if lookups are done with table_lookup_many()
+ *    show_stats - true if table_stats() is printed after each phase
+ *    show_memory - true if the memory of each phase is printed
+ *    eytzinger - true if lookups search the Eytzinger copy of the table
+ *    format - how to print the results
+ *    workload - true if the workload phase is timed instead of the others
+ *    config - the settings of a generated workload
+ *    trace - the file of a workload to replay, or NULL to generate one
+ *    sweep_start, sweep_stop, sweep_step - the values of n of a sweep,
+ *                                          or 0 if there is no sweep
+ *    runs - the number of runs at each n of a sweep
+ */
+struct timing_options {
+        int warmups;
+        int trials;
+        bool latency;
+        bool batch_lookups;
+        bool show_stats;
+        bool show_memory;
+        bool eytzinger;
+        enum output_format format;
+        bool workload;
+        workload_config config;
+        const char *trace;
+        int sweep_start;
+        int sweep_stop;
+        int sweep_step;
+        int runs;
+};
+
+/* A sequence of distinct int keys, either kept in an array or
+ * computed on demand as a random permutation of 0 to size-1.
+ *    size - the number of keys
+ *    keys - the keys, or NULL if they are computed
+ *    mask - one less than the smallest power of two that is at least
+ *           size, which the permutation mixes the keys below
+ *    shift - the shift of the xorshift steps of the permutation
+ *    mult - odd multipliers of the steps of the permutation
+ *    add - constants added in the steps of the permutation
+ */
+struct key_set {
+        int size;
+        int *keys;
+        uint64_t mask;
+        int shift;
+        uint64_t mult[3];
+        uint64_t add[3];
+};
+
+/* Operations of the workload phase and the items they work on.
+ *    ops - the operations, replayed in order
+ *    n_ops - the number of operations
+ *    items - the keys inserted before the operations
+ *    n_items - the number of keys in items
+ *    records - the keys of the records that scans may cover, or NULL
+ *              if there are no records
+ *    max_scan - the largest number of records of a scan
+ *    trace_items - the items of a trace, which items points to
+ */
+struct workload {
+        workload_op *ops;
+        int n_ops;
+        const struct key_set *items;
+        int n_items;
+        const struct key_set *records;
+        int max_scan;
+        struct key_set trace_items;
+};
+
+/* Keys collected for one call to table_lookup_many().
+ *    keys - pointers to the collected keys
+ *    ints - the collected keys, which keys point to
+ *    count - the number of collected keys
+ */
+struct key_batch {
+        void *keys[LOOKUP_BATCH];
+        int ints[LOOKUP_BATCH];
+        int count;
+};
+
+/* Allocations made since the program started. They are only counted
+ * if the program is built with -DALLOC_STATS, see the top of the
+ * file. Sizes are usable sizes, i.e. including any rounding up by
+ * malloc().
+ *    count - the number of allocations
+ *    bytes - the number of bytes allocated
+ *    live - the number of bytes allocated and not yet freed
+ */
+struct alloc_counts {
+        unsigned long long count;
+        unsigned long long bytes;
+        unsigned long long live;
+};
+
+struct alloc_counts alloc_counts;
+
+/* Memory used in the last trial of a phase.
+ *    allocs - the number of allocations of the timed operations
+ *    alloc_bytes - the number of bytes allocated by them
+ *    table_bytes - the number of bytes held by the table when it
+ *                  holds its items
+ *    items - the number of items
+ *    peak_rss_kb - the peak resident set size of the process in kB
+ *                  during the trial, or 0 if unknown
+ */
+struct phase_memory {
+        unsigned long long allocs;
+        unsigned long long alloc_bytes;
+        unsigned long long table_bytes;
+        int items;
+        long peak_rss_kb;
+};
+
+/* Result of the measured trials of one phase.
+ *    trial_ns - the time of each trial in nanoseconds
+ *    latency - histogram of the latency of each table call in all
+ *              trials, if recorded
+ *    memory - the memory used in the last trial
+ */
+struct phase_result {
+        unsigned long long *trial_ns;
+        unsigned long latency[LATENCY_BUCKETS];
+        struct phase_memory memory;
+};
+
+/* Summary of the times of the trials of a phase, in nanoseconds. The
+ * standard deviation is that of a sample, zero for a single trial.
+ */
+struct timing_summary {
+        double min;
+        double median;
+        double p99;
+        double mean;
+        double stddev;
+};
 
 /**
  * copy_string() - Create a dynamic copy of a string.
@@ -123,15 +485,256 @@ int *int_ptr_from_int(int i)
 }
 
 /**
- * get_milliseconds() - Return the current time-of-day in milliseconds.
+ * get_nanoseconds() - Return the time of a monotonic clock in nanoseconds.
+ *
+ * Returns: The time in nanoseconds since some unspecified point.
+ */
+unsigned long long get_nanoseconds()
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long long)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+
+#ifdef ALLOC_STATS
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *p, size_t size);
+int __real_posix_memalign(void **p, size_t alignment, size_t size);
+void __real_free(void *p);
+
+/**
+ * count_alloc() - Count an allocation.
+ * @p: The allocated block, or NULL if the allocation failed.
+ *
+ * The counts are updated atomically since threads share them with -j.
+ */
+void count_alloc(void *p)
+{
+        if (p == NULL) {
+                return;
+        }
+        unsigned long long size = malloc_usable_size(p);
+        __atomic_add_fetch(&alloc_counts.count, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&alloc_counts.bytes, size, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&alloc_counts.live, size, __ATOMIC_RELAXED);
+}
+
+/**
+ * count_free() - Count that a block of memory is freed.
+ * @size: Usable size of the block.
+ */
+void count_free(unsigned long long size)
+{
+        __atomic_sub_fetch(&alloc_counts.live, size, __ATOMIC_RELAXED);
+}
+
+/*
+ * Replacements of the allocation functions, called instead of them by
+ * every part of the program that is linked with --wrap.
+ */
+
+void *__wrap_malloc(size_t size)
+{
+        void *p = __real_malloc(size);
+        count_alloc(p);
+        return p;
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+        void *p = __real_calloc(nmemb, size);
+        count_alloc(p);
+        return p;
+}
+
+void *__wrap_realloc(void *p, size_t size)
+{
+        unsigned long long old = p != NULL ? malloc_usable_size(p) : 0;
+        void *q = __real_realloc(p, size);
+        // realloc(p, 0) may free p and return NULL
+        if (q != NULL || size == 0) {
+                count_free(old);
+        }
+        count_alloc(q);
+        return q;
+}
+
+int __wrap_posix_memalign(void **p, size_t alignment, size_t size)
+{
+        int err = __real_posix_memalign(p, alignment, size);
+        if (err == 0) {
+                count_alloc(*p);
+        }
+        return err;
+}
+
+void __wrap_free(void *p)
+{
+        if (p != NULL) {
+                count_free(malloc_usable_size(p));
+        }
+        __real_free(p);
+}
+#endif
+
+/**
+ * counting_allocs() - Tell whether allocations are counted.
+ *
+ * Returns: True if the program is built with -DALLOC_STATS.
+ */
+bool counting_allocs()
+{
+#ifdef ALLOC_STATS
+        return true;
+#else
+        return false;
+#endif
+}
+
+/**
+ * int_alloc_bytes() - Return the usable size of an allocated int.
  *
- * Returns: The current time-of-day in milliseconds.
+ * Returns: The bytes counted for each key and value of the timings,
+ * or 0 if allocations are not counted.
  */
-unsigned long get_milliseconds()
+unsigned long long int_alloc_bytes()
 {
-        struct timeval tv;
-        gettimeofday(&tv, 0);
-        return (unsigned long)(tv.tv_sec*1000 + tv.tv_usec/1000);
+        struct alloc_counts before = alloc_counts;
+        int *ip = malloc(sizeof(int));
+        unsigned long long bytes = alloc_counts.bytes - before.bytes;
+        free(ip);
+        return bytes;
+}
+
+/**
+ * reset_peak_rss() - Reset the peak resident set size of the process.
+ *
+ * Only Linux 4.0 and later allow this. Elsewhere the peak is that
+ * since the program started.
+ */
+void reset_peak_rss()
+{
+        FILE *fp = fopen("/proc/self/clear_refs", "w");
+        if (fp != NULL) {
+                fputs("5", fp);
+                fclose(fp);
+        }
+}
+
+/**
+ * get_peak_rss_kb() - Return the peak resident set size of the process.
+ *
+ * Returns: The peak since the program started or reset_peak_rss() was
+ * called, in kB, or 0 if it is unknown.
+ */
+long get_peak_rss_kb()
+{
+        FILE *fp = fopen("/proc/self/status", "r");
+        char line[128];
+        long kb = 0;
+
+        if (fp == NULL) {
+                return 0;
+        }
+        while (fgets(line, sizeof(line), fp) != NULL) {
+                if (sscanf(line, "VmHWM: %ld kB", &kb) == 1) {
+                        break;
+                }
+        }
+        fclose(fp);
+        return kb;
+}
+
+/**
+ * impl_count() - Return the number of implementations to test.
+ *
+ * Returns: The number of implementations chosen with --impl, or 1 if
+ * the program is linked with a single implementation of table.h.
+ */
+int impl_count()
+{
+#ifdef TABLE_OPS
+        return n_impls;
+#else
+        return 1;
+#endif
+}
+
+/**
+ * select_impl() - Make the table functions call an implementation.
+ * @i: Index of the implementation, from 0 to impl_count()-1.
+ */
+void select_impl(int i)
+{
+#ifdef TABLE_OPS
+        table_impl_select(impls[i]);
+#endif
+}
+
+/**
+ * impl_name() - Return the name of the selected implementation.
+ *
+ * Returns: The name, or "linked" if the program is linked with a
+ * single implementation of table.h.
+ */
+const char *impl_name()
+{
+#ifdef TABLE_OPS
+        return table_impl_selected()->name;
+#else
+        return "linked";
+#endif
+}
+
+/**
+ * impl_int_keys_only() - Check if the selected implementation only
+ * takes int keys, unlike the correctness tests.
+ *
+ * Returns: True if the keys must be ints. Unknown, so false, for a
+ * single linked implementation, which is tested with -n instead.
+ */
+bool impl_int_keys_only()
+{
+#ifdef TABLE_OPS
+        return (table_impl_selected()->flags & TABLE_IMPL_INT_KEYS) != 0;
+#else
+        return false;
+#endif
+}
+
+/**
+ * impl_string_keys_only() - Check if the selected implementation only
+ * takes string keys, unlike the timings.
+ *
+ * Returns: True if the keys must be strings. Unknown, so false, for a
+ * single linked implementation, which is tested with -c instead.
+ */
+bool impl_string_keys_only()
+{
+#ifdef TABLE_OPS
+        return (table_impl_selected()->flags & TABLE_IMPL_STRING_KEYS) != 0;
+#else
+        return false;
+#endif
+}
+
+/**
+ * impl_thread_safe() - Check if tables of the selected implementation
+ * may be shared by threads without a lock.
+ *
+ * Returns: True if the implementation is thread-safe. A single linked
+ * implementation is if the program is compiled with THREAD_SAFE_TABLE.
+ */
+bool impl_thread_safe()
+{
+#ifdef TABLE_OPS
+        return (table_impl_selected()->flags & TABLE_IMPL_THREAD_SAFE) != 0;
+#elif defined(THREAD_SAFE_TABLE)
+        return true;
+#else
+        return false;
+#endif
 }
 
 /**
@@ -166,21 +769,45 @@ int string_compare(const void *ip1,const void *ip2)
         return strcmp(s1,s2);
 }
 
-/* Shuffles the numbers stored in seq
+/**
+ * int_hash() - Hash an integer via a pointer.
+ * @ip: Pointer to the integer to be hashed.
+ *
+ * Returns: The integer value itself. Equal integers give equal hashes.
+ */
+unsigned long int_hash(const void *ip)
+{
+        const int *n=ip;
+        return (unsigned long)*n;
+}
+
+/**
+ * string_hash() - Hash a string.
+ * @ip: Pointer to the string to be hashed.
+ *
+ * Uses the 32-bit FNV-1a hash.
+ *
+ * Returns: The hash value of the string.
+ */
+unsigned long string_hash(const void *ip)
+{
+        const unsigned char *s=ip;
+        unsigned long h=2166136261UL;
+        while (*s!='\0') {
+                h^=*s++;
+                h=(h*16777619UL) & 0xffffffffUL;
+        }
+        return h;
+}
+
+/* Shuffles the numbers stored in seq, with every order equally likely
  *    seq - an array of randomnumbers to be shuffled
  *    n - the number of elements in seq to shuffle, i.e the indexes [0, n]
  *        will be shuffled. However, seq might be larger than n...
  */
 void random_shuffle(int seq[], int n)
 {
-        for(int i=0;i<n;i++) {
-                int switchPos=rand()%n;
-                if(i!=switchPos) {
-                        int temp=seq[i];
-                        seq[i]=seq[switchPos];
-                        seq[switchPos]=temp;
-                }
-        }
+        workload_shuffle(&rng, seq, n);
 }
 
 /* Generate n unique random numbers. The numbers will be stored i seq
@@ -195,118 +822,250 @@ void create_random_sample(int seq[], int n)
         random_shuffle(seq,n);
 }
 
+/* Computes a key of a key set without an array. Each step of the
+ * mixing is a bijection on the numbers below mask+1, and a result of
+ * size or above is mixed again until it is below size, so the keys
+ * are a permutation of 0 to size-1. Fewer than two rounds are needed
+ * on average since mask+1 is less than 2*size.
+ *    ks - the key set
+ *    i - the position of the key, from 0 to size-1
+ */
+int compute_key(const struct key_set *ks, int i)
+{
+        uint64_t x = i;
+        do {
+                for (int r = 0; r < 3; r++) {
+                        x = (x*ks->mult[r] + ks->add[r]) & ks->mask;
+                        x ^= x >> ks->shift;
+                }
+        } while (x >= (uint64_t)ks->size);
+        return (int)x;
+}
+
+/* Returns the key at a position of a key set.
+ *    ks - the key set
+ *    i - the position of the key, from 0 to size-1
+ */
+int key_at(const struct key_set *ks, int i)
+{
+        return ks->keys != NULL ? ks->keys[i] : compute_key(ks, i);
+}
+
+/* Creates a random permutation of 0 to size-1. It is shuffled into an
+ * array unless it has more than MAX_KEY_ARRAY keys, in which case each
+ * key is computed when it is used.
+ *    ks - set to the permutation
+ *    size - the number of keys, at least 1
+ */
+void key_set_init(struct key_set *ks, int size)
+{
+        int bits = 1;
+        while ((1ULL << bits) < (unsigned long long)size) {
+                bits++;
+        }
+        ks->size = size;
+        ks->mask = (1ULL << bits) - 1;
+        ks->shift = bits/2 + 1;
+        for (int r = 0; r < 3; r++) {
+                ks->mult[r] = workload_rng_next(&rng) | 1;
+                ks->add[r] = workload_rng_next(&rng);
+        }
+        ks->keys = NULL;
+        if (size <= MAX_KEY_ARRAY) {
+                ks->keys = malloc(size*sizeof(*ks->keys));
+                create_random_sample(ks->keys, size);
+        }
+}
+
+/* Frees the array of a key set, if it has one.
+ *    ks - the key set
+ */
+void key_set_free(struct key_set *ks)
+{
+        free(ks->keys);
+        ks->keys = NULL;
+}
 
-/* Fill a table with values.
+/* Fill a table with values. The value of the item with key i of the
+ * key set is i.
  *    table - the table to fill
- *    keys - a list of keys to use
- *    values - a list of values to use
+ *    keys - the keys to use
+ *    n - the number of items to insert
  */
-void insert_values(table *t, int *keys, int *values, int n)
+void insert_values(table *t, const struct key_set *keys, int n)
 {
         // Insert all items
         for(int i=0;i<n;i++) {
-                table_insert(t, int_ptr_from_int(keys[i]),
-                             int_ptr_from_int(values[i]));
+                table_insert(t, int_ptr_from_int(key_at(keys,i)),
+                             int_ptr_from_int(i));
+        }
+}
+
+/* Adds the latency of one operation to a histogram.
+ *    latency - the histogram, or NULL if latencies are not recorded
+ *    start - the time the operation started, from get_nanoseconds()
+ */
+void record_latency(unsigned long *latency, unsigned long long start)
+{
+        if (latency == NULL) {
+                return;
         }
+        unsigned long long ns = get_nanoseconds() - start;
+        int b = 0;
+        while (b < LATENCY_BUCKETS-1 && ns >= (1ULL << b)) {
+                b++;
+        }
+        latency[b]++;
+}
+
+/* Look up the keys collected so far with one call and empty the batch.
+ *    t - the table to do the lookups in
+ *    batch - the keys to look up
+ *    latency - histogram to add the time of the call to, or NULL
+ */
+void lookup_batch(table *t, struct key_batch *batch,
+                  unsigned long *latency)
+{
+        void *values[LOOKUP_BATCH];
+        unsigned long long start = latency != NULL ? get_nanoseconds() : 0;
+
+        table_lookup_many(t, batch->keys, values, batch->count);
+        record_latency(latency, start);
+        batch->count = 0;
 }
 
+/* Look up a key, either directly or by adding it to a batch that is
+ * looked up when it is full.
+ *    t - the table to do the lookup in
+ *    key - the key to look up
+ *    batch - the keys collected so far, or NULL to look up directly
+ *    latency - histogram to add the time of each table call to, or NULL
+ */
+void lookup_key(table *t, int key, struct key_batch *batch,
+                unsigned long *latency)
+{
+        if (batch == NULL) {
+                unsigned long long start =
+                        latency != NULL ? get_nanoseconds() : 0;
+                table_lookup(t, &key);
+                record_latency(latency, start);
+                return;
+        }
+        batch->ints[batch->count] = key;
+        batch->keys[batch->count] = &batch->ints[batch->count];
+        batch->count++;
+        if (batch->count == LOOKUP_BATCH) {
+                lookup_batch(t, batch, latency);
+        }
+}
 
 /* Measures time taken to fill a table with values
  *    table - the table to fill
- *    keys - a list of keys to use
- *    values - a list of values to use
+ *    keys - the keys to use
  *    n - the number of items to insert
- *    machine_table - true if we should output a machine-readable table
+ *    latency - histogram to add the time of each insert to, or NULL
+ *
+ * Returns: The time taken in nanoseconds.
  */
-void get_insert_speed(table *t, int *keys, int *values, int n,
-		bool machine_table)
+unsigned long long get_insert_speed(table *t, const struct key_set *keys,
+                                    int n, unsigned long *latency)
 {
-        unsigned long start;
-        unsigned long end;
+        unsigned long long start;
+        unsigned long long end;
 
         // Insert all items
-        start = get_milliseconds();
-        insert_values(t,keys,values,n);
-        end =  get_milliseconds();
-	if (machine_table) {
-		printf("%d, %d, %lu\n",1,n,end-start);
-	} else {
-		printf("Insert %5d items                   : ", n);
-		printf("%lu ms.\n",end-start);
-	}
+        start = get_nanoseconds();
+        for(int i=0;i<n;i++) {
+                int *key = int_ptr_from_int(key_at(keys,i));
+                int *value = int_ptr_from_int(i);
+                unsigned long long op =
+                        latency != NULL ? get_nanoseconds() : 0;
+                table_insert(t, key, value);
+                record_latency(latency, op);
+        }
+        end = get_nanoseconds();
+        return end-start;
 }
 
 /* Measures time taken to do n lookups of existing keys in a table
  *    t - the table to fill
- *    keys - a list of keys to use
- *    values - a list of values to use
+ *    keys - the keys to use
  *    n - the number of lookups to perform
- *    machine_table - true if we should output a machine-readable table
+ *    batch - buffer of keys to look up with table_lookup_many(), or
+ *            NULL to use table_lookup()
+ *    latency - histogram to add the time of each table call to, or NULL
+ *
+ * Returns: The time taken in nanoseconds.
  */
-void get_random_existing_lookup_speed(table *t, int *keys, int n,
-				bool machine_table)
+unsigned long long get_random_existing_lookup_speed(
+        table *t, const struct key_set *keys, int n, struct key_batch *batch,
+        unsigned long *latency)
 {
-        unsigned long start;
-        unsigned long end;
+        unsigned long long start;
+        unsigned long long end;
 
-        start = get_milliseconds();
+        start = get_nanoseconds();
         for(int i=0;i<n;i++) {
                 // The existing keys in the table are stored in index
-                // [0, TABLESIZE-1] in the key-array
-                int pos = rand()%n;
-                table_lookup(t,&keys[pos]);
-        }
-        end = get_milliseconds();
-	if (machine_table) {
-		printf("%d, %d, %lu\n",4,n,end-start);
-	} else {
-		printf("%5d random lookups                 : ",n );
-		printf("%lu ms.\n", end-start);
-	}
+                // [0, n-1] in the key set
+                int pos = (int)workload_rng_below(&rng, n);
+                lookup_key(t,key_at(keys,pos),batch,latency);
+        }
+        if (batch != NULL) {
+                lookup_batch(t,batch,latency);
+        }
+        end = get_nanoseconds();
+        return end-start;
 }
 
 /* Measures time taken to do n lookups of non-existing keys in a table
  *    t - the table to fill
- *    keys - a list of keys to use
- *    values - a list of values to use
+ *    keys - the keys to use
  *    n - the number of lookups to perform
- *    machine_table - true if we should output a machine-readable table
+ *    batch - buffer of keys to look up with table_lookup_many(), or
+ *            NULL to use table_lookup()
+ *    latency - histogram to add the time of each table call to, or NULL
+ *
+ * Returns: The time taken in nanoseconds.
  */
-void get_random_non_existing_lookup_speed(table *t, int *keys, int n,
-				bool machine_table)
+unsigned long long get_random_non_existing_lookup_speed(
+        table *t, const struct key_set *keys, int n, struct key_batch *batch,
+        unsigned long *latency)
 {
-        unsigned long start;
-        unsigned long end;
+        unsigned long long start;
+        unsigned long long end;
 
-        // We know the exisiting keys have indexes in [0, TABLESIZE-1]
-        // so if we try to lookup keys in the area [TABLESIZE,
-        // 2*TABLESIZE-1] they will not exist
-        start =  get_milliseconds();
+        // We know the exisiting keys have indexes in [0, n-1] so if we
+        // try to lookup keys in the area [n, 2*n-1] they will not exist
+        start = get_nanoseconds();
         int startindex = n;
         for(int i=0;i<n;i++){
-                table_lookup(t,&keys[startindex + (i%n)]);
-        }
-        end = get_milliseconds();
-	if (machine_table) {
-		printf("%d, %d, %lu\n",3,n,end-start);
-	} else {
-		printf("%5d lookups with non-existent keys : ", n);
-		printf("%lu ms.\n" ,end-start);
-	}
+                lookup_key(t,key_at(keys,startindex + (i%n)),batch,latency);
+        }
+        if (batch != NULL) {
+                lookup_batch(t,batch,latency);
+        }
+        end = get_nanoseconds();
+        return end-start;
 }
 
 /* Measures time taken to do n lookups of existing keys in a table when the
  * keys chosen are from only a part of all available keys
  *    t - the table to fill
- *    keys - a list of keys to use
- *    values - a list of values to use
+ *    keys - the keys to use
  *    n - the number of lookups to perform
- *    machine_table - true if we should output a machine-readable table
+ *    batch - buffer of keys to look up with table_lookup_many(), or
+ *            NULL to use table_lookup()
+ *    latency - histogram to add the time of each table call to, or NULL
+ *
+ * Returns: The time taken in nanoseconds.
  */
-void get_skewed_lookup_speed(table *t, int *keys, int n, bool machine_table)
+unsigned long long get_skewed_lookup_speed(table *t, const struct key_set *keys,
+                                           int n, struct key_batch *batch,
+                                           unsigned long *latency)
 {
-        unsigned long start;
-        unsigned long end;
+        unsigned long long start;
+        unsigned long long end;
 
         // Lookup skewed to a certain range (in this case the middle third
         // of the keys used)
@@ -314,132 +1073,667 @@ void get_skewed_lookup_speed(table *t, int *keys, int n, bool machine_table)
         int stopindex = n*2/3;
         int partition = stopindex - startindex + 1;
 
-        start =  get_milliseconds();
+        start = get_nanoseconds();
         for(int i=0;i<n;i++) {
-                int pos = rand()%partition + startindex;
-                table_lookup(t,&keys[pos]);
-        }
-        end = get_milliseconds();
-	if (machine_table) {
-		printf("%d, %d, %lu\n",5,n,end-start);
-	} else {
-		printf("%5d skewed lookups                 : " ,n);
-		printf("%lu ms.\n" ,end-start);
-	}
+                int pos = (int)workload_rng_below(&rng, partition) +
+                        startindex;
+                lookup_key(t,key_at(keys,pos),batch,latency);
+        }
+        if (batch != NULL) {
+                lookup_batch(t,batch,latency);
+        }
+        end = get_nanoseconds();
+        return end-start;
 }
 
 /* Measures time taken remove all keys from a table
  *    t - the table to fill
- *    keys - a list of keys to use
- *    values - a list of values to use
+ *    keys - the keys to use
+ *    order - a permutation of 0 to n-1, the order to remove the keys in
  *    n - number of items in the table
- *    machine_table - true if we should output a machine-readable table
+ *    latency - histogram to add the time of each remove to, or NULL
+ *
+ * Returns: The time taken in nanoseconds.
  */
-void get_remove_speed(table *t, int *keys, int n, bool machine_table)
+unsigned long long get_remove_speed(table *t, const struct key_set *keys,
+                                    const struct key_set *order, int n,
+                                    unsigned long *latency)
 {
-        unsigned long start;
-        unsigned long end;
+        unsigned long long start;
+        unsigned long long end;
 
-        // Remove all items, not in the same order as they were inserted
-        start = get_milliseconds();
-        random_shuffle(keys, n);  // to get a new order of the keys
+        start = get_nanoseconds();
         for(int i=0;i<n;i++) {
-                table_remove(t,&keys[i]);
-        }
-        end = get_milliseconds();
-	if (machine_table) {
-		printf("%d, %d, %lu\n",2,n,end-start);
-	} else {
-		printf("Remove all items                     : ");
-		printf("%lu ms.\n" ,end-start);
-	}
+                int key = key_at(keys, key_at(order, i));
+                unsigned long long op =
+                        latency != NULL ? get_nanoseconds() : 0;
+                table_remove(t,&key);
+                record_latency(latency, op);
+        }
+        end = get_nanoseconds();
+        return end-start;
 }
 
-/* Tests if isempty returns true directly after a table is created.
+/* Measures time taken to replay the operations of a workload on a
+ * table holding its items. Updates and inserts give the key a new
+ * value, and a read-modify-write looks up the key before the update.
+ *    t - the table to replay the operations on
+ *    w - the workload
+ *    latency - histogram to add the time of each operation to, or NULL
+ *
+ * Returns: The time taken in nanoseconds.
  */
-void test_isempty(){
-        table *t = table_empty(int_compare, NULL, NULL);
-
-        if (!table_is_empty(t)){
-                printf("An newly created empty table is said to be nonempty.\n");
-                exit(EXIT_FAILURE);
+unsigned long long get_workload_speed(table *t, const struct workload *w,
+                                      unsigned long *latency)
+{
+        void **values = malloc(w->max_scan*sizeof(*values));
+        void **scan_keys = malloc(w->max_scan*sizeof(*scan_keys));
+        int *scan_ints = malloc(w->max_scan*sizeof(*scan_ints));
+        unsigned long long start;
+        unsigned long long end;
+
+        for(int i=0;i<w->max_scan;i++) {
+                scan_keys[i] = &scan_ints[i];
         }
-        printf("Isempty returns true directly after a table is created. - OK\n");
-        table_kill(t);
+        start = get_nanoseconds();
+        for(int i=0;i<w->n_ops;i++) {
+                const workload_op *op = &w->ops[i];
+                unsigned long long op_start =
+                        latency != NULL ? get_nanoseconds() : 0;
+                switch (op->type) {
+                case WORKLOAD_READ:
+                        table_lookup(t,&op->key);
+                        break;
+                case WORKLOAD_READ_MODIFY_WRITE:
+                        table_lookup(t,&op->key);
+                        // The new value is written as in an update
+                        // Fall through
+                case WORKLOAD_UPDATE:
+                case WORKLOAD_INSERT:
+                        table_insert(t,int_ptr_from_int(op->key),
+                                     int_ptr_from_int(i));
+                        break;
+                case WORKLOAD_SCAN:
+                        for(int j=0;j<op->length;j++) {
+                                scan_ints[j] = key_at(w->records,
+                                                      op->record + j);
+                        }
+                        table_lookup_many(t,scan_keys,values,op->length);
+                        break;
+                case WORKLOAD_REMOVE:
+                        table_remove(t,&op->key);
+                        break;
+                }
+                record_latency(latency, op_start);
+        }
+        end = get_nanoseconds();
+        free(values);
+        free(scan_keys);
+        free(scan_ints);
+        return end-start;
 }
 
-/* Tests if isempty returns false directly after a table is created
- * and one element (key-value-pair) is inserted to it.
+/* Compares two times for qsort().
+ *    a, b - pointers to the unsigned long long times to compare
  */
-void test_insert_single_element(void)
+int compare_times(const void *a, const void *b)
 {
-        table *t = table_empty(string_compare, free, free);
-        char *key = copy_string("key1");
-        char *value = copy_string("value1");
-
-        table_insert(t, key, value);
-        if (table_is_empty(t)){
-                printf("A table with one inserted element is seen as empty.\n");
-                exit(EXIT_FAILURE);
-        }
-        printf("Isempty false if one element is inserted to table. - OK\n");
-        table_kill(t);
+        unsigned long long x = *(const unsigned long long *)a;
+        unsigned long long y = *(const unsigned long long *)b;
+        return (x > y) - (x < y);
 }
 
-/* Tests looking up the key key in a table table. Checks that lookup is
- *  returning the value value
- *     t - the table to do the lookup in
- *     key - the key to lookup
- *     value - the expected value
+/* Computes the summary of the measured trials of a phase.
+ *    trial_ns - the time of each trial in nanoseconds
+ *    trials - the number of trials
+ *    summary - set to the summary
  */
-void test_lookup_existing_key(table *t, char *key, char *value)
+void summarize_trials(const unsigned long long *trial_ns, int trials,
+                      struct timing_summary *summary)
 {
-        char *return_value = (char *)table_lookup(t, key);
-        if (return_value==NULL){
-                printf("Looked up an existing key, table claims it does "
-                       "not exist.\n");
-                exit(EXIT_FAILURE);
+        unsigned long long *ns = malloc(trials*sizeof(*ns));
+        double squares = 0;
+        double sum = 0;
+
+        memcpy(ns, trial_ns, trials*sizeof(*ns));
+        qsort(ns, trials, sizeof(*ns), compare_times);
+        summary->min = ns[0];
+        summary->median = trials%2 == 1 ? ns[trials/2]
+                : (ns[trials/2-1] + ns[trials/2]) / 2.0;
+        // Nearest-rank percentile: the smallest time that at least 99%
+        // of the trials are at or below
+        summary->p99 = ns[(99*trials + 99)/100 - 1];
+        for (int i = 0; i < trials; i++) {
+                sum += ns[i];
         }
-        if (strcmp(return_value, value)){
-                printf("Looked up a key but the value returned was wrong.");
-                printf(" Expected: %s but got %s.\n", value, return_value);
-                exit(EXIT_FAILURE);
+        summary->mean = sum/trials;
+        for (int i = 0; i < trials; i++) {
+                squares += (ns[i] - summary->mean)*(ns[i] - summary->mean);
         }
+        summary->stddev = trials > 1 ? sqrt(squares/(trials-1)) : 0;
+        free(ns);
 }
 
-/* Tests looking up the key key in a table table. Verifies that the
- * key is not found.
+/* Returns the smallest latency in nanoseconds of a histogram bucket.
+ *    b - the bucket
  */
-void test_lookup_missing_key(table *t, char *key)
+unsigned long long latency_bucket_low(int b)
 {
-        char *return_value = (char *)table_lookup(t, key);
-        if (return_value!=NULL){
-                printf("Looked up an missing key %s, table claims it has "
-                       "value %s.\n",key,return_value);
-                exit(EXIT_FAILURE);
-        }
+        return b == 0 ? 0 : 1ULL << (b - 1);
 }
 
-/*  Tests a table by creating it and inserting one key-value-pair. After
- *  that it is checked that the returned values from a lookup are the ones
- *  expected. First by looking up a non-existent key, then by looking up
- *  an existent key.
- *
- *  It is assumed that test_insert_single_value has been run before calling
- *  this test, i.e. that it has been tested that inserting one element
- *  results in an nonempty table.
+/* Prints the name of the selected implementation in front of a line
+ * of human-readable timings, unless the program is linked with a
+ * single implementation.
  */
-void test_lookup_single_element()
+void print_impl_label()
 {
-        table *t = table_empty(string_compare, free, free);
+#ifdef TABLE_OPS
+        printf("%-10s ", impl_name());
+#endif
+}
 
-        char *key1 = copy_string("key1");
-        char *value1 = copy_string("value1");
-        char *value2;
+/* Starts a new element of the results array in the JSON output,
+ * separated from the previous one by a comma.
+ */
+void begin_json_result(void)
+{
+        static int printed = 0;
 
-        table_insert(t, key1, value1);
+        printf(printed++ > 0 ? ",\n  " : "  ");
+}
 
-        // Lookup a non-existent key
+/* Returns the bytes per entry that a table holds besides the key and
+ * value of each item, or 0 if the phase has no items.
+ *    m - the memory used by the phase
+ */
+double bytes_per_entry(const struct phase_memory *m)
+{
+        if (m->items == 0) {
+                return 0;
+        }
+        return ((double)m->table_bytes -
+                2.0*m->items*int_alloc_bytes())/m->items;
+}
+
+/* Prints the memory used by a phase in one of the output formats.
+ *    m - the memory used by the phase
+ *    format - how to print it
+ */
+void print_phase_memory(const struct phase_memory *m,
+                        enum output_format format)
+{
+        bool counted = counting_allocs();
+
+        switch (format) {
+        case OUTPUT_TEXT:
+                printf("  memory:");
+                if (counted) {
+                        printf(" %llu allocations of %llu bytes, table of "
+                               "%llu bytes (%.1f bytes/entry),",
+                               m->allocs, m->alloc_bytes, m->table_bytes,
+                               bytes_per_entry(m));
+                }
+                printf(" peak RSS %ld kB\n", m->peak_rss_kb);
+                break;
+        case OUTPUT_CSV:
+                if (counted) {
+                        printf(",%llu,%llu,%llu,%.1f", m->allocs,
+                               m->alloc_bytes, m->table_bytes,
+                               bytes_per_entry(m));
+                } else {
+                        printf(",,,,");
+                }
+                printf(",%ld", m->peak_rss_kb);
+                break;
+        case OUTPUT_JSON:
+                if (counted) {
+                        printf(", \"allocs\": %llu, \"alloc_bytes\": %llu, "
+                               "\"table_bytes\": %llu, "
+                               "\"bytes_per_entry\": %.1f", m->allocs,
+                               m->alloc_bytes, m->table_bytes,
+                               bytes_per_entry(m));
+                }
+                printf(", \"peak_rss_kb\": %ld", m->peak_rss_kb);
+                break;
+        }
+}
+
+/* Prints the result of the measured trials of a phase.
+ *    phase - the phase
+ *    n - the number of items
+ *    result - the times of the trials and their latency histogram
+ *    opts - the settings of the timings
+ */
+void print_phase_result(enum phase phase, int n,
+                        const struct phase_result *result,
+                        const struct timing_options *opts)
+{
+        struct timing_summary s;
+        bool first = true;
+
+        summarize_trials(result->trial_ns, opts->trials, &s);
+        switch (opts->format) {
+        case OUTPUT_TEXT:
+                print_impl_label();
+                printf(phase_labels[phase], n);
+                if (opts->trials == 1) {
+                        printf("%.3f ms.\n", s.median/1e6);
+                } else {
+                        printf("%.3f ms median (min %.3f, p99 %.3f, "
+                               "sd %.3f ms, %d trials).\n", s.median/1e6,
+                               s.min/1e6, s.p99/1e6, s.stddev/1e6,
+                               opts->trials);
+                }
+                if (opts->latency) {
+                        // Bucket [low] holds latencies from low to 2*low-1
+                        printf("  latency ns:");
+                        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+                                if (result->latency[b] > 0) {
+                                        printf(" [%llu]=%lu",
+                                               latency_bucket_low(b),
+                                               result->latency[b]);
+                                }
+                        }
+                        printf("\n");
+                }
+                if (opts->show_memory) {
+                        print_phase_memory(&result->memory, OUTPUT_TEXT);
+                }
+                break;
+        case OUTPUT_CSV:
+                printf("%s,%d,%s,%d,%d,%.0f,%.1f,%.0f,%.1f,%.1f,",
+                       impl_name(), phase, phase_names[phase], n,
+                       opts->trials, s.min, s.median, s.p99, s.mean,
+                       s.stddev);
+                for (int b = 0; b < LATENCY_BUCKETS; b++) {
+                        if (result->latency[b] > 0) {
+                                printf("%s%llu:%lu", first ? "" : " ",
+                                       latency_bucket_low(b),
+                                       result->latency[b]);
+                                first = false;
+                        }
+                }
+                print_phase_memory(&result->memory, OUTPUT_CSV);
+                printf("\n");
+                break;
+        case OUTPUT_JSON:
+                begin_json_result();
+                printf("{\"impl\": \"%s\", \"test\": %d, \"phase\": \"%s\", "
+                       "\"n\": %d, \"trials\": %d, \"min_ns\": %.0f, "
+                       "\"median_ns\": %.1f, \"p99_ns\": %.0f, "
+                       "\"mean_ns\": %.1f, \"stddev_ns\": %.1f, "
+                       "\"trial_ns\": [", impl_name(), phase,
+                       phase_names[phase], n, opts->trials, s.min, s.median,
+                       s.p99, s.mean, s.stddev);
+                for (int i = 0; i < opts->trials; i++) {
+                        printf("%s%llu", i > 0 ? ", " : "",
+                               result->trial_ns[i]);
+                }
+                printf("]");
+                if (opts->latency) {
+                        printf(", \"latency_histogram\": [");
+                        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+                                if (result->latency[b] > 0) {
+                                        printf("%s{\"min_ns\": %llu, "
+                                               "\"count\": %lu}",
+                                               first ? "" : ", ",
+                                               latency_bucket_low(b),
+                                               result->latency[b]);
+                                        first = false;
+                                }
+                        }
+                        printf("]");
+                }
+                print_phase_memory(&result->memory, OUTPUT_JSON);
+                printf("}");
+                break;
+        }
+}
+
+/* Returns the two-sided 95% critical value of Student's t
+ * distribution.
+ *    df - the degrees of freedom, at least 1
+ */
+double t_critical_95(int df)
+{
+        static const double t[] = {
+                0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365,
+                2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131,
+                2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069,
+                2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+        };
+        const double z = 1.959964;
+        const double z2 = z*z;
+
+        if (df <= 30) {
+                return t[df];
+        }
+        // Cornish-Fisher expansion around the normal distribution up
+        // to the term in 1/df^3, off by less than 0.000002 above 30.
+        // The first term alone is off by 0.003 at 31.
+        double g1 = (z2 + 1)*z/4;
+        double g2 = ((5*z2 + 16)*z2 + 3)*z/96;
+        double g3 = (((3*z2 + 19)*z2 + 17)*z2 - 15)*z/384;
+        return z + (g1 + (g2 + g3/df)/df)/df;
+}
+
+/* Prints the mean and 95% confidence interval of the runs of a phase
+ * at one n of a sweep.
+ *    phase - the phase
+ *    n - the number of items
+ *    run_ns - the time of each run in nanoseconds
+ *    memory - the memory used in the last run
+ *    opts - the settings of the timings
+ */
+void print_sweep_point(enum phase phase, int n,
+                       const unsigned long long *run_ns,
+                       const struct phase_memory *memory,
+                       const struct timing_options *opts)
+{
+        struct timing_summary s;
+        double margin = 0;
+
+        summarize_trials(run_ns, opts->runs, &s);
+        if (opts->runs > 1) {
+                margin = t_critical_95(opts->runs - 1)*s.stddev
+                        /sqrt(opts->runs);
+        }
+        switch (opts->format) {
+        case OUTPUT_TEXT:
+        case OUTPUT_CSV:
+                printf("%s,%d,%s,%d,%d,%.1f,%.1f,%.1f,%.1f,%.3f",
+                       impl_name(), phase, phase_names[phase], n, opts->runs,
+                       s.mean, s.stddev, s.mean - margin, s.mean + margin,
+                       s.mean/n);
+                print_phase_memory(memory, OUTPUT_CSV);
+                printf("\n");
+                break;
+        case OUTPUT_JSON:
+                begin_json_result();
+                printf("{\"impl\": \"%s\", \"test\": %d, \"phase\": \"%s\", "
+                       "\"n\": %d, \"runs\": %d, \"mean_ns\": %.1f, "
+                       "\"stddev_ns\": %.1f, \"ci95_low_ns\": %.1f, "
+                       "\"ci95_high_ns\": %.1f, \"mean_ns_per_op\": %.3f, "
+                       "\"run_ns\": [", impl_name(), phase,
+                       phase_names[phase], n, opts->runs, s.mean, s.stddev,
+                       s.mean - margin, s.mean + margin, s.mean/n);
+                for (int i = 0; i < opts->runs; i++) {
+                        printf("%s%llu", i > 0 ? ", " : "", run_ns[i]);
+                }
+                printf("]");
+                print_phase_memory(memory, OUTPUT_JSON);
+                printf("}");
+                break;
+        }
+}
+
+/* State of one thread in a concurrent speed test.
+ *    t - the shared table
+ *    keys - the keys, the first n of which are in the table
+ *    n - the number of keys in the table and operations to perform
+ *    first_own - the first of the keys that only this thread inserts
+ *    rng - the random number generator of the thread
+ *    start - barrier that all threads start at
+ *    lock - lock to hold during every table call, or NULL
+ *    start_time, end_time - set to the time the thread started and
+ *                           ended its operations
+ */
+struct thread_job {
+        table *t;
+        const struct key_set *keys;
+        int n;
+        int first_own;
+        workload_rng rng;
+        pthread_barrier_t *start;
+        pthread_mutex_t *lock;
+        unsigned long long start_time;
+        unsigned long long end_time;
+};
+
+/* Take the lock of a job, if it has one.
+ *    job - the job to lock for
+ */
+void lock_job(struct thread_job *job)
+{
+        if (job->lock != NULL) {
+                pthread_mutex_lock(job->lock);
+        }
+}
+
+/* Release the lock of a job, if it has one.
+ *    job - the job to unlock for
+ */
+void unlock_job(struct thread_job *job)
+{
+        if (job->lock != NULL) {
+                pthread_mutex_unlock(job->lock);
+        }
+}
+
+/* Performs the operations of one thread in a concurrent speed test.
+ * Eight out of ten operations look up random existing keys. The other
+ * two insert a key of the thread's own and remove it again, so the
+ * table ends up as it started.
+ *    arg - pointer to the struct thread_job of the thread
+ */
+void *run_thread_job(void *arg)
+{
+        struct thread_job *job = arg;
+
+        pthread_barrier_wait(job->start);
+        job->start_time = get_nanoseconds();
+        for(int i=0;i<job->n;i++) {
+                int own = job->first_own + i/10;
+                if (i%10 == 0) {
+                        int *key = int_ptr_from_int(own);
+                        int *value = int_ptr_from_int(i);
+                        lock_job(job);
+                        table_insert(job->t, key, value);
+                        unlock_job(job);
+                } else if (i%10 == 5) {
+                        lock_job(job);
+                        table_remove(job->t, &own);
+                        unlock_job(job);
+                } else {
+                        int pos = (int)workload_rng_below(&job->rng,
+                                                          job->n);
+                        lock_job(job);
+                        int key = key_at(job->keys, pos);
+                        table_lookup(job->t, &key);
+                        unlock_job(job);
+                }
+        }
+        // The last own key is still in the table if the loop ended
+        // before its remove
+        int last = job->first_own + (job->n-1)/10;
+        lock_job(job);
+        table_remove(job->t, &last);
+        unlock_job(job);
+        job->end_time = get_nanoseconds();
+        return NULL;
+}
+
+/* Checks that a table holds the right keys after a concurrent speed
+ * test, i.e. all of the original keys and none of the threads' own.
+ *    t - the table to check
+ *    keys - the keys, the first n of which were inserted before the test
+ *    n - the number of keys in the table and operations per thread
+ *    jobs - the jobs of the threads
+ *    threads - the number of threads
+ */
+void check_thread_jobs(table *t, const struct key_set *keys, int n,
+                       struct thread_job *jobs, int threads)
+{
+        for(int i=0;i<n;i++) {
+                int key = key_at(keys, i);
+                if (table_lookup(t,&key) == NULL) {
+                        printf("Key %d was lost during the concurrent test "
+                               "with %d threads.\n", key, threads);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        for(int j=0;j<threads;j++) {
+                for(int i=0;i<(n+9)/10;i++) {
+                        int own = jobs[j].first_own + i;
+                        if (table_lookup(t,&own) != NULL) {
+                                printf("Key %d was not removed during the "
+                                       "concurrent test with %d threads.\n",
+                                       own, threads);
+                                exit(EXIT_FAILURE);
+                        }
+                }
+        }
+}
+
+/* Measures the throughput of threads that share a table.
+ *    keys - a set of 2*n keys, the first n of which are inserted
+ *    n - the number of keys in the table and operations per thread
+ *    threads - the number of threads
+ *    lock - lock to hold during every table call, or NULL
+ *
+ * Returns: The number of operations per second of all threads.
+ */
+double get_thread_throughput(const struct key_set *keys, int n, int threads,
+                             pthread_mutex_t *lock)
+{
+        pthread_t ids[MAX_THREADS];
+        struct thread_job jobs[MAX_THREADS];
+        pthread_barrier_t start_barrier;
+        unsigned long long start;
+        unsigned long long end;
+
+        table *t = table_empty_hashed(int_compare, int_hash, free, free);
+        insert_values(t,keys,n);
+
+        pthread_barrier_init(&start_barrier, NULL, threads+1);
+        for(int j=0;j<threads;j++) {
+                // Own keys are above the 2*n keys in the key set
+                jobs[j].t = t;
+                jobs[j].keys = keys;
+                jobs[j].n = n;
+                jobs[j].first_own = 2*n + j*n;
+                workload_rng_seed(&jobs[j].rng, j+1);
+                jobs[j].start = &start_barrier;
+                jobs[j].lock = lock;
+                if (pthread_create(&ids[j], NULL, run_thread_job,
+                                   &jobs[j]) != 0) {
+                        fprintf(stderr,"Error: could not create thread.\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+        pthread_barrier_wait(&start_barrier);
+        for(int j=0;j<threads;j++) {
+                pthread_join(ids[j], NULL);
+        }
+        pthread_barrier_destroy(&start_barrier);
+
+        // Time from when the first thread started to when the last ended
+        start = jobs[0].start_time;
+        end = jobs[0].end_time;
+        for(int j=1;j<threads;j++) {
+                if (jobs[j].start_time < start) {
+                        start = jobs[j].start_time;
+                }
+                if (jobs[j].end_time > end) {
+                        end = jobs[j].end_time;
+                }
+        }
+
+        check_thread_jobs(t,keys,n,jobs,threads);
+        table_kill(t);
+
+        if (end == start) {
+                end++;
+        }
+        return (double)threads*n*1e9/(end-start);
+}
+
+/* Tests if isempty returns true directly after a table is created.
+ */
+void test_isempty(){
+        table *t = table_empty_hashed(int_compare, int_hash, NULL, NULL);
+
+        if (!table_is_empty(t)){
+                printf("An newly created empty table is said to be nonempty.\n");
+                exit(EXIT_FAILURE);
+        }
+        printf("Isempty returns true directly after a table is created. - OK\n");
+        table_kill(t);
+}
+
+/* Tests if isempty returns false directly after a table is created
+ * and one element (key-value-pair) is inserted to it.
+ */
+void test_insert_single_element(void)
+{
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
+        char *key = copy_string("key1");
+        char *value = copy_string("value1");
+
+        table_insert(t, key, value);
+        if (table_is_empty(t)){
+                printf("A table with one inserted element is seen as empty.\n");
+                exit(EXIT_FAILURE);
+        }
+        printf("Isempty false if one element is inserted to table. - OK\n");
+        table_kill(t);
+}
+
+/* Tests looking up the key key in a table table. Checks that lookup is
+ *  returning the value value
+ *     t - the table to do the lookup in
+ *     key - the key to lookup
+ *     value - the expected value
+ */
+void test_lookup_existing_key(table *t, char *key, char *value)
+{
+        char *return_value = (char *)table_lookup(t, key);
+        if (return_value==NULL){
+                printf("Looked up an existing key, table claims it does "
+                       "not exist.\n");
+                exit(EXIT_FAILURE);
+        }
+        if (strcmp(return_value, value)){
+                printf("Looked up a key but the value returned was wrong.");
+                printf(" Expected: %s but got %s.\n", value, return_value);
+                exit(EXIT_FAILURE);
+        }
+}
+
+/* Tests looking up the key key in a table table. Verifies that the
+ * key is not found.
+ */
+void test_lookup_missing_key(table *t, char *key)
+{
+        char *return_value = (char *)table_lookup(t, key);
+        if (return_value!=NULL){
+                printf("Looked up an missing key %s, table claims it has "
+                       "value %s.\n",key,return_value);
+                exit(EXIT_FAILURE);
+        }
+}
+
+/*  Tests a table by creating it and inserting one key-value-pair. After
+ *  that it is checked that the returned values from a lookup are the ones
+ *  expected. First by looking up a non-existent key, then by looking up
+ *  an existent key.
+ *
+ *  It is assumed that test_insert_single_value has been run before calling
+ *  this test, i.e. that it has been tested that inserting one element
+ *  results in an nonempty table.
+ */
+void test_lookup_single_element()
+{
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
+
+        char *key1 = copy_string("key1");
+        char *value1 = copy_string("value1");
+        char *value2;
+
+        table_insert(t, key1, value1);
+
+        // Lookup a non-existent key
         value2 = (char *)table_lookup(t, "key2");
         if (value2!=NULL){
                 printf("Looked up non-existing key, table claims it does "
@@ -466,7 +1760,7 @@ void test_lookup_single_element()
  */
 void test_insert_lookup_different_keys()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
 
         char *key1 = copy_string("key1");
         char *key2 = copy_string("key2");
@@ -502,7 +1796,7 @@ void test_insert_lookup_different_keys()
  */
 void test_insert_lookup_same_keys()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
 
         /* Separate key to use on lookup, since it is not defined
          * which duplicate key will be removed.
@@ -540,7 +1834,7 @@ void test_insert_lookup_same_keys()
  */
 void test_remove_single_element()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
 
         char *key1 = copy_string("key1");
         char *value1 = copy_string("value1");
@@ -570,7 +1864,7 @@ void test_remove_single_element()
  */
 void test_remove_elements_different_keys()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
 
         char *key1 = copy_string("key1");
         char *key2 = copy_string("key2");
@@ -631,7 +1925,7 @@ void test_remove_elements_different_keys()
  */
 void test_remove_elements_same_keys()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
 
         /* Separate key to use in remove, since it is not defined
          * which duplicate key will be removed.
@@ -681,6 +1975,445 @@ void test_remove_elements_same_keys()
         table_kill(t);
 }
 
+/*  Tests the batched operations. Four key-value-pairs, two of them
+ *  with the same key, are inserted with one call. The three keys and a
+ *  missing key are looked up with one call and it is checked that the
+ *  latest value is returned for the duplicate key. Then the keys are
+ *  removed with one call and it is checked that the table is empty.
+ */
+/* Looks up four keys with one call and checks the values found.
+ * Exits the program if a value is wrong.
+ *    t - the table to look up in
+ *    keys - the keys to look up
+ *    expected - the expected value of each key, or NULL if missing
+ */
+void test_lookup_batch(table *t, void **keys, char **expected)
+{
+        void *found[4];
+
+        table_lookup_many(t, keys, found, 4);
+        for (int i = 0; i < 4; i++) {
+                if (expected[i] == NULL ? found[i] != NULL :
+                    found[i] == NULL || strcmp(found[i], expected[i]) != 0) {
+                        printf("Batched lookup of \"%s\" does not return "
+                               "the expected value.\n", (char *)keys[i]);
+                        exit(EXIT_FAILURE);
+                }
+        }
+}
+
+void test_batch_operations()
+{
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
+
+        void *keys[4] = { copy_string("key1"), copy_string("key2"),
+                          copy_string("key3"), copy_string("key2") };
+        void *values[4] = { copy_string("value1"), copy_string("value2"),
+                            copy_string("value3"), copy_string("value22") };
+        void *lookup_keys[4] = { "key1", "key2", "key3", "key4" };
+        char *expected[4] = { "value1", "value22", "value3", NULL };
+
+        table_insert_many(t, keys, values, 4);
+        test_lookup_batch(t, lookup_keys, expected);
+#ifdef EYTZINGER_TABLE
+        // The copy is searched with all keys in lock step
+        table_build_eytzinger(t);
+        test_lookup_batch(t, lookup_keys, expected);
+#endif
+        table_remove_many(t, lookup_keys, 4);
+        if (!table_is_empty(t)) {
+                printf("Removing all keys with one call does not "
+                       "result in an empty table.\n");
+                exit(EXIT_FAILURE);
+        }
+
+        printf("Inserting, looking up and removing keys in batches - OK\n");
+        table_kill(t);
+}
+
+/*  Tests table_stats() by inserting three different keys, looking up
+ *  two of them and a missing key and then removing one key. If the
+ *  table keeps statistics, it is checked that each operation was
+ *  counted and that the probe lengths add up.
+ */
+void test_stats()
+{
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
+        table_statistics stats;
+
+        table_insert(t, copy_string("key1"), copy_string("value1"));
+        table_insert(t, copy_string("key2"), copy_string("value2"));
+        table_insert(t, copy_string("key3"), copy_string("value3"));
+        table_lookup(t, "key1");
+        table_lookup(t, "key3");
+        table_lookup(t, "key4");
+        table_remove(t, "key2");
+        table_stats(t, &stats);
+        if (!stats.enabled) {
+                printf("Table compiled without statistics, "
+                       "skipped test of table_stats()\n");
+                table_kill(t);
+                return;
+        }
+
+        unsigned long sum = 0;
+        for (int i = 0; i < TABLE_STATS_BUCKETS; i++) {
+                sum += stats.lookup_probes.histogram[i];
+        }
+        if (stats.inserts != 3 || stats.lookups != 3 || stats.hits != 2
+            || stats.misses != 1 || stats.removes != 1
+            || stats.lookup_probes.count != 3 || sum != 3
+            || stats.lookup_probes.max * 3 < stats.lookup_probes.total) {
+                printf("table_stats() does not count the operations "
+                       "made on the table.\n");
+                exit(EXIT_FAILURE);
+        }
+
+        printf("Counting operations with table_stats() - OK\n");
+        table_kill(t);
+}
+
+/* Number of pairs seen by count_pair(). */
+int counted_pairs;
+
+/* Counts the pairs of a table with table_print(). */
+void count_pair(const void *key, const void *value)
+{
+        counted_pairs++;
+}
+
+/* Frees the pairs handed over by table_drain() and counts them. */
+void take_pair(void *key, void *value)
+{
+        counted_pairs++;
+        free(key);
+        free(value);
+}
+
+/*  Tests a table created with TABLE_UNIQUE_KEYS. Two keys are inserted
+ *  twice each, with different allocations. It is checked that the
+ *  latest values are returned and that only two pairs are stored. Then
+ *  one key is removed alone and the other in a batch with a missing
+ *  key, and it is checked that the table is empty. Finally the same
+ *  pair is inserted twice and a key is replaced, and the table is
+ *  drained, filled the same way again and killed.
+ */
+void test_unique_keys()
+{
+        table *t = table_empty_ex(string_compare, string_hash, free, free,
+                                  TABLE_UNIQUE_KEYS);
+
+        table_insert(t, copy_string("key1"), copy_string("value1"));
+        table_insert(t, copy_string("key2"), copy_string("value2"));
+        table_insert(t, copy_string("key2"), copy_string("value22"));
+        table_insert(t, copy_string("key1"), copy_string("value11"));
+        test_lookup_existing_key(t, "key1", "value11");
+        test_lookup_existing_key(t, "key2", "value22");
+
+        counted_pairs = 0;
+        table_print(t, count_pair);
+        if (counted_pairs != 2) {
+                printf("Inserting an existing key in a table with unique "
+                       "keys does not replace its pair.\n");
+                exit(EXIT_FAILURE);
+        }
+
+        void *keys[2] = { "key2", "key3" };
+        table_remove(t, "key1");
+        test_lookup_missing_key(t, "key1");
+        table_remove_many(t, keys, 2);
+        test_lookup_missing_key(t, "key2");
+        if (!table_is_empty(t)) {
+                printf("Removing all keys from a table with unique keys "
+                       "does not result in an empty table.\n");
+                exit(EXIT_FAILURE);
+        }
+
+        // Inserting the same pair again must not free it, and a replaced
+        // pair must be freed once and never handed over
+        for (int round = 0; round < 2; round++) {
+                char *key = copy_string("key4");
+                char *value = copy_string("value4");
+                table_insert(t, key, value);
+                table_insert(t, key, value);
+                table_insert(t, copy_string("key5"), copy_string("value5"));
+                table_insert(t, copy_string("key5"), copy_string("value55"));
+                if (round == 1) {
+                        break;
+                }
+                counted_pairs = 0;
+                table_drain(t, take_pair);
+                if (counted_pairs != 2) {
+                        printf("Draining a table with unique keys hands over "
+                               "%d pairs instead of 2.\n", counted_pairs);
+                        exit(EXIT_FAILURE);
+                }
+        }
+
+        printf("Inserting existing keys in a table with unique keys "
+               "replaces their pairs - OK\n");
+        table_kill(t);
+}
+
+/*  Tests table_drain() and table_clear(). Three pairs are drained and
+ *  freed by take_pair(), so the table must not free them again. Then it
+ *  is checked that the table can be used and cleared.
+ */
+void test_clear_drain()
+{
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
+
+        table_insert(t, copy_string("key1"), copy_string("value1"));
+        table_insert(t, copy_string("key2"), copy_string("value2"));
+        table_insert(t, copy_string("key3"), copy_string("value3"));
+        counted_pairs = 0;
+        table_drain(t, take_pair);
+        if (counted_pairs != 3 || !table_is_empty(t)) {
+                printf("Draining a table with three pairs hands over %d "
+                       "pairs and leaves the table %s.\n", counted_pairs,
+                       table_is_empty(t) ? "empty" : "nonempty");
+                exit(EXIT_FAILURE);
+        }
+        test_lookup_missing_key(t, "key1");
+
+        table_insert(t, copy_string("key4"), copy_string("value4"));
+        test_lookup_existing_key(t, "key4", "value4");
+        table_clear(t);
+        if (!table_is_empty(t)) {
+                printf("Clearing a table does not result in an empty "
+                       "table.\n");
+                exit(EXIT_FAILURE);
+        }
+        test_lookup_missing_key(t, "key4");
+
+        printf("Draining and clearing a table empties it - OK\n");
+        table_kill(t);
+}
+
+/* Values seen by visit_pair(), at most 3. */
+const void *visited_values[3];
+
+/* Records the values visited by table_lookup_all(). */
+void visit_pair(const void *key, const void *value)
+{
+        if (counted_pairs < 3) {
+                visited_values[counted_pairs] = value;
+        }
+        counted_pairs++;
+}
+
+/*  Tests table_lookup_all() and table_count(). The key key1 is inserted
+ *  twice, so its values must be visited latest inserted first. A table
+ *  that replaces duplicates holds only the latest pair of key1.
+ */
+void test_lookup_all_count()
+{
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
+
+        table_insert(t, copy_string("key1"), copy_string("value1"));
+        table_insert(t, copy_string("key2"), copy_string("value2"));
+        table_insert(t, copy_string("key1"), copy_string("value11"));
+
+        counted_pairs = 0;
+        table_lookup_all(t, "key1", visit_pair);
+        unsigned long n = table_count(t, "key1");
+        if (counted_pairs < 1 || counted_pairs > 2 ||
+            n != (unsigned long)counted_pairs ||
+            strcmp(visited_values[0], "value11") != 0 ||
+            (counted_pairs == 2 &&
+             strcmp(visited_values[1], "value1") != 0)) {
+                printf("Looking up all pairs of a key inserted twice visits "
+                       "%d pairs and counts %lu, expected the latest value "
+                       "first.\n", counted_pairs, n);
+                exit(EXIT_FAILURE);
+        }
+
+        counted_pairs = 0;
+        table_lookup_all(t, "key3", visit_pair);
+        if (counted_pairs != 0 || table_count(t, "key3") != 0 ||
+            table_count(t, "key2") != 1) {
+                printf("Counting the pairs of a missing key or a single "
+                       "key gives the wrong result.\n");
+                exit(EXIT_FAILURE);
+        }
+
+        printf("Looking up and counting all pairs of a key - OK\n");
+        table_kill(t);
+}
+
+#ifdef BLOOM_TABLE
+/* Prints the lookup counters and false positive rates of the filter of
+ * a table of bloomtable.c.
+ *    t - the table
+ */
+void print_bloom_stats(const table *t)
+{
+        bloom_stats bloom;
+
+        table_bloom_stats(t, &bloom);
+        printf("  filter: %lu lookups, %lu filtered, %lu false positives, "
+               "false positive rate %.5f (estimated %.5f)\n", bloom.lookups,
+               bloom.filtered, bloom.false_positives, bloom.observed_fpr,
+               bloom.estimated_fpr);
+}
+#endif
+
+/*  Prints the statistics of a table after a timed test, if it keeps
+ *  any.
+ */
+void print_stats(const table *t)
+{
+        table_statistics stats;
+        const char *names[3] = { "insert", "lookup", "remove" };
+        table_probe_stats *probes[3] = { &stats.insert_probes,
+                                         &stats.lookup_probes,
+                                         &stats.remove_probes };
+
+#ifdef BLOOM_TABLE
+        print_bloom_stats(t);
+#endif
+        table_stats(t, &stats);
+        if (!stats.enabled) {
+                printf("  (no statistics, compile with -DTABLE_STATS)\n");
+                return;
+        }
+        printf("  %lu hits, %lu misses, %lu key compares\n",
+               stats.hits, stats.misses, stats.key_compares);
+        for (int i = 0; i < 3; i++) {
+                if (probes[i]->count == 0) {
+                        continue;
+                }
+                printf("  %s probes: mean %.2f, max %lu, histogram",
+                       names[i], probes[i]->mean, probes[i]->max);
+                // Bucket b holds probe lengths from 2^(b-1) to 2^b - 1.
+                for (int b = 0; b < TABLE_STATS_BUCKETS; b++) {
+                        if (probes[i]->histogram[b] > 0) {
+                                printf(" [%lu]=%lu",
+                                       b == 0 ? 0 : 1UL << (b - 1),
+                                       probes[i]->histogram[b]);
+                        }
+                }
+                printf("\n");
+        }
+}
+
+/* Tests that reordering lookups keep the latest value of duplicates,
+ * see the top of the file.
+ */
+void test_lookup_reorder()
+{
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
+
+        table_insert(t, copy_string("key1"), copy_string("value11"));
+        table_insert(t, copy_string("key2"), copy_string("value2"));
+        table_insert(t, copy_string("key3"), copy_string("value31"));
+        for (int i = 0; i < 5; i++) {
+                test_lookup_existing_key(t, "key1", "value11");
+                test_lookup_existing_key(t, "key3", "value31");
+        }
+
+        // The older pairs have been found more often and moved forward
+        table_insert(t, copy_string("key1"), copy_string("value12"));
+        table_insert(t, copy_string("key3"), copy_string("value32"));
+        for (int i = 0; i < 5; i++) {
+                test_lookup_existing_key(t, "key2", "value2");
+                test_lookup_existing_key(t, "key3", "value32");
+                test_lookup_existing_key(t, "key1", "value12");
+        }
+
+        table_remove(t, "key1");
+        test_lookup_missing_key(t, "key1");
+        test_lookup_existing_key(t, "key3", "value32");
+        test_lookup_existing_key(t, "key2", "value2");
+        table_remove(t, "key3");
+        test_lookup_missing_key(t, "key3");
+        test_lookup_existing_key(t, "key2", "value2");
+        table_remove(t, "key2");
+        if (!table_is_empty(t)) {
+                printf("Removing all keys after reordering lookups does not "
+                       "result in an empty table.\n");
+                exit(EXIT_FAILURE);
+        }
+
+        printf("Looking up duplicates in a reordered table - OK\n");
+        table_kill(t);
+}
+
+#ifdef BLOOM_TABLE
+/* Looks up missing keys and checks that the false positive rate of
+ * the filter stays within a few times its estimate. A few false
+ * positives are allowed regardless, since the estimate may be close
+ * to zero. Exits the program if the check fails.
+ *    t - the table to look up in
+ *    first - the number of the first missing key to look up
+ *    est - set to the estimated rate
+ */
+void test_bloom_rate(table *t, int first, double *est)
+{
+        char key[32];
+        bloom_stats before;
+        bloom_stats after;
+
+        table_bloom_stats(t, &before);
+        for (int i = first; i < first + BLOOM_TEST_LOOKUPS; i++) {
+                sprintf(key, "missing%d", i);
+                if (table_lookup(t, key) != NULL) {
+                        printf("Looking up a missing key in a Bloom filter "
+                               "table finds it.\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+        table_bloom_stats(t, &after);
+
+        double rate = (double)(after.false_positives - before.false_positives)
+                / BLOOM_TEST_LOOKUPS;
+        double slack = 5.0 / BLOOM_TEST_LOOKUPS;
+        if (rate > 4*after.estimated_fpr + slack ||
+            rate < after.estimated_fpr/4 - slack) {
+                printf("The false positive rate of the Bloom filter is %.5f, "
+                       "estimated %.5f.\n", rate, after.estimated_fpr);
+                exit(EXIT_FAILURE);
+        }
+        *est = after.estimated_fpr;
+}
+
+/* Tests the false positive rate of the filter of bloomtable.c before
+ * and after it is rebuilt, see the top of the file.
+ */
+void test_bloom_rebuild()
+{
+        table *t = table_empty_hashed(string_compare, string_hash, free, free);
+        char key[32];
+        double filled;
+        double rebuilt;
+
+        for (int i = 0; i < BLOOM_TEST_KEYS; i++) {
+                sprintf(key, "key%d", i);
+                table_insert(t, copy_string(key), copy_string("value"));
+        }
+        test_bloom_rate(t, 0, &filled);
+
+        // The filter is rebuilt once more than half of its keys are stale
+        for (int i = 0; i < BLOOM_TEST_KEYS*3/4; i++) {
+                sprintf(key, "key%d", i);
+                table_remove(t, key);
+        }
+        test_bloom_rate(t, BLOOM_TEST_LOOKUPS, &rebuilt);
+        if (rebuilt >= filled) {
+                printf("Removing most keys does not lower the estimated "
+                       "false positive rate of the Bloom filter.\n");
+                exit(EXIT_FAILURE);
+        }
+        sprintf(key, "key%d", BLOOM_TEST_KEYS - 1);
+        test_lookup_existing_key(t, key, "value");
+
+        printf("False positive rate of the Bloom filter before (%.5f) and "
+               "after (%.5f) rebuild - OK\n", filled, rebuilt);
+        table_kill(t);
+}
+
+#endif
+
 /*  Tests a table by performing a set of tests. Program exits if any
  *  error is found.
  */
@@ -694,70 +2427,722 @@ void correctness_test()
         test_remove_single_element();
         test_remove_elements_different_keys();
         test_remove_elements_same_keys();
+        test_batch_operations();
+        test_stats();
+        test_unique_keys();
+        test_clear_drain();
+        test_lookup_all_count();
+        test_lookup_reorder();
+#ifdef BLOOM_TABLE
+        test_bloom_rebuild();
+#endif
+}
+
+/* Runs the warm-up and measured trials of a timed phase. Each trial
+ * uses a new table, filled with the n items unless the phase is the
+ * insert. The workload phase instead uses a table with unique keys,
+ * filled with the items of the workload. Warm-up trials are not
+ * recorded. The memory is measured on the last trial.
+ *    phase - the phase to time
+ *    keys - a set of 2*n keys, as created by speed_test()
+ *    n - the number of items
+ *    work - the workload of the workload phase, otherwise NULL
+ *    opts - the settings of the timings
+ *    result - set to the times, latencies and memory of the trials.
+ *             Its trial_ns must hold opts->trials times.
+ *
+ * Returns: The table of the last trial, to be killed by the caller.
+ */
+table *measure_phase(enum phase phase, const struct key_set *keys, int n,
+                     const struct workload *work,
+                     const struct timing_options *opts,
+                     struct phase_result *result)
+{
+        struct key_batch batch = { .count = 0 };
+        struct key_batch *lookup_buffer = opts->batch_lookups ? &batch : NULL;
+        struct alloc_counts before;
+        struct alloc_counts filled;
+        struct key_set order = { .keys = NULL };
+        table *t = NULL;
+
+        for (int trial = -opts->warmups; trial < opts->trials; trial++) {
+                unsigned long *latency = trial >= 0 && opts->latency
+                        ? result->latency : NULL;
+                unsigned long long ns = 0;
+
+                if (t != NULL) {
+                        table_kill(t);
+                }
+                if (phase == PHASE_REMOVE) {
+                        // Remove all items, not in the same order as they
+                        // were inserted. The order is not part of the time.
+                        key_set_free(&order);
+                        key_set_init(&order, n);
+                }
+                reset_peak_rss();
+                before = alloc_counts;
+                if (phase == PHASE_WORKLOAD) {
+                        t = table_empty_ex(int_compare, int_hash, free, free,
+                                           TABLE_UNIQUE_KEYS);
+                        insert_values(t,work->items,work->n_items);
+                } else {
+                        t = table_empty_hashed(int_compare, int_hash, free,
+                                               free);
+                }
+                if (phase != PHASE_INSERT && phase != PHASE_WORKLOAD) {
+                        insert_values(t,keys,n);
+                }
+#ifdef EYTZINGER_TABLE
+                // Removes drop the copy, so only lookups can use it
+                if (opts->eytzinger && phase != PHASE_INSERT &&
+                    phase != PHASE_REMOVE && phase != PHASE_WORKLOAD) {
+                        table_build_eytzinger(t);
+                }
+#endif
+                filled = alloc_counts;
+                switch (phase) {
+                case PHASE_INSERT:
+                        ns = get_insert_speed(t,keys,n,latency);
+                        break;
+                case PHASE_REMOVE:
+                        ns = get_remove_speed(t,keys,&order,n,latency);
+                        break;
+                case PHASE_MISSING_LOOKUP:
+                        ns = get_random_non_existing_lookup_speed(
+                                t,keys,n,lookup_buffer,latency);
+                        break;
+                case PHASE_RANDOM_LOOKUP:
+                        ns = get_random_existing_lookup_speed(
+                                t,keys,n,lookup_buffer,latency);
+                        break;
+                case PHASE_SKEWED_LOOKUP:
+                        ns = get_skewed_lookup_speed(t,keys,n,lookup_buffer,
+                                                     latency);
+                        break;
+                case PHASE_WORKLOAD:
+                        ns = get_workload_speed(t,work,latency);
+                        break;
+                case PHASE_THREADS:
+                        break;
+                }
+                if (trial >= 0) {
+                        struct phase_memory *m = &result->memory;
+                        result->trial_ns[trial] = ns;
+                        m->allocs = alloc_counts.count - filled.count;
+                        m->alloc_bytes = alloc_counts.bytes - filled.bytes;
+                        // The inserted table is full after the timing,
+                        // the others before it
+                        m->table_bytes = (phase == PHASE_INSERT
+                                          ? alloc_counts.live : filled.live)
+                                - before.live;
+                        m->items = work != NULL ? work->n_items : n;
+                        m->peak_rss_kb = get_peak_rss_kb();
+                }
+        }
+        key_set_free(&order);
+        return t;
+}
+
+/* Runs the trials of a timed phase, see measure_phase(), and prints
+ * the result.
+ *    phase - the phase to time
+ *    keys - a set of 2*n keys, as created by speed_test()
+ *    n - the number of items
+ *    work - the workload of the workload phase, otherwise NULL
+ *    opts - the settings of the timings
+ */
+void time_phase(enum phase phase, const struct key_set *keys, int n,
+                const struct workload *work,
+                const struct timing_options *opts)
+{
+        struct phase_result result = { 0 };
+        table *t;
+
+        result.trial_ns = malloc(opts->trials*sizeof(*result.trial_ns));
+        t = measure_phase(phase, keys, n, work, opts, &result);
+        print_phase_result(phase, work != NULL ? work->n_ops : n, &result,
+                           opts);
+        // The statistics are those of the last trial
+        if (opts->show_stats && opts->format == OUTPUT_TEXT) {
+                print_stats(t);
+        }
+        table_kill(t);
+        free(result.trial_ns);
+}
+
+/* A use of a key in a trace.
+ *    key - the key
+ *    index - the index of the operation in the trace
+ */
+struct key_use {
+        int key;
+        int index;
+};
+
+/* Compares two uses of keys for qsort(), by key and then by index.
+ *    a, b - pointers to the struct key_use to compare
+ */
+int compare_key_uses(const void *a, const void *b)
+{
+        const struct key_use *x = a;
+        const struct key_use *y = b;
+        if (x->key != y->key) {
+                return (x->key > y->key) - (x->key < y->key);
+        }
+        return (x->index > y->index) - (x->index < y->index);
+}
+
+/* Sets up a workload that replays a trace. The items are the keys that
+ * the trace uses before it inserts them, if ever, in random order.
+ * Exits if the trace cannot be read.
+ *    w - the workload to set up
+ *    path - the file of the trace
+ */
+void load_trace_workload(struct workload *w, const char *path)
+{
+        w->ops = workload_load_trace(path, &w->n_ops);
+        if (w->ops == NULL) {
+                exit(EXIT_FAILURE);
+        }
+
+        struct key_use *uses = malloc((w->n_ops+1)*sizeof(*uses));
+        for (int i = 0; i < w->n_ops; i++) {
+                uses[i].key = w->ops[i].key;
+                uses[i].index = i;
+        }
+        qsort(uses, w->n_ops, sizeof(*uses), compare_key_uses);
+
+        // The first use of each key decides if it is an item
+        int *items = malloc((w->n_ops+1)*sizeof(*items));
+        w->n_items = 0;
+        for (int i = 0; i < w->n_ops; i++) {
+                if ((i == 0 || uses[i].key != uses[i-1].key) &&
+                    w->ops[uses[i].index].type != WORKLOAD_INSERT) {
+                        items[w->n_items++] = uses[i].key;
+                }
+        }
+        random_shuffle(items, w->n_items);
+        free(uses);
+
+        w->trace_items.size = w->n_items;
+        w->trace_items.keys = items;
+        w->items = &w->trace_items;
+        w->records = NULL;
+        w->max_scan = 1;
+}
+
+/* Sets up a generated workload of n operations on a table with n
+ * items. Inserts add the keys after the items. Exits if the settings
+ * are invalid.
+ *    w - the workload to set up
+ *    keys - a set of 2*n keys, the first n of which are the items
+ *    n - the number of items and operations
+ *    config - the settings of the workload
+ */
+void generate_workload(struct workload *w, const struct key_set *keys,
+                       int n, const workload_config *config)
+{
+        w->ops = workload_generate(config, NULL, n, 2*n, n);
+        if (w->ops == NULL) {
+                fprintf(stderr,"Error: invalid workload settings.\n");
+                exit(EXIT_FAILURE);
+        }
+        // The records are the positions of their keys in the key set
+        for (int i = 0; i < n; i++) {
+                w->ops[i].key = key_at(keys, w->ops[i].record);
+        }
+        w->n_ops = n;
+        w->items = keys;
+        w->n_items = n;
+        w->records = keys;
+        w->max_scan = config->max_scan_length;
 }
 
 /* Tests the speed of a table using random numbers. First a number of
  * elements are inserted. Second a random lookup among the elements are
  * done followed by a skewed lookup (where a subset of the keys are
- * looked up more frequently). Finally all elements are removed.
+ * looked up more frequently). Finally all elements are removed. If a
+ * workload is chosen, only its phase is run.
+ *
+ * Each phase is run for every implementation in turn, with the same
+ * keys in the same order and the same random numbers, so that they
+ * can be compared side by side.
  */
-void speed_test(int n,bool machine_table)
+void speed_test(int n,const struct timing_options *opts)
 {
         int randomsize = 2*n; // To make it easier testing
                               // non-existing keys later
-        int *keys = malloc(randomsize*sizeof(int));
-        int *values = malloc(randomsize*sizeof(int));
-        create_random_sample(keys, randomsize);
-        create_random_sample(values, n);
+        struct key_set keys;
+        struct workload work = { 0 };
+        int first = PHASE_INSERT;
+        int last = PHASE_SKEWED_LOOKUP;
+        key_set_init(&keys, randomsize);
+
+        if (opts->trace != NULL) {
+                load_trace_workload(&work, opts->trace);
+        } else if (opts->workload) {
+                generate_workload(&work, &keys, n, &opts->config);
+        }
+        if (work.ops != NULL) {
+                first = last = PHASE_WORKLOAD;
+        }
 
-        table *t = table_empty(int_compare, free, free);
-        get_insert_speed(t, keys, values, n, machine_table);
-        table_kill(t);
+        for (int phase = first; phase <= last; phase++) {
+                uint64_t seed = workload_rng_next(&rng);
+                for (int i = 0; i < impl_count(); i++) {
+                        select_impl(i);
+                        if (impl_string_keys_only()) {
+                                continue;
+                        }
+                        workload_rng_seed(&rng, seed);
+                        time_phase(phase, &keys, n,
+                                   work.ops != NULL ? &work : NULL, opts);
+                }
+        }
 
-        t = table_empty(int_compare, free, free);
-        insert_values(t,keys,values,n);
-        get_remove_speed(t, keys, n, machine_table);
-        table_kill(t);
+        free(work.ops);
+        free(work.trace_items.keys);
+        key_set_free(&keys);
+}
 
-        t = table_empty(int_compare, free, free);
-        insert_values(t,keys,values,n);
-        get_random_non_existing_lookup_speed(t, keys, n, machine_table);
-        table_kill(t);
+/* Runs the timings for every n of a sweep and prints the mean and
+ * confidence interval of the runs at each n. Each run uses new keys,
+ * and a new generated workload if one is chosen, and times every
+ * phase for every implementation in turn as speed_test() does. The
+ * time of a run is the median of its trials. Latencies are not
+ * recorded.
+ */
+void sweep_test(const struct timing_options *opts)
+{
+        struct timing_options run_opts = *opts;
+        struct timing_summary s;
+        int first = opts->workload ? PHASE_WORKLOAD : PHASE_INSERT;
+        int last = opts->workload ? PHASE_WORKLOAD : PHASE_SKEWED_LOOKUP;
+        int n_phases = last - first + 1;
+        int cells = impl_count()*n_phases;
+        int points = (opts->sweep_stop - opts->sweep_start)/opts->sweep_step
+                + 1;
+        unsigned long long *run_ns = malloc(cells*opts->runs*sizeof(*run_ns));
+        struct phase_memory *memory = malloc(cells*sizeof(*memory));
+        struct phase_result result;
+
+        run_opts.latency = false;
+        result.trial_ns = malloc(opts->trials*sizeof(*result.trial_ns));
+        for (int p = 0; p < points; p++) {
+                int n = opts->sweep_start + p*opts->sweep_step;
+                fprintf(stderr,"Sweep n=%d (%d of %d)...\n",n,p+1,points);
+                for (int run = 0; run < opts->runs; run++) {
+                        struct key_set keys;
+                        struct workload work = { 0 };
+                        key_set_init(&keys, 2*n);
+                        if (opts->workload) {
+                                workload_config config = opts->config;
+                                config.seed = workload_rng_next(&rng);
+                                generate_workload(&work, &keys, n, &config);
+                        }
+                        for (int phase = first; phase <= last; phase++) {
+                                uint64_t seed = workload_rng_next(&rng);
+                                for (int i = 0; i < impl_count(); i++) {
+                                        int cell = i*n_phases + phase - first;
+                                        select_impl(i);
+                                        if (impl_string_keys_only()) {
+                                                continue;
+                                        }
+                                        workload_rng_seed(&rng, seed);
+                                        table_kill(measure_phase(
+                                                phase, &keys, n,
+                                                opts->workload ? &work : NULL,
+                                                &run_opts, &result));
+                                        summarize_trials(result.trial_ns,
+                                                         opts->trials, &s);
+                                        run_ns[cell*opts->runs + run] =
+                                                llround(s.median);
+                                        memory[cell] = result.memory;
+                                }
+                        }
+                        free(work.ops);
+                        key_set_free(&keys);
+                }
+                for (int i = 0; i < impl_count(); i++) {
+                        select_impl(i);
+                        if (impl_string_keys_only()) {
+                                continue;
+                        }
+                        for (int phase = first; phase <= last; phase++) {
+                                int cell = i*n_phases + phase - first;
+                                print_sweep_point(phase, n,
+                                                  &run_ns[cell*opts->runs],
+                                                  &memory[cell], opts);
+                        }
+                }
+        }
+        free(result.trial_ns);
+        free(memory);
+        free(run_ns);
+}
 
-        t = table_empty(int_compare, free, free);
-        insert_values(t,keys,values,n);
-        get_random_existing_lookup_speed(t, keys, n, machine_table);
-        table_kill(t);
+/* Tests the throughput of a table shared by threads. Each thread
+ * performs n operations on a table with n elements, first with one
+ * thread, then with twice as many threads up to max_threads. Unless
+ * the selected implementation is thread-safe, all table calls are made
+ * under one global lock.
+ */
+void thread_speed_test(int n,int max_threads,enum output_format format)
+{
+        struct key_set keys;
+        key_set_init(&keys, 2*n);
+        pthread_mutex_t global_lock;
+        pthread_mutex_t *lock = NULL;
+        double single = 0;
+
+        if (!impl_thread_safe()) {
+                lock = &global_lock;
+                pthread_mutex_init(lock, NULL);
+        }
 
-        t = table_empty(int_compare, free, free);
-        insert_values(t,keys,values,n);
-        get_skewed_lookup_speed(t, keys, n, machine_table);
-        table_kill(t);
+        int threads = 1;
+        while (true) {
+                double throughput = get_thread_throughput(&keys, n, threads,
+                                                          lock);
+                if (threads == 1) {
+                        single = throughput;
+                }
+                switch (format) {
+                case OUTPUT_TEXT:
+                        print_impl_label();
+                        printf("%2d threads, %5d operations each : ",
+                               threads, n);
+                        printf("%.0f ops/s (%.2fx).\n", throughput,
+                               throughput/single);
+                        break;
+                case OUTPUT_CSV:
+                        printf("%s,%d,threads,%d,%d,%.0f\n",impl_name(),
+                               PHASE_THREADS,threads,n,throughput);
+                        break;
+                case OUTPUT_JSON:
+                        begin_json_result();
+                        printf("{\"impl\": \"%s\", \"test\": %d, "
+                               "\"phase\": \"threads\", \"threads\": %d, "
+                               "\"n\": %d, \"ops_per_s\": %.0f}",
+                               impl_name(),PHASE_THREADS,threads,n,
+                               throughput);
+                        break;
+                }
+                if (threads == max_threads) {
+                        break;
+                }
+                threads = 2*threads < max_threads ? 2*threads : max_threads;
+        }
 
-        free(keys);
-        free(values);
+        if (lock != NULL) {
+                pthread_mutex_destroy(lock);
+        }
+        key_set_free(&keys);
 }
 
 #define NAME "tabletest"
 
+/* Returns the number given to a switch, either directly after the
+ * switch letter or as the next argument.
+ *    argc, argv - the arguments of the program
+ *    i - the index of the switch, moved past a separate number
+ */
+int switch_value(int argc, char **argv, int *i)
+{
+        char *s = argv[*i];
+
+        if (s[2] != '\0') {
+                return atoi(s+2);
+        }
+        if (*i+1 < argc) {
+                return atoi(argv[++*i]);
+        }
+        return -1;
+}
+
+/* Returns true if the first len characters of s are name.
+ *    s - the string to check
+ *    len - the number of characters to compare
+ *    name - the name to compare with
+ */
+bool matches(const char *s, size_t len, const char *name)
+{
+        return len == strlen(name) && strncmp(s, name, len) == 0;
+}
+
+/* Sets the distribution of a workload from the argument of --dist,
+ * e.g. zipf:0.9 or hotspot:0.1:0.9.
+ *    s - the argument
+ *    config - the settings to change
+ *
+ * Returns: true if the argument names a distribution with at most as
+ * many parameters as it takes.
+ */
+bool parse_distribution(const char *s, workload_config *config)
+{
+        const char *params = strchr(s, ':');
+        size_t len = params != NULL ? (size_t)(params - s) : strlen(s);
+        double a = 0;
+        double b = 0;
+        int n_params = 0;
+
+        if (params != NULL) {
+                n_params = sscanf(params, ":%lf:%lf", &a, &b);
+                if (n_params < 1) {
+                        return false;
+                }
+        }
+        if (matches(s, len, "uniform") && n_params == 0) {
+                config->distribution = WORKLOAD_UNIFORM;
+        } else if (matches(s, len, "sequential") && n_params == 0) {
+                config->distribution = WORKLOAD_SEQUENTIAL;
+        } else if ((matches(s, len, "zipf") || matches(s, len, "latest"))
+                   && n_params <= 1) {
+                config->distribution = s[0] == 'z' ? WORKLOAD_ZIPFIAN
+                        : WORKLOAD_LATEST;
+                if (n_params == 1) {
+                        config->theta = a;
+                }
+        } else if (matches(s, len, "hotspot")) {
+                config->distribution = WORKLOAD_HOTSPOT;
+                if (n_params >= 1) {
+                        config->hot_fraction = a;
+                }
+                if (n_params == 2) {
+                        config->hot_probability = b;
+                }
+        } else {
+                return false;
+        }
+        return true;
+}
+
+/* Sets the values of n of a sweep from the argument of --sweep,
+ * start:stop:step.
+ *    s - the argument
+ *    opts - the settings to change
+ *
+ * Returns: true if the argument holds a positive start, a stop at least
+ * as large and a positive step.
+ */
+bool parse_sweep(const char *s, struct timing_options *opts)
+{
+        char end;
+
+        if (sscanf(s, "%d:%d:%d%c", &opts->sweep_start, &opts->sweep_stop,
+                   &opts->sweep_step, &end) != 3) {
+                return false;
+        }
+        return opts->sweep_start >= 1 &&
+                opts->sweep_stop >= opts->sweep_start &&
+                opts->sweep_step >= 1;
+}
+
+/* Sets the mix of operations of a workload from the argument of --mix,
+ * the proportions of reads, updates, inserts, scans and
+ * read-modify-writes separated by colons. Missing ones are zero.
+ *    s - the argument
+ *    config - the settings to change
+ *
+ * Returns: true if the argument holds at least one proportion.
+ */
+bool parse_mix(const char *s, workload_config *config)
+{
+        double mix[5] = { 0 };
+
+        if (sscanf(s, "%lf:%lf:%lf:%lf:%lf", &mix[0], &mix[1], &mix[2],
+                   &mix[3], &mix[4]) < 1) {
+                return false;
+        }
+        config->read = mix[0];
+        config->update = mix[1];
+        config->insert = mix[2];
+        config->scan = mix[3];
+        config->read_modify_write = mix[4];
+        return true;
+}
+
+/* Handles a switch that starts with --. Exits with an error message if
+ * the switch or its argument is bad.
+ *    s - the switch
+ *    opts - the settings of the timings to change
+ *    impl_names - set to the argument of --impl
+ *    prog - the name of the program
+ */
+void parse_long_switch(const char *s, struct timing_options *opts,
+                       const char **impl_names, const char *prog)
+{
+        const char *arg = strchr(s, '=');
+        bool ok = arg != NULL;
+
+        if (!ok) {
+                // All long switches take an argument
+        } else if (strncmp(s, "--impl=", 7) == 0) {
+                *impl_names = arg+1;
+        } else if (strncmp(s, "--ycsb=", 7) == 0) {
+                ok = arg[2] == '\0' &&
+                        workload_config_ycsb(&opts->config, arg[1]) == 0;
+                opts->workload = true;
+        } else if (strncmp(s, "--dist=", 7) == 0) {
+                ok = parse_distribution(arg+1, &opts->config);
+                opts->workload = true;
+        } else if (strncmp(s, "--mix=", 6) == 0) {
+                ok = parse_mix(arg+1, &opts->config);
+                opts->workload = true;
+        } else if (strncmp(s, "--trace=", 8) == 0) {
+                opts->trace = arg+1;
+        } else if (strncmp(s, "--sweep=", 8) == 0) {
+                ok = parse_sweep(arg+1, opts);
+        } else if (strncmp(s, "--runs=", 7) == 0) {
+                opts->runs = atoi(arg+1);
+                ok = opts->runs >= 1;
+        } else if (strncmp(s, "--seed=", 7) == 0) {
+                char *end;
+                opts->config.seed = strtoull(arg+1, &end, 10);
+                ok = end != arg+1 && *end == '\0';
+        } else {
+                ok = false;
+        }
+        if (!ok) {
+                fprintf(stderr,"%s: Bad switch: %s.\n",prog,s);
+                exit(EXIT_FAILURE);
+        }
+}
+
+#ifdef TABLE_OPS
+/* Sets the implementations to test. Exits with an error message if a
+ * name is not registered.
+ *    names - comma-separated names given with --impl, or NULL for all
+ *            registered implementations
+ *    prog - the name of the program
+ */
+void choose_impls(const char *names, const char *prog)
+{
+        if (names == NULL) {
+                n_impls = table_impl_count();
+                impls = malloc(n_impls*sizeof(*impls));
+                for (int i = 0; i < n_impls; i++) {
+                        impls[i] = table_impl_get(i);
+                }
+                return;
+        }
+
+        char *list = copy_string(names);
+        int max = 1;
+        for (const char *c = names; *c != '\0'; c++) {
+                max += *c == ',';
+        }
+        impls = malloc(max*sizeof(*impls));
+        n_impls = 0;
+        for (char *name = strtok(list, ","); name != NULL;
+             name = strtok(NULL, ",")) {
+                impls[n_impls] = table_impl_find(name);
+                if (impls[n_impls] == NULL) {
+                        fprintf(stderr,"%s: Unknown implementation %s, "
+                                "choose from",prog,name);
+                        for (int i = 0; i < table_impl_count(); i++) {
+                                fprintf(stderr," %s",table_impl_get(i)->name);
+                        }
+                        fprintf(stderr,".\n");
+                        exit(EXIT_FAILURE);
+                }
+                n_impls++;
+        }
+        free(list);
+        if (n_impls == 0) {
+                fprintf(stderr,"%s: No implementation given to --impl.\n",
+                        prog);
+                exit(EXIT_FAILURE);
+        }
+}
+#endif
+
 int main(int argc,char **argv)
 {
 	bool do_test=true; // Should we run the testing code?
-	bool machine_table=false; // Should we output a machine-readable table?
+	bool do_timing=true; // Should we run the timing code?
+	struct timing_options opts = {
+		.warmups = 0, // Untimed trials before the timed ones
+		.trials = 1, // Timed trials of each phase
+		.latency = false, // Should the latency of each call be recorded?
+		.batch_lookups = false, // Should lookups be done in batches?
+		.show_stats = false, // Should table statistics be printed?
+		.show_memory = false, // Should the memory used be printed?
+		.eytzinger = false, // Should lookups use the Eytzinger copy?
+		.format = OUTPUT_TEXT, // How should the timings be printed?
+		.workload = false, // Should a workload be timed instead?
+		.trace = NULL, // File of a workload to replay
+		.sweep_step = 0, // Step between the values of n of a sweep
+		.runs = 0 // Runs at each n of a sweep, 0 if not given
+	};
+	int max_threads=0; // Number of threads to share the table, 0 if none
+	const char *impl_names=NULL; // Implementations given with --impl
         int n=-1;
 
         fprintf(stderr,NAME " " VERSION " (" VERSION_DATE ")\n");
+	workload_config_default(&opts.config);
 
 	for (int i=1; i<argc; i++) {
 		// Parse each argument
 		char *s=argv[i];
 		if (strlen(s)>0 && s[0]=='-') {
 			switch (s[1]) {
+			case '-':
+				parse_long_switch(s,&opts,&impl_names,argv[0]);
+				break;
 			case 'n':
 				do_test=false;
 				break;
+			case 'c':
+				do_timing=false;
+				break;
 			case 't':
-				machine_table=true;
+				opts.format=OUTPUT_CSV;
+				break;
+			case 'J':
+				opts.format=OUTPUT_JSON;
+				break;
+			case 'b':
+				opts.batch_lookups=true;
+				break;
+			case 's':
+				opts.show_stats=true;
+				break;
+			case 'l':
+				opts.latency=true;
+				break;
+			case 'M':
+				opts.show_memory=true;
+				break;
+			case 'e':
+				opts.eytzinger=true;
+				break;
+			case 'w':
+				opts.warmups=switch_value(argc,argv,&i);
+				if (opts.warmups<0) {
+					fprintf(stderr,"%s: Number of warm-up "
+						"trials must be at least 0.\n",
+						argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			case 'r':
+				opts.trials=switch_value(argc,argv,&i);
+				if (opts.trials<1) {
+					fprintf(stderr,"%s: Number of trials "
+						"must be at least 1.\n",
+						argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			case 'j':
+				max_threads=switch_value(argc,argv,&i);
+				if (max_threads<1 || max_threads>MAX_THREADS) {
+					fprintf(stderr,"%s: Number of threads "
+						"must be from 1 to %d.\n",
+						argv[0],MAX_THREADS);
+					exit(EXIT_FAILURE);
+				}
 				break;
 			default:
 				fprintf(stderr,"%s: Bad switch: %s.\n",
@@ -771,28 +3156,148 @@ int main(int argc,char **argv)
 		}
 	}
 
-        if (n<0) {
-                fprintf(stderr,"Usage:\n\t%s [-n] [-t] n\n"
-			"\twhere n is an integer from 1 to %d.\n\n"
+        if ((n<0) == (opts.sweep_step==0)) {
+                fprintf(stderr,"Usage:\n\t%s [-n] [-c] [-t] [-J] [-b] [-s] [-l] [-M] [-e]\n"
+			"\t[-w warmups] [-r trials] [-j threads] [--impl=names] [--ycsb=letter]\n"
+			"\t[--dist=name[:params]] [--mix=r:u:i:s:m] [--trace=file]\n"
+			"\t[--seed=seed] n | --sweep=start:stop:step [--runs=runs]\n"
+			"\twhere n is an integer from 1 to %d, the number of items.\n\n"
 			"\tUse -n (no-test) to skip the testing.\n"
-			"\tUse -t (table) to output a machine-readable table with the timings.\n",
-			argv[0],TABLESIZE);
+			"\tUse -c (correctness) to skip the timings.\n"
+			"\tUse -t (table) to output the timings as CSV.\n"
+			"\tUse -J (JSON) to output the timings as JSON.\n"
+			"\tUse -w (warm-up) to run each timing warmups times before measuring.\n"
+			"\tUse -r (repeat) to measure each timing trials times and print\n"
+			"\tthe min, median, 99th percentile and standard deviation.\n"
+			"\tUse -l (latency) to print a histogram of the latency of each call.\n"
+			"\tUse -M (memory) to print the memory used by each timing. Build\n"
+			"\twith -DALLOC_STATS as makebench.sh does to count allocations.\n"
+			"\tUse -b (batch) to do the timed lookups with table_lookup_many().\n"
+			"\tUse -s (stats) to print table_stats() after each timing.\n"
+			"\tUse -e (Eytzinger) to do the timed lookups in the copy made by\n"
+			"\ttable_build_eytzinger() of sortedtable.c. Build with\n"
+			"\t-DEYTZINGER_TABLE as makesorted.sh does.\n"
+			"\tUse -j (jobs) to measure the throughput of 1 up to threads threads\n"
+			"\tsharing one table instead of the timings.\n"
+			"\tUse --impl to choose the implementations of a program built with\n"
+			"\tmakebench.sh, e.g. --impl=dlist,mtf,array. All are used by default.\n"
+			"\tUse --ycsb to time the YCSB core workload a to f instead of the\n"
+			"\ttimings, --dist to choose its distribution, zipf[:theta],\n"
+			"\tlatest[:theta], hotspot[:fraction[:probability]], uniform or\n"
+			"\tsequential, and --mix to choose the proportions of reads,\n"
+			"\tupdates, inserts, scans and read-modify-writes. n operations are\n"
+			"\tdone on n items. The default is uniform reads.\n"
+			"\tUse --trace to replay the operations of a file instead, one per\n"
+			"\tline as r, u, i, m or d and a key, see workload.h.\n"
+			"\tUse --seed to seed the random numbers, 1 by default.\n"
+			"\tUse --sweep instead of n to run the timings for n from start to\n"
+			"\tstop in steps of step, each runs times with new keys, 1 by\n"
+			"\tdefault, and print the mean and 95%% confidence interval of the\n"
+			"\truns at each n as CSV, or as JSON with -J.\n",
+			argv[0],INT_MAX/2);
 		exit(EXIT_FAILURE);
 	}
-	if (n<1 || n>TABLESIZE) {
+        if (opts.sweep_step>0) {
+                if (max_threads>0 || opts.trace!=NULL) {
+                        fprintf(stderr,"%s: --sweep cannot be used with "
+                                "-j or --trace.\n",argv[0]);
+                        exit(EXIT_FAILURE);
+                }
+                n=opts.sweep_stop;
+                if (opts.format==OUTPUT_TEXT) {
+                        opts.format=OUTPUT_CSV;
+                }
+        } else if (opts.runs>0) {
+                fprintf(stderr,"%s: --runs needs --sweep.\n",argv[0]);
+                exit(EXIT_FAILURE);
+        }
+        if (opts.runs==0) {
+                opts.runs=1;
+        }
+	// The keys 0 to 2n-1 and the own keys of the threads must be ints
+	int max_n = INT_MAX/(2+max_threads);
+	if (n<1 || n>max_n) {
 		fprintf(stderr,"Error: supplied value of n (%d) is outside "
-                        "allowed range 1-%d.\n",n,TABLESIZE);
+                        "allowed range 1-%d.\n",n,max_n);
+                exit(EXIT_FAILURE);
+        }
+#ifndef EYTZINGER_TABLE
+        if (opts.eytzinger) {
+                fprintf(stderr,"%s: -e needs a program built with "
+                        "-DEYTZINGER_TABLE and sortedtable.c.\n",argv[0]);
+                exit(EXIT_FAILURE);
+        }
+#endif
+#ifdef TABLE_OPS
+        choose_impls(impl_names,argv[0]);
+#else
+        if (impl_names!=NULL) {
+                fprintf(stderr,"%s: --impl needs a program built with "
+                        "makebench.sh.\n",argv[0]);
                 exit(EXIT_FAILURE);
         }
-	if (do_test) {
+#endif
+        workload_rng_seed(&rng,opts.config.seed);
+	for (int i=0; do_test && i<impl_count(); i++) {
+                select_impl(i);
+                if (impl_int_keys_only()) {
+                        printf("Skipping the tests of %s, which only takes "
+                               "int keys.\n\n",impl_name());
+                        continue;
+                }
+#ifdef TABLE_OPS
+		printf("Testing %s...\n",impl_name());
+#else
 		printf("Testing...\n");
+#endif
 		correctness_test();
 		printf("All correctness tests succeeded!\n\n");
 	}
         /*getchar();*/
-        speed_test(n,machine_table);
-        if (!machine_table) {
+        if (do_timing && opts.sweep_step>0 && opts.format==OUTPUT_CSV) {
+                printf("impl,test,phase,n,runs,mean_ns,stddev_ns,ci95_low_ns,"
+                       "ci95_high_ns,mean_ns_per_op,allocs,alloc_bytes,"
+                       "table_bytes,bytes_per_entry,peak_rss_kb\n");
+        } else if (do_timing && opts.sweep_step>0) {
+                printf("{\"version\": \"" VERSION "\", \"sweep\": "
+                       "{\"start\": %d, \"stop\": %d, \"step\": %d}, "
+                       "\"runs\": %d, \"warmups\": %d, \"trials\": %d, "
+                       "\"results\": [\n", opts.sweep_start, opts.sweep_stop,
+                       opts.sweep_step, opts.runs, opts.warmups, opts.trials);
+        } else if (do_timing && opts.format==OUTPUT_CSV) {
+                printf(max_threads>0
+                       ? "impl,test,phase,threads,n,ops_per_s\n"
+                       : "impl,test,phase,n,trials,min_ns,median_ns,p99_ns,"
+                       "mean_ns,stddev_ns,latency_histogram,allocs,"
+                       "alloc_bytes,table_bytes,bytes_per_entry,"
+                       "peak_rss_kb\n");
+        } else if (do_timing && opts.format==OUTPUT_JSON) {
+                printf("{\"version\": \"" VERSION "\", \"n\": %d, "
+                       "\"warmups\": %d, \"trials\": %d, \"results\": [\n",
+                       n, opts.warmups, opts.trials);
+        }
+        for (int i=0; do_timing && max_threads>0 && i<impl_count(); i++) {
+                select_impl(i);
+                if (impl_string_keys_only()) {
+                        continue;
+                }
+                // Every implementation gets the same keys
+                workload_rng_seed(&rng,opts.config.seed);
+                thread_speed_test(n,max_threads,opts.format);
+        }
+        if (do_timing && opts.sweep_step>0) {
+                sweep_test(&opts);
+        } else if (do_timing && max_threads==0) {
+                speed_test(n,&opts);
+        }
+        if (do_timing && opts.format==OUTPUT_JSON) {
+                printf("\n]}\n");
+        }
+        if (opts.format==OUTPUT_TEXT) {
 		printf("Test completed.\n");
 	}
+#ifdef TABLE_OPS
+        free(impls);
+#endif
         return 0;
 }
@@ -0,0 +1,630 @@
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "workload.h"
+
+/*
+ * Generation and loading of workloads, see workload.h.
+ *
+ * The zipfian distribution uses the method of Gray et al., "Quickly
+ * generating billion-record synthetic databases" (SIGMOD 1994), which
+ * draws a rank in constant time once the zeta constant of the number
+ * of records is known. Like in YCSB, the constant is extended term by
+ * term as inserts add records, so a workload of n operations costs
+ * O(records + n) to generate.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ *   2026-10-18: v1.1, workload_generate() takes NULL for the keys.
+ */
+
+// Initial capacity of the operations of a trace.
+#define TRACE_CAPACITY 1024
+
+// Longest line of a trace, including the newline.
+#define TRACE_LINE_LENGTH 256
+
+// ===========INTERNAL DATA TYPES============
+
+// State of a zipfian distribution over the ranks 0 to n-1.
+struct zipfian {
+	int n;
+	double theta;
+	double alpha;
+	double zeta2;
+	double zetan;
+	double eta;
+};
+
+// State of the generation of a workload.
+struct generator {
+	const workload_config *config;
+	workload_rng rng;
+	struct zipfian zipf;
+	// Number of records in the table so far.
+	int records;
+	// Next record of WORKLOAD_SEQUENTIAL.
+	int next;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * rotl() - Rotate a 64-bit number to the left.
+ * @x: Number to rotate.
+ * @k: Number of bits, from 1 to 63.
+ *
+ * Returns: The rotated number.
+ */
+static uint64_t rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * splitmix64() - Step a splitmix64 generator.
+ * @state: State of the generator.
+ *
+ * Returns: The next number of the generator.
+ */
+static uint64_t splitmix64(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/**
+ * zeta() - Add the terms of a zeta constant.
+ * @from: First rank, counting from 1.
+ * @to: Last rank.
+ * @theta: Skew of the distribution.
+ *
+ * Returns: The sum of 1/i^theta for i from from to to.
+ */
+static double zeta(int from, int to, double theta)
+{
+	double sum = 0;
+
+	for (int i = from; i <= to; i++) {
+		sum += 1 / pow(i, theta);
+	}
+	return sum;
+}
+
+/**
+ * zipfian_init() - Set up a zipfian distribution without ranks.
+ * @z: Distribution to set up.
+ * @theta: Skew of the distribution, between 0 and 1.
+ *
+ * The ranks are added by zipfian_resize() before the first draw.
+ *
+ * Returns: Nothing.
+ */
+static void zipfian_init(struct zipfian *z, double theta)
+{
+	z->n = 0;
+	z->theta = theta;
+	z->alpha = 1 / (1 - theta);
+	z->zeta2 = zeta(1, 2, theta);
+	z->zetan = 0;
+	z->eta = 0;
+}
+
+/**
+ * zipfian_resize() - Change the number of ranks of a distribution.
+ * @z: Distribution to change.
+ * @n: New number of ranks, at least the old one.
+ *
+ * Only the new terms of the zeta constant are computed.
+ *
+ * Returns: Nothing.
+ */
+static void zipfian_resize(struct zipfian *z, int n)
+{
+	if (n == z->n) {
+		return;
+	}
+	z->zetan += zeta(z->n + 1, n, z->theta);
+	z->n = n;
+	z->eta = (1 - pow(2.0 / n, 1 - z->theta)) / (1 - z->zeta2 / z->zetan);
+}
+
+/**
+ * zipfian_next() - Draw a rank from a zipfian distribution.
+ * @z: Distribution to draw from.
+ * @rng: Generator to draw with.
+ *
+ * Returns: A rank from 0 to n-1, where lower ranks are more likely.
+ */
+static int zipfian_next(const struct zipfian *z, workload_rng *rng)
+{
+	double u = workload_rng_double(rng);
+	double uz = u * z->zetan;
+
+	if (uz < 1) {
+		return 0;
+	}
+	if (uz < 1 + pow(0.5, z->theta) && z->n > 1) {
+		return 1;
+	}
+
+	int rank = (int)(z->n * pow(z->eta * u - z->eta + 1, z->alpha));
+
+	// Guard against rounding at the top end.
+	return rank < z->n ? rank : z->n - 1;
+}
+
+/**
+ * choose_record() - Choose the record of an operation.
+ * @g: State of the generation.
+ *
+ * Returns: A record from 0 to g->records-1.
+ */
+static int choose_record(struct generator *g)
+{
+	const workload_config *c = g->config;
+	int records = g->records;
+
+	switch (c->distribution) {
+	case WORKLOAD_ZIPFIAN:
+		zipfian_resize(&g->zipf, records);
+		return zipfian_next(&g->zipf, &g->rng);
+	case WORKLOAD_LATEST:
+		zipfian_resize(&g->zipf, records);
+		return records - 1 - zipfian_next(&g->zipf, &g->rng);
+	case WORKLOAD_HOTSPOT: {
+		int hot = (int)(c->hot_fraction * records);
+
+		if (hot < 1) {
+			hot = 1;
+		}
+		if (hot == records ||
+		    workload_rng_double(&g->rng) < c->hot_probability) {
+			return (int)workload_rng_below(&g->rng, hot);
+		}
+		return hot + (int)workload_rng_below(&g->rng, records - hot);
+	}
+	case WORKLOAD_SEQUENTIAL:
+		if (g->next >= records) {
+			g->next = 0;
+		}
+		return g->next++;
+	default:
+		return (int)workload_rng_below(&g->rng, records);
+	}
+}
+
+/**
+ * choose_type() - Choose the type of an operation.
+ * @g: State of the generation.
+ * @total: Sum of the fractions of the operation types.
+ *
+ * Returns: The type of the operation.
+ */
+static workload_op_type choose_type(struct generator *g, double total)
+{
+	const workload_config *c = g->config;
+	double x = workload_rng_double(&g->rng) * total;
+
+	if ((x -= c->read) < 0) {
+		return WORKLOAD_READ;
+	}
+	if ((x -= c->update) < 0) {
+		return WORKLOAD_UPDATE;
+	}
+	if ((x -= c->insert) < 0) {
+		return WORKLOAD_INSERT;
+	}
+	if ((x -= c->scan) < 0) {
+		return WORKLOAD_SCAN;
+	}
+	if (c->read_modify_write > 0) {
+		return WORKLOAD_READ_MODIFY_WRITE;
+	}
+	// Rounding left x at the top end, take the last type in use.
+	if (c->scan > 0) {
+		return WORKLOAD_SCAN;
+	}
+	if (c->insert > 0) {
+		return WORKLOAD_INSERT;
+	}
+	return c->update > 0 ? WORKLOAD_UPDATE : WORKLOAD_READ;
+}
+
+/**
+ * valid_config() - Check the settings of a workload.
+ * @c: Settings to check.
+ *
+ * Returns: True if the settings can generate a workload.
+ */
+static bool valid_config(const workload_config *c)
+{
+	double fractions[] = {c->read, c->update, c->insert, c->scan,
+			      c->read_modify_write};
+	double total = 0;
+
+	for (int i = 0; i < 5; i++) {
+		if (!(fractions[i] >= 0)) {
+			return false;
+		}
+		total += fractions[i];
+	}
+	if (!(total > 0) || c->max_scan_length < 1) {
+		return false;
+	}
+	if ((c->distribution == WORKLOAD_ZIPFIAN ||
+	     c->distribution == WORKLOAD_LATEST) &&
+	    !(c->theta > 0 && c->theta < 1)) {
+		return false;
+	}
+	if (c->distribution == WORKLOAD_HOTSPOT &&
+	    !(c->hot_fraction > 0 && c->hot_fraction <= 1 &&
+	      c->hot_probability >= 0 && c->hot_probability <= 1)) {
+		return false;
+	}
+	return true;
+}
+
+/**
+ * parse_trace_line() - Parse one line of a trace.
+ * @line: Line to parse.
+ * @op: Set to the operation of the line.
+ *
+ * Returns: 1 if the line holds an operation, 0 if it is empty or a
+ * comment, or -1 if it is malformed.
+ */
+static int parse_trace_line(const char *line, workload_op *op)
+{
+	const char *p = line;
+
+	while (isspace((unsigned char)*p)) {
+		p++;
+	}
+	if (*p == '\0' || *p == '#') {
+		return 0;
+	}
+
+	op->type = WORKLOAD_READ;
+	if (isalpha((unsigned char)*p)) {
+		switch (tolower((unsigned char)*p)) {
+		case 'r':
+			op->type = WORKLOAD_READ;
+			break;
+		case 'u':
+			op->type = WORKLOAD_UPDATE;
+			break;
+		case 'i':
+			op->type = WORKLOAD_INSERT;
+			break;
+		case 'm':
+			op->type = WORKLOAD_READ_MODIFY_WRITE;
+			break;
+		case 'd':
+			op->type = WORKLOAD_REMOVE;
+			break;
+		default:
+			return -1;
+		}
+		p++;
+		if (!isspace((unsigned char)*p)) {
+			return -1;
+		}
+	}
+
+	char *end;
+
+	errno = 0;
+	long key = strtol(p, &end, 10);
+
+	if (end == p || errno != 0 || key < INT_MIN || key > INT_MAX) {
+		return -1;
+	}
+	while (isspace((unsigned char)*end)) {
+		end++;
+	}
+	if (*end != '\0') {
+		return -1;
+	}
+	op->key = (int)key;
+	op->record = -1;
+	op->length = 1;
+	return 1;
+}
+
+// ===========EXTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * workload_rng_seed() - Seed a random number generator.
+ * @rng: Generator to seed.
+ * @seed: Any value. Equal seeds give equal sequences.
+ *
+ * Returns: Nothing.
+ */
+void workload_rng_seed(workload_rng *rng, uint64_t seed)
+{
+	// splitmix64 never gives an all-zero state, which xoshiro256**
+	// cannot leave.
+	for (int i = 0; i < 4; i++) {
+		rng->s[i] = splitmix64(&seed);
+	}
+}
+
+/**
+ * workload_rng_next() - Draw a random number.
+ * @rng: Generator to draw from.
+ *
+ * Uses xoshiro256** by Blackman and Vigna.
+ *
+ * Returns: A uniformly distributed 64-bit number.
+ */
+uint64_t workload_rng_next(workload_rng *rng)
+{
+	uint64_t *s = rng->s;
+	uint64_t result = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+	return result;
+}
+
+/**
+ * workload_rng_below() - Draw a random number below a bound.
+ * @rng: Generator to draw from.
+ * @n: Bound, at least 1.
+ *
+ * Draws are rejected from the low end of the range so that the
+ * remaining range is a multiple of n, which keeps the result free of
+ * modulo bias.
+ *
+ * Returns: A uniformly distributed number from 0 to n-1.
+ */
+uint64_t workload_rng_below(workload_rng *rng, uint64_t n)
+{
+	// (2^64 - n) % n == 2^64 % n, the number of draws to reject.
+	uint64_t threshold = -n % n;
+	uint64_t x;
+
+	do {
+		x = workload_rng_next(rng);
+	} while (x < threshold);
+	return x % n;
+}
+
+/**
+ * workload_rng_double() - Draw a random fraction.
+ * @rng: Generator to draw from.
+ *
+ * Returns: A uniformly distributed number in [0, 1).
+ */
+double workload_rng_double(workload_rng *rng)
+{
+	// The top 53 bits fill the mantissa of a double.
+	return (workload_rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * workload_shuffle() - Shuffle an array of ints.
+ * @rng: Generator to draw from.
+ * @seq: Array to shuffle.
+ * @n: Number of elements of seq.
+ *
+ * Uses the Fisher-Yates shuffle, so every order is equally likely.
+ *
+ * Returns: Nothing.
+ */
+void workload_shuffle(workload_rng *rng, int *seq, int n)
+{
+	for (int i = n - 1; i > 0; i--) {
+		int j = (int)workload_rng_below(rng, i + 1);
+		int tmp = seq[i];
+
+		seq[i] = seq[j];
+		seq[j] = tmp;
+	}
+}
+
+/**
+ * workload_config_default() - Get the default settings.
+ * @config: Set to uniform reads only, theta 0.99, 20% of the records
+ *	    getting 80% of the operations of a hotspot, scans of up to
+ *	    100 records and seed 1.
+ *
+ * Returns: Nothing.
+ */
+void workload_config_default(workload_config *config)
+{
+	config->distribution = WORKLOAD_UNIFORM;
+	config->theta = 0.99;
+	config->hot_fraction = 0.2;
+	config->hot_probability = 0.8;
+	config->read = 1;
+	config->update = 0;
+	config->insert = 0;
+	config->scan = 0;
+	config->read_modify_write = 0;
+	config->max_scan_length = 100;
+	config->seed = 1;
+}
+
+/**
+ * workload_config_ycsb() - Set the mix and distribution of a YCSB core
+ * workload.
+ * @config: Settings to change. The other fields are kept.
+ * @name: Letter of the workload, from 'a' to 'f' in either case.
+ *
+ * Returns: 0, or -1 if name is not a YCSB workload.
+ */
+int workload_config_ycsb(workload_config *config, char name)
+{
+	// Fractions of read, update, insert, scan and read-modify-write.
+	static const double mixes[6][5] = {
+		{0.50, 0.50, 0, 0, 0},
+		{0.95, 0.05, 0, 0, 0},
+		{1, 0, 0, 0, 0},
+		{0.95, 0, 0.05, 0, 0},
+		{0, 0, 0.05, 0.95, 0},
+		{0.50, 0, 0, 0, 0.50},
+	};
+	int i = tolower((unsigned char)name) - 'a';
+
+	if (i < 0 || i >= 6) {
+		return -1;
+	}
+	config->read = mixes[i][0];
+	config->update = mixes[i][1];
+	config->insert = mixes[i][2];
+	config->scan = mixes[i][3];
+	config->read_modify_write = mixes[i][4];
+	config->distribution = i == 3 ? WORKLOAD_LATEST : WORKLOAD_ZIPFIAN;
+	return 0;
+}
+
+/**
+ * workload_generate() - Generate the operations of a workload.
+ * @config: Settings of the workload.
+ * @keys: Keys of the records. Must hold max_records keys, or be NULL to
+ *	  use each record as its own key.
+ * @records: Number of records in the table before the workload.
+ * @max_records: Number of records that inserts may add up to. Once it
+ *		 is reached, inserts are generated as reads instead.
+ * @n: Number of operations to generate.
+ *
+ * Returns: A dynamic array of n operations, to be freed by the caller,
+ * or NULL if the settings are invalid.
+ */
+workload_op *workload_generate(const workload_config *config,
+			       const int *keys, int records, int max_records,
+			       int n)
+{
+	if (!valid_config(config) || records < 1 || max_records < records ||
+	    n < 0) {
+		return NULL;
+	}
+
+	workload_op *ops = malloc((n > 0 ? n : 1) * sizeof(*ops));
+	struct generator g;
+	double total = config->read + config->update + config->insert +
+		       config->scan + config->read_modify_write;
+
+	if (ops == NULL) {
+		return NULL;
+	}
+	g.config = config;
+	workload_rng_seed(&g.rng, config->seed);
+	zipfian_init(&g.zipf, config->theta);
+	g.records = records;
+	g.next = 0;
+
+	for (int i = 0; i < n; i++) {
+		workload_op *op = &ops[i];
+
+		op->type = choose_type(&g, total);
+		op->length = 1;
+		if (op->type == WORKLOAD_INSERT) {
+			if (g.records < max_records) {
+				op->record = g.records++;
+				op->key = keys != NULL ? keys[op->record]
+						       : op->record;
+				continue;
+			}
+			op->type = WORKLOAD_READ;
+		}
+		op->record = choose_record(&g);
+		op->key = keys != NULL ? keys[op->record] : op->record;
+		if (op->type == WORKLOAD_SCAN) {
+			int length = 1 + (int)workload_rng_below(
+				&g.rng, config->max_scan_length);
+
+			// Scans stop at the latest record.
+			if (length > g.records - op->record) {
+				length = g.records - op->record;
+			}
+			op->length = length;
+		}
+	}
+	return ops;
+}
+
+/**
+ * workload_load_trace() - Read the operations of a trace file.
+ * @path: Name of the file.
+ * @n: Set to the number of operations.
+ *
+ * Returns: A dynamic array of the operations, to be freed by the
+ * caller, or NULL if the file cannot be read or has a malformed line.
+ */
+workload_op *workload_load_trace(const char *path, int *n)
+{
+	FILE *fp = fopen(path, "r");
+
+	if (fp == NULL) {
+		fprintf(stderr, "workload_load_trace: Cannot open %s: %s\n",
+			path, strerror(errno));
+		return NULL;
+	}
+
+	int capacity = TRACE_CAPACITY;
+	int count = 0;
+	int line_no = 0;
+	workload_op *ops = malloc(capacity * sizeof(*ops));
+	char line[TRACE_LINE_LENGTH];
+
+	while (ops != NULL && fgets(line, sizeof(line), fp) != NULL) {
+		line_no++;
+		if (strchr(line, '\n') == NULL && !feof(fp)) {
+			fprintf(stderr, "workload_load_trace: %s:%d: Line "
+				"too long\n", path, line_no);
+			free(ops);
+			ops = NULL;
+			break;
+		}
+		if (count == capacity) {
+			workload_op *grown;
+
+			capacity *= 2;
+			grown = realloc(ops, capacity * sizeof(*ops));
+			if (grown == NULL) {
+				free(ops);
+				ops = NULL;
+				break;
+			}
+			ops = grown;
+		}
+
+		int parsed = parse_trace_line(line, &ops[count]);
+
+		if (parsed < 0) {
+			fprintf(stderr, "workload_load_trace: %s:%d: Malformed "
+				"line\n", path, line_no);
+			free(ops);
+			ops = NULL;
+			break;
+		}
+		count += parsed;
+	}
+	if (ops != NULL && ferror(fp)) {
+		fprintf(stderr, "workload_load_trace: Cannot read %s\n", path);
+		free(ops);
+		ops = NULL;
+	}
+	fclose(fp);
+	if (ops != NULL) {
+		*n = count;
+	}
+	return ops;
+}
@@ -0,0 +1,208 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Workloads for timing implementations of table.h.
+ *
+ * A workload is a sequence of operations on a table that already
+ * holds a number of records. The operations are generated up front
+ * from a mix of operation types and a distribution over the records,
+ * or read from a trace file, so that generating them is not part of
+ * the timing and every implementation replays the same sequence.
+ *
+ * Records are numbered in insertion order and stand for the keys of a
+ * caller-supplied array, keys[record]. The keys of the records loaded
+ * before the workload are keys[0] to keys[records-1], and inserts use
+ * the following ones.
+ *
+ * The random numbers come from xoshiro256**, seeded with splitmix64,
+ * and numbers below a bound are drawn without modulo bias.
+ *
+ * Author: Rasmus Lyxell (c19rll@cs.umu.se)
+ *
+ * Version information:
+ *   2026-10-18: v1.0, first version.
+ *   2026-10-18: v1.1, workload_generate() takes NULL for the keys.
+ */
+
+// ==========PUBLIC DATA TYPES============
+
+// State of a random number generator.
+typedef struct workload_rng {
+	uint64_t s[4];
+} workload_rng;
+
+// How the records of operations are chosen.
+typedef enum workload_distribution {
+	// Every record is equally likely.
+	WORKLOAD_UNIFORM,
+	// Record r is chosen with a probability proportional to
+	// 1/(r+1)^theta, so the earliest records are the most popular.
+	WORKLOAD_ZIPFIAN,
+	// A fraction of the records gets a fraction of the operations,
+	// uniformly within the hot and the cold records.
+	WORKLOAD_HOTSPOT,
+	// The records are chosen in order, starting over after the last.
+	WORKLOAD_SEQUENTIAL,
+	// Zipfian over the records from the latest inserted and back.
+	WORKLOAD_LATEST
+} workload_distribution;
+
+// Type of an operation.
+typedef enum workload_op_type {
+	// Look up a key.
+	WORKLOAD_READ,
+	// Insert a new value for an existing key.
+	WORKLOAD_UPDATE,
+	// Insert a new key.
+	WORKLOAD_INSERT,
+	// Look up a run of consecutive records.
+	WORKLOAD_SCAN,
+	// Look up a key, then insert a new value for it.
+	WORKLOAD_READ_MODIFY_WRITE,
+	// Remove a key. Only occurs in traces.
+	WORKLOAD_REMOVE
+} workload_op_type;
+
+// One operation of a workload.
+typedef struct workload_op {
+	workload_op_type type;
+	// Key of the operation, or of the first record of a scan.
+	int key;
+	// Record of the key, or -1 for operations read from a trace.
+	int record;
+	// Number of records of a scan, otherwise 1.
+	int length;
+} workload_op;
+
+// Settings of a generated workload.
+typedef struct workload_config {
+	workload_distribution distribution;
+	// Skew of WORKLOAD_ZIPFIAN and WORKLOAD_LATEST, between 0 and 1.
+	double theta;
+	// Fraction of the records that are hot in WORKLOAD_HOTSPOT.
+	double hot_fraction;
+	// Fraction of the operations on hot records in WORKLOAD_HOTSPOT.
+	double hot_probability;
+	// Fractions of each type of operation. They are scaled to sum
+	// to 1.
+	double read;
+	double update;
+	double insert;
+	double scan;
+	double read_modify_write;
+	// Scans cover 1 to max_scan_length records.
+	int max_scan_length;
+	uint64_t seed;
+} workload_config;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * workload_rng_seed() - Seed a random number generator.
+ * @rng: Generator to seed.
+ * @seed: Any value. Equal seeds give equal sequences.
+ *
+ * Returns: Nothing.
+ */
+void workload_rng_seed(workload_rng *rng, uint64_t seed);
+
+/**
+ * workload_rng_next() - Draw a random number.
+ * @rng: Generator to draw from.
+ *
+ * Returns: A uniformly distributed 64-bit number.
+ */
+uint64_t workload_rng_next(workload_rng *rng);
+
+/**
+ * workload_rng_below() - Draw a random number below a bound.
+ * @rng: Generator to draw from.
+ * @n: Bound, at least 1.
+ *
+ * Returns: A uniformly distributed number from 0 to n-1.
+ */
+uint64_t workload_rng_below(workload_rng *rng, uint64_t n);
+
+/**
+ * workload_rng_double() - Draw a random fraction.
+ * @rng: Generator to draw from.
+ *
+ * Returns: A uniformly distributed number in [0, 1).
+ */
+double workload_rng_double(workload_rng *rng);
+
+/**
+ * workload_shuffle() - Shuffle an array of ints.
+ * @rng: Generator to draw from.
+ * @seq: Array to shuffle.
+ * @n: Number of elements of seq.
+ *
+ * Uses the Fisher-Yates shuffle, so every order is equally likely.
+ *
+ * Returns: Nothing.
+ */
+void workload_shuffle(workload_rng *rng, int *seq, int n);
+
+/**
+ * workload_config_default() - Get the default settings.
+ * @config: Set to uniform reads only, theta 0.99, 20% of the records
+ *	    getting 80% of the operations of a hotspot, scans of up to
+ *	    100 records and seed 1.
+ *
+ * Returns: Nothing.
+ */
+void workload_config_default(workload_config *config);
+
+/**
+ * workload_config_ycsb() - Set the mix and distribution of a YCSB core
+ * workload.
+ * @config: Settings to change. The other fields are kept.
+ * @name: Letter of the workload, from 'a' to 'f' in either case:
+ *	  a: 50% reads, 50% updates, zipfian.
+ *	  b: 95% reads, 5% updates, zipfian.
+ *	  c: 100% reads, zipfian.
+ *	  d: 95% reads, 5% inserts, latest.
+ *	  e: 95% scans, 5% inserts, zipfian.
+ *	  f: 50% reads, 50% read-modify-writes, zipfian.
+ *
+ * Returns: 0, or -1 if name is not a YCSB workload.
+ */
+int workload_config_ycsb(workload_config *config, char name);
+
+/**
+ * workload_generate() - Generate the operations of a workload.
+ * @config: Settings of the workload.
+ * @keys: Keys of the records. Must hold max_records keys, or be NULL to
+ *	  use each record as its own key.
+ * @records: Number of records in the table before the workload.
+ * @max_records: Number of records that inserts may add up to. Once it
+ *		 is reached, inserts are generated as reads instead.
+ * @n: Number of operations to generate.
+ *
+ * Returns: A dynamic array of n operations, to be freed by the caller,
+ * or NULL if the settings are invalid.
+ */
+workload_op *workload_generate(const workload_config *config,
+			       const int *keys, int records, int max_records,
+			       int n);
+
+/**
+ * workload_load_trace() - Read the operations of a trace file.
+ * @path: Name of the file.
+ * @n: Set to the number of operations.
+ *
+ * Each line holds an operation as a letter and a key, e.g. "r 42",
+ * where r is a read, u an update, i an insert, m a read-modify-write
+ * and d a remove. A line with only a key is a read. Empty lines and
+ * lines starting with # are skipped.
+ *
+ * Returns: A dynamic array of the operations, to be freed by the
+ * caller, or NULL if the file cannot be read or has a malformed line.
+ */
+workload_op *workload_load_trace(const char *path, int *n);
+
+#endif